@@ -0,0 +1,186 @@
+"""Benchmarks the nqm.irimager frame pipeline, using IRImagerMock.
+
+Reports the frames/s, and the p50/p99 latency, of getting frames from Python
+for every fixture resolution, so that regressions in the hot path are visible.
+
+Usage::
+
+    python benchmarks/bench_frames.py [--frames 200] [--cpp build/benchmarks]
+
+If ``--cpp`` is given, the C++ benchmarks in that directory (built with
+``SKBUILD_CMAKE_DEFINE='BUILD_BENCHMARKS=ON;IRImager_mock=ON'``) are run too,
+and their results are added to the report.
+"""
+
+import argparse
+import datetime
+import json
+import pathlib
+import subprocess
+import sys
+import tempfile
+import time
+import typing
+
+import numpy as np
+
+from nqm.irimager import IRImagerMock, Recorder, ReplayTiming, SyntheticSceneOptions
+
+FIXTURES = pathlib.Path(__file__).parent.parent / "tests" / "__fixtures__"
+XML_FILES = [
+    FIXTURES / "72x56@1000Hz.xml",
+    FIXTURES / "382x288@80Hz.xml",
+    FIXTURES / "764x480@32Hz.xml",
+]
+CPP_BENCHMARKS = ["bench_irimager", "bench_kernels"]
+
+
+class Result(typing.NamedTuple):
+    """The result of a single benchmark."""
+
+    name: str
+    frames_per_second: float
+    p50_us: float
+    p99_us: float
+
+
+def summarize(name: str, elapsed_s: float, latencies_ns: np.ndarray) -> Result:
+    """Summarises the latency (in ns) of every frame in a benchmark."""
+    p50, p99 = np.percentile(latencies_ns, [50, 99]) / 1000
+    return Result(name, len(latencies_ns) / elapsed_s, p50, p99)
+
+
+def bench_paced(xml_path: pathlib.Path, frames: int, frame_queue_size: int):
+    """Gets frames from a mock paced at the XML framerate.
+
+    The latency is the time between when the frame was taken, and when Python
+    has the frame as a numpy array.
+    """
+    irimager = IRImagerMock(xml_path, scene=SyntheticSceneOptions())
+    latencies = np.empty(frames, dtype=np.int64)
+    irimager.start_streaming(frame_queue_size=frame_queue_size)
+    try:
+        start = time.perf_counter()
+        for i in range(frames):
+            _, timestamp = irimager.get_frame_monotonic()
+            # both are CLOCK_MONOTONIC on Linux
+            timestamp_ns = timestamp // datetime.timedelta(microseconds=1) * 1000
+            latencies[i] = time.monotonic_ns() - timestamp_ns
+        elapsed = time.perf_counter() - start
+    finally:
+        irimager.stop_streaming()
+    return summarize(
+        f"{xml_path.stem} get_frame_monotonic queue={frame_queue_size}",
+        elapsed,
+        latencies,
+    )
+
+
+def bench_unpaced(recording: pathlib.Path, xml_path: pathlib.Path, frames: int):
+    """Replays frames as fast as possible, timing each Python call.
+
+    Comparing ``get_frame_monotonic`` (which wraps a new C++ frame in a numpy
+    array) with ``get_frame_monotonic_into`` (which writes into an existing
+    numpy array) shows the cost of converting Eigen frames to numpy.
+    """
+    irimager = IRImagerMock(
+        xml_path, recording, replay_timing=ReplayTiming.AS_FAST_AS_POSSIBLE
+    )
+    out = np.empty(irimager.get_frame_shape(), dtype=np.uint16)
+    calls = {
+        "get_frame_monotonic": irimager.get_frame_monotonic,
+        "get_frame_monotonic_into": lambda: irimager.get_frame_monotonic_into(out),
+        "get_frame_celsius": irimager.get_frame_celsius,
+    }
+    results = []
+    with irimager:
+        for call_name, call in calls.items():
+            latencies = np.empty(frames, dtype=np.int64)
+            start = time.perf_counter()
+            for i in range(frames):
+                call_start = time.perf_counter_ns()
+                call()
+                latencies[i] = time.perf_counter_ns() - call_start
+            elapsed = time.perf_counter() - start
+            results.append(
+                summarize(f"{xml_path.stem} {call_name} unpaced", elapsed, latencies)
+            )
+    return results
+
+
+def record_frames(path: pathlib.Path, xml_path: pathlib.Path, frames: int):
+    """Records random frames for bench_unpaced() to replay."""
+    irimager = IRImagerMock(xml_path)
+    rows, cols = irimager.get_frame_shape()
+    rng = np.random.default_rng(seed=0)
+    with Recorder(path, rows, cols, irimager.get_temp_range_decimal()) as recorder:
+        recorder.append_frames(
+            rng.integers(18000, 19000, size=(frames, rows, cols), dtype=np.uint16),
+            np.arange(frames, dtype=np.int64) * 12_500_000,
+        )
+
+
+def run_cpp_benchmarks(build_dir: pathlib.Path) -> typing.List[Result]:
+    """Runs the C++ google-benchmark executables, and parses their JSON output."""
+    results = []
+    for name in CPP_BENCHMARKS:
+        executable = build_dir / name
+        if not executable.exists():
+            print(f"Skipping {executable}, it hasn't been built", file=sys.stderr)
+            continue
+        output = subprocess.run(
+            [executable, "--benchmark_format=json"],
+            check=True,
+            capture_output=True,
+            text=True,
+        ).stdout
+        for benchmark in json.loads(output)["benchmarks"]:
+            frames_per_second = benchmark.get(
+                "frames/s", benchmark["iterations"] / benchmark["real_time"] * 1e9
+            )
+            results.append(
+                Result(
+                    f"{name} {benchmark['name']}",
+                    frames_per_second,
+                    benchmark.get("p50_us", float("nan")),
+                    benchmark.get("p99_us", float("nan")),
+                )
+            )
+    return results
+
+
+def main():
+    """Runs every benchmark, and prints a table of the results."""
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--frames", type=int, default=200, help="frames to get per benchmark"
+    )
+    parser.add_argument(
+        "--cpp",
+        type=pathlib.Path,
+        help="directory containing the C++ benchmark executables",
+    )
+    args = parser.parse_args()
+
+    results = []
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        for xml_path in XML_FILES:
+            for frame_queue_size in [0, 8]:
+                results.append(bench_paced(xml_path, args.frames, frame_queue_size))
+            recording = pathlib.Path(tmp_dir) / f"{xml_path.stem}.nqmrec"
+            record_frames(recording, xml_path, 64)
+            results.extend(bench_unpaced(recording, xml_path, args.frames))
+    if args.cpp:
+        results.extend(run_cpp_benchmarks(args.cpp))
+
+    name_width = max(len(result.name) for result in results)
+    print(f"{'benchmark':<{name_width}} {'frames/s':>12} {'p50 µs':>10} {'p99 µs':>10}")
+    for result in results:
+        print(
+            f"{result.name:<{name_width}} {result.frames_per_second:>12.1f}"
+            f" {result.p50_us:>10.1f} {result.p99_us:>10.1f}"
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,198 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "../src/nqm/irimager/irimager_class.hpp"
+#include "../src/nqm/irimager/recording.hpp"
+#include "../src/nqm/irimager/synthetic_scene.hpp"
+
+static std::filesystem::path FIXTURES;
+
+/**
+ * Adds the frames/s, and the p50/p99 latency (in µs), as benchmark counters.
+ *
+ * @param latencies The latency of each frame, sorted in-place.
+ */
+static void set_latency_counters(
+    benchmark::State &state,
+    std::vector<std::chrono::steady_clock::duration> &latencies) {
+  state.counters["frames/s"] = benchmark::Counter(
+      static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  if (latencies.empty()) {
+    return;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  auto percentile = [&latencies](double q) {
+    auto index = static_cast<std::size_t>(
+        q * static_cast<double>(latencies.size() - 1) + 0.5);
+    return std::chrono::duration<double, std::micro>(latencies[index]).count();
+  };
+  state.counters["p50_us"] = percentile(0.50);
+  state.counters["p99_us"] = percentile(0.99);
+}
+
+/**
+ * Gets frames from a mock paced at the fixture's frame rate.
+ *
+ * The latency is the time between when the frame was due, and when
+ * get_pooled_frame_monotonic() returns it.
+ *
+ * `state.range(0)` is the `frame_queue_size`, i.e. `0` to get frames on the
+ * calling thread, or non-zero to use the background acquisition thread.
+ */
+static void BM_GetFrameMonotonic(benchmark::State &state,
+                                 const char *fixture) {
+  auto irimager = IRImagerMock(FIXTURES / fixture);
+  irimager.start_streaming(static_cast<std::size_t>(state.range(0)));
+  auto latencies = std::vector<std::chrono::steady_clock::duration>();
+
+  for (auto _ : state) {
+    auto [frame, time_point, metadata] = irimager.get_pooled_frame_monotonic();
+    latencies.push_back(std::chrono::steady_clock::now() - time_point);
+    benchmark::DoNotOptimize(frame->data());
+  }
+
+  irimager.stop_streaming();
+  set_latency_counters(state, latencies);
+}
+BENCHMARK_CAPTURE(BM_GetFrameMonotonic, 72x56@1000Hz, "72x56@1000Hz.xml")
+    ->Arg(0)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetFrameMonotonic, 382x288@80Hz, "382x288@80Hz.xml")
+    ->Arg(0)
+    ->Arg(8)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetFrameMonotonic, 764x480@32Hz, "764x480@32Hz.xml")
+    ->Arg(0)
+    ->Arg(8)
+    ->UseRealTime();
+
+/**
+ * Replays recorded synthetic frames as fast as possible, to measure the
+ * overhead of the frame pipeline itself, without any pacing.
+ *
+ * `state.range(0)` is the index of the fixture in ::FIXTURE_NAMES.
+ */
+class ReplayFixture : public benchmark::Fixture {
+ public:
+  static constexpr std::size_t FRAME_COUNT = 64;
+
+  void SetUp(const benchmark::State &state) override {
+    const auto *fixture = FIXTURE_NAMES[state.range(0)];
+    xml_path_ = FIXTURES / fixture;
+    recording_path_ =
+        std::filesystem::temp_directory_path() /
+        ("bench_irimager_" + xml_path_.stem().string() + ".nqmrec");
+
+    auto config = MockCameraConfig::from_xml(xml_path_);
+    auto scene = SyntheticScene(config, SyntheticSceneOptions{}, 1);
+    auto frame = std::vector<std::uint16_t>(
+        static_cast<std::size_t>(config.rows * config.cols));
+    auto recorder = Recorder(recording_path_, config.rows, config.cols, 1);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < FRAME_COUNT; i++) {
+      scene.render(i, frame.data());
+      recorder.append(frame.data(),
+                      start + config.frame_period() * static_cast<int>(i),
+                      FrameMetadata{});
+    }
+  }
+
+  void TearDown(const benchmark::State &) override {
+    std::filesystem::remove(recording_path_);
+  }
+
+  /** Returns a mock that replays the recording as fast as possible */
+  IRImagerMock make_irimager() const {
+    return IRImagerMock(xml_path_, recording_path_,
+                        ReplayTiming::AS_FAST_AS_POSSIBLE, true);
+  }
+
+  static void set_bytes_processed(benchmark::State &state,
+                                  IRImagerMock &irimager) {
+    auto [rows, cols] = irimager.get_frame_shape();
+    state.SetBytesProcessed(state.iterations() * rows * cols *
+                            static_cast<std::int64_t>(sizeof(std::uint16_t)));
+    state.counters["frames/s"] = benchmark::Counter(
+        static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  }
+
+  static constexpr const char *FIXTURE_NAMES[] = {
+      "72x56@1000Hz.xml",
+      "382x288@80Hz.xml",
+      "764x480@32Hz.xml",
+  };
+
+ private:
+  std::filesystem::path xml_path_;
+  std::filesystem::path recording_path_;
+};
+
+/** Allocates a new frame for every call */
+BENCHMARK_DEFINE_F(ReplayFixture, GetFrameMonotonic)(benchmark::State &state) {
+  auto irimager = make_irimager();
+  irimager.start_streaming();
+  for (auto _ : state) {
+    auto [frame, time_point] = irimager.get_frame_monotonic();
+    benchmark::DoNotOptimize(frame.data());
+  }
+  irimager.stop_streaming();
+  set_bytes_processed(state, irimager);
+}
+BENCHMARK_REGISTER_F(ReplayFixture, GetFrameMonotonic)
+    ->ArgName("fixture")
+    ->DenseRange(0, 2);
+
+/** Writes every frame into the same buffer */
+BENCHMARK_DEFINE_F(ReplayFixture, GetFrameMonotonicInto)
+(benchmark::State &state) {
+  auto irimager = make_irimager();
+  auto [rows, cols] = irimager.get_frame_shape();
+  auto frame = IRImager::ThermalFrame(rows, cols);
+  irimager.start_streaming();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(irimager.get_frame_monotonic_into(frame));
+  }
+  irimager.stop_streaming();
+  set_bytes_processed(state, irimager);
+}
+BENCHMARK_REGISTER_F(ReplayFixture, GetFrameMonotonicInto)
+    ->ArgName("fixture")
+    ->DenseRange(0, 2);
+
+/** Gets frames from the background acquisition thread's queue */
+BENCHMARK_DEFINE_F(ReplayFixture, GetPooledFrameQueued)
+(benchmark::State &state) {
+  auto irimager = make_irimager();
+  irimager.start_streaming(8, OverflowPolicy::BLOCK);
+  for (auto _ : state) {
+    auto [frame, time_point, metadata] = irimager.get_pooled_frame_monotonic();
+    benchmark::DoNotOptimize(frame->data());
+  }
+  irimager.stop_streaming();
+  set_bytes_processed(state, irimager);
+}
+BENCHMARK_REGISTER_F(ReplayFixture, GetPooledFrameQueued)
+    ->ArgName("fixture")
+    ->DenseRange(0, 2)
+    ->UseRealTime();
+
+int main(int argc, char **argv) {
+  FIXTURES = std::filesystem::path(argv[0]).parent_path() / "__fixtures__";
+  // don't print a "Creating a MOCKED IRImager object!" warning for every run
+  spdlog::set_level(spdlog::level::err);
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
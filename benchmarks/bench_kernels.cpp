@@ -0,0 +1,245 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "../src/nqm/irimager/chrono.hpp"
+#include "../src/nqm/irimager/frame_codec.hpp"
+#include "../src/nqm/irimager/frame_transform.hpp"
+#include "../src/nqm/irimager/histogram.hpp"
+#include "../src/nqm/irimager/hotspots.hpp"
+#include "../src/nqm/irimager/roi.hpp"
+#include "../src/nqm/irimager/synthetic_scene.hpp"
+#include "../src/nqm/irimager/temperature.hpp"
+#include "../src/nqm/irimager/temporal_filter.hpp"
+
+/**
+ * The `{rows, cols}` of each fixture, used as the arguments of every frame
+ * processing benchmark.
+ */
+static void fixture_resolutions(benchmark::internal::Benchmark *benchmark) {
+  benchmark->Args({72, 56})->Args({382, 288})->Args({764, 480});
+}
+
+/** The FrameEncoder keyframe interval used by the codec benchmarks */
+static constexpr std::size_t CODEC_KEYFRAME_INTERVAL = 64;
+
+/** A realistic frame, with hotspots and noise, of the benchmark's shape */
+static IRImager::ThermalFrame make_frame(const benchmark::State &state) {
+  auto config = MockCameraConfig{};
+  config.rows = state.range(0);
+  config.cols = state.range(1);
+  auto frame = IRImager::ThermalFrame(config.rows, config.cols);
+  SyntheticScene(config, SyntheticSceneOptions{}, 1).render(0, frame.data());
+  return frame;
+}
+
+/** Counts the pixels (as `uint16` bytes) processed by each iteration */
+static void set_bytes_processed(benchmark::State &state) {
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          state.range(1) *
+                          static_cast<std::int64_t>(sizeof(std::uint16_t)));
+}
+
+static void BM_ClockCast(benchmark::State &state) {
+  auto time_point = std::chrono::steady_clock::now();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(nqm::irimager::clock_cast(time_point));
+  }
+}
+BENCHMARK(BM_ClockCast);
+
+static void BM_RawToTemperature(benchmark::State &state) {
+  auto frame = make_frame(state);
+  auto out = std::vector<float>(static_cast<std::size_t>(frame.size()));
+  for (auto _ : state) {
+    raw_to_temperature(frame.data(), out.data(), out.size(), 1);
+    benchmark::DoNotOptimize(out.data());
+  }
+  set_bytes_processed(state);
+}
+BENCHMARK(BM_RawToTemperature)->Apply(fixture_resolutions);
+
+static void BM_FrameTransform(benchmark::State &state) {
+  auto frame = make_frame(state);
+  auto transform = FrameTransform{};
+  transform.binning = 2;
+  transform.binning_mode = BinningMode::MAX;
+  auto [rows, cols] = transform.output_shape({frame.rows(), frame.cols()});
+  auto out = IRImager::ThermalFrame(rows, cols);
+  for (auto _ : state) {
+    transform.apply(frame.data(), {frame.rows(), frame.cols()},
+                    Eigen::Map<IRImager::ThermalFrame>(out.data(), rows, cols));
+    benchmark::DoNotOptimize(out.data());
+  }
+  set_bytes_processed(state);
+}
+BENCHMARK(BM_FrameTransform)->Apply(fixture_resolutions);
+
+/** 16 rectangles, tiling the frame, with the median and 95th percentile */
+static void BM_RoiStats(benchmark::State &state) {
+  auto frame = make_frame(state);
+  auto engine = RoiStatsEngine(frame.rows(), frame.cols());
+  for (Eigen::Index row = 0; row < 4; row++) {
+    for (Eigen::Index col = 0; col < 4; col++) {
+      engine.add_rectangle(row * frame.rows() / 4, col * frame.cols() / 4,
+                           frame.rows() / 4, frame.cols() / 4);
+    }
+  }
+  engine.set_quantiles({0.5, 0.95});
+  auto out = RoiStatsEngine::RoiStats(
+      static_cast<Eigen::Index>(engine.size()), engine.stat_count());
+  for (auto _ : state) {
+    engine.compute(frame, out, 1);
+    benchmark::DoNotOptimize(out.data());
+  }
+  set_bytes_processed(state);
+}
+BENCHMARK(BM_RoiStats)->Apply(fixture_resolutions);
+
+static void BM_HistogramQuantiles(benchmark::State &state) {
+  auto frame = make_frame(state);
+  auto histogram = Histogram();
+  const auto quantiles = std::vector<double>{0.05, 0.5, 0.95, 0.99};
+  auto out = std::vector<std::uint16_t>(quantiles.size());
+  for (auto _ : state) {
+    histogram.clear();
+    histogram.add(frame.data(), static_cast<std::size_t>(frame.size()));
+    histogram.quantiles(quantiles.data(), out.data(), out.size());
+    benchmark::DoNotOptimize(out.data());
+  }
+  set_bytes_processed(state);
+}
+BENCHMARK(BM_HistogramQuantiles)->Apply(fixture_resolutions);
+
+/** Finds the synthetic scene's hot spots, relative to the median */
+static void BM_Hotspots(benchmark::State &state) {
+  auto frame = make_frame(state);
+  auto detector = HotspotDetector(frame.rows(), frame.cols(), 20.0f,
+                                  HotspotThreshold::RELATIVE);
+  for (auto _ : state) {
+    auto hotspots = detector.detect(frame, 1);
+    benchmark::DoNotOptimize(hotspots.data());
+  }
+  state.counters["hotspots"] =
+      static_cast<double>(detector.detect(frame, 1).rows());
+  set_bytes_processed(state);
+}
+BENCHMARK(BM_Hotspots)->Apply(fixture_resolutions);
+
+/** Pushes frames into a filter with a window of 16 frames */
+static void BM_TemporalFilter(benchmark::State &state,
+                              TemporalFilterMode mode) {
+  auto frame = make_frame(state);
+  auto filter = TemporalFilter(frame.rows(), frame.cols(), mode, 16);
+  for (auto _ : state) {
+    filter.push(frame);
+    benchmark::DoNotOptimize(filter.snapshot().data());
+  }
+  set_bytes_processed(state);
+}
+BENCHMARK_CAPTURE(BM_TemporalFilter, ema, TemporalFilterMode::EMA)
+    ->Apply(fixture_resolutions);
+BENCHMARK_CAPTURE(BM_TemporalFilter, max_hold, TemporalFilterMode::MAX_HOLD)
+    ->Apply(fixture_resolutions);
+BENCHMARK_CAPTURE(BM_TemporalFilter, mean, TemporalFilterMode::MEAN)
+    ->Apply(fixture_resolutions);
+
+/**
+ * One keyframe interval of frames from a synthetic scene, with the sensor
+ * noise given in the README (0.15 ℃, i.e. 1.5 raw units).
+ */
+static std::vector<IRImager::ThermalFrame> make_codec_frames(
+    const benchmark::State &state) {
+  auto config = MockCameraConfig{};
+  config.rows = state.range(0);
+  config.cols = state.range(1);
+  auto options = SyntheticSceneOptions{};
+  options.noise = 0.15f;
+  auto scene = SyntheticScene(config, options, 1);
+  auto frames = std::vector<IRImager::ThermalFrame>(
+      CODEC_KEYFRAME_INTERVAL,
+      IRImager::ThermalFrame(config.rows, config.cols));
+  for (std::size_t i = 0; i < frames.size(); i++) {
+    scene.render(i, frames[i].data());
+  }
+  return frames;
+}
+
+/** Encodes each frame in order, as a separate buffer */
+static std::vector<std::vector<std::uint8_t>> encode_frames(
+    const std::vector<IRImager::ThermalFrame> &frames) {
+  auto encoder = FrameEncoder(frames[0].rows(), frames[0].cols(),
+                              CODEC_KEYFRAME_INTERVAL);
+  auto encoded = std::vector<std::vector<std::uint8_t>>(frames.size());
+  for (std::size_t i = 0; i < frames.size(); i++) {
+    encoder.encode(frames[i].data(), encoded[i]);
+  }
+  return encoded;
+}
+
+/** The size of the raw frames, divided by the size of the encoded frames */
+static void set_compression_ratio(
+    benchmark::State &state,
+    const std::vector<std::vector<std::uint8_t>> &encoded) {
+  std::size_t encoded_bytes = 0;
+  for (const auto &data : encoded) {
+    encoded_bytes += data.size();
+  }
+  auto raw_bytes = encoded.size() * sizeof(std::uint16_t) *
+                   static_cast<std::size_t>(state.range(0) * state.range(1));
+  state.counters["compression_ratio"] =
+      static_cast<double>(raw_bytes) / static_cast<double>(encoded_bytes);
+}
+
+static void BM_FrameEncode(benchmark::State &state) {
+  auto frames = make_codec_frames(state);
+
+  auto encoder = FrameEncoder(state.range(0), state.range(1),
+                              CODEC_KEYFRAME_INTERVAL);
+  auto encoded = std::vector<std::uint8_t>();
+  std::size_t i = 0;
+  for (auto _ : state) {
+    encoded.clear();
+    encoder.encode(frames[i++ % frames.size()].data(), encoded);
+    benchmark::DoNotOptimize(encoded.data());
+  }
+  set_bytes_processed(state);
+  set_compression_ratio(state, encode_frames(frames));
+}
+BENCHMARK(BM_FrameEncode)->Apply(fixture_resolutions);
+
+static void BM_FrameDecode(benchmark::State &state) {
+  auto encoded = encode_frames(make_codec_frames(state));
+
+  auto decoder = FrameDecoder();
+  auto frame = IRImager::ThermalFrame(state.range(0), state.range(1));
+  std::size_t i = 0;
+  for (auto _ : state) {
+    // the frames are decoded in order, starting with the keyframe
+    const auto &data = encoded[i++ % encoded.size()];
+    decoder.decode(data.data(), data.size(), frame.data());
+    benchmark::DoNotOptimize(frame.data());
+  }
+  set_bytes_processed(state);
+  set_compression_ratio(state, encoded);
+}
+BENCHMARK(BM_FrameDecode)->Apply(fixture_resolutions);
+
+static void BM_SyntheticScene(benchmark::State &state) {
+  auto config = MockCameraConfig{};
+  config.rows = state.range(0);
+  config.cols = state.range(1);
+  auto scene = SyntheticScene(config, SyntheticSceneOptions{}, 1);
+  auto frame = IRImager::ThermalFrame(config.rows, config.cols);
+  std::uint64_t frame_index = 0;
+  for (auto _ : state) {
+    scene.render(frame_index++, frame.data());
+    benchmark::DoNotOptimize(frame.data());
+  }
+  set_bytes_processed(state);
+}
+BENCHMARK(BM_SyntheticScene)->Apply(fixture_resolutions);
+
+BENCHMARK_MAIN();
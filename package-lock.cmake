@@ -32,3 +32,15 @@ CPMDeclarePackage(eigen
   SYSTEM ON
   EXCLUDE_FROM_ALL TRUE URL https://gitlab.com/libeigen/eigen/-/archive/3.4.0/eigen-3.4.0.tar.bz2 URL_HASH SHA3_256=652266ca1f8c15663076d21be840a85910ae4071453b2a1aa6f6a55ea22daddf
 )
+# benchmark
+CPMDeclarePackage(benchmark
+  NAME benchmark
+  VERSION 1.8.3
+  GITHUB_REPOSITORY google/benchmark
+  GIT_TAG v1.8.3
+  SYSTEM ON
+  EXCLUDE_FROM_ALL TRUE
+  OPTIONS
+    "BENCHMARK_ENABLE_TESTING OFF"
+    "BENCHMARK_ENABLE_INSTALL OFF"
+)
@@ -8,6 +8,7 @@ We use the IRImagerDirect SDK
 to control these cameras.
 """
 import datetime
+import enum
 import os
 import types
 import typing
@@ -48,19 +49,934 @@ def monotonic_to_system_clock(
         to return accurate results for past time points.
     """
 
+class BufferPoolStats:
+    """Statistics about a BufferPool."""
+
+    @property
+    def hits(self) -> int:
+        """Number of times a buffer was reused from the pool."""
+    @property
+    def misses(self) -> int:
+        """Number of times a new buffer had to be allocated."""
+    @property
+    def available(self) -> int:
+        """Number of free buffers currently stored in the pool."""
+
+class LatencyStats:
+    """Summary of the latencies recorded by a LatencyHistogram.
+
+    All durations are ``0`` if nothing has been recorded.
+    """
+
+    @property
+    def count(self) -> int:
+        """Number of latencies that have been recorded."""
+    @property
+    def p50(self) -> datetime.timedelta:
+        """The median latency."""
+    @property
+    def p99(self) -> datetime.timedelta:
+        """The 99th percentile latency."""
+    @property
+    def max(self) -> datetime.timedelta:
+        """The highest latency."""
+    @property
+    def mean(self) -> datetime.timedelta:
+        """The mean latency."""
+
+class PipelineStats:
+    """Per-stage latencies, and frame counters, of an IRImager.
+
+    The frame counters are a consistent snapshot, so
+    ``frames_acquired >= frames_delivered + frames_dropped +
+    frames_shutter_closed`` always holds, even while streaming. The difference
+    is the number of frames that are still queued, or being processed.
+    """
+
+    @property
+    def acquire(self) -> LatencyStats:
+        """Waiting for the camera to return a raw frame."""
+    @property
+    def process(self) -> LatencyStats:
+        """Converting the raw frame into a thermal frame."""
+    @property
+    def handoff(self) -> LatencyStats:
+        """Passing the frame from the background acquisition thread to the caller,
+        i.e. time spent in the frame queue, and waking up the caller."""
+    @property
+    def convert(self) -> LatencyStats:
+        """Converting the frame into a Python object."""
+    @property
+    def delivery(self) -> LatencyStats:
+        """From when the frame was taken, until it was returned to the caller."""
+    @property
+    def flag_closures(self) -> LatencyStats:
+        """How long the shutter flag stayed closed, counted once the flag reopens."""
+    @property
+    def frames_acquired(self) -> int:
+        """Number of frames grabbed from the camera, including bad frames."""
+    @property
+    def frames_shutter_closed(self) -> int:
+        """Number of frames skipped because the shutter flag was not open.
+
+        Frames replaced by the last good frame, see
+        :py:attr:`ShutterPolicy.RETURN_STALE`, are delivered, not skipped.
+        """
+    @property
+    def frames_delivered(self) -> int:
+        """Number of frames returned to the caller, or to the frame callback."""
+    @property
+    def frames_dropped(self) -> int:
+        """Number of grabbed frames that we threw away.
+
+        Either because the frame queue was full, or because streaming stopped
+        before they were read.
+        """
+    @property
+    def frames_overrun(self) -> int:
+        """Number of frames taken by the camera that were never grabbed.
+
+        Happens when nobody asked for a frame in time. These are not counted in
+        :py:attr:`frames_acquired`.
+        """
+
+class ThreadScheduling:
+    """How a background thread should be scheduled by the OS.
+
+    By default, nothing is changed, so the thread inherits the scheduling of
+    the thread that started it.
+
+    For example, pinning the acquisition thread to a CPU that isn't used by
+    any heavy numpy processing, and giving it a real-time priority, stops other
+    threads from delaying frames.
+    """
+
+    cpus: typing.List[int]
+    """The CPUs that the thread may run on, numbered from ``0``, or empty to
+    allow any CPU."""
+    fifo_priority: typing.Optional[int]
+    """If set, use the real-time ``SCHED_FIFO`` policy with this priority,
+    from ``1`` (lowest) to ``99`` (highest).
+
+    This normally needs the ``CAP_SYS_NICE`` capability, or a high enough
+    ``RLIMIT_RTPRIO`` limit (e.g. ``ulimit -r``)."""
+    nice: typing.Optional[int]
+    """If set, the niceness of the thread, from ``-20`` (highest priority) to
+    ``19`` (lowest priority). Ignored by the OS while the thread uses
+    ``SCHED_FIFO``.
+
+    Lowering the niceness normally needs the ``CAP_SYS_NICE`` capability, or
+    a high enough ``RLIMIT_NICE`` limit."""
+
+    def __init__(
+        self,
+        cpus: typing.Sequence[int] = (),
+        fifo_priority: typing.Optional[int] = None,
+        nice: typing.Optional[int] = None,
+    ) -> None:
+        """Creates a new ThreadScheduling.
+
+        Raises:
+            ValueError: If a CPU, the ``fifo_priority``, or the ``nice`` value
+                is out of range.
+        """
+
+class AppliedThreadScheduling:
+    """The scheduling that a thread actually got, after trying to apply a
+    :py:class:`ThreadScheduling`.
+
+    The OS may refuse some of the requested settings, e.g. if we don't have
+    permission to use ``SCHED_FIFO``. Instead of stopping the thread, the
+    settings are left unchanged, and the reason is added to :py:attr:`errors`.
+    """
+
+    @property
+    def cpus(self) -> typing.List[int]:
+        """The CPUs that the thread may run on."""
+    @property
+    def fifo_priority(self) -> typing.Optional[int]:
+        """The ``SCHED_FIFO`` priority of the thread, or ``None`` if it does not
+        use ``SCHED_FIFO``."""
+    @property
+    def nice(self) -> int:
+        """The niceness of the thread."""
+    @property
+    def errors(self) -> typing.List[str]:
+        """Why each setting that wasn't applied was refused, if any."""
+
+class TemperatureUnit(enum.Enum):
+    """Unit of temperature."""
+
+    CELSIUS = 0
+    """Degrees Celsius (℃)."""
+    KELVIN = 1
+    """Kelvin (K)."""
+
+def raw_to_temperature(
+    raw: npt.NDArray[np.uint16],
+    temp_range_decimal: int,
+    unit: TemperatureUnit = TemperatureUnit.CELSIUS,
+    out: typing.Optional[npt.NDArray[np.float32]] = None,
+) -> npt.NDArray[np.float32]:
+    """Converts raw thermal data to ``float32`` temperatures.
+
+    Computes ``raw / 10 ** temp_range_decimal - 100`` (plus ``273.15`` for
+    Kelvin) in a single vectorised pass, without any temporary arrays.
+
+    Args:
+        raw: A C-contiguous ``uint16`` array of any shape, e.g. from
+            :py:meth:`IRImager.get_frame` or :py:meth:`IRImager.get_frames`.
+        temp_range_decimal: See :py:meth:`IRImager.get_temp_range_decimal`.
+        unit: The unit of temperature to output.
+        out: If set, a C-contiguous ``float32`` array with the same shape as
+            ``raw``, that the temperatures are written to.
+
+    Returns:
+        The temperatures, in ``out`` if it was given.
+    """
+
+class Histogram:
+    """Histogram of raw ``uint16`` thermal data.
+
+    Since raw thermal data only has 65536 possible values, quantiles (e.g. the
+    median) can be computed exactly from a counting histogram in a single
+    pass, instead of sorting the data like :py:func:`numpy.quantile`.
+
+    Only the bins between the smallest and largest values that have been
+    added are touched, so clearing the histogram and computing quantiles is
+    cheap for the narrow range of temperatures in a typical scene.
+
+    The same histogram can be reused for every frame, by calling
+    :py:meth:`clear` in between, so that no memory is allocated.
+    """
+
+    def __init__(self, bin_width: int = 1) -> None:
+        """Create an empty histogram.
+
+        Args:
+            bin_width: How many consecutive raw values are counted in each bin.
+                A width of ``1`` gives exact quantiles.
+        """
+    @property
+    def bin_width(self) -> int:
+        """How many consecutive raw values are counted in each bin."""
+    @property
+    def count(self) -> int:
+        """The total number of values that have been added."""
+    def clear(self) -> None:
+        """Removes all values."""
+    def add(self, values: npt.NDArray[np.uint16]) -> None:
+        """Adds raw thermal data to the histogram.
+
+        Args:
+            values: A ``uint16`` array of any shape, e.g. a frame from
+                :py:meth:`IRImager.get_frame`, a slice of a frame, or the pixels
+                selected by a boolean mask.
+        """
+    def counts(self) -> npt.NDArray[np.uint64]:
+        """The number of values in each bin.
+
+        Bin ``i`` counts the raw values from ``i * bin_width`` to
+        ``(i + 1) * bin_width - 1``.
+        """
+    def quantile(self, q: float) -> int:
+        """Computes a quantile of the values.
+
+        Uses the inverted cumulative distribution function, i.e. returns the
+        smallest value ``v`` where at least ``q * count`` values are ``<= v``.
+        This is the same as ``numpy.quantile(values, q, method="inverted_cdf")``,
+        if :py:attr:`bin_width` is ``1``.
+        Otherwise, the lowest raw value of the bin is returned.
+
+        Args:
+            q: The quantile to compute, from ``0.0`` to ``1.0``.
+
+        Raises:
+            ValueError: If ``q`` is not between ``0.0`` and ``1.0``.
+            RuntimeError: If the histogram is empty.
+
+        Returns:
+            The raw value of the quantile, see :py:func:`raw_to_temperature`.
+        """
+    def quantiles(self, q: npt.ArrayLike) -> npt.NDArray[np.uint16]:
+        """Computes multiple quantiles, see :py:meth:`quantile`.
+
+        If ``q`` is sorted, all quantiles are computed in a single pass.
+
+        Args:
+            q: The quantiles to compute, from ``0.0`` to ``1.0``.
+
+        Returns:
+            A ``uint16`` array of the raw value of each quantile.
+        """
+
+class BinningMode(enum.Enum):
+    """How pixels are combined by :py:attr:`FrameTransform.binning`."""
+
+    MEAN = 0
+    """Use the mean of each bin, rounded to the nearest raw value."""
+    MAX = 1
+    """Use the maximum of each bin, e.g. so that small hot spots are kept."""
+
+class FrameTransform:
+    """Crop rectangle and binning applied to every frame.
+
+    Frames are cropped and binned while they are copied out of the
+    IRImagerDirect SDK's buffer, so every later stage only sees the smaller
+    frame. See :py:meth:`IRImager.set_frame_transform`.
+
+    The default value does not change the frame.
+    """
+
+    row: int
+    """The first row of the crop rectangle."""
+    col: int
+    """The first column of the crop rectangle."""
+    height: int
+    """The number of rows in the crop rectangle, or ``0`` to use every row
+    after :py:attr:`row`."""
+    width: int
+    """The number of columns in the crop rectangle, or ``0`` to use every column
+    after :py:attr:`col`."""
+    binning: int
+    """Combine each ``binning x binning`` block of pixels into a single pixel,
+    from ``1`` (no binning) to ``16``.
+
+    If the crop rectangle isn't a multiple of ``binning``, the leftover
+    rows/columns at the bottom/right are dropped."""
+    binning_mode: BinningMode
+    """How pixels are combined by :py:attr:`binning`."""
+
+    def __init__(
+        self,
+        row: int = 0,
+        col: int = 0,
+        height: int = 0,
+        width: int = 0,
+        binning: int = 1,
+        binning_mode: BinningMode = BinningMode.MEAN,
+    ) -> None: ...
+
+class FrameEncoder:
+    """Losslessly compresses a stream of raw thermal frames.
+
+    Each pixel is predicted from either the same pixel in the previous frame
+    (temporal prediction), or, for keyframes, from its left/upper neighbour
+    (spatial prediction). The prediction errors are zig-zag encoded, so that
+    small negative errors become small positive numbers, then bit-packed in
+    blocks of 16 pixels, using the fewest bits needed for each block.
+
+    Frames must be decoded in the same order by a :py:class:`FrameDecoder`.
+    Keyframes don't depend on any other frame, so decoding can start from any
+    keyframe.
+    """
+
+    def __init__(self, rows: int, cols: int, keyframe_interval: int = 64) -> None:
+        """Creates a new encoder.
+
+        Args:
+            rows: The number of rows in each frame.
+            cols: The number of columns in each frame.
+            keyframe_interval: Encode a keyframe every ``keyframe_interval``
+                frames, e.g. ``1`` to only encode keyframes.
+
+        Raises:
+            ValueError: If any argument is ``0``.
+        """
+    @property
+    def rows(self) -> int:
+        """The number of rows in each frame."""
+    @property
+    def cols(self) -> int:
+        """The number of columns in each frame."""
+    @property
+    def max_encoded_size(self) -> int:
+        """The maximum number of bytes that :py:meth:`encode` can return."""
+    def encode(self, frame: npt.NDArray[np.uint16]) -> bytes:
+        """Encodes a frame.
+
+        Args:
+            frame: A C-contiguous ``uint16`` frame with shape ``(rows, cols)``,
+                e.g. from :py:meth:`IRImager.get_frame`.
+
+        Returns:
+            The encoded frame, which must be decoded by a
+            :py:class:`FrameDecoder` in the same order as it was encoded.
+        """
+    def request_keyframe(self) -> None:
+        """Makes the next encoded frame a keyframe."""
+
+class FrameDecoder:
+    """Decodes frames encoded by a :py:class:`FrameEncoder`."""
+
+    def decode(self, data: typing.Union[bytes, memoryview]) -> npt.NDArray[np.uint16]:
+        """Decodes a frame.
+
+        Args:
+            data: A frame encoded by :py:meth:`FrameEncoder.encode`, e.g. as
+                ``bytes`` or a ``memoryview``.
+
+        Returns:
+            The decoded ``uint16`` frame.
+
+        Raises:
+            ValueError: If ``data`` is not a valid encoded frame.
+            RuntimeError: If ``data`` is not a keyframe, and the frame before
+                it was not decoded.
+        """
+    @staticmethod
+    def is_keyframe(data: bytes) -> bool:
+        """Whether an encoded frame is a keyframe."""
+    def reset(self) -> None:
+        """Forgets the previous frame, e.g. after seeking to a different keyframe."""
+
+class TemporalFilterMode(enum.Enum):
+    """How :py:class:`TemporalFilter` combines each pixel over consecutive frames."""
+
+    EMA = 0
+    """Exponential moving average, where each new frame has a weight of
+    ``alpha``."""
+    MAX_HOLD = 1
+    """The maximum of each pixel over the last ``window`` frames."""
+    MIN_HOLD = 2
+    """The minimum of each pixel over the last ``window`` frames."""
+    MEAN = 3
+    """The mean of each pixel over the last ``window`` frames (boxcar)."""
+
+class TemporalFilter:
+    """Filters each pixel over consecutive frames, e.g. to smooth noise.
+
+    Every pushed frame updates the filter's state incrementally, instead of
+    re-reading the whole history. :py:attr:`TemporalFilterMode.MAX_HOLD` and
+    :py:attr:`TemporalFilterMode.MIN_HOLD` use the van Herk/Gil-Werman
+    algorithm, so cost about four passes over each frame, whatever the window
+    size.
+
+    This class is not thread-safe.
+    """
+
+    def __init__(
+        self,
+        rows: int,
+        cols: int,
+        mode: TemporalFilterMode,
+        window: int = 8,
+        alpha: float = 0.125,
+    ) -> None:
+        """Creates a new, empty filter.
+
+        Args:
+            rows: The number of rows in each frame.
+            cols: The number of columns in each frame.
+            mode: How to combine each pixel over consecutive frames.
+            window: The number of frames to combine, ignored by
+                :py:attr:`TemporalFilterMode.EMA`. Uses ``window`` frames of
+                memory.
+            alpha: The weight of each new frame, from ``0.0`` (exclusive) to
+                ``1.0``, only used by :py:attr:`TemporalFilterMode.EMA`.
+
+        Raises:
+            ValueError: If the frame is empty, if ``window`` is ``0`` or larger
+                than ``65536``, or if ``alpha`` is out of range.
+        """
+    @property
+    def rows(self) -> int:
+        """The number of rows in each frame."""
+    @property
+    def cols(self) -> int:
+        """The number of columns in each frame."""
+    @property
+    def mode(self) -> TemporalFilterMode:
+        """How pixels are combined over consecutive frames."""
+    @property
+    def window(self) -> int:
+        """The number of frames that are combined."""
+    @property
+    def alpha(self) -> float:
+        """The weight of each new frame in :py:attr:`TemporalFilterMode.EMA`."""
+    @property
+    def count(self) -> int:
+        """The number of frames pushed since construction, or since :py:meth:`reset`."""
+    def push(self, frame: npt.NDArray[np.uint16]) -> None:
+        """Adds a frame to the filter, and updates the :py:meth:`snapshot`.
+
+        Until ``window`` frames have been pushed, the window only contains the
+        frames pushed so far.
+
+        Raises:
+            ValueError: If ``frame`` has the wrong shape.
+        """
+    def apply(self, frame: npt.NDArray[np.uint16]) -> None:
+        """Adds a frame to the filter, then overwrites it with the :py:meth:`snapshot`.
+
+        Args:
+            frame: A writable ``uint16`` frame with shape ``(rows, cols)``.
+
+        Raises:
+            ValueError: If ``frame`` has the wrong shape.
+        """
+    def snapshot(self) -> npt.NDArray[np.uint16]:
+        """A copy of the filtered frame, rounded to the nearest raw value.
+
+        Raises:
+            RuntimeError: If no frames have been pushed since construction, or
+                since :py:meth:`reset`.
+        """
+    def reset(self) -> None:
+        """Forgets every pushed frame."""
+
+class Recorder:
+    """Writes thermal frames to a single append-only recording file.
+
+    Each frame is stored with its monotonic timestamp and
+    :py:class:`FrameMetadata` in a fixed-size record, and a time index is
+    written when the recording is closed. The file is grown one chunk of
+    ``frames_per_chunk`` frames at a time, and written through a memory
+    mapping, so appending a frame doesn't need any system calls.
+
+    Recordings that were not closed (e.g. if the process crashed) can still be
+    read, just without the time index.
+
+    Use in a ``with`` statement to automatically close the recording.
+    """
+
+    def __init__(
+        self,
+        path: typing.Union[os.PathLike, str],
+        rows: int,
+        cols: int,
+        temp_range_decimal: int,
+        frames_per_chunk: int = 256,
+    ) -> None:
+        """Creates a new recording, overwriting any existing file.
+
+        Args:
+            path: The file to write to.
+            rows: The number of rows in each frame.
+            cols: The number of columns in each frame.
+            temp_range_decimal: See :py:meth:`IRImager.get_temp_range_decimal`,
+                stored so that the recording can be converted to temperatures
+                later.
+            frames_per_chunk: The number of frames that the file grows by.
+
+        Raises:
+            ValueError: If ``rows``, ``cols``, or ``frames_per_chunk`` are ``0``.
+            RuntimeError: If the file could not be created.
+        """
+    def append(
+        self,
+        frame: npt.NDArray[np.uint16],
+        timestamp: datetime.timedelta,
+        metadata: typing.Optional[FrameMetadata] = None,
+    ) -> None:
+        """Appends a frame to the recording.
+
+        Args:
+            frame: A C-contiguous ``uint16`` frame with shape ``(rows, cols)``,
+                e.g. from :py:meth:`IRImager.get_frame_monotonic`.
+            timestamp: The monotonic time of the frame, must not be earlier
+                than the timestamp of the previous frame.
+            metadata: The metadata of the frame, see
+                :py:meth:`IRImager.get_frame_with_metadata`.
+
+        Raises:
+            ValueError: If ``frame`` has the wrong shape, or ``timestamp`` is
+                out of order.
+        """
+    def append_frames(
+        self,
+        frames: npt.NDArray[np.uint16],
+        timestamps: npt.NDArray[np.int64],
+        metadata: typing.Optional[npt.NDArray[np.void]] = None,
+    ) -> None:
+        """Appends multiple frames to the recording.
+
+        Accepts the arrays returned by :py:meth:`IRImager.get_frames`.
+
+        Args:
+            frames: A C-contiguous ``(count, rows, cols)`` ``uint16`` array.
+            timestamps: A ``(count,)`` ``int64`` array of monotonic timestamps,
+                in nanoseconds.
+            metadata: A ``(count,)`` structured array of :py:class:`FrameMetadata`.
+        """
+    def close(self) -> None:
+        """Writes the time index, and closes the file.
+
+        Does nothing if the recording is already closed.
+        """
+    @property
+    def closed(self) -> bool:
+        """Whether :py:meth:`close` has been called."""
+    @property
+    def rows(self) -> int:
+        """The number of rows in each frame."""
+    @property
+    def cols(self) -> int:
+        """The number of columns in each frame."""
+    def __len__(self) -> int:
+        """The number of frames that have been appended."""
+    def __enter__(self) -> Recorder: ...
+    def __exit__(
+        self,
+        exc_type: typing.Optional[typing.Type[BaseException]],
+        exc: typing.Optional[BaseException],
+        traceback: typing.Optional[types.TracebackType],
+    ) -> None: ...
+
+class RecordingReader:
+    """Reads a recording written by a :py:class:`Recorder`.
+
+    The whole file is memory-mapped, so frames are only read from disk when
+    they are accessed, and can be used without copying them.
+    """
+
+    def __init__(self, path: typing.Union[os.PathLike, str]) -> None:
+        """Opens and memory-maps a recording.
+
+        Raises:
+            RuntimeError: If the file could not be opened.
+            ValueError: If the file is not a valid recording.
+        """
+    def __len__(self) -> int:
+        """The number of frames in the recording."""
+    @property
+    def rows(self) -> int:
+        """The number of rows in each frame."""
+    @property
+    def cols(self) -> int:
+        """The number of columns in each frame."""
+    @property
+    def temp_range_decimal(self) -> int:
+        """See :py:meth:`IRImager.get_temp_range_decimal`."""
+    @property
+    def has_index(self) -> bool:
+        """Whether the recording was closed, and so has a time index."""
+    def frames(
+        self, start: int = 0, stop: typing.Optional[int] = None
+    ) -> npt.NDArray[np.uint16]:
+        """Return a range of frames, without copying them.
+
+        Args:
+            start: The index of the first frame.
+            stop: The index after the last frame, or ``None`` for the end of
+                the recording.
+
+        Returns:
+            A read-only ``(stop - start, rows, columns)`` ``uint16`` view of
+            the memory-mapped recording. Frames are only read from disk when
+            they are accessed. The view keeps the recording open.
+
+        Raises:
+            IndexError: If ``start``/``stop`` are out of range.
+        """
+    def timestamps(
+        self, start: int = 0, stop: typing.Optional[int] = None
+    ) -> npt.NDArray[np.int64]:
+        """Return a view of the monotonic timestamps of a range of frames.
+
+        Returns:
+            A read-only ``(stop - start,)`` ``int64`` array of timestamps, in
+            nanoseconds, see :py:meth:`frames`.
+        """
+    def metadata(
+        self, start: int = 0, stop: typing.Optional[int] = None
+    ) -> npt.NDArray[np.void]:
+        """Return a view of the metadata of a range of frames.
+
+        Returns:
+            A read-only ``(stop - start,)`` structured array of each frame's
+            :py:class:`FrameMetadata`, see :py:meth:`frames`.
+        """
+    def seek(self, timestamp: datetime.timedelta) -> int:
+        """Finds the first frame with a timestamp at or after ``timestamp``.
+
+        Uses a binary search of the time index (or, if the recording was not
+        closed, of the records), so only ``O(log n)`` pages of the file are
+        read.
+
+        Returns:
+            The index of the frame, or ``len(self)`` if every frame is earlier.
+        """
+
+class RoiStat(enum.Enum):
+    """Columns of the array returned by :py:meth:`IRImager.get_roi_stats`."""
+
+    MIN = 0
+    """The minimum temperature in the region."""
+    MAX = 1
+    """The maximum temperature in the region."""
+    MEAN = 2
+    """The mean temperature in the region."""
+    STDDEV = 3
+    """The (population) standard deviation of the temperature in the region."""
+
+class HotspotStat(enum.Enum):
+    """Columns of the array returned by :py:meth:`HotspotDetector.detect`."""
+
+    AREA = 0
+    """The number of pixels in the hot spot."""
+    CENTROID_ROW = 1
+    """The mean row index of the pixels in the hot spot."""
+    CENTROID_COL = 2
+    """The mean column index of the pixels in the hot spot."""
+    ROW = 3
+    """The first row of the hot spot's bounding box."""
+    COL = 4
+    """The first column of the hot spot's bounding box."""
+    HEIGHT = 5
+    """The number of rows in the hot spot's bounding box."""
+    WIDTH = 6
+    """The number of columns in the hot spot's bounding box."""
+    PEAK = 7
+    """The maximum temperature in the hot spot."""
+    MEAN = 8
+    """The mean temperature in the hot spot."""
+
+class HotspotThreshold(enum.Enum):
+    """What :py:attr:`HotspotDetector.threshold` is relative to."""
+
+    ABSOLUTE = 0
+    """The threshold is a temperature, in degrees Celsius."""
+    RELATIVE = 1
+    """The threshold is a temperature difference, in degrees Celsius, above the
+    median temperature of the background region, see
+    :py:meth:`HotspotDetector.set_background_rectangle`."""
+
+class HotspotDetector:
+    """Finds the hot spots in a frame, i.e. connected regions of pixels that are
+    hotter than a threshold.
+
+    Each row of the frame is split into runs of hot pixels, then touching runs
+    in consecutive rows are merged using a union-find, which is much faster
+    than thresholding in numpy and calling ``scipy.ndimage.label``.
+    """
+
+    def __init__(
+        self,
+        rows: int,
+        cols: int,
+        threshold: float,
+        threshold_mode: HotspotThreshold = HotspotThreshold.ABSOLUTE,
+        min_area: int = 1,
+        connectivity: int = 8,
+    ) -> None:
+        """Creates a new detector.
+
+        Args:
+            rows: The number of rows in each frame.
+            cols: The number of columns in each frame.
+            threshold: Pixels hotter than this are part of a hot spot, in
+                degrees Celsius.
+            threshold_mode: What ``threshold`` is relative to.
+            min_area: Ignore hot spots with fewer pixels than this, e.g. to
+                ignore single noisy pixels.
+            connectivity: ``8`` if diagonally adjacent pixels are connected,
+                or ``4`` if only horizontally/vertically adjacent pixels are
+                connected.
+
+        Raises:
+            ValueError: If the frame is empty, if ``min_area`` is ``0``, or if
+                ``connectivity`` is not ``4`` or ``8``.
+        """
+    @property
+    def rows(self) -> int:
+        """The number of rows in each frame."""
+    @property
+    def cols(self) -> int:
+        """The number of columns in each frame."""
+    @property
+    def threshold(self) -> float:
+        """Pixels hotter than this are part of a hot spot, in degrees Celsius."""
+    @property
+    def threshold_mode(self) -> HotspotThreshold:
+        """What :py:attr:`threshold` is relative to."""
+    @property
+    def min_area(self) -> int:
+        """Hot spots with fewer pixels than this are ignored."""
+    @property
+    def connectivity(self) -> int:
+        """``8`` if diagonally adjacent pixels are connected, otherwise ``4``."""
+    def set_threshold(self, threshold: float, threshold_mode: HotspotThreshold) -> None:
+        """Changes the :py:attr:`threshold` and :py:attr:`threshold_mode`."""
+    def set_background_rectangle(
+        self, row: int, col: int, height: int, width: int
+    ) -> None:
+        """Sets the background region to a rectangle.
+
+        See :py:attr:`HotspotThreshold.RELATIVE`. By default, the whole frame
+        is used. The rectangle is clipped to the frame.
+
+        Raises:
+            ValueError: If the rectangle does not contain any pixels.
+        """
+    def set_background_polygon(
+        self, vertices: typing.Sequence[typing.Tuple[float, float]]
+    ) -> None:
+        """Sets the background region to a polygon.
+
+        See :py:meth:`IRImager.add_roi_polygon` and
+        :py:attr:`HotspotThreshold.RELATIVE`.
+
+        Raises:
+            ValueError: If the polygon has fewer than 3 vertices, or does not
+                contain any pixels.
+        """
+    def clear_background(self) -> None:
+        """Uses the whole frame as the background region."""
+    def detect(
+        self, frame: npt.NDArray[np.uint16], temp_range_decimal: int
+    ) -> npt.NDArray[np.float32]:
+        """Finds the hot spots in a frame.
+
+        Args:
+            frame: A ``uint16`` frame with shape ``(rows, cols)``, e.g. from
+                :py:meth:`IRImager.get_frame`.
+            temp_range_decimal: See :py:meth:`IRImager.get_temp_range_decimal`.
+
+        Returns:
+            A ``(hot spot count, 9)`` ``float32`` array, whose columns are
+            indexed by :py:class:`HotspotStat`, with temperatures in degrees
+            Celsius. Hot spots are sorted by their top row, then by the first
+            column in that row.
+
+        Raises:
+            ValueError: If ``frame`` has the wrong shape.
+        """
+
+class FlagState(enum.Enum):
+    """State of the shutter flag of the camera."""
+
+    OPEN = 0
+    """The flag is open, the frame contains valid thermal data."""
+    CLOSED = 1
+    """The flag is closed, e.g. for calibration."""
+    OPENING = 2
+    """The flag is opening."""
+    CLOSING = 3
+    """The flag is closing."""
+    ERROR = 4
+    """The flag is in an error/unknown state."""
+
+class FrameMetadata:
+    """Metadata about a thermal frame."""
+
+    @property
+    def counter(self) -> int:
+        """Frame counter, as counted by the IRImagerDirect SDK."""
+    @property
+    def counter_hw(self) -> int:
+        """Frame counter, as counted by the camera hardware."""
+    @property
+    def flag_state(self) -> FlagState:
+        """State of the shutter flag when the frame was taken."""
+    @property
+    def temp_chip(self) -> float:
+        """Temperature of the camera's chip, in degrees Celsius."""
+    @property
+    def temp_flag(self) -> float:
+        """Temperature of the camera's shutter flag, in degrees Celsius."""
+    @property
+    def temp_box(self) -> float:
+        """Temperature of the camera's housing, in degrees Celsius."""
+    @property
+    def sequence(self) -> int:
+        """Sequence number of the frame, counted by IRImager from ``1``.
+
+        Every frame grabbed from the camera gets the next sequence number, even
+        if it is later dropped or skipped, so a gap between two frames means
+        that frames were lost in between. A gap in :py:attr:`counter_hw` instead
+        means that the camera took frames that were never grabbed.
+        """
+    @property
+    def stale(self) -> bool:
+        """Whether the shutter flag was not open when this frame was taken.
+
+        If so, the thermal data is from the last good frame. Only happens with
+        :py:attr:`ShutterPolicy.RETURN_STALE`.
+        """
+
+class OverflowPolicy(enum.Enum):
+    """What to do when the background frame queue is full."""
+
+    BLOCK = 0
+    """Stop grabbing frames until there is space in the queue.
+
+    No frames are dropped by us, but the camera may drop frames internally.
+    """
+    DROP_OLDEST = 1
+    """Throw away the oldest queued frame.
+
+    This means the newest frame is always available. Use with a
+    ``frame_queue_size`` of ``1`` to always get the latest frame.
+    """
+    DROP_NEWEST = 2
+    """Throw away new frames until there is space in the queue."""
+
+class ShutterPolicy(enum.Enum):
+    """What to do with frames taken while the shutter flag is not open.
+
+    For example, while the camera is calibrating itself.
+    """
+
+    WAIT = 0
+    """Skip the frames.
+
+    Getting a frame waits until the shutter flag is open again (usually around
+    ~1s).
+    """
+    RETURN_STALE = 1
+    """Immediately return the last good frame, with the metadata of the new frame.
+
+    :py:attr:`FrameMetadata.stale` is ``True`` for these frames. Frames are
+    still skipped if there hasn't been a good frame since streaming started.
+    Every good frame is copied, so this is slightly slower than
+    :py:attr:`ShutterPolicy.WAIT`.
+    """
+
+class FrameStream:
+    """Asynchronous iterator over frames, see :py:meth:`IRImager.stream`."""
+
+    def __aiter__(self) -> FrameStream: ...
+    async def __anext__(
+        self,
+    ) -> typing.Tuple[npt.NDArray[np.uint16], datetime.datetime]: ...
+
 class IRImager:
     """IRImager object - interfaces with a camera."""
 
     def __init__(self, xml_path: os.PathLike) -> None:
         """Loads the configuration for an IR Camera from the given XML file"""
-    def start_streaming(self) -> None:
+    def start_streaming(
+        self,
+        frame_queue_size: int = 0,
+        overflow_policy: OverflowPolicy = OverflowPolicy.DROP_NEWEST,
+        shutter_policy: ShutterPolicy = ShutterPolicy.WAIT,
+    ) -> None:
         """Start video grabbing
 
+        Prefer using ``with irimager: ...`` to automatically start/stop
+        streaming on errors.
+
+        Args:
+            frame_queue_size: If ``0`` (the default), frames are only grabbed
+                from the camera when calling :py:meth:`~IRImager.get_frame`.
+                Otherwise, a background thread continuously grabs frames from
+                the camera and stores up to ``frame_queue_size`` frames in a
+                queue, so that frames aren't lost if
+                :py:meth:`~IRImager.get_frame` isn't called often enough.
+            overflow_policy: What to do with new frames when the queue is
+                full. Ignored if ``frame_queue_size`` is ``0``.
+            shutter_policy: What to do with frames taken while the shutter
+                flag is not open.
+
         Raises:
             RuntimeError: If streaming cannot be started, e.g. if the camera is not connected.
         """
     def stop_streaming(self) -> None:
         """Stop video grabbing"""
+    def is_streaming(self) -> bool:
+        """Whether :py:meth:`start_streaming` has been called, and
+        :py:meth:`stop_streaming` has not."""
     def __enter__(self: _SelfIRImager) -> _SelfIRImager: ...
     def __exit__(
         self,
@@ -73,7 +989,8 @@ class IRImager:
 
         If the shutter is down (normally done automatically by the thermal
         camera for calibration), this function will wait until the shutter is
-        back up, before returning (usually around ~1s).
+        back up, before returning (usually around ~1s), unless streaming was
+        started with :py:attr:`ShutterPolicy.RETURN_STALE`.
 
         Throws:
             RuntimeError if a frame cannot be loaded, e.g. if the camera isn't
@@ -86,6 +1003,90 @@ class IRImager:
                  temperature in degrees Celcius, offset from -100 ℃.
               2. The approximate time the image was taken.
         """
+    def try_get_frame(
+        self, timeout: typing.Union[datetime.timedelta, float]
+    ) -> typing.Optional[typing.Tuple[npt.NDArray[np.uint16], datetime.datetime]]:
+        """Return a frame, or ``None`` if no frame arrives within ``timeout``.
+
+        Similar to :py:meth:`get_frame`, except that this never waits for
+        longer than ``timeout`` (plus one frame period, if
+        ``frame_queue_size`` is ``0``).
+
+        To always get the latest frame, start streaming with
+        ``frame_queue_size=1`` and
+        ``overflow_policy=OverflowPolicy.DROP_OLDEST``.
+        """
+    def try_get_frame_monotonic(
+        self, timeout: typing.Union[datetime.timedelta, float]
+    ) -> typing.Optional[typing.Tuple[npt.NDArray[np.uint16], datetime.timedelta]]:
+        """Return a frame with a monotonic timestamp, or ``None`` on timeout.
+
+        Similar to :py:meth:`try_get_frame`, except returns a monotonic
+        timepoint, see :py:meth:`get_frame_monotonic`.
+        """
+    def get_frame_async(
+        self,
+    ) -> typing.Awaitable[typing.Tuple[npt.NDArray[np.uint16], datetime.datetime]]:
+        """Return an awaitable that resolves to the next frame.
+
+        Similar to :py:meth:`get_frame`, except that it doesn't block the
+        :py:mod:`asyncio` event loop, or use any executor threads.
+        Instead, the event loop waits on a file descriptor (an ``eventfd``)
+        that the C++ background thread signals whenever a frame is queued.
+
+        Requires calling :py:meth:`start_streaming` with a
+        ``frame_queue_size`` greater than ``0``, and cannot be used at the same
+        time as :py:meth:`set_frame_callback`.
+
+        Raises:
+            RuntimeError: If we're not streaming with a frame queue, or if a
+                frame cannot be loaded.
+        """
+    def stream(self) -> FrameStream:
+        """Iterate over frames with ``async for``.
+
+        For example:
+
+        .. code-block:: python
+
+            irimager.start_streaming(frame_queue_size=8)
+            async for frame, timestamp in irimager.stream():
+                ...
+
+        Each iteration is the same as awaiting :py:meth:`get_frame_async`,
+        except that iteration stops once :py:meth:`stop_streaming` is called.
+        """
+    def get_frame_event_fd(self) -> int:
+        """File descriptor that becomes readable when frames are queued.
+
+        Can be passed to :py:func:`select.poll` or
+        :py:meth:`asyncio.loop.add_reader`, to wait for frames from the frame
+        queue without blocking a thread.
+        The file descriptor is also made readable when streaming stops, so
+        that any waiters can wake up.
+
+        The file descriptor is reset when trying to get a frame from an empty
+        frame queue, so callers should keep calling :py:meth:`try_get_frame`
+        with a timeout of ``0`` until it returns ``None``, before waiting again.
+
+        The file descriptor is owned by this object, and must not be closed.
+
+        Raises:
+            RuntimeError: If we're not streaming with a frame queue, or if a
+                frame callback is set.
+        """
+    def get_frame_with_metadata(
+        self,
+    ) -> typing.Tuple[npt.NDArray[np.uint16], datetime.datetime, FrameMetadata]:
+        """Return a frame, with its timestamp and metadata.
+
+        Returns:
+            A tuple containing:
+              1. The frame, see :py:meth:`get_frame`.
+              2. The approximate time the frame was taken.
+              3. The :py:class:`FrameMetadata` of the frame, e.g. the shutter
+                 flag state and the camera's internal temperatures.
+        """
     def get_frame_monotonic(
         self,
     ) -> typing.Tuple[npt.NDArray[np.uint16], datetime.timedelta]:
@@ -98,6 +1099,299 @@ class IRImager:
         and may be the time since last boot or the time since the program
         started.
         """
+    def get_frame_into(self, out: npt.NDArray[np.uint16]) -> datetime.datetime:
+        """Write a frame into an existing array, instead of allocating one.
+
+        Similar to :py:meth:`get_frame`, except that the thermal data is
+        written directly into ``out``.
+
+        Args:
+            out: A C-contiguous, writeable ``uint16`` array, with the same
+                shape as the arrays returned by :py:meth:`get_frame`.
+
+        Raises:
+            ValueError: If ``out`` has the wrong shape or is not contiguous.
+            TypeError: If ``out`` has the wrong dtype or is not writeable.
+            RuntimeError: If a frame cannot be loaded, e.g. if the camera
+                isn't streaming.
+
+        Returns:
+            The approximate time the image was taken.
+        """
+    def get_frame_monotonic_into(
+        self, out: npt.NDArray[np.uint16]
+    ) -> datetime.timedelta:
+        """Write a frame into an existing array, with a monotonic timestamp.
+
+        Similar to :py:meth:`get_frame_into`, except returns a monotonic
+        timepoint, see :py:meth:`get_frame_monotonic`.
+        """
+    def get_frame_celsius(
+        self,
+    ) -> typing.Tuple[npt.NDArray[np.float32], datetime.datetime]:
+        """Return a frame, converted to degrees Celsius.
+
+        Similar to :py:meth:`get_frame`, except that the frame is returned as a
+        ``float32`` array of temperatures in degrees Celsius, instead of raw
+        ``uint16`` data.
+
+        This is faster than converting the raw data with numpy, since the
+        conversion is done in a single vectorised pass, without any temporary
+        arrays.
+        To avoid allocating a new array for every frame, use
+        :py:meth:`get_temperature_frame_monotonic_into`.
+        """
+    def get_temperature_frame_monotonic_into(
+        self,
+        out: npt.NDArray[np.float32],
+        unit: TemperatureUnit = TemperatureUnit.CELSIUS,
+    ) -> datetime.timedelta:
+        """Write a frame's temperatures into an existing array.
+
+        Args:
+            out: A writeable, C-contiguous ``float32`` array, with the shape
+                returned by :py:meth:`get_frame_shape`.
+            unit: The unit of temperature to output.
+
+        Returns:
+            The monotonic timepoint of the frame,
+            see :py:meth:`get_frame_monotonic`.
+
+        Raises:
+            ValueError: If ``out`` has the wrong shape.
+        """
+    def get_frames(
+        self,
+        count: int,
+        timeout: typing.Union[datetime.timedelta, float] = 30.0,
+    ) -> typing.Tuple[
+        npt.NDArray[np.uint16], npt.NDArray[np.int64], npt.NDArray[np.void]
+    ]:
+        """Return multiple frames, with monotonic timestamps.
+
+        Acquires ``count`` frames with the GIL released, which avoids the
+        per-frame overhead of calling :py:meth:`get_frame` from Python.
+
+        Returns:
+            A tuple containing:
+              1. A ``(count, rows, columns)`` ``uint16`` array of frames.
+              2. A ``(count,)`` ``int64`` array of monotonic timestamps, in
+                 nanoseconds.
+              3. A ``(count,)`` structured array of each frame's
+                 :py:class:`FrameMetadata`.
+            If ``timeout`` expires, fewer than ``count`` frames are returned.
+        """
+    def get_frame_shape(self) -> typing.Tuple[int, int]:
+        """The shape of the frames returned by :py:meth:`get_frame`.
+
+        Returns:
+            A tuple of ``(rows, columns)``.
+        """
+    def set_frame_callback(
+        self,
+        callback: typing.Optional[
+            typing.Callable[
+                [npt.NDArray[np.uint16], datetime.timedelta, FrameMetadata], None
+            ]
+        ],
+    ) -> None:
+        """Set a function that is called with every new frame.
+
+        Instead of polling with :py:meth:`get_frame`, frames are pushed to
+        ``callback`` from a background thread, as soon as they are grabbed.
+        While a callback is set, frames are not stored in the frame queue.
+
+        The callback is called with the frame (see :py:meth:`get_frame`), the
+        monotonic time the frame was taken (see :py:meth:`get_frame_monotonic`),
+        and the frame's :py:class:`FrameMetadata`.
+
+        Frames are passed to Python in batches, from a dedicated thread that
+        only takes the GIL once per batch. If ``callback`` is too slow, frames
+        are dropped.
+
+        Args:
+            callback: The function to call, or ``None`` to remove the current
+                callback.
+
+        Raises:
+            RuntimeError: If a callback is set while streaming with a
+                ``frame_queue_size`` of ``0``, since there is no background
+                thread to call it. Set the callback before calling
+                :py:meth:`start_streaming` instead.
+        """
+    def set_acquisition_thread_scheduling(
+        self, thread_scheduling: ThreadScheduling
+    ) -> None:
+        """Set the CPU affinity and scheduling of the background acquisition
+        thread.
+
+        Takes effect the next time :py:meth:`start_streaming` starts the
+        background thread, i.e. with a ``frame_queue_size`` greater than ``0``,
+        or with a frame callback. Without a background thread, frames are
+        grabbed by whichever thread calls :py:meth:`get_frame`.
+
+        Raises:
+            ValueError: if ``thread_scheduling`` is out of range.
+        """
+    def get_acquisition_thread_scheduling(
+        self,
+    ) -> typing.Optional[AppliedThreadScheduling]:
+        """Get the CPU affinity and scheduling that the OS actually gave the most
+        recently started acquisition thread.
+
+        Settings that the OS refused, e.g. ``SCHED_FIFO`` without the
+        ``CAP_SYS_NICE`` capability, are listed in
+        :py:attr:`AppliedThreadScheduling.errors`.
+
+        Returns:
+            The applied scheduling, or ``None`` if no acquisition thread has
+            been started yet.
+        """
+    def set_frame_transform(self, frame_transform: FrameTransform) -> None:
+        """Set the crop rectangle and binning applied to every frame.
+
+        Frames are cropped and binned while they are copied out of the
+        IRImagerDirect SDK's buffer, so the full frame is never copied, and
+        every other method (e.g. :py:meth:`get_frame` and
+        :py:meth:`get_frame_shape`) returns the smaller frame.
+
+        Raises:
+            ValueError: If the crop rectangle is not inside the camera's
+                frame, or if the binning is invalid.
+            RuntimeError: If we're streaming, or if any regions of interest
+                have been added, since they depend on the frame shape.
+        """
+    def get_frame_transform(self) -> FrameTransform:
+        """The transform set by :py:meth:`set_frame_transform`."""
+    def add_roi_rectangle(self, row: int, col: int, height: int, width: int) -> int:
+        """Add a rectangular region of interest (ROI).
+
+        The min/max/mean/standard deviation of the temperature in each ROI is
+        computed for every frame, see :py:meth:`get_roi_stats`.
+
+        The rectangle is clipped to the frame.
+
+        Args:
+            row: The first row of the rectangle.
+            col: The first column of the rectangle.
+            height: The number of rows in the rectangle.
+            width: The number of columns in the rectangle.
+
+        Raises:
+            ValueError: If the rectangle does not contain any pixels.
+            RuntimeError: If we're streaming.
+
+        Returns:
+            The index of the ROI, i.e. its row in :py:meth:`get_roi_stats`.
+        """
+    def add_roi_polygon(
+        self, vertices: typing.Sequence[typing.Tuple[float, float]]
+    ) -> int:
+        """Add a polygonal region of interest (ROI).
+
+        The polygon is rasterised once, when it is added. A pixel is in the
+        polygon if its centre is inside the polygon (using the even-odd rule),
+        where pixel ``(row, col)`` covers the area from ``(col, row)`` to
+        ``(col + 1, row + 1)``.
+
+        Args:
+            vertices: The ``(x, y)`` (i.e. ``(column, row)``) coordinates of
+                the vertices of the polygon, in order.
+
+        Raises:
+            ValueError: If the polygon has fewer than 3 vertices, or does not
+                contain any pixels.
+            RuntimeError: If we're streaming.
+
+        Returns:
+            The index of the ROI, i.e. its row in :py:meth:`get_roi_stats`.
+        """
+    def clear_rois(self) -> None:
+        """Remove all regions of interest.
+
+        Raises:
+            RuntimeError: If we're streaming.
+        """
+    def get_roi_count(self) -> int:
+        """The number of regions of interest."""
+    def set_roi_quantiles(self, quantiles: typing.Sequence[float]) -> None:
+        """Set the quantiles computed for every region of interest.
+
+        For example, ``[0.5, 0.95]`` computes the median and the 95th percentile
+        temperature of every ROI.
+        Quantiles are computed exactly from a counting histogram of the raw
+        data, see :py:meth:`Histogram.quantile`, without sorting any pixels.
+
+        Args:
+            quantiles: Each quantile (from ``0.0`` to ``1.0``) adds a column to
+                :py:meth:`get_roi_stats`, after the :py:class:`RoiStat` columns.
+
+        Raises:
+            ValueError: If a quantile is not between ``0.0`` and ``1.0``.
+            RuntimeError: If we're streaming.
+        """
+    def get_roi_quantiles(self) -> typing.List[float]:
+        """The quantiles set by :py:meth:`set_roi_quantiles`."""
+    def get_roi_stats(
+        self,
+    ) -> typing.Tuple[npt.NDArray[np.float32], datetime.datetime]:
+        """Return the statistics of each region of interest (ROI) of a frame.
+
+        Add ROIs with :py:meth:`add_roi_rectangle` or :py:meth:`add_roi_polygon`
+        before calling :py:meth:`start_streaming`.
+
+        If ``frame_queue_size`` is greater than ``0``, the statistics are
+        computed by the background thread as each frame is grabbed, so only a
+        small array is copied to Python, instead of the whole frame.
+
+        Returns:
+            A tuple containing:
+              1. A ``float32`` array, with one row per ROI. The first columns
+                 are indexed by :py:class:`RoiStat`, followed by one column for
+                 each quantile set by :py:meth:`set_roi_quantiles`, in degrees
+                 Celsius.
+              2. The approximate time the frame was taken.
+        """
+    def get_roi_stats_monotonic_into(
+        self, out: npt.NDArray[np.float32]
+    ) -> datetime.timedelta:
+        """Write the statistics of each region of interest into an array.
+
+        Similar to :py:meth:`get_roi_stats`, except that the statistics are
+        written into ``out``, and a monotonic timepoint is returned, see
+        :py:meth:`get_frame_monotonic`.
+
+        Raises:
+            ValueError: If ``out`` has the wrong shape.
+        """
+    def get_frame_pool_stats(self) -> BufferPoolStats:
+        """Get statistics on how often frame buffers were reused.
+
+        The pool is created by :py:meth:`~IRImager.start_streaming`, so all
+        statistics are ``0`` before streaming has started.
+        """
+    def get_stats(self) -> PipelineStats:
+        """Get the latency of each stage of the frame pipeline.
+
+        Latencies are always recorded, so this can be used to find out where the
+        time went when frames arrive late, e.g. waiting for the camera,
+        processing the raw frame, waiting in the frame queue, or converting the
+        frame to a numpy array.
+
+        Also counts how many frames were acquired, delivered, dropped because
+        the frame queue was full, skipped because the shutter was closed, or
+        never grabbed from the camera at all, so that sustained frame loss can
+        be detected.
+
+        Statistics are kept until :py:meth:`reset_stats` is called, even if
+        streaming is stopped and restarted.
+        """
+    def reset_stats(self) -> None:
+        """Reset all the statistics returned by :py:meth:`get_stats` to ``0``.
+
+        Frames that are still queued are counted when they are delivered, so
+        call this when not streaming to keep the frame counters consistent.
+        """
     def get_temp_range_decimal(self) -> int:
         """The number of decimal places in the thermal data
 
@@ -114,13 +1408,207 @@ class IRImager:
             has been mocked.
         """
 
+class ReplayTiming(enum.Enum):
+    """How :py:class:`IRImagerMock` plays back recorded frames."""
+
+    ORIGINAL = 0
+    """Wait between frames, so that they arrive as they were recorded."""
+    AS_FAST_AS_POSSIBLE = 1
+    """Return each frame as soon as it is requested, e.g. to benchmark how
+    quickly frames can be processed."""
+
+class SyntheticSceneOptions:
+    """Options for the synthetic scene generated by :py:class:`IRImagerMock`."""
+
+    seed: int
+    """Seed for the random scene.
+
+    The same seed always generates the same frames (on the same platform)."""
+    hotspots: int
+    """The number of hotspots that move around the scene."""
+    noise: float
+    """The standard deviation of the noise added to each pixel, in ℃."""
+    shutter_closures: bool
+    """Whether to periodically close the shutter flag, if ``<autoflag>`` is
+    enabled in the XML config file.
+
+    Frames taken while the shutter flag is not open are skipped, like with a
+    real camera."""
+
+    def __init__(
+        self,
+        seed: int = 0,
+        hotspots: int = 3,
+        noise: float = 0.5,
+        shutter_closures: bool = True,
+    ) -> None: ...
+
 class IRImagerMock(IRImager):
     """Mocked version of IRImager.
 
     This class can be used to return dummy data when there isn't a camera
     connected (e.g. for testing).
+
+    The mock pretends to be the camera in the XML config file, i.e. frames are
+    returned at its ``<framerate>``, and the resolution is read from a
+    ``<rows>x<cols>`` prefix in the XML filename (e.g. ``382x288@27Hz.xml``),
+    or is 382x288 otherwise.
+    """
+
+    @typing.overload
+    def __init__(self, xml_path: os.PathLike) -> None:
+        """Loads the configuration for an IR Camera from the given XML file"""
+    @typing.overload
+    def __init__(
+        self,
+        xml_path: os.PathLike,
+        replay: typing.Union[os.PathLike, str],
+        replay_timing: ReplayTiming = ReplayTiming.ORIGINAL,
+        loop: bool = True,
+    ) -> None:
+        """Creates a mocked IRImager that plays back recorded frames.
+
+        Recorded shutter flag states are replayed too, so frames recorded with
+        the shutter closed are skipped, like with a real camera.
+
+        Args:
+            xml_path: The camera configuration.
+            replay: Either a recording written by a :py:class:`Recorder`,
+                or a directory of ``.npy`` files (e.g. saved with
+                ``numpy.save()``), each containing a single ``uint16`` frame,
+                played back in filename order.
+            replay_timing: Whether to wait between frames, to play them back
+                at the recorded frame rate. Frames from ``.npy`` files are
+                played back at the ``<framerate>`` in ``xml_path``.
+            loop: If ``True``, start again from the first frame after the last
+                frame, otherwise getting a frame after the last frame raises a
+                ``RuntimeError``.
+
+        Raises:
+            ValueError: If ``replay`` is not a valid recording, or a directory
+                of valid ``.npy`` files.
+        """
+    @typing.overload
+    def __init__(
+        self, xml_path: os.PathLike, scene: SyntheticSceneOptions
+    ) -> None:
+        """Creates a mocked IRImager that generates a synthetic scene.
+
+        Frames contain a few hotspots that move around a smooth background,
+        with random noise. The same ``scene.seed`` always generates the same
+        frames.
+
+        If ``<autoflag>`` is enabled in ``xml_path``, the shutter flag closes
+        every ``<mininterval>`` seconds, and frames taken while it is closed
+        are skipped.
+
+        Args:
+            xml_path: The camera configuration.
+            scene: What the synthetic scene contains.
+        """
+
+class CameraGroup:
+    """Group of cameras, whose frames are matched by the time they were taken.
+
+    Every camera is streamed by its own native acquisition thread, which pushes
+    frames into a short per-camera history, without ever taking the Python GIL.
+    :py:meth:`get_frame_set` then picks the frame from each camera that is
+    closest in time to the others.
+
+    Cameras can be accessed by index, e.g. ``camera_group[0].get_stats()``.
     """
 
+    def __init__(self, xml_paths: typing.Sequence[os.PathLike]) -> None:
+        """Opens a camera for each XML config file.
+
+        The cameras are opened in parallel, since opening a camera can take
+        multiple seconds.
+
+        Raises:
+            ValueError: If ``xml_paths`` is empty.
+            RuntimeError: If any camera could not be opened, after every camera
+                has been opened or failed.
+        """
+    def __len__(self) -> int:
+        """The number of cameras."""
+    def __getitem__(self, index: int) -> IRImager:
+        """The camera at ``index``, e.g. to get its :py:meth:`IRImager.get_stats`."""
+    def __enter__(self) -> CameraGroup: ...
+    def __exit__(
+        self,
+        exc_type: typing.Optional[typing.Type[BaseException]],
+        exc: typing.Optional[BaseException],
+        traceback: typing.Optional[types.TracebackType],
+    ) -> None: ...
+    def start_streaming(
+        self, history_size: int = 4, shutter_policy: ShutterPolicy = ShutterPolicy.WAIT
+    ) -> None:
+        """Start streaming from every camera, in parallel.
+
+        Args:
+            history_size: The number of recent frames kept for each camera,
+                that :py:meth:`get_frame_set` can choose from. Older frames are
+                dropped.
+            shutter_policy: What to do with frames taken while a camera's
+                shutter flag is not open, see :py:meth:`IRImager.start_streaming`.
+
+        Raises:
+            ValueError: If ``history_size`` is ``0``.
+            RuntimeError: If any camera cannot start streaming, in which case
+                every camera is stopped.
+        """
+    def stop_streaming(self) -> None:
+        """Stop streaming from every camera, and forget all recent frames."""
+    def is_streaming(self) -> bool:
+        """Whether :py:meth:`start_streaming` has been called, and
+        :py:meth:`stop_streaming` has not."""
+    def get_frame_set(
+        self, tolerance: typing.Union[datetime.timedelta, float]
+    ) -> typing.List[
+        typing.Tuple[npt.NDArray[np.uint16], datetime.timedelta, FrameMetadata]
+    ]:
+        """Return a frame from every camera, all taken at around the same time.
+
+        The reference time is the newest frame of the camera that is furthest
+        behind, and every other camera's frame is the one closest to it. Each
+        returned frame, and any older frames, are removed from the history, so
+        consecutive frame sets never share frames.
+
+        Args:
+            tolerance: The maximum skew, i.e. the time between the oldest and
+                newest frame in the set. If the closest frames are further apart
+                than this, wait for new frames.
+
+        Raises:
+            RuntimeError: If no frame set arrives within 30 seconds, or if the
+                cameras aren't streaming.
+
+        Returns:
+            A list with a ``(frame, monotonic_time, metadata)`` tuple for each
+            camera, in the same order as the cameras, see
+            :py:meth:`IRImager.get_frame_with_metadata`. ``monotonic_time`` is a
+            monotonic timestamp, see :py:meth:`IRImager.get_frame_monotonic`.
+        """
+    def try_get_frame_set(
+        self,
+        tolerance: typing.Union[datetime.timedelta, float],
+        timeout: typing.Union[datetime.timedelta, float],
+    ) -> typing.Optional[
+        typing.List[
+            typing.Tuple[npt.NDArray[np.uint16], datetime.timedelta, FrameMetadata]
+        ]
+    ]:
+        """Return a frame set, or ``None`` if none arrives within ``timeout``.
+
+        Similar to :py:meth:`get_frame_set`, except that this never waits for
+        longer than ``timeout``.
+        """
+    def get_skew_stats(self) -> LatencyStats:
+        """Statistics of the skew (the time between the oldest and newest frame)
+        of every frame set returned by :py:meth:`get_frame_set`."""
+    def reset_skew_stats(self) -> None:
+        """Reset the statistics returned by :py:meth:`get_skew_stats`."""
+
 class Logger:
     """Handles converting C++ logs to Python :py:class:`logging.Logger`.
 
@@ -134,8 +1622,18 @@ class Logger:
     You must destroy existing instances to create a new instance.
     """
 
+    @typing.overload
     def __init__(self) -> None:
         """Creates a new logger using the default Python :py:class:`logging.Logger`"""
+    @typing.overload
+    def __init__(self, thread_scheduling: ThreadScheduling) -> None:
+        """Creates a new logger using the default Python :py:class:`logging.Logger`,
+        whose background thread is scheduled with ``thread_scheduling``, e.g. to
+        keep it off the CPUs used by the acquisition thread.
+        """
+    def get_thread_scheduling(self) -> AppliedThreadScheduling:
+        """Get the CPU affinity and scheduling that the OS actually gave the
+        background thread that reads evo::IRLogger logs."""
     def __del__(self): ...
 
 class LoggerContextManager:
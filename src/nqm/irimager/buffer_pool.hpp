@@ -0,0 +1,155 @@
+/**
+ * @file
+ * @brief Pool of reusable buffers, to avoid heap allocations per frame.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_BUFFER_POOL
+#define NQM_IRIMAGER_BUFFER_POOL
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Statistics about a BufferPool.
+ */
+struct BufferPoolStats {
+  /** Number of times a buffer was reused from the pool. */
+  std::uint64_t hits;
+  /** Number of times a new buffer had to be allocated. */
+  std::uint64_t misses;
+  /** Number of free buffers currently stored in the pool. */
+  std::size_t available;
+};
+
+/**
+ * @brief Thread-safe pool of recyclable buffers.
+ *
+ * Buffers are handed out as BufferPool::Handle objects, which return their
+ * buffer to the pool when they are destroyed (even if this happens after the
+ * pool's original owner has been destroyed).
+ *
+ * Once the pool is warmed up, acquiring and releasing buffers does not cause
+ * any heap allocations.
+ *
+ * @tparam T The buffer type, e.g. IRImager::ThermalFrame.
+ *           New buffers are copy-constructed from a prototype.
+ */
+template <class T>
+class BufferPool : public std::enable_shared_from_this<BufferPool<T>> {
+ public:
+  /**
+   * @brief Owning handle to a buffer from a BufferPool.
+   *
+   * Behaves similarly to a `std::unique_ptr<T>`.
+   */
+  class Handle {
+   public:
+    Handle() = default;
+    Handle(Handle &&) = default;
+    Handle &operator=(Handle &&other) {
+      release();
+      pool_ = std::move(other.pool_);
+      buffer_ = std::move(other.buffer_);
+      return *this;
+    }
+    Handle(const Handle &) = delete;
+    Handle &operator=(const Handle &) = delete;
+
+    ~Handle() { release(); }
+
+    T &operator*() const { return *buffer_; }
+    T *operator->() const { return buffer_.get(); }
+    T *get() const { return buffer_.get(); }
+    explicit operator bool() const { return static_cast<bool>(buffer_); }
+
+   private:
+    friend class BufferPool<T>;
+
+    Handle(std::shared_ptr<BufferPool<T>> pool, std::unique_ptr<T> buffer)
+        : pool_{std::move(pool)}, buffer_{std::move(buffer)} {}
+
+    void release() {
+      if (pool_ && buffer_) {
+        pool_->release(std::move(buffer_));
+      }
+      pool_ = nullptr;
+    }
+
+    std::shared_ptr<BufferPool<T>> pool_;
+    std::unique_ptr<T> buffer_;
+  };
+
+  /**
+   * @brief Creates a new BufferPool.
+   *
+   * @param prototype New buffers are created as a copy of this object.
+   * @param max_available The maximum number of free buffers to keep.
+   *                      Any extra released buffers are deallocated.
+   */
+  static std::shared_ptr<BufferPool<T>> create(const T &prototype,
+                                               std::size_t max_available) {
+    // can't use std::make_shared, since our constructor is private
+    return std::shared_ptr<BufferPool<T>>(
+        new BufferPool<T>(prototype, max_available));
+  }
+
+  /**
+   * @brief Gets a buffer from the pool, allocating a new one if required.
+   *
+   * Reused buffers contain whatever data they held when they were released.
+   */
+  Handle acquire() {
+    {
+      auto lock = std::scoped_lock(mutex_);
+      if (!available_.empty()) {
+        auto buffer = std::move(available_.back());
+        available_.pop_back();
+        hits_++;
+        return Handle(this->shared_from_this(), std::move(buffer));
+      }
+    }
+    misses_++;
+    return Handle(this->shared_from_this(), std::make_unique<T>(prototype_));
+  }
+
+  /** Get statistics about this pool. */
+  BufferPoolStats stats() {
+    auto lock = std::scoped_lock(mutex_);
+    return {hits_.load(), misses_.load(), available_.size()};
+  }
+
+  /** The object used as a prototype for new buffers. */
+  const T &prototype() const { return prototype_; }
+
+ private:
+  BufferPool(const T &prototype, std::size_t max_available)
+      : prototype_{prototype}, max_available_{max_available} {
+    // reserve now, so that releasing buffers never reallocates
+    available_.reserve(max_available_);
+  }
+
+  void release(std::unique_ptr<T> buffer) {
+    auto lock = std::scoped_lock(mutex_);
+    if (available_.size() < max_available_) {
+      available_.push_back(std::move(buffer));
+    }
+  }
+
+  const T prototype_;
+  const std::size_t max_available_;
+
+  /** Locks ::available_ */
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<T>> available_;
+
+  std::atomic<std::uint64_t> hits_ = 0;
+  std::atomic<std::uint64_t> misses_ = 0;
+};
+
+#endif /* NQM_IRIMAGER_BUFFER_POOL */
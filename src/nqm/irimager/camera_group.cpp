@@ -0,0 +1,259 @@
+#include "./camera_group.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+namespace {
+
+/**
+ * Calls `function(i)` for every `i` from `0` to @p count, each in its own
+ * thread, then waits for all of them to finish.
+ *
+ * @throws ... the exception thrown by the call with the lowest `i`, if any.
+ */
+template <class Function>
+void parallel_for_each(std::size_t count, Function &&function) {
+  auto errors = std::vector<std::exception_ptr>(count);
+  auto threads = std::vector<std::thread>();
+  threads.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    threads.emplace_back([&function, &errors, i]() {
+      try {
+        function(i);
+      } catch (...) {
+        errors[i] = std::current_exception();
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (auto &error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+}  // namespace
+
+CameraGroup::CameraGroup(const std::vector<std::filesystem::path> &xml_paths)
+    : cameras_(xml_paths.size()), histories_(xml_paths.size()) {
+  if (xml_paths.empty()) {
+    throw std::invalid_argument("A CameraGroup needs at least one camera");
+  }
+  parallel_for_each(xml_paths.size(), [this, &xml_paths](std::size_t i) {
+    cameras_[i] = std::make_unique<IRImager>(xml_paths[i]);
+  });
+}
+
+CameraGroup::CameraGroup(std::vector<std::unique_ptr<IRImager>> cameras)
+    : cameras_(std::move(cameras)), histories_(cameras_.size()) {
+  if (cameras_.empty()) {
+    throw std::invalid_argument("A CameraGroup needs at least one camera");
+  }
+  if (std::find(cameras_.begin(), cameras_.end(), nullptr) != cameras_.end()) {
+    throw std::invalid_argument("Invalid CameraGroup camera: nullptr");
+  }
+}
+
+CameraGroup::~CameraGroup() {
+  try {
+    stop_streaming();
+  } catch (const std::exception &error) {
+    // can't throw from a destructor, every camera has still been stopped
+    spdlog::error("Failed to stop streaming from CameraGroup: {}",
+                  error.what());
+  }
+}
+
+IRImager &CameraGroup::camera(std::size_t index) {
+  if (index >= cameras_.size()) {
+    throw std::out_of_range("Invalid camera index " + std::to_string(index) +
+                            ", there are only " +
+                            std::to_string(cameras_.size()) + " cameras");
+  }
+  return *cameras_[index];
+}
+
+void CameraGroup::start_streaming(std::size_t history_size,
+                                  ShutterPolicy shutter_policy) {
+  if (history_size == 0) {
+    throw std::invalid_argument("history_size must be at least 1");
+  }
+  stop_streaming();
+
+  {
+    auto lock = std::scoped_lock(mutex_);
+    history_size_ = history_size;
+    for (auto &history : histories_) {
+      // one extra, since push_frame() pushes before dropping the oldest frame
+      history.reserve(history_size + 1);
+    }
+    streaming_ = true;
+  }
+
+  try {
+    parallel_for_each(cameras_.size(), [&](std::size_t i) {
+      cameras_[i]->set_frame_callback(
+          [this, i](IRImager::PooledThermalFrame thermal_frame,
+                    std::chrono::steady_clock::time_point time_point,
+                    const FrameMetadata &metadata) {
+            push_frame(i, TimedFrame{std::move(thermal_frame), time_point,
+                                     metadata});
+          });
+      // a frame callback always uses a background acquisition thread
+      cameras_[i]->start_streaming(0, OverflowPolicy::DROP_NEWEST,
+                                   shutter_policy);
+    });
+  } catch (...) {
+    stop_streaming();
+    throw;
+  }
+}
+
+void CameraGroup::stop_streaming() {
+  {
+    auto lock = std::scoped_lock(mutex_);
+    if (!streaming_) {
+      return;
+    }
+    streaming_ = false;
+  }
+  frame_pushed_.notify_all();
+
+  // the acquisition threads lock mutex_ in push_frame(), so they must be
+  // stopped without holding it.
+  // every camera is stopped, even if an earlier one fails, since their
+  // callbacks push frames into this group
+  std::exception_ptr error;
+  for (auto &camera : cameras_) {
+    try {
+      camera->stop_streaming();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+    camera->set_frame_callback(nullptr);
+  }
+
+  {
+    auto lock = std::scoped_lock(mutex_);
+    for (auto &history : histories_) {
+      history.clear();
+    }
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool CameraGroup::is_streaming() {
+  auto lock = std::scoped_lock(mutex_);
+  return streaming_;
+}
+
+void CameraGroup::push_frame(std::size_t index, TimedFrame timed_frame) {
+  {
+    auto lock = std::scoped_lock(mutex_);
+    auto &history = histories_[index];
+    history.push_back(std::move(timed_frame));
+    if (history.size() > history_size_) {
+      history.erase(history.begin());
+    }
+  }
+  frame_pushed_.notify_all();
+}
+
+std::optional<std::vector<std::size_t>> CameraGroup::match_frames(
+    std::chrono::steady_clock::duration tolerance) const {
+  auto reference = std::chrono::steady_clock::time_point::max();
+  for (const auto &history : histories_) {
+    if (history.empty()) {
+      return std::nullopt;
+    }
+    reference = std::min(reference, history.back().time_point);
+  }
+
+  auto distance = [reference](const TimedFrame &timed_frame) {
+    return timed_frame.time_point > reference
+               ? timed_frame.time_point - reference
+               : reference - timed_frame.time_point;
+  };
+
+  auto indexes = std::vector<std::size_t>();
+  indexes.reserve(histories_.size());
+  auto oldest = std::chrono::steady_clock::time_point::max();
+  auto newest = std::chrono::steady_clock::time_point::min();
+  for (const auto &history : histories_) {
+    auto closest = std::min_element(
+        history.begin(), history.end(),
+        [&distance](const TimedFrame &a, const TimedFrame &b) {
+          return distance(a) < distance(b);
+        });
+    indexes.push_back(static_cast<std::size_t>(closest - history.begin()));
+    oldest = std::min(oldest, closest->time_point);
+    newest = std::max(newest, closest->time_point);
+  }
+
+  if (newest - oldest > tolerance) {
+    return std::nullopt;
+  }
+  return indexes;
+}
+
+std::optional<std::vector<CameraGroup::CameraFrame>>
+CameraGroup::try_get_frame_set(std::chrono::steady_clock::duration tolerance,
+                               std::chrono::steady_clock::duration timeout) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  auto lock = std::unique_lock(mutex_);
+  if (!streaming_) {
+    throw std::runtime_error("IRIMAGER_STREAMOFF: Not streaming");
+  }
+
+  auto indexes = std::optional<std::vector<std::size_t>>();
+  if (!frame_pushed_.wait_until(lock, deadline, [&] {
+        indexes = match_frames(tolerance);
+        return indexes.has_value() || !streaming_;
+      })) {
+    return std::nullopt;
+  }
+  if (!indexes) {
+    throw std::runtime_error("IRIMAGER_STREAMOFF: Not streaming");
+  }
+
+  auto frame_set = std::vector<CameraFrame>();
+  frame_set.reserve(histories_.size());
+  auto oldest = std::chrono::steady_clock::time_point::max();
+  auto newest = std::chrono::steady_clock::time_point::min();
+  for (std::size_t i = 0; i < histories_.size(); i++) {
+    auto &history = histories_[i];
+    auto chosen = history.begin() + static_cast<std::ptrdiff_t>((*indexes)[i]);
+    oldest = std::min(oldest, chosen->time_point);
+    newest = std::max(newest, chosen->time_point);
+    frame_set.emplace_back(std::move(chosen->thermal_frame),
+                           chosen->time_point, chosen->metadata);
+    // older frames can never be part of a later frame set
+    history.erase(history.begin(), chosen + 1);
+  }
+  skew_.record(newest - oldest);
+  return frame_set;
+}
+
+std::vector<CameraGroup::CameraFrame> CameraGroup::get_frame_set(
+    std::chrono::steady_clock::duration tolerance) {
+  auto frame_set = try_get_frame_set(tolerance, FRAME_SET_TIMEOUT);
+  if (!frame_set) {
+    throw std::runtime_error(
+        "Timeout when waiting for a synchronised frame set");
+  }
+  return std::move(*frame_set);
+}
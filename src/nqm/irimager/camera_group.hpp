@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @brief Streams from multiple cameras, returning time-aligned frame sets.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_CAMERA_GROUP
+#define NQM_IRIMAGER_CAMERA_GROUP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+#include "./irimager_class.hpp"
+#include "./latency_stats.hpp"
+
+/**
+ * @brief Group of cameras, whose frames are matched by the time they were
+ * taken.
+ *
+ * Every camera is streamed by its own native acquisition thread, which pushes
+ * frames into a short per-camera history, without ever taking the Python GIL.
+ * :py:meth:`get_frame_set` then picks the frame from each camera that is
+ * closest in time to the others.
+ */
+class CameraGroup {
+ public:
+  /**
+   * A frame from one camera in a frame set, see
+   * IRImager::get_pooled_frame_monotonic()
+   */
+  using CameraFrame =
+      std::tuple<IRImager::PooledThermalFrame,
+                 std::chrono::steady_clock::time_point, FrameMetadata>;
+
+  /** The default number of recent frames kept for each camera. */
+  static constexpr std::size_t DEFAULT_HISTORY_SIZE = 4;
+
+  /**
+   * Opens a camera for each XML config file.
+   *
+   * The cameras are opened in parallel, since opening a camera can take
+   * multiple seconds.
+   *
+   * @param xml_paths The config of each camera, see IRImager::IRImager().
+   * @throws std::invalid_argument if @p xml_paths is empty.
+   * @throws ... the exception thrown when opening the first camera that
+   *         failed to open, after every camera has been opened or failed.
+   */
+  explicit CameraGroup(const std::vector<std::filesystem::path> &xml_paths);
+
+  /**
+   * Takes ownership of cameras that are already open, e.g. IRImagerMock.
+   *
+   * @throws std::invalid_argument if @p cameras is empty, or contains
+   *                               `nullptr`.
+   */
+  explicit CameraGroup(std::vector<std::unique_ptr<IRImager>> cameras);
+
+  // the acquisition threads hold a pointer to us, so we can't be moved
+  CameraGroup(const CameraGroup &) = delete;
+  CameraGroup &operator=(const CameraGroup &) = delete;
+
+  /** Stops streaming, if we're streaming, logging any errors. */
+  ~CameraGroup();
+
+  /** The number of cameras. */
+  std::size_t size() const { return cameras_.size(); }
+
+  /**
+   * The camera at @p index, e.g. to get its :py:meth:`IRImager.get_stats`.
+   *
+   * @throws std::out_of_range if @p index is not less than size().
+   */
+  IRImager &camera(std::size_t index);
+
+  /**
+   * Start streaming from every camera, in parallel.
+   *
+   * @param history_size The number of recent frames kept for each camera,
+   * that :py:meth:`get_frame_set` can choose from. Older frames are dropped.
+   * @param shutter_policy What to do with frames taken while a camera's
+   * shutter flag is not open, see :py:meth:`IRImager.start_streaming`.
+   * @throws ValueError if ``history_size`` is ``0``.
+   * @throws RuntimeError if any camera cannot start streaming, in which case
+   *                      every camera is stopped.
+   */
+  void start_streaming(std::size_t history_size = DEFAULT_HISTORY_SIZE,
+                       ShutterPolicy shutter_policy = ShutterPolicy::WAIT);
+
+  /**
+   * Stop streaming from every camera, and forget all recent frames.
+   *
+   * @throws ... the first exception thrown by IRImager::stop_streaming(),
+   *             after trying to stop every camera.
+   */
+  void stop_streaming();
+
+  /**
+   * Whether :py:meth:`start_streaming` has been called, and
+   * :py:meth:`stop_streaming` has not.
+   */
+  bool is_streaming();
+
+  /**
+   * @brief Return a frame from every camera, all taken at around the same
+   * time.
+   *
+   * The reference time is the newest frame of the camera that is furthest
+   * behind, and every other camera's frame is the one closest to it. Each
+   * returned frame, and any older frames, are removed from the history, so
+   * consecutive frame sets never share frames.
+   *
+   * @param tolerance The maximum skew, i.e. the time between the oldest and
+   * newest frame in the set. If the closest frames are further apart than
+   * this, wait for new frames.
+   * @param timeout How long to wait for a frame set within ``tolerance``.
+   * @throws RuntimeError if we're not streaming.
+   * @returns One frame per camera, in the same order as the cameras, or
+   *          `std::nullopt` on timeout.
+   */
+  std::optional<std::vector<CameraFrame>> try_get_frame_set(
+      std::chrono::steady_clock::duration tolerance,
+      std::chrono::steady_clock::duration timeout);
+
+  /**
+   * @copybrief try_get_frame_set()
+   *
+   * Similar to :py:meth:`try_get_frame_set`, except waits for up to 30
+   * seconds, like :py:meth:`IRImager.get_frame`.
+   *
+   * @throws RuntimeError on timeout, or if we're not streaming.
+   */
+  std::vector<CameraFrame> get_frame_set(
+      std::chrono::steady_clock::duration tolerance);
+
+  /**
+   * Statistics of the skew (the time between the oldest and newest frame)
+   * of every frame set returned by :py:meth:`get_frame_set`.
+   */
+  LatencyStats get_skew_stats() const { return skew_.summary(); }
+
+  /** Reset the statistics returned by :py:meth:`get_skew_stats`. */
+  void reset_skew_stats() { skew_.reset(); }
+
+ private:
+  /** A recent frame from a camera */
+  struct TimedFrame {
+    IRImager::PooledThermalFrame thermal_frame;
+    std::chrono::steady_clock::time_point time_point;
+    FrameMetadata metadata;
+  };
+
+  std::vector<std::unique_ptr<IRImager>> cameras_;
+
+  /** Locks ::histories_ and ::streaming_ */
+  std::mutex mutex_;
+  /** Notifies that a frame was pushed, or that we stopped streaming */
+  std::condition_variable frame_pushed_;
+  /** The recent frames of each camera, oldest first */
+  std::vector<std::vector<TimedFrame>> histories_;
+  /** The maximum size of each of the ::histories_ */
+  std::size_t history_size_ = DEFAULT_HISTORY_SIZE;
+  bool streaming_ = false;
+  /** The skew of each frame set */
+  LatencyHistogram skew_;
+
+  /** How long get_frame_set() waits for a frame set. */
+  static constexpr auto FRAME_SET_TIMEOUT = std::chrono::seconds(30);
+
+  /** Called by the acquisition thread of camera @p index with every frame */
+  void push_frame(std::size_t index, TimedFrame timed_frame);
+
+  /**
+   * Finds the frame of each camera that is closest to the newest frame of the
+   * camera that is furthest behind.
+   *
+   * Must be called with ::mutex_ locked.
+   *
+   * @returns The index of the chosen frame in each of the ::histories_, or
+   *          `std::nullopt` if a camera has no frames, or if the chosen frames
+   *          are more than @p tolerance apart.
+   */
+  std::optional<std::vector<std::size_t>> match_frames(
+      std::chrono::steady_clock::duration tolerance) const;
+};
+
+#endif /* NQM_IRIMAGER_CAMERA_GROUP */
@@ -0,0 +1,61 @@
+/**
+ * @file
+ * @brief File descriptor that can be used to wake up event loops.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_EVENT_FD
+#define NQM_IRIMAGER_EVENT_FD
+
+/**
+ * @brief RAII wrapper around a Linux `eventfd`.
+ *
+ * The file descriptor returned by fd() becomes readable after notify() is
+ * called, and stays readable until clear() is called, so it can be passed to
+ * `select()`/`poll()`/`epoll()`, e.g. with Python's
+ * :py:meth:`asyncio.loop.add_reader`.
+ *
+ * Multiple calls to notify() are merged into a single wake-up.
+ *
+ * On POSIX systems without `eventfd`, a non-blocking pipe is used instead.
+ */
+class EventFd {
+ public:
+  /**
+   * Creates a new non-blocking event file descriptor.
+   *
+   * @throws std::system_error if the file descriptor could not be created.
+   */
+  EventFd();
+
+  EventFd(const EventFd &) = delete;
+  EventFd &operator=(const EventFd &) = delete;
+
+  virtual ~EventFd();
+
+  /** The file descriptor to wait on, e.g. with `poll()`. */
+  int fd() const noexcept { return read_fd_; }
+
+  /**
+   * Makes fd() readable.
+   *
+   * Safe to call from any thread, and never blocks.
+   */
+  void notify() noexcept;
+
+  /**
+   * Resets fd() so that it's no longer readable, until the next notify().
+   *
+   * Never blocks.
+   */
+  void clear() noexcept;
+
+ private:
+  int read_fd_ = -1;
+  /** The same as ::read_fd_ if we're using an `eventfd` */
+  int write_fd_ = -1;
+};
+
+#endif /* NQM_IRIMAGER_EVENT_FD */
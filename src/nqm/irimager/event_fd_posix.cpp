@@ -0,0 +1,75 @@
+#include "./event_fd.hpp"
+
+#if __has_include(<unistd.h>)
+// this is fine!! Expected behavior
+#else
+#error \
+    "This file requires OS functions that are only available on POSIX systems"
+#endif
+
+#include <array>
+#include <cerrno>  // POSIX errno
+#include <cstdint>
+#include <system_error>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+
+#if __has_include(<sys/eventfd.h>)
+#include <sys/eventfd.h>
+#define NQM_IRIMAGER_HAS_EVENTFD 1
+#endif
+}
+
+EventFd::EventFd() {
+#ifdef NQM_IRIMAGER_HAS_EVENTFD
+  read_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (read_fd_ == -1) {
+    throw std::system_error(std::error_code(errno, std::system_category()),
+                            "Failed to create eventfd");
+  }
+  write_fd_ = read_fd_;
+#else
+  auto pipe_fds = std::array<int, 2>{-1, -1};
+  if (pipe(pipe_fds.data()) == -1) {
+    throw std::system_error(std::error_code(errno, std::system_category()),
+                            "Failed to create pipe");
+  }
+  read_fd_ = pipe_fds[0];
+  write_fd_ = pipe_fds[1];
+  for (auto pipe_fd : pipe_fds) {
+    fcntl(pipe_fd, F_SETFL, fcntl(pipe_fd, F_GETFL) | O_NONBLOCK);
+    fcntl(pipe_fd, F_SETFD, FD_CLOEXEC);
+  }
+#endif
+}
+
+EventFd::~EventFd() {
+  close(read_fd_);
+  if (write_fd_ != read_fd_) {
+    close(write_fd_);
+  }
+}
+
+void EventFd::notify() noexcept {
+#ifdef NQM_IRIMAGER_HAS_EVENTFD
+  std::uint64_t value = 1;
+#else
+  unsigned char value = 1;
+#endif
+  // EAGAIN means the fd is already readable, so we can ignore any errors
+  [[maybe_unused]] auto bytes = write(write_fd_, &value, sizeof(value));
+}
+
+void EventFd::clear() noexcept {
+#ifdef NQM_IRIMAGER_HAS_EVENTFD
+  std::uint64_t value;
+  [[maybe_unused]] auto bytes = read(read_fd_, &value, sizeof(value));
+#else
+  auto buffer = std::array<unsigned char, 64>();
+  while (read(read_fd_, buffer.data(), buffer.size()) > 0) {
+    // keep reading until the pipe is empty
+  }
+#endif
+}
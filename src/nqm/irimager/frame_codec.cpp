@@ -0,0 +1,278 @@
+#include "./frame_codec.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+/** Marks the start of every encoded frame, `"NQ"` in ASCII */
+constexpr std::uint8_t MAGIC[] = {0x4E, 0x51};
+/** Incremented whenever the encoded format changes */
+constexpr std::uint8_t FORMAT_VERSION = 1;
+/** Set in the flags byte if the frame doesn't depend on the previous frame */
+constexpr std::uint8_t KEYFRAME_FLAG = 0x01;
+/** magic, version, flags, uint32 rows, uint32 cols */
+constexpr std::size_t HEADER_SIZE = 12;
+/** Number of residuals that share the same bit width */
+constexpr std::size_t BLOCK_SIZE = 16;
+
+void write_uint32(std::uint8_t *out, std::uint32_t value) {
+  for (std::size_t i = 0; i < 4; i++) {
+    out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+  }
+}
+
+std::uint32_t read_uint32(const std::uint8_t *in) {
+  std::uint32_t value = 0;
+  for (std::size_t i = 0; i < 4; i++) {
+    value |= std::uint32_t{in[i]} << (8 * i);
+  }
+  return value;
+}
+
+/** Maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ... (mod 2**16) */
+std::uint16_t zigzag(std::uint16_t delta) {
+  return static_cast<std::uint16_t>(
+      (delta << 1) ^ ((delta & 0x8000) != 0 ? 0xFFFF : 0x0000));
+}
+
+std::uint16_t unzigzag(std::uint16_t value) {
+  return static_cast<std::uint16_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+/** The number of bits needed to store @p value */
+std::uint8_t bit_width(std::uint16_t value) {
+  std::uint8_t width = 0;
+  while (value != 0) {
+    value = static_cast<std::uint16_t>(value >> 1);
+    width++;
+  }
+  return width;
+}
+
+/** The number of bytes needed to store @p count values of @p width bits */
+std::size_t packed_size(std::size_t count, std::size_t width) {
+  return (count * width + 7) / 8;
+}
+
+/**
+ * Computes the zig-zag encoded prediction errors of @p frame.
+ *
+ * @param previous The previous frame, or `nullptr` for a keyframe.
+ */
+void predict(const std::uint16_t *frame, const std::uint16_t *previous,
+             Eigen::Index rows, Eigen::Index cols, std::uint16_t *residuals) {
+  auto size = rows * cols;
+  if (previous != nullptr) {
+    for (Eigen::Index i = 0; i < size; i++) {
+      residuals[i] = zigzag(static_cast<std::uint16_t>(frame[i] - previous[i]));
+    }
+    return;
+  }
+
+  for (Eigen::Index r = 0; r < rows; r++) {
+    const auto *row = frame + r * cols;
+    // predict the first pixel of each row from the pixel above it
+    auto above = r == 0 ? std::uint16_t{0} : row[-cols];
+    residuals[r * cols] = zigzag(static_cast<std::uint16_t>(row[0] - above));
+    for (Eigen::Index c = 1; c < cols; c++) {
+      residuals[r * cols + c] =
+          zigzag(static_cast<std::uint16_t>(row[c] - row[c - 1]));
+    }
+  }
+}
+
+/** Inverse of predict(), overwrites @p residuals with the decoded frame */
+void unpredict(std::uint16_t *residuals, const std::uint16_t *previous,
+               Eigen::Index rows, Eigen::Index cols) {
+  auto size = rows * cols;
+  if (previous != nullptr) {
+    for (Eigen::Index i = 0; i < size; i++) {
+      residuals[i] =
+          static_cast<std::uint16_t>(previous[i] + unzigzag(residuals[i]));
+    }
+    return;
+  }
+
+  for (Eigen::Index r = 0; r < rows; r++) {
+    auto *row = residuals + r * cols;
+    auto above = r == 0 ? std::uint16_t{0} : row[-cols];
+    row[0] = static_cast<std::uint16_t>(above + unzigzag(row[0]));
+    for (Eigen::Index c = 1; c < cols; c++) {
+      row[c] = static_cast<std::uint16_t>(row[c - 1] + unzigzag(row[c]));
+    }
+  }
+}
+
+std::invalid_argument truncated_frame_error() {
+  return std::invalid_argument("Invalid encoded frame: data is truncated");
+}
+
+}  // namespace
+
+FrameEncoder::FrameEncoder(Eigen::Index rows, Eigen::Index cols,
+                           std::size_t keyframe_interval)
+    : rows_{rows},
+      cols_{cols},
+      keyframe_interval_{keyframe_interval},
+      frames_since_keyframe_{keyframe_interval} {
+  if (rows <= 0 || cols <= 0 || keyframe_interval == 0) {
+    throw std::invalid_argument(
+        "Invalid FrameEncoder: rows, cols, and keyframe_interval must be "
+        "positive");
+  }
+  auto size = static_cast<std::size_t>(rows * cols);
+  previous_.resize(size);
+  residuals_.resize(size);
+}
+
+std::size_t FrameEncoder::max_encoded_size() const {
+  auto size = static_cast<std::size_t>(rows_ * cols_);
+  auto block_count = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  // worst case, every block needs all 16 bits
+  return HEADER_SIZE + block_count + size * sizeof(std::uint16_t);
+}
+
+std::size_t FrameEncoder::encode(const std::uint16_t *frame,
+                                 std::vector<std::uint8_t> &out) {
+  auto keyframe = frames_since_keyframe_ >= keyframe_interval_;
+  predict(frame, keyframe ? nullptr : previous_.data(), rows_, cols_,
+          residuals_.data());
+  std::copy_n(frame, previous_.size(), previous_.begin());
+  frames_since_keyframe_ = keyframe ? 1 : frames_since_keyframe_ + 1;
+
+  auto start = out.size();
+  // resize to the worst case up front, so the loop below doesn't need to
+  // check for space
+  out.resize(start + max_encoded_size());
+  auto *pos = out.data() + start;
+
+  pos[0] = MAGIC[0];
+  pos[1] = MAGIC[1];
+  pos[2] = FORMAT_VERSION;
+  pos[3] = keyframe ? KEYFRAME_FLAG : 0;
+  write_uint32(pos + 4, static_cast<std::uint32_t>(rows_));
+  write_uint32(pos + 8, static_cast<std::uint32_t>(cols_));
+  pos += HEADER_SIZE;
+
+  for (std::size_t block = 0; block < residuals_.size(); block += BLOCK_SIZE) {
+    const auto *values = residuals_.data() + block;
+    auto count = std::min(BLOCK_SIZE, residuals_.size() - block);
+
+    std::uint16_t all_bits = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      all_bits = static_cast<std::uint16_t>(all_bits | values[i]);
+    }
+    auto width = bit_width(all_bits);
+    *pos++ = width;
+
+    // at most 7 leftover bits + 16 new bits, so this never overflows
+    std::uint32_t bits = 0;
+    unsigned bit_count = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      bits |= std::uint32_t{values[i]} << bit_count;
+      bit_count += width;
+      while (bit_count >= 8) {
+        *pos++ = static_cast<std::uint8_t>(bits);
+        bits >>= 8;
+        bit_count -= 8;
+      }
+    }
+    if (bit_count > 0) {
+      *pos++ = static_cast<std::uint8_t>(bits);
+    }
+  }
+
+  out.resize(static_cast<std::size_t>(pos - out.data()));
+  return out.size() - start;
+}
+
+std::array<Eigen::Index, 2> FrameDecoder::frame_shape(const std::uint8_t *data,
+                                                      std::size_t size) {
+  if (size < HEADER_SIZE) {
+    throw truncated_frame_error();
+  }
+  if (data[0] != MAGIC[0] || data[1] != MAGIC[1]) {
+    throw std::invalid_argument(
+        "Invalid encoded frame: does not start with the expected magic bytes");
+  }
+  if (data[2] != FORMAT_VERSION) {
+    throw std::invalid_argument(
+        "Invalid encoded frame: unsupported format version " +
+        std::to_string(data[2]));
+  }
+  auto rows = std::uint64_t{read_uint32(data + 4)};
+  auto cols = std::uint64_t{read_uint32(data + 8)};
+  // every block needs at least one byte, so a corrupt header can't make us
+  // allocate a huge frame
+  auto max_pixels = std::uint64_t{size - HEADER_SIZE} * BLOCK_SIZE;
+  if (rows == 0 || cols == 0 || rows > max_pixels / cols) {
+    throw std::invalid_argument(
+        "Invalid encoded frame: shape (" + std::to_string(rows) + ", " +
+        std::to_string(cols) + ") does not match the data size");
+  }
+  return {static_cast<Eigen::Index>(rows), static_cast<Eigen::Index>(cols)};
+}
+
+bool FrameDecoder::is_keyframe(const std::uint8_t *data, std::size_t size) {
+  frame_shape(data, size);  // validates the header
+  return (data[3] & KEYFRAME_FLAG) != 0;
+}
+
+void FrameDecoder::decode(const std::uint8_t *data, std::size_t size,
+                          std::uint16_t *out) {
+  auto shape = frame_shape(data, size);
+  auto keyframe = is_keyframe(data, size);
+  if (!keyframe && (previous_.empty() || shape != previous_shape_)) {
+    throw std::runtime_error(
+        "Cannot decode frame: it depends on the previous frame, which was not "
+        "decoded. Start decoding from a keyframe.");
+  }
+
+  const auto *pos = data + HEADER_SIZE;
+  const auto *end = data + size;
+  auto pixel_count = static_cast<std::size_t>(shape[0] * shape[1]);
+
+  for (std::size_t block = 0; block < pixel_count; block += BLOCK_SIZE) {
+    auto count = std::min(BLOCK_SIZE, pixel_count - block);
+    if (pos >= end) {
+      throw truncated_frame_error();
+    }
+    auto width = *pos++;
+    if (width > 16) {
+      throw std::invalid_argument(
+          "Invalid encoded frame: bit width " + std::to_string(width) +
+          " is larger than 16");
+    }
+    if (static_cast<std::size_t>(end - pos) < packed_size(count, width)) {
+      throw truncated_frame_error();
+    }
+
+    auto *values = out + block;
+    if (width == 0) {
+      std::fill_n(values, count, std::uint16_t{0});
+      continue;
+    }
+    auto mask = static_cast<std::uint32_t>((1U << width) - 1);
+    std::uint32_t bits = 0;
+    unsigned bit_count = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      while (bit_count < width) {
+        bits |= std::uint32_t{*pos++} << bit_count;
+        bit_count += 8;
+      }
+      values[i] = static_cast<std::uint16_t>(bits & mask);
+      bits >>= width;
+      bit_count -= width;
+    }
+  }
+  if (pos != end) {
+    throw std::invalid_argument(
+        "Invalid encoded frame: unexpected data after the last block");
+  }
+
+  unpredict(out, keyframe ? nullptr : previous_.data(), shape[0], shape[1]);
+  previous_.assign(out, out + pixel_count);
+  previous_shape_ = shape;
+}
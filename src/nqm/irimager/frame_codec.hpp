@@ -0,0 +1,125 @@
+/**
+ * @file
+ * @brief Lossless compression of thermal frames.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_FRAME_CODEC
+#define NQM_IRIMAGER_FRAME_CODEC
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Losslessly compresses a stream of raw thermal frames.
+ *
+ * Each pixel is predicted from either the same pixel in the previous frame
+ * (temporal prediction), or, for keyframes, from its left/upper neighbour
+ * (spatial prediction). The prediction errors are zig-zag encoded, so that
+ * small negative errors become small positive numbers, then bit-packed in
+ * blocks of 16 pixels, using the fewest bits needed for each block.
+ *
+ * Since neighbouring thermal pixels (and consecutive frames) are very
+ * similar, most blocks only need a few bits per pixel, and blocks that
+ * haven't changed since the previous frame need a single byte.
+ *
+ * Frames must be decoded in the same order by a FrameDecoder. Keyframes
+ * don't depend on any other frame, so decoding can start from any
+ * keyframe.
+ */
+class FrameEncoder {
+ public:
+  /**
+   * @param rows The number of rows in each frame.
+   * @param cols The number of columns in each frame.
+   * @param keyframe_interval Encode a keyframe every @p keyframe_interval
+   *                          frames, e.g. `1` to only encode keyframes.
+   *
+   * @throws std::invalid_argument if any argument is `0`.
+   */
+  FrameEncoder(Eigen::Index rows, Eigen::Index cols,
+               std::size_t keyframe_interval = 64);
+
+  /**
+   * Encodes a frame, and appends it to @p out.
+   *
+   * @param[in] frame A C-contiguous frame, with the shape given in the
+   *                  constructor.
+   * @param[in,out] out The encoded frame is appended to this buffer.
+   *                    Reusing the same buffer avoids memory allocations.
+   * @returns The number of bytes appended to @p out.
+   */
+  std::size_t encode(const std::uint16_t *frame,
+                     std::vector<std::uint8_t> &out);
+
+  /** The number of rows in each frame. */
+  Eigen::Index rows() const { return rows_; }
+
+  /** The number of columns in each frame. */
+  Eigen::Index cols() const { return cols_; }
+
+  /** Makes the next encoded frame a keyframe. */
+  void request_keyframe() { frames_since_keyframe_ = keyframe_interval_; }
+
+  /** The maximum number of bytes that encode() can append. */
+  std::size_t max_encoded_size() const;
+
+ private:
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  std::size_t keyframe_interval_;
+  std::size_t frames_since_keyframe_;
+  /** The previous frame, used for temporal prediction */
+  std::vector<std::uint16_t> previous_;
+  /** Scratch space for the zig-zag encoded prediction errors */
+  std::vector<std::uint16_t> residuals_;
+};
+
+/**
+ * @brief Decodes frames encoded by a FrameEncoder.
+ */
+class FrameDecoder {
+ public:
+  /**
+   * Reads the `{rows, cols}` of an encoded frame, without decoding it.
+   *
+   * @throws std::invalid_argument if @p data is not an encoded frame.
+   */
+  static std::array<Eigen::Index, 2> frame_shape(const std::uint8_t *data,
+                                                 std::size_t size);
+
+  /** Whether an encoded frame is a keyframe. */
+  static bool is_keyframe(const std::uint8_t *data, std::size_t size);
+
+  /**
+   * Decodes a single frame.
+   *
+   * @param[in] data An encoded frame, as appended by FrameEncoder::encode().
+   * @param size The number of bytes in @p data.
+   * @param[out] out Where to store the decoded frame, must have room for
+   *                 the number of pixels given by frame_shape().
+   *
+   * @throws std::invalid_argument if @p data is not a valid encoded frame.
+   * @throws std::runtime_error if @p data is not a keyframe, and the
+   *                            previous frame was not decoded.
+   */
+  void decode(const std::uint8_t *data, std::size_t size, std::uint16_t *out);
+
+  /**
+   * Forgets the previous frame, e.g. after seeking to a different keyframe.
+   */
+  void reset() { previous_.clear(); }
+
+ private:
+  /** The previously decoded frame, used for temporal prediction */
+  std::vector<std::uint16_t> previous_;
+  std::array<Eigen::Index, 2> previous_shape_ = {0, 0};
+};
+
+#endif /* NQM_IRIMAGER_FRAME_CODEC */
@@ -0,0 +1,175 @@
+#include "./frame_replay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace {
+
+/** Marks the start of every `.npy` file */
+constexpr char NPY_MAGIC[] = "\x93NUMPY";
+constexpr std::size_t NPY_MAGIC_SIZE = sizeof(NPY_MAGIC) - 1;
+
+/**
+ * Returns the value of @p key in a `.npy` header, e.g. `'<u2'` for `descr`.
+ *
+ * The header is a Python dict literal, with simple values, so we don't need
+ * a full Python parser.
+ */
+std::string npy_header_value(const std::string &header, const std::string &key,
+                             const std::filesystem::path &path) {
+  auto key_start = header.find("'" + key + "'");
+  auto colon = header.find(':', key_start);
+  auto value_start = header.find_first_not_of(' ', colon + 1);
+  if (key_start == std::string::npos || colon == std::string::npos ||
+      value_start == std::string::npos) {
+    throw std::invalid_argument("Invalid .npy file " + path.string() +
+                                ": header is missing " + key);
+  }
+  // the shape is a tuple, which contains commas
+  auto value_end = header[value_start] == '('
+                       ? header.find(')', value_start) + 1
+                       : header.find_first_of(",}", value_start);
+  return header.substr(value_start, value_end - value_start);
+}
+
+/**
+ * Reads a 2-D `uint16` array from a `.npy` file.
+ *
+ * @param[in,out] shape The `{rows, cols}` of the array. If `{0, 0}`, this is
+ *                      set to the shape of the array, otherwise the array must
+ *                      have this shape.
+ * @param[out] frames The array is appended to this vector.
+ */
+void read_npy(const std::filesystem::path &path,
+              std::array<Eigen::Index, 2> &shape,
+              std::vector<std::uint16_t> &frames) {
+  auto file = std::ifstream(path, std::ios::binary);
+  if (!file) {
+    throw std::system_error(std::make_error_code(std::errc::io_error),
+                            "Failed to open " + path.string());
+  }
+  auto invalid = [&path](const std::string &reason) {
+    return std::invalid_argument("Invalid .npy file " + path.string() + ": " +
+                                 reason);
+  };
+
+  auto preamble = std::array<char, NPY_MAGIC_SIZE + 2>();
+  file.read(preamble.data(), static_cast<std::streamsize>(preamble.size()));
+  if (!file || std::memcmp(preamble.data(), NPY_MAGIC, NPY_MAGIC_SIZE) != 0) {
+    throw invalid("bad magic number");
+  }
+  auto major_version = static_cast<unsigned char>(preamble[NPY_MAGIC_SIZE]);
+  // version 1 has a 2-byte header length, later versions a 4-byte length
+  auto header_length_size = std::size_t{major_version == 1 ? 2u : 4u};
+  auto header_length_bytes = std::array<unsigned char, 4>();
+  file.read(reinterpret_cast<char *>(header_length_bytes.data()),
+            static_cast<std::streamsize>(header_length_size));
+  auto header_length = std::size_t{0};
+  for (std::size_t i = 0; i < header_length_size; i++) {
+    header_length |= std::size_t{header_length_bytes[i]} << (8 * i);
+  }
+  auto header = std::string(header_length, '\0');
+  file.read(header.data(), static_cast<std::streamsize>(header.size()));
+  if (!file || major_version < 1 || major_version > 3) {
+    throw invalid("unsupported version or truncated header");
+  }
+
+  auto descr = npy_header_value(header, "descr", path);
+  if (descr != "'<u2'" && descr != "'=u2'") {
+    throw invalid("expected a little-endian uint16 array, not " + descr);
+  }
+  if (npy_header_value(header, "fortran_order", path) != "False") {
+    throw invalid("expected a C-contiguous array");
+  }
+  auto npy_shape = npy_header_value(header, "shape", path);
+  auto npy_rows = Eigen::Index{0};
+  auto npy_cols = Eigen::Index{0};
+  // e.g. `(382, 288)`
+  if (std::sscanf(npy_shape.c_str(), "(%td, %td)", &npy_rows, &npy_cols) !=
+          2 ||
+      npy_rows <= 0 || npy_cols <= 0) {
+    throw invalid("expected a 2-D array, not shape " + npy_shape);
+  }
+  if (shape == std::array<Eigen::Index, 2>{0, 0}) {
+    shape = {npy_rows, npy_cols};
+  } else if (shape != std::array<Eigen::Index, 2>{npy_rows, npy_cols}) {
+    throw invalid("shape " + npy_shape + " does not match the first frame");
+  }
+
+  auto frame_size = static_cast<std::size_t>(npy_rows * npy_cols);
+  auto offset = frames.size();
+  frames.resize(offset + frame_size);
+  file.read(reinterpret_cast<char *>(frames.data() + offset),
+            static_cast<std::streamsize>(frame_size * sizeof(std::uint16_t)));
+  if (!file) {
+    throw invalid("data is truncated");
+  }
+}
+
+}  // namespace
+
+FrameReplay::FrameReplay(const std::filesystem::path &path,
+                         std::chrono::steady_clock::duration npy_frame_period)
+    : shape_{0, 0}, npy_frame_period_{npy_frame_period} {
+  if (!std::filesystem::is_directory(path)) {
+    recording_ = std::make_unique<RecordingReader>(path);
+    if (recording_->size() == 0) {
+      throw std::invalid_argument("Invalid replay: recording " +
+                                  path.string() + " does not have any frames");
+    }
+    shape_ = {recording_->rows(), recording_->cols()};
+    return;
+  }
+
+  auto npy_paths = std::vector<std::filesystem::path>();
+  for (const auto &entry : std::filesystem::directory_iterator(path)) {
+    if (entry.is_regular_file() && entry.path().extension() == ".npy") {
+      npy_paths.push_back(entry.path());
+    }
+  }
+  if (npy_paths.empty()) {
+    throw std::invalid_argument("Invalid replay: directory " + path.string() +
+                                " does not contain any .npy files");
+  }
+  // directory_iterator doesn't have a defined order
+  std::sort(npy_paths.begin(), npy_paths.end());
+
+  for (const auto &npy_path : npy_paths) {
+    read_npy(npy_path, shape_, npy_frames_);
+  }
+  npy_frame_count_ = npy_paths.size();
+}
+
+std::size_t FrameReplay::size() const {
+  return recording_ ? recording_->size() : npy_frame_count_;
+}
+
+short FrameReplay::temp_range_decimal() const {
+  return recording_ ? recording_->temp_range_decimal() : 1;
+}
+
+std::chrono::steady_clock::duration FrameReplay::read(
+    std::size_t index, std::uint16_t *out, FrameMetadata &metadata) const {
+  auto frame_size = static_cast<std::size_t>(shape_[0] * shape_[1]);
+
+  if (recording_) {
+    const auto *frame = recording_->frame(index);
+    std::copy(frame, frame + frame_size, out);
+    metadata = recording_->metadata(index);
+    return recording_->timestamp(index) - recording_->timestamp(0);
+  }
+
+  if (index >= npy_frame_count_) {
+    throw std::out_of_range("Frame index out of range");
+  }
+  const auto *frame = npy_frames_.data() + index * frame_size;
+  std::copy(frame, frame + frame_size, out);
+  metadata = FrameMetadata{};
+  metadata.flag_state = FlagState::OPEN;
+  return npy_frame_period_ * static_cast<std::int64_t>(index);
+}
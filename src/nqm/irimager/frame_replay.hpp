@@ -0,0 +1,93 @@
+/**
+ * @file
+ * @brief Plays back recorded thermal frames, e.g. for IRImagerMock.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_FRAME_REPLAY
+#define NQM_IRIMAGER_FRAME_REPLAY
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "./irimager_class.hpp"
+#include "./recording.hpp"
+
+/**
+ * @brief Recorded frames that can be played back in order.
+ *
+ * Frames can come from either:
+ * - a recording written by a Recorder, which is memory-mapped, and keeps
+ *   its recorded timestamps and metadata, or
+ * - a directory of `.npy` files (e.g. saved with `numpy.save()`), each
+ *   containing a single 2-D `uint16` frame, which are played back in
+ *   filename order. Since `.npy` files don't have timestamps, frames are
+ *   spaced by a fixed frame period. These frames are all loaded into memory
+ *   up-front, so that playing them back doesn't touch the disk.
+ */
+class FrameReplay {
+ public:
+  /**
+   * Loads frames to play back.
+   *
+   * @param path A Recorder recording, or a directory of `.npy` files.
+   * @param npy_frame_period The time between frames loaded from `.npy` files,
+   *                         80 Hz by default.
+   *
+   * @throws std::invalid_argument if @p path is not a valid recording, if it
+   *                               is a directory without any `.npy` files,
+   *                               or if the `.npy` files are not all 2-D
+   *                               little-endian `uint16` arrays of the same
+   *                               shape.
+   * @throws std::system_error if @p path could not be read.
+   */
+  explicit FrameReplay(const std::filesystem::path &path,
+                       std::chrono::steady_clock::duration npy_frame_period =
+                           std::chrono::microseconds(12500));
+
+  /** The `{rows, cols}` of each frame. */
+  std::array<Eigen::Index, 2> shape() const { return shape_; }
+
+  /** The number of frames. */
+  std::size_t size() const;
+
+  /**
+   * See IRImager::get_temp_range_decimal(), `1` for `.npy` files, which
+   * don't store it.
+   */
+  short temp_range_decimal() const;
+
+  /**
+   * Copies a frame.
+   *
+   * @param index The index of the frame, from `0` to size() - 1.
+   * @param[out] out Where to write the C-contiguous frame, with the shape().
+   * @param[out] metadata The frame's recorded metadata, or an open shutter
+   *                      flag for `.npy` files.
+   *
+   * @returns The time between the first frame and this frame.
+   */
+  std::chrono::steady_clock::duration read(std::size_t index,
+                                           std::uint16_t *out,
+                                           FrameMetadata &metadata) const;
+
+ private:
+  std::array<Eigen::Index, 2> shape_;
+
+  /** The memory-mapped recording, if we're not playing back `.npy` files */
+  std::unique_ptr<RecordingReader> recording_;
+
+  /** Every frame loaded from `.npy` files, one after the other */
+  std::vector<std::uint16_t> npy_frames_;
+  std::size_t npy_frame_count_ = 0;
+  std::chrono::steady_clock::duration npy_frame_period_;
+};
+
+#endif /* NQM_IRIMAGER_FRAME_REPLAY */
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @brief Paces mocked frames at a fixed frame rate.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_FRAME_SCHEDULER
+#define NQM_IRIMAGER_FRAME_SCHEDULER
+
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+
+/**
+ * @brief Steady-clock schedule of frame deadlines, one every frame period.
+ *
+ * Deadlines are absolute, i.e. the `n`th frame is due at
+ * `start + n * period`, so that the time taken to make each frame, and any
+ * oversleeping, doesn't accumulate into drift, like it would if we slept for
+ * one period after each frame.
+ *
+ * If the caller falls a whole frame period behind (e.g. because nobody was
+ * reading frames), the missed frames are skipped instead of returning a
+ * burst of late frames, like a real camera that drops frames.
+ */
+class FrameScheduler {
+ public:
+  /**
+   * How long before a deadline precise_sleep_until() stops sleeping, and
+   * starts yielding instead.
+   *
+   * Linux usually wakes up sleeping threads within ~100µs, but this is
+   * enough to cover the occasional late wake-up.
+   */
+  static constexpr auto SPIN_DURATION = std::chrono::microseconds(200);
+
+  /**
+   * @param period The time between frames.
+   * @throws std::invalid_argument if @p period is not positive.
+   */
+  explicit FrameScheduler(std::chrono::steady_clock::duration period)
+      : period_{period} {
+    if (period <= std::chrono::steady_clock::duration::zero()) {
+      throw std::invalid_argument("FrameScheduler period must be positive");
+    }
+  }
+
+  /** The time between frames. */
+  std::chrono::steady_clock::duration period() const { return period_; }
+
+  /** Starts a new schedule, so that the next wait() returns immediately. */
+  void reset() { started_ = false; }
+
+  /**
+   * Waits until the next frame is due.
+   *
+   * @returns The time the frame was due, which is never after the current
+   *          time.
+   */
+  std::chrono::steady_clock::time_point wait() {
+    auto now = std::chrono::steady_clock::now();
+    missed_frames_ = 0;
+    if (!started_) {
+      started_ = true;
+      next_deadline_ = now;
+      next_frame_index_ = 0;
+    } else if (now - next_deadline_ >= period_) {
+      // skip to the latest frame that is due
+      auto missed = (now - next_deadline_) / period_;
+      next_deadline_ += missed * period_;
+      missed_frames_ = static_cast<std::uint64_t>(missed);
+      next_frame_index_ += missed_frames_;
+    } else {
+      precise_sleep_until(next_deadline_);
+    }
+    auto deadline = next_deadline_;
+    frame_index_ = next_frame_index_;
+    next_deadline_ += period_;
+    next_frame_index_++;
+    return deadline;
+  }
+
+  /**
+   * The index of the frame returned by the last wait(), since the last
+   * reset(), including any skipped frames.
+   */
+  std::uint64_t frame_index() const { return frame_index_; }
+
+  /** The number of frames skipped by the last wait(). */
+  std::uint64_t missed_frames() const { return missed_frames_; }
+
+  /**
+   * Like `std::this_thread::sleep_until()`, but doesn't oversleep.
+   *
+   * Sleeps until just before the deadline, then yields the CPU until the
+   * deadline, so that we wake up within a few microseconds of the deadline,
+   * without busy-waiting for the whole time.
+   */
+  static void precise_sleep_until(
+      std::chrono::steady_clock::time_point deadline) {
+    std::this_thread::sleep_until(deadline - SPIN_DURATION);
+    while (std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  std::chrono::steady_clock::duration period_;
+  /** Whether wait() has been called since the last reset() */
+  bool started_ = false;
+  std::chrono::steady_clock::time_point next_deadline_;
+  std::uint64_t next_frame_index_ = 0;
+  std::uint64_t frame_index_ = 0;
+  std::uint64_t missed_frames_ = 0;
+};
+
+#endif /* NQM_IRIMAGER_FRAME_SCHEDULER */
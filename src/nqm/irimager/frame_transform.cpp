@@ -0,0 +1,123 @@
+#include "./frame_transform.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+using Frame = Eigen::Matrix<std::uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                            Eigen::RowMajor>;
+
+/** Large bins are pointless, and would need a bigger buffer in bin_frame() */
+constexpr Eigen::Index MAX_BINNING = 16;
+
+/**
+ * Combines each @p binning x @p binning block of @p in into a pixel of @p out.
+ *
+ * @tparam Combine Functor with the signature
+ *                 `uint16_t(const uint16_t *const *rows, Index col)`, that
+ *                 combines `rows[0][col..col + binning]` to
+ *                 `rows[binning - 1][col..col + binning]`.
+ */
+template <class Combine>
+void bin_frame(const Eigen::Map<const Frame, 0, Eigen::OuterStride<>> &in,
+               Eigen::Index binning, Eigen::Map<Frame> &out,
+               Combine &&combine) {
+  // pointers to each input row of the current bin
+  auto rows = std::array<const std::uint16_t *, MAX_BINNING>();
+
+  for (Eigen::Index r = 0; r < out.rows(); r++) {
+    for (Eigen::Index i = 0; i < binning; i++) {
+      rows[static_cast<std::size_t>(i)] =
+          in.data() + (r * binning + i) * in.outerStride();
+    }
+    auto *out_row = &out(r, 0);
+    for (Eigen::Index c = 0; c < out.cols(); c++) {
+      out_row[c] = combine(rows.data(), c * binning);
+    }
+  }
+}
+
+}  // namespace
+
+std::array<Eigen::Index, 2> FrameTransform::output_shape(
+    std::array<Eigen::Index, 2> sensor_shape) const {
+  auto [sensor_rows, sensor_cols] = sensor_shape;
+  auto crop_height = height == 0 ? sensor_rows - row : height;
+  auto crop_width = width == 0 ? sensor_cols - col : width;
+
+  if (row < 0 || col < 0 || crop_height <= 0 || crop_width <= 0 ||
+      row + crop_height > sensor_rows || col + crop_width > sensor_cols) {
+    throw std::invalid_argument(
+        "Invalid crop rectangle: must be inside the " +
+        std::to_string(sensor_rows) + "x" + std::to_string(sensor_cols) +
+        " frame");
+  }
+  if (binning < 1 || binning > MAX_BINNING) {
+    throw std::invalid_argument("Invalid binning: must be between 1 and " +
+                                std::to_string(MAX_BINNING) + ", but got " +
+                                std::to_string(binning));
+  }
+  if (crop_height < binning || crop_width < binning) {
+    throw std::invalid_argument(
+        "Invalid binning: the crop rectangle is smaller than a single bin");
+  }
+
+  return {crop_height / binning, crop_width / binning};
+}
+
+void FrameTransform::apply(const std::uint16_t *sensor_frame,
+                           std::array<Eigen::Index, 2> sensor_shape,
+                           Eigen::Map<Frame> out) const {
+  auto [out_rows, out_cols] = output_shape(sensor_shape);
+  if (out.rows() != out_rows || out.cols() != out_cols) {
+    throw std::invalid_argument(
+        "Invalid output frame: expected shape (" + std::to_string(out_rows) +
+        ", " + std::to_string(out_cols) + "), but got (" +
+        std::to_string(out.rows()) + ", " + std::to_string(out.cols()) + ")");
+  }
+
+  auto sensor_cols = sensor_shape[1];
+  auto crop = Eigen::Map<const Frame, 0, Eigen::OuterStride<>>(
+      sensor_frame + row * sensor_cols + col, out_rows * binning,
+      out_cols * binning, Eigen::OuterStride<>(sensor_cols));
+
+  if (binning == 1) {
+    out = crop;
+    return;
+  }
+
+  switch (binning_mode) {
+    case BinningMode::MEAN: {
+      auto bin_size = static_cast<std::uint32_t>(binning * binning);
+      bin_frame(crop, binning, out,
+                [binning = binning, bin_size](const std::uint16_t *const *rows,
+                                              Eigen::Index c) {
+                  std::uint32_t sum = 0;
+                  for (Eigen::Index i = 0; i < binning; i++) {
+                    for (Eigen::Index j = 0; j < binning; j++) {
+                      sum += rows[i][c + j];
+                    }
+                  }
+                  // round to the nearest value
+                  return static_cast<std::uint16_t>((sum + bin_size / 2) /
+                                                    bin_size);
+                });
+      break;
+    }
+    case BinningMode::MAX:
+      bin_frame(crop, binning, out,
+                [binning = binning](const std::uint16_t *const *rows,
+                                    Eigen::Index c) {
+                  std::uint16_t max = 0;
+                  for (Eigen::Index i = 0; i < binning; i++) {
+                    for (Eigen::Index j = 0; j < binning; j++) {
+                      max = std::max(max, rows[i][c + j]);
+                    }
+                  }
+                  return max;
+                });
+      break;
+  }
+}
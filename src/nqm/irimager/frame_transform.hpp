@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @brief Crops and bins thermal frames while copying them.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_FRAME_TRANSFORM
+#define NQM_IRIMAGER_FRAME_TRANSFORM
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <cstdint>
+
+/**
+ * How pixels are combined by FrameTransform::binning.
+ */
+enum class BinningMode : std::uint8_t {
+  /** Use the mean of each bin, rounded to the nearest raw value. */
+  MEAN,
+  /** Use the maximum of each bin, e.g. so that small hot spots are kept. */
+  MAX,
+};
+
+/**
+ * @brief Crop rectangle and binning applied to every frame.
+ *
+ * Frames are cropped and binned while they are copied out of the
+ * IRImagerDirect SDK's buffer, so every later stage only sees the smaller
+ * frame.
+ *
+ * The default value does not change the frame.
+ */
+struct FrameTransform {
+  /** The first row of the crop rectangle. */
+  Eigen::Index row = 0;
+  /** The first column of the crop rectangle. */
+  Eigen::Index col = 0;
+  /**
+   * The number of rows in the crop rectangle, or ``0`` to use every row
+   * after FrameTransform::row.
+   */
+  Eigen::Index height = 0;
+  /**
+   * The number of columns in the crop rectangle, or ``0`` to use every
+   * column after FrameTransform::col.
+   */
+  Eigen::Index width = 0;
+  /**
+   * Combine each ``binning x binning`` block of pixels into a single pixel,
+   * from ``1`` (no binning) to ``16``.
+   *
+   * If the crop rectangle isn't a multiple of ``binning``, the leftover
+   * rows/columns at the bottom/right are dropped.
+   */
+  Eigen::Index binning = 1;
+  /** How pixels are combined by FrameTransform::binning. */
+  BinningMode binning_mode = BinningMode::MEAN;
+
+  /** Whether this transform changes the frame. */
+  bool is_identity() const {
+    return row == 0 && col == 0 && height == 0 && width == 0 && binning == 1;
+  }
+
+  /**
+   * The `{rows, cols}` of frames after applying this transform.
+   *
+   * @param sensor_shape The `{rows, cols}` of the frames from the camera.
+   * @throws std::invalid_argument if the crop rectangle is not inside the
+   *                               frame, or if the output would be empty.
+   */
+  std::array<Eigen::Index, 2> output_shape(
+      std::array<Eigen::Index, 2> sensor_shape) const;
+
+  /**
+   * Crops and bins a row-major frame from the camera into @p out.
+   *
+   * @param[in] sensor_frame The frame from the camera.
+   * @param sensor_shape The `{rows, cols}` of @p sensor_frame.
+   * @param[out] out Where to store the result, must have the output_shape().
+   */
+  void apply(const std::uint16_t *sensor_frame,
+             std::array<Eigen::Index, 2> sensor_shape,
+             Eigen::Map<Eigen::Matrix<std::uint16_t, Eigen::Dynamic,
+                                      Eigen::Dynamic, Eigen::RowMajor>>
+                 out) const;
+};
+
+#endif /* NQM_IRIMAGER_FRAME_TRANSFORM */
@@ -0,0 +1,139 @@
+#include "./histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/** Number of possible raw values */
+static constexpr std::size_t RAW_VALUE_COUNT =
+    std::size_t{std::numeric_limits<std::uint16_t>::max()} + 1;
+
+Histogram::Histogram(std::uint16_t bin_width) : bin_width_{bin_width} {
+  if (bin_width == 0) {
+    throw std::invalid_argument("Invalid bin_width: must be at least 1");
+  }
+  bin_reciprocal_ = ((std::uint64_t{1} << 32) + bin_width - 1) / bin_width;
+  bin_count_ = (RAW_VALUE_COUNT + bin_width - 1) / bin_width;
+  lowest_bin_ = bin_count_;
+  counts_.resize(bin_count_);
+  lane_counts_.resize(LANES * bin_count_);
+}
+
+void Histogram::clear() {
+  if (lowest_bin_ <= highest_bin_) {
+    auto begin = static_cast<std::ptrdiff_t>(lowest_bin_);
+    auto end = static_cast<std::ptrdiff_t>(highest_bin_ + 1);
+    std::fill(counts_.begin() + begin, counts_.begin() + end, 0);
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+      auto lane_begin =
+          lane_counts_.begin() + static_cast<std::ptrdiff_t>(lane * bin_count_);
+      std::fill(lane_begin + begin, lane_begin + end, 0);
+    }
+  }
+  count_ = 0;
+  pending_ = 0;
+  lowest_bin_ = bin_count_;
+  highest_bin_ = 0;
+}
+
+void Histogram::add(const std::uint16_t *values, std::size_t size) {
+  if (size == 0) {
+    return;
+  }
+
+  // a separate min/max pass is vectorised, and is much cheaper than the
+  // histogram loop below
+  auto [min_value, max_value] = std::minmax_element(values, values + size);
+  lowest_bin_ = std::min(lowest_bin_, bin(*min_value));
+  highest_bin_ = std::max(highest_bin_, bin(*max_value));
+
+  constexpr auto MAX_PENDING = std::numeric_limits<std::uint32_t>::max();
+  while (size > 0) {
+    if (pending_ == MAX_PENDING) {
+      flush();
+    }
+    auto chunk_size = static_cast<std::size_t>(
+        std::min<std::uint64_t>(size, MAX_PENDING - pending_));
+
+    static_assert(LANES == 4, "the loop below is manually unrolled");
+    auto *lane_0 = lane_counts_.data();
+    auto *lane_1 = lane_0 + bin_count_;
+    auto *lane_2 = lane_1 + bin_count_;
+    auto *lane_3 = lane_2 + bin_count_;
+    std::size_t i = 0;
+    for (; i + LANES <= chunk_size; i += LANES) {
+      lane_0[bin(values[i])]++;
+      lane_1[bin(values[i + 1])]++;
+      lane_2[bin(values[i + 2])]++;
+      lane_3[bin(values[i + 3])]++;
+    }
+    for (; i < chunk_size; i++) {
+      lane_0[bin(values[i])]++;
+    }
+
+    pending_ += chunk_size;
+    count_ += chunk_size;
+    values += chunk_size;
+    size -= chunk_size;
+  }
+}
+
+const std::vector<std::uint64_t> &Histogram::counts() const {
+  flush();
+  return counts_;
+}
+
+std::uint16_t Histogram::quantile(double q) const {
+  std::uint16_t result;
+  quantiles(&q, &result, 1);
+  return result;
+}
+
+void Histogram::quantiles(const double *q, std::uint16_t *out,
+                          std::size_t size) const {
+  for (std::size_t i = 0; i < size; i++) {
+    if (!(q[i] >= 0.0 && q[i] <= 1.0)) {
+      throw std::invalid_argument(
+          "Invalid quantile: must be between 0 and 1, but got " +
+          std::to_string(q[i]));
+    }
+  }
+  if (count_ == 0) {
+    throw std::runtime_error("Cannot compute quantiles of an empty histogram");
+  }
+  flush();
+
+  auto bin_index = lowest_bin_;
+  auto cumulative_count = counts_[bin_index];
+  for (std::size_t i = 0; i < size; i++) {
+    // if the quantiles are sorted, we only need a single pass over the bins
+    if (i > 0 && q[i] < q[i - 1]) {
+      bin_index = lowest_bin_;
+      cumulative_count = counts_[bin_index];
+    }
+    // the rank (1-indexed) of the value we want
+    auto rank = std::clamp(static_cast<std::uint64_t>(
+                               std::ceil(q[i] * static_cast<double>(count_))),
+                           std::uint64_t{1}, count_);
+    while (cumulative_count < rank) {
+      bin_index++;
+      cumulative_count += counts_[bin_index];
+    }
+    out[i] = static_cast<std::uint16_t>(bin_index * bin_width_);
+  }
+}
+
+void Histogram::flush() const {
+  if (pending_ == 0) {
+    return;
+  }
+  for (auto i = lowest_bin_; i <= highest_bin_; i++) {
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+      counts_[i] += lane_counts_[lane * bin_count_ + i];
+      lane_counts_[lane * bin_count_ + i] = 0;
+    }
+  }
+  pending_ = 0;
+}
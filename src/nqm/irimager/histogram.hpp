@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @brief Counting histograms and exact quantiles of raw thermal data.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_HISTOGRAM
+#define NQM_IRIMAGER_HISTOGRAM
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Histogram of raw ``uint16`` thermal data.
+ *
+ * Since raw thermal data only has 65536 possible values, quantiles (e.g. the
+ * median) can be computed exactly from a counting histogram in a single
+ * pass, instead of sorting the data.
+ *
+ * Only the bins between the smallest and largest values that have been
+ * added are touched, so clearing the histogram and computing quantiles is
+ * cheap for the narrow range of temperatures in a typical scene.
+ *
+ * The same histogram can be reused for every frame, by calling clear() in
+ * between, so that no memory is allocated after construction.
+ *
+ * @remark This class is not thread-safe, even the `const` methods.
+ */
+class Histogram {
+ public:
+  /**
+   * @param bin_width How many consecutive raw values are counted in each bin.
+   *                  A width of ``1`` gives exact quantiles.
+   *
+   * @throws std::invalid_argument if @p bin_width is ``0``.
+   */
+  explicit Histogram(std::uint16_t bin_width = 1);
+
+  /** How many consecutive raw values are counted in each bin. */
+  std::uint16_t bin_width() const { return bin_width_; }
+
+  /** The total number of values that have been added. */
+  std::uint64_t count() const { return count_; }
+
+  /** Removes all values. */
+  void clear();
+
+  /**
+   * Adds @p size values to the histogram.
+   *
+   * @param values The raw thermal data, e.g. a flattened
+   *               IRImager::ThermalFrame, or a row of a ROI.
+   */
+  void add(const std::uint16_t *values, std::size_t size);
+
+  /**
+   * The number of values in each bin.
+   *
+   * Bin `i` counts the raw values from `i * bin_width()` to
+   * `(i + 1) * bin_width() - 1`.
+   */
+  const std::vector<std::uint64_t> &counts() const;
+
+  /**
+   * @brief Computes a quantile of the values.
+   *
+   * Uses the inverted cumulative distribution function, i.e. returns the
+   * smallest value ``v`` where at least ``q * count()`` values are ``<= v``.
+   * This is the same as ``numpy.quantile(values, q,
+   * method="inverted_cdf")``, if bin_width() is ``1``.
+   * Otherwise, the lowest raw value of the bin is returned.
+   *
+   * @param q The quantile to compute, from ``0.0`` to ``1.0``.
+   *
+   * @throws std::invalid_argument if @p q is not between ``0.0`` and ``1.0``.
+   * @throws std::runtime_error if the histogram is empty.
+   */
+  std::uint16_t quantile(double q) const;
+
+  /**
+   * @brief Computes multiple quantiles.
+   *
+   * If @p q is sorted, all quantiles are computed in a single pass.
+   *
+   * @param[in] q The quantiles to compute, see quantile().
+   * @param[out] out Where to store the @p size results.
+   * @param size The number of elements in @p q and @p out.
+   *
+   * @throws std::invalid_argument if any @p q is not between ``0.0`` and
+   *                               ``1.0``.
+   * @throws std::runtime_error if the histogram is empty.
+   */
+  void quantiles(const double *q, std::uint16_t *out, std::size_t size) const;
+
+ private:
+  /**
+   * The number of interleaved sub-histograms.
+   *
+   * Consecutive values are counted in different sub-histograms, so that runs
+   * of equal values (very common in thermal images) don't stall on
+   * incrementing the same counter.
+   */
+  static constexpr std::size_t LANES = 4;
+
+  std::uint16_t bin_width_;
+  /** `ceil(2**32 / bin_width)`, so `value / bin_width` is a multiply/shift */
+  std::uint64_t bin_reciprocal_;
+  std::size_t bin_count_;
+
+  std::uint64_t count_ = 0;
+  /** Lowest bin that may be non-zero. */
+  std::size_t lowest_bin_;
+  /** Highest bin that may be non-zero. */
+  std::size_t highest_bin_ = 0;
+
+  /** Totals of each bin, up to date after flush() */
+  mutable std::vector<std::uint64_t> counts_;
+  /** ::LANES sub-histograms of 32-bit counters, lane-major */
+  mutable std::vector<std::uint32_t> lane_counts_;
+  /** Number of values in ::lane_counts_, to avoid overflowing them */
+  mutable std::uint64_t pending_ = 0;
+
+  std::size_t bin(std::uint16_t value) const {
+    return static_cast<std::size_t>((value * bin_reciprocal_) >> 32);
+  }
+
+  /** Adds ::lane_counts_ into ::counts_, and resets them to zero */
+  void flush() const;
+};
+
+#endif /* NQM_IRIMAGER_HISTOGRAM */
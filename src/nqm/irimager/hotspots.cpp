@@ -0,0 +1,255 @@
+#include "./hotspots.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+HotspotDetector::HotspotDetector(Eigen::Index rows, Eigen::Index cols,
+                                 float threshold,
+                                 HotspotThreshold threshold_mode,
+                                 std::size_t min_area, int connectivity)
+    : rows_{rows},
+      cols_{cols},
+      threshold_{threshold},
+      threshold_mode_{threshold_mode},
+      min_area_{min_area},
+      connectivity_{connectivity} {
+  if (rows <= 0 || cols <= 0) {
+    throw std::invalid_argument("Invalid frame shape: (" +
+                                std::to_string(rows) + ", " +
+                                std::to_string(cols) + ") is empty");
+  }
+  if (min_area == 0) {
+    throw std::invalid_argument("Invalid min_area: must be at least 1");
+  }
+  if (connectivity != 4 && connectivity != 8) {
+    throw std::invalid_argument("Invalid connectivity " +
+                                std::to_string(connectivity) +
+                                ": must be 4 or 8");
+  }
+}
+
+void HotspotDetector::set_threshold(float threshold,
+                                    HotspotThreshold threshold_mode) {
+  threshold_ = threshold;
+  threshold_mode_ = threshold_mode;
+}
+
+void HotspotDetector::set_background_rectangle(Eigen::Index row,
+                                               Eigen::Index col,
+                                               Eigen::Index height,
+                                               Eigen::Index width) {
+  auto background = RoiStatsEngine(rows_, cols_);
+  background.add_rectangle(row, col, height, width);
+  background_ = std::move(background);
+}
+
+void HotspotDetector::set_background_polygon(
+    const std::vector<RoiStatsEngine::Vertex> &vertices) {
+  auto background = RoiStatsEngine(rows_, cols_);
+  background.add_polygon(vertices);
+  background_ = std::move(background);
+}
+
+void HotspotDetector::clear_background() { background_.reset(); }
+
+void HotspotDetector::check_frame(const Eigen::Ref<const Frame> &frame) const {
+  if (frame.rows() != rows_ || frame.cols() != cols_) {
+    throw std::invalid_argument(
+        "Invalid frame: expected shape (" + std::to_string(rows_) + ", " +
+        std::to_string(cols_) + "), but got (" + std::to_string(frame.rows()) +
+        ", " + std::to_string(frame.cols()) + ")");
+  }
+}
+
+std::uint32_t HotspotDetector::raw_threshold(
+    const Eigen::Ref<const Frame> &frame, short temp_range_decimal) {
+  const auto raw_per_degree =
+      std::pow(10.0, static_cast<double>(temp_range_decimal));
+
+  double threshold;
+  if (threshold_mode_ == HotspotThreshold::RELATIVE) {
+    histogram_.clear();
+    if (background_) {
+      background_->add_to_histogram(frame, 0, histogram_);
+    } else {
+      for (Eigen::Index row = 0; row < rows_; row++) {
+        histogram_.add(frame.data() + row * frame.outerStride(),
+                       static_cast<std::size_t>(cols_));
+      }
+    }
+    threshold = histogram_.quantile(0.5) +
+                static_cast<double>(threshold_) * raw_per_degree;
+  } else {
+    // the raw data is offset from -100 ℃
+    threshold = (static_cast<double>(threshold_) + 100.0) * raw_per_degree;
+  }
+
+  // pixels must be strictly hotter than the threshold
+  constexpr auto no_hot_pixels =
+      std::uint32_t{std::numeric_limits<std::uint16_t>::max()} + 1;
+  auto min_raw = std::floor(threshold) + 1.0;
+  if (!(min_raw < no_hot_pixels)) {  // also catches NaN
+    return no_hot_pixels;
+  }
+  return static_cast<std::uint32_t>(std::max(min_raw, 0.0));
+}
+
+std::size_t HotspotDetector::find_root(std::size_t run) {
+  auto root = run;
+  while (parents_[root] != root) {
+    root = parents_[root];
+  }
+  while (parents_[run] != root) {
+    auto parent = parents_[run];
+    parents_[run] = root;
+    run = parent;
+  }
+  return root;
+}
+
+void HotspotDetector::label(const Eigen::Ref<const Frame> &frame,
+                            std::uint32_t min_raw) {
+  runs_.clear();
+  parents_.clear();
+
+  // with 8-connectivity, runs also touch if they are diagonally adjacent
+  const Eigen::Index gap = connectivity_ == 8 ? 1 : 0;
+  std::size_t previous_row_begin = 0;
+  std::size_t previous_row_end = 0;
+
+  for (Eigen::Index row = 0; row < rows_; row++) {
+    auto row_begin = runs_.size();
+
+    // most rows don't have any hot pixels, so skip them with a single
+    // vectorised pass
+    if (frame.row(row).maxCoeff() >= min_raw) {
+      const auto *pixels = frame.data() + row * frame.outerStride();
+      for (Eigen::Index col = 0; col < cols_;) {
+        if (pixels[col] < min_raw) {
+          col++;
+          continue;
+        }
+        auto col_begin = col;
+        while (col < cols_ && pixels[col] >= min_raw) {
+          col++;
+        }
+        runs_.push_back({row, col_begin, col});
+        parents_.push_back(runs_.size() - 1);
+      }
+    }
+
+    // merge with the touching runs in the previous row, both of which are
+    // sorted by column, so each previous run is only skipped once
+    auto previous = previous_row_begin;
+    for (auto run = row_begin; run < runs_.size(); run++) {
+      const auto &current = runs_[run];
+      while (previous < previous_row_end &&
+             runs_[previous].col_end + gap <= current.col_begin) {
+        previous++;
+      }
+      // the last touching run may also touch the next current run, so don't
+      // skip it
+      auto touching = previous;
+      while (touching < previous_row_end &&
+             runs_[touching].col_begin < current.col_end + gap) {
+        auto root = find_root(touching);
+        auto current_root = find_root(run);
+        // keep the earliest run as the root
+        if (root < current_root) {
+          parents_[current_root] = root;
+        } else if (current_root < root) {
+          parents_[root] = current_root;
+        }
+        touching++;
+      }
+    }
+
+    previous_row_begin = row_begin;
+    previous_row_end = runs_.size();
+  }
+}
+
+HotspotDetector::Hotspots HotspotDetector::detect(
+    const Eigen::Ref<const Frame> &frame, short temp_range_decimal) {
+  check_frame(frame);
+  label(frame, raw_threshold(frame, temp_range_decimal));
+
+  // since each root is the first run of its component, and runs are sorted,
+  // each root is visited before the other runs in its component
+  blobs_.clear();
+  blob_indices_.resize(runs_.size());
+  for (std::size_t run = 0; run < runs_.size(); run++) {
+    const auto &[row, col_begin, col_end] = runs_[run];
+    auto root = find_root(run);
+    if (root == run) {
+      blob_indices_[run] = blobs_.size();
+      blobs_.push_back({0, 0, 0, 0, row, row, col_begin, col_end - 1, 0});
+    } else {
+      blob_indices_[run] = blob_indices_[root];
+    }
+    auto &blob = blobs_[blob_indices_[run]];
+
+    // keep the accumulators local and the loop branch-free, so that the
+    // compiler vectorises it
+    const auto *pixels = frame.data() + row * frame.outerStride();
+    auto run_peak = std::numeric_limits<std::uint16_t>::min();
+    std::uint64_t run_sum = 0;
+    for (auto col = col_begin; col < col_end; col++) {
+      run_peak = std::max(run_peak, pixels[col]);
+      run_sum += pixels[col];
+    }
+
+    auto length = static_cast<std::uint64_t>(col_end - col_begin);
+    blob.area += length;
+    blob.row_sum += length * static_cast<std::uint64_t>(row);
+    // sum of col_begin to col_end - 1, the product is always even
+    auto col_sum = length * static_cast<std::uint64_t>(col_begin + col_end - 1);
+    blob.col_sum += col_sum / 2;
+    blob.raw_sum += run_sum;
+    blob.max_row = row;
+    blob.min_col = std::min(blob.min_col, col_begin);
+    blob.max_col = std::max(blob.max_col, col_end - 1);
+    blob.peak = std::max(blob.peak, run_peak);
+  }
+
+  auto hotspot_count = std::count_if(
+      blobs_.begin(), blobs_.end(),
+      [this](const Blob &blob) { return blob.area >= min_area_; });
+  auto hotspots = Hotspots(hotspot_count, STAT_COUNT);
+
+  const auto scale =
+      1.0 / std::pow(10.0, static_cast<double>(temp_range_decimal));
+  // the raw data is offset from -100 ℃
+  constexpr auto offset = -100.0;
+
+  Eigen::Index index = 0;
+  for (const auto &blob : blobs_) {
+    if (blob.area < min_area_) {
+      continue;
+    }
+    auto area = static_cast<double>(blob.area);
+    auto stat = [&](HotspotStat column) -> float & {
+      return hotspots(index, static_cast<Eigen::Index>(column));
+    };
+    stat(HotspotStat::AREA) = static_cast<float>(blob.area);
+    stat(HotspotStat::CENTROID_ROW) =
+        static_cast<float>(static_cast<double>(blob.row_sum) / area);
+    stat(HotspotStat::CENTROID_COL) =
+        static_cast<float>(static_cast<double>(blob.col_sum) / area);
+    stat(HotspotStat::ROW) = static_cast<float>(blob.min_row);
+    stat(HotspotStat::COL) = static_cast<float>(blob.min_col);
+    stat(HotspotStat::HEIGHT) =
+        static_cast<float>(blob.max_row - blob.min_row + 1);
+    stat(HotspotStat::WIDTH) =
+        static_cast<float>(blob.max_col - blob.min_col + 1);
+    stat(HotspotStat::PEAK) = static_cast<float>(blob.peak * scale + offset);
+    stat(HotspotStat::MEAN) = static_cast<float>(
+        static_cast<double>(blob.raw_sum) / area * scale + offset);
+    index++;
+  }
+  return hotspots;
+}
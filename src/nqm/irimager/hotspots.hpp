@@ -0,0 +1,233 @@
+/**
+ * @file
+ * @brief Finds hot spots in a frame, using connected-component labelling.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_HOTSPOTS
+#define NQM_IRIMAGER_HOTSPOTS
+
+#include <Eigen/Dense>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "./histogram.hpp"
+#include "./roi.hpp"
+
+/**
+ * Columns of the array returned by HotspotDetector::detect().
+ */
+enum class HotspotStat : std::uint8_t {
+  /** The number of pixels in the hot spot. */
+  AREA,
+  /** The mean row index of the pixels in the hot spot. */
+  CENTROID_ROW,
+  /** The mean column index of the pixels in the hot spot. */
+  CENTROID_COL,
+  /** The first row of the hot spot's bounding box. */
+  ROW,
+  /** The first column of the hot spot's bounding box. */
+  COL,
+  /** The number of rows in the hot spot's bounding box. */
+  HEIGHT,
+  /** The number of columns in the hot spot's bounding box. */
+  WIDTH,
+  /** The maximum temperature in the hot spot. */
+  PEAK,
+  /** The mean temperature in the hot spot. */
+  MEAN,
+};
+
+/**
+ * What HotspotDetector::threshold() is relative to.
+ */
+enum class HotspotThreshold : std::uint8_t {
+  /** The threshold is a temperature, in degrees Celsius. */
+  ABSOLUTE,
+  /**
+   * The threshold is a temperature difference, in degrees Celsius, above
+   * the median temperature of the background region, see
+   * HotspotDetector::set_background_rectangle().
+   */
+  RELATIVE,
+};
+
+/**
+ * @brief Finds the hot spots in a frame, i.e. connected regions of pixels
+ * that are hotter than a threshold.
+ *
+ * The threshold is converted to a raw value once per frame, so the frame is
+ * never converted to temperatures. Each row of the frame is split into runs
+ * of hot pixels (rows without any hot pixels are skipped by a single
+ * vectorised maximum), then touching runs in consecutive rows are merged
+ * using a union-find, so pixels are only read once, and the labels are only
+ * resolved once per run, instead of once per pixel.
+ *
+ * The memory used for runs and labels is reused for every frame, so
+ * detect() only allocates if a frame has more runs than any previous frame.
+ *
+ * @remark This class is not thread-safe, even the `const` methods.
+ */
+class HotspotDetector {
+ public:
+  /** The number of HotspotStat columns in Hotspots. */
+  static constexpr Eigen::Index STAT_COUNT = 9;
+
+  /**
+   * Raw thermal frame, see IRImager::ThermalFrame.
+   */
+  using Frame = Eigen::Matrix<std::uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>;
+
+  /**
+   * The statistics of each hot spot, with one row per hot spot, and
+   * ::STAT_COUNT columns, indexed by HotspotStat. Temperatures are in
+   * degrees Celsius.
+   */
+  using Hotspots =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  /**
+   * @param rows The number of rows in each frame.
+   * @param cols The number of columns in each frame.
+   * @param threshold Pixels hotter than this are part of a hot spot, in
+   *                  degrees Celsius.
+   * @param threshold_mode What @p threshold is relative to.
+   * @param min_area Ignore hot spots with fewer pixels than this, e.g. to
+   *                 ignore single noisy pixels.
+   * @param connectivity ``8`` if diagonally adjacent pixels are connected,
+   *                     or ``4`` if only horizontally/vertically adjacent
+   *                     pixels are connected.
+   *
+   * @throws std::invalid_argument if the frame is empty, if @p min_area is
+   *                               `0`, or if @p connectivity is not ``4`` or
+   *                               ``8``.
+   */
+  HotspotDetector(Eigen::Index rows, Eigen::Index cols, float threshold,
+                  HotspotThreshold threshold_mode = HotspotThreshold::ABSOLUTE,
+                  std::size_t min_area = 1, int connectivity = 8);
+
+  /** The number of rows in each frame. */
+  Eigen::Index rows() const { return rows_; }
+  /** The number of columns in each frame. */
+  Eigen::Index cols() const { return cols_; }
+  /** Pixels hotter than this are part of a hot spot, in degrees Celsius. */
+  float threshold() const { return threshold_; }
+  /** What threshold() is relative to. */
+  HotspotThreshold threshold_mode() const { return threshold_mode_; }
+  /** Hot spots with fewer pixels than this are ignored. */
+  std::size_t min_area() const { return min_area_; }
+  /** ``8`` if diagonally adjacent pixels are connected, otherwise ``4``. */
+  int connectivity() const { return connectivity_; }
+
+  /** Changes the threshold() and threshold_mode(). */
+  void set_threshold(float threshold, HotspotThreshold threshold_mode);
+
+  /**
+   * Sets the background region to a rectangle, see
+   * HotspotThreshold::RELATIVE. By default, the whole frame is used.
+   *
+   * The rectangle is clipped to the frame.
+   *
+   * @throws std::invalid_argument if the rectangle does not contain any
+   *                               pixels of the frame.
+   */
+  void set_background_rectangle(Eigen::Index row, Eigen::Index col,
+                                Eigen::Index height, Eigen::Index width);
+
+  /**
+   * Sets the background region to a polygon, see
+   * RoiStatsEngine::add_polygon() and HotspotThreshold::RELATIVE.
+   *
+   * @throws std::invalid_argument if the polygon has fewer than 3 vertices,
+   *                               or does not contain any pixels of the frame.
+   */
+  void set_background_polygon(
+      const std::vector<RoiStatsEngine::Vertex> &vertices);
+
+  /** Uses the whole frame as the background region. */
+  void clear_background();
+
+  /**
+   * Finds the hot spots in a frame.
+   *
+   * @param frame The raw thermal frame, with the shape given in the
+   *              constructor.
+   * @param temp_range_decimal Used to convert the raw data to temperatures,
+   *                           see IRImager::get_temp_range_decimal().
+   *
+   * @throws std::invalid_argument if @p frame has the wrong shape.
+   * @returns The hot spots with at least min_area() pixels, in the order of
+   *          their first pixel (i.e. sorted by their top row, then by the
+   *          first column in that row).
+   */
+  Hotspots detect(const Eigen::Ref<const Frame> &frame,
+                  short temp_range_decimal);
+
+ private:
+  /** A horizontal run of hot pixels, from `col_begin` to `col_end - 1`. */
+  struct Run {
+    Eigen::Index row;
+    Eigen::Index col_begin;
+    Eigen::Index col_end;
+  };
+
+  /** The running totals of a connected component. */
+  struct Blob {
+    std::uint64_t area;
+    std::uint64_t row_sum;
+    std::uint64_t col_sum;
+    std::uint64_t raw_sum;
+    Eigen::Index min_row;
+    Eigen::Index max_row;
+    Eigen::Index min_col;
+    Eigen::Index max_col;
+    std::uint16_t peak;
+  };
+
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  float threshold_;
+  HotspotThreshold threshold_mode_;
+  std::size_t min_area_;
+  int connectivity_;
+
+  /** The background region, or `std::nullopt` to use the whole frame */
+  std::optional<RoiStatsEngine> background_;
+  /** Reused by detect(), to compute the median of the background */
+  Histogram histogram_;
+
+  /** The runs of the last frame, sorted by row, then by column */
+  std::vector<Run> runs_;
+  /**
+   * The union-find forest of runs, where run `i`'s parent is `parents_[i]`.
+   * Each root is the first run (in raster order) of its component.
+   */
+  std::vector<std::size_t> parents_;
+  /** The index of each run's Blob in ::blobs_ */
+  std::vector<std::size_t> blob_indices_;
+  std::vector<Blob> blobs_;
+
+  /** @throws std::invalid_argument if @p frame has the wrong shape. */
+  void check_frame(const Eigen::Ref<const Frame> &frame) const;
+
+  /**
+   * The smallest raw value that is hotter than the threshold, which may be
+   * above the largest raw value, if no pixels can be hot.
+   */
+  std::uint32_t raw_threshold(const Eigen::Ref<const Frame> &frame,
+                              short temp_range_decimal);
+
+  /** Finds the root of run @p run, compressing the path to it. */
+  std::size_t find_root(std::size_t run);
+
+  /** Finds the runs of hot pixels, and merges the touching runs. */
+  void label(const Eigen::Ref<const Frame> &frame, std::uint32_t min_raw);
+};
+
+#endif /* NQM_IRIMAGER_HOTSPOTS */
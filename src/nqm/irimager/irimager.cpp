@@ -6,10 +6,18 @@
 #include <pybind11/stl/filesystem.h>
 #include <pybind11/stl_bind.h>
 
+#include "./camera_group.hpp"
 #include "./chrono.hpp"
+#include "./frame_codec.hpp"
+#include "./histogram.hpp"
+#include "./hotspots.hpp"
 #include "./irimager_class.hpp"
 #include "./logger.hpp"
 #include "./logger_context_manager.hpp"
+#include "./python_frame_callback.hpp"
+#include "./recording.hpp"
+#include "./temporal_filter.hpp"
+#include "./thread_scheduling.hpp"
 
 #ifndef DOCSTRINGS_H
 #error DOCSTRINGS_H must be defined to the output of pybind11_mkdocs
@@ -30,9 +38,607 @@ static void IRImager_exit_(
     [[maybe_unused]] const std::optional<pybind11::type> &exc_type,
     [[maybe_unused]] const std::optional<pybind11::object> &exc_value,
     [[maybe_unused]] const std::optional<pybind11::object>) {
+  // joins the acquisition thread, which may be waiting for the GIL
+  auto no_gil = pybind11::gil_scoped_release();
   irimager->stop_streaming();
 }
 
+/**
+ * Converts a frame to a numpy array, recording how long it took as the
+ * PipelineStage::CONVERT latency of @p irimager.
+ */
+static pybind11::array_t<uint16_t> IRImager_frame_to_numpy_(
+    IRImager &irimager, IRImager::PooledThermalFrame thermal_frame) {
+  auto start = std::chrono::steady_clock::now();
+  auto array = pooled_frame_to_numpy(std::move(thermal_frame));
+  irimager.record_latency(PipelineStage::CONVERT,
+                          std::chrono::steady_clock::now() - start);
+  return array;
+}
+
+static pybind11::tuple IRImager_get_frame_(IRImager &irimager) {
+  auto [thermal_frame, time_point] = [&irimager]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    auto [pooled_frame, monotonic_time_point, metadata] =
+        irimager.get_pooled_frame_monotonic();
+    return std::make_tuple(std::move(pooled_frame),
+                           nqm::irimager::clock_cast(monotonic_time_point));
+  }();
+  return pybind11::make_tuple(
+      IRImager_frame_to_numpy_(irimager, std::move(thermal_frame)), time_point);
+}
+
+static pybind11::tuple IRImager_get_frame_with_metadata_(IRImager &irimager) {
+  auto [thermal_frame, time_point, metadata] = [&irimager]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    auto [pooled_frame, monotonic_time_point, frame_metadata] =
+        irimager.get_pooled_frame_monotonic();
+    return std::make_tuple(std::move(pooled_frame),
+                           nqm::irimager::clock_cast(monotonic_time_point),
+                           frame_metadata);
+  }();
+  return pybind11::make_tuple(
+      IRImager_frame_to_numpy_(irimager, std::move(thermal_frame)), time_point,
+      metadata);
+}
+
+static constexpr auto IRImager_get_frame_with_metadata_doc_ =
+    R"(Return a frame, with its timestamp and metadata.
+
+Returns:
+    A tuple containing:
+      1. The frame, see :py:meth:`get_frame`.
+      2. The approximate time the frame was taken.
+      3. The :py:class:`FrameMetadata` of the frame, e.g. the shutter flag
+         state and the camera's internal temperatures.)";
+
+static pybind11::tuple IRImager_get_frame_celsius_(IRImager &irimager) {
+  auto [rows, cols] = irimager.get_frame_shape();
+  auto frame =
+      pybind11::array_t<float>(std::array<pybind11::ssize_t, 2>{rows, cols});
+  auto frame_map = Eigen::Map<IRImager::TemperatureFrame>(frame.mutable_data(),
+                                                          rows, cols);
+
+  auto time_point = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return irimager.get_temperature_frame_monotonic_into(
+        frame_map, TemperatureUnit::CELSIUS);
+  }();
+  return pybind11::make_tuple(frame, nqm::irimager::clock_cast(time_point));
+}
+
+static constexpr auto IRImager_get_frame_celsius_doc_ =
+    R"(Return a frame, converted to degrees Celsius.
+
+Similar to :py:meth:`get_frame`, except that the frame is returned as a
+``float32`` array of temperatures in degrees Celsius, instead of raw
+``uint16`` data.
+
+This is faster than converting the raw data with numpy, since the conversion
+is done in a single vectorised pass, without any temporary arrays.
+To avoid allocating a new array for every frame, use
+:py:meth:`get_temperature_frame_monotonic_into`.)";
+
+static pybind11::tuple IRImager_get_roi_stats_(IRImager &irimager) {
+  auto rows = static_cast<Eigen::Index>(irimager.get_roi_count());
+  auto cols = RoiStatsEngine::STAT_COUNT +
+              static_cast<Eigen::Index>(irimager.get_roi_quantiles().size());
+  auto stats =
+      pybind11::array_t<float>(std::array<pybind11::ssize_t, 2>{rows, cols});
+  auto stats_map =
+      Eigen::Map<IRImager::RoiStats>(stats.mutable_data(), rows, cols);
+
+  auto time_point = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return irimager.get_roi_stats_monotonic_into(stats_map);
+  }();
+  return pybind11::make_tuple(stats, nqm::irimager::clock_cast(time_point));
+}
+
+static constexpr auto IRImager_get_roi_stats_doc_ =
+    R"(Return the statistics of each region of interest (ROI) of a frame.
+
+Add ROIs with :py:meth:`add_roi_rectangle` or :py:meth:`add_roi_polygon`
+before calling :py:meth:`start_streaming`.
+
+If ``frame_queue_size`` is greater than ``0``, the statistics are computed by
+the background thread as each frame is grabbed, so only a small array is
+copied to Python, instead of the whole frame.
+
+Returns:
+    A tuple containing:
+      1. A ``float32`` array, with one row per ROI. The first columns are
+         indexed by :py:class:`RoiStat`, followed by one column for each
+         quantile set by :py:meth:`set_roi_quantiles`, in degrees Celsius.
+      2. The approximate time the frame was taken.)";
+
+static pybind11::array_t<float> raw_to_temperature_(
+    pybind11::array_t<uint16_t, pybind11::array::c_style> raw,
+    short temp_range_decimal, TemperatureUnit unit,
+    std::optional<pybind11::array_t<float, pybind11::array::c_style>> out) {
+  if (!out) {
+    out = pybind11::array_t<float>(std::vector<pybind11::ssize_t>(
+        raw.shape(), raw.shape() + raw.ndim()));
+  } else if (out->ndim() != raw.ndim() ||
+             !std::equal(raw.shape(), raw.shape() + raw.ndim(),
+                         out->shape())) {
+    throw std::invalid_argument(
+        "Invalid output array: must have the same shape as the input array");
+  }
+
+  auto raw_data = raw.data();
+  auto out_data = out->mutable_data();
+  auto size = static_cast<std::size_t>(raw.size());
+  {
+    auto no_gil = pybind11::gil_scoped_release();
+    raw_to_temperature(raw_data, out_data, size, temp_range_decimal, unit);
+  }
+  return *out;
+}
+
+static pybind11::tuple IRImager_get_frame_monotonic_(IRImager &irimager) {
+  auto [thermal_frame, time_point, metadata] = [&irimager]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return irimager.get_pooled_frame_monotonic();
+  }();
+  return pybind11::make_tuple(
+      IRImager_frame_to_numpy_(irimager, std::move(thermal_frame)), time_point);
+}
+
+static std::optional<pybind11::tuple> IRImager_try_get_frame_(
+    IRImager &irimager, std::chrono::duration<double> timeout) {
+  auto pooled_frame = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return irimager.try_get_pooled_frame_monotonic(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            timeout));
+  }();
+  if (!pooled_frame) {
+    return std::nullopt;
+  }
+  auto &[thermal_frame, time_point, metadata] = *pooled_frame;
+  return pybind11::make_tuple(
+      IRImager_frame_to_numpy_(irimager, std::move(thermal_frame)),
+      nqm::irimager::clock_cast(time_point));
+}
+
+static std::optional<pybind11::tuple> IRImager_try_get_frame_monotonic_(
+    IRImager &irimager, std::chrono::duration<double> timeout) {
+  auto pooled_frame = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return irimager.try_get_pooled_frame_monotonic(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            timeout));
+  }();
+  if (!pooled_frame) {
+    return std::nullopt;
+  }
+  auto &[thermal_frame, time_point, metadata] = *pooled_frame;
+  return pybind11::make_tuple(
+      IRImager_frame_to_numpy_(irimager, std::move(thermal_frame)), time_point);
+}
+
+static constexpr auto IRImager_try_get_frame_doc_ =
+    R"(Return a frame, or ``None`` if no frame arrives within ``timeout``.
+
+Similar to :py:meth:`get_frame`, except that this never waits for longer
+than ``timeout`` (plus one frame period, if ``frame_queue_size`` is ``0``).
+
+To always get the latest frame, start streaming with ``frame_queue_size=1``
+and ``overflow_policy=OverflowPolicy.DROP_OLDEST``.)";
+
+static constexpr auto IRImager_try_get_frame_monotonic_doc_ =
+    R"(Return a frame with a monotonic timestamp, or ``None`` on timeout.
+
+Similar to :py:meth:`try_get_frame`, except returns a monotonic timepoint, see
+:py:meth:`get_frame_monotonic`.)";
+
+/**
+ * Creates an asyncio future that resolves to the next frame from the frame
+ * queue, without blocking the event loop.
+ *
+ * The event loop waits on a duplicate of IRImager::get_frame_event_fd(), so
+ * that multiple futures can wait at the same time.
+ *
+ * @param self The Python IRImager object, kept alive until the future is done.
+ * @param stop_iteration If `true`, raise `StopAsyncIteration` instead of
+ *                       `RuntimeError` once the IRImager has stopped streaming.
+ */
+static pybind11::object IRImager_next_frame_future_(pybind11::object self,
+                                                    bool stop_iteration) {
+  auto &irimager = self.cast<IRImager &>();
+  auto builtins = pybind11::module_::import("builtins");
+  auto os = pybind11::module_::import("os");
+  auto loop = pybind11::module_::import("asyncio").attr("get_running_loop")();
+  auto future = loop.attr("create_future")();
+
+  auto set_error = [self, future, builtins,
+                    stop_iteration](const std::exception &error) {
+    if (stop_iteration && !self.cast<IRImager &>().is_streaming()) {
+      future.attr("set_exception")(builtins.attr("StopAsyncIteration")());
+    } else {
+      future.attr("set_exception")(builtins.attr("RuntimeError")(error.what()));
+    }
+  };
+
+  /** Returns `true` once the future is done */
+  auto try_resolve = [self, future, set_error]() {
+    if (future.attr("done")().cast<bool>()) {
+      return true;
+    }
+    try {
+      auto frame = IRImager_try_get_frame_(self.cast<IRImager &>(),
+                                           std::chrono::duration<double>(0));
+      if (!frame) {
+        return false;
+      }
+      future.attr("set_result")(*frame);
+    } catch (const std::exception &error) {
+      set_error(error);
+    }
+    return true;
+  };
+
+  int event_fd;
+  try {
+    event_fd = irimager.get_frame_event_fd();
+  } catch (const std::exception &error) {
+    set_error(error);
+    return future;
+  }
+
+  if (try_resolve()) {
+    return future;
+  }
+
+  auto waiter_fd = os.attr("dup")(event_fd);
+  loop.attr("add_reader")(waiter_fd,
+                          pybind11::cpp_function([try_resolve]() {
+                            try_resolve();
+                          }));
+  future.attr("add_done_callback")(
+      pybind11::cpp_function([loop, os, waiter_fd](pybind11::object) {
+        loop.attr("remove_reader")(waiter_fd);
+        os.attr("close")(waiter_fd);
+      }));
+  return future;
+}
+
+static pybind11::object IRImager_get_frame_async_(pybind11::object self) {
+  return IRImager_next_frame_future_(self, false);
+}
+
+static constexpr auto IRImager_get_frame_async_doc_ =
+    R"(Return an awaitable that resolves to the next frame.
+
+Similar to :py:meth:`get_frame`, except that it doesn't block the
+:py:mod:`asyncio` event loop, or use any executor threads.
+Instead, the event loop waits on a file descriptor (an ``eventfd``) that the
+C++ background thread signals whenever a frame is queued.
+
+Requires calling :py:meth:`start_streaming` with a ``frame_queue_size``
+greater than ``0``, and cannot be used at the same time as
+:py:meth:`set_frame_callback`.
+
+Raises:
+    RuntimeError: If we're not streaming with a frame queue, or if a frame
+        cannot be loaded.)";
+
+/**
+ * Asynchronous iterator over the frames of an IRImager.
+ */
+struct FrameStream {
+  /** The Python IRImager object. */
+  pybind11::object irimager;
+};
+
+static constexpr auto IRImager_stream_doc_ =
+    R"(Iterate over frames with ``async for``.
+
+For example:
+
+.. code-block:: python
+
+    irimager.start_streaming(frame_queue_size=8)
+    async for frame, timestamp in irimager.stream():
+        ...
+
+Each iteration is the same as awaiting :py:meth:`get_frame_async`, except
+that iteration stops once :py:meth:`stop_streaming` is called.)";
+
+static void IRImager_set_frame_callback_(
+    IRImager &irimager, std::optional<pybind11::function> callback) {
+  if (!callback) {
+    auto no_gil = pybind11::gil_scoped_release();
+    irimager.set_frame_callback(nullptr);
+    return;
+  }
+
+  auto python_frame_callback = std::make_shared<PythonFrameCallback>(*callback);
+  auto no_gil = pybind11::gil_scoped_release();
+  irimager.set_frame_callback(
+      [python_frame_callback](
+          IRImager::PooledThermalFrame thermal_frame,
+          std::chrono::steady_clock::time_point time_point,
+          const FrameMetadata &metadata) {
+        (*python_frame_callback)(std::move(thermal_frame), time_point,
+                                 metadata);
+      });
+}
+
+static pybind11::tuple IRImager_get_frames_(
+    IRImager &irimager, std::size_t count,
+    std::chrono::duration<double> timeout) {
+  auto [rows, cols] = irimager.get_frame_shape();
+  auto frames = pybind11::array_t<uint16_t>(std::array<pybind11::ssize_t, 3>{
+      static_cast<pybind11::ssize_t>(count), rows, cols});
+  auto timestamps =
+      pybind11::array_t<std::int64_t>(static_cast<pybind11::ssize_t>(count));
+  auto metadata =
+      pybind11::array_t<FrameMetadata>(static_cast<pybind11::ssize_t>(count));
+
+  auto frames_map = Eigen::Map<IRImager::ThermalFrames>(
+      frames.mutable_data(), static_cast<Eigen::Index>(count), rows * cols);
+  auto timestamps_map = Eigen::Map<IRImager::Timestamps>(
+      timestamps.mutable_data(), static_cast<Eigen::Index>(count));
+
+  auto frames_read = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return irimager.get_frames_monotonic_into(
+        frames_map, timestamps_map,
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            timeout),
+        metadata.mutable_data());
+  }();
+
+  if (frames_read < count) {
+    auto slice = pybind11::slice(
+        pybind11::ssize_t{0}, static_cast<pybind11::ssize_t>(frames_read),
+        pybind11::ssize_t{1});
+    pybind11::object frames_read_slice = frames[slice];
+    pybind11::object timestamps_read_slice = timestamps[slice];
+    pybind11::object metadata_read_slice = metadata[slice];
+    return pybind11::make_tuple(frames_read_slice, timestamps_read_slice,
+                                metadata_read_slice);
+  }
+  return pybind11::make_tuple(frames, timestamps, metadata);
+}
+
+static constexpr auto IRImager_get_frames_doc_ =
+    R"(Return multiple frames, with monotonic timestamps.
+
+Acquires ``count`` frames with the GIL released, which avoids the per-frame
+overhead of calling :py:meth:`get_frame` from Python.
+
+Returns:
+    A tuple containing:
+      1. A ``(count, rows, columns)`` ``uint16`` array of frames.
+      2. A ``(count,)`` ``int64`` array of monotonic timestamps, in
+         nanoseconds.
+      3. A ``(count,)`` structured array of each frame's
+         :py:class:`FrameMetadata`.
+    If ``timeout`` expires, fewer than ``count`` frames are returned.)";
+
+/** Throws if @p frames doesn't contain @p count frames of the right shape */
+static void Recorder_check_frames_(const Recorder &recorder,
+                                   const pybind11::array &frames,
+                                   pybind11::ssize_t count) {
+  if (frames.ndim() != 3 || frames.shape(0) != count ||
+      frames.shape(1) != recorder.rows() ||
+      frames.shape(2) != recorder.cols()) {
+    throw std::invalid_argument("Invalid frames: expected shape (" +
+                                std::to_string(count) + ", " +
+                                std::to_string(recorder.rows()) + ", " +
+                                std::to_string(recorder.cols()) + ")");
+  }
+}
+
+static void Recorder_append_(
+    Recorder &recorder,
+    pybind11::array_t<uint16_t, pybind11::array::c_style> frame,
+    std::chrono::steady_clock::time_point timestamp,
+    std::optional<FrameMetadata> metadata) {
+  if (frame.ndim() != 2 || frame.shape(0) != recorder.rows() ||
+      frame.shape(1) != recorder.cols()) {
+    throw std::invalid_argument("Invalid frame: expected shape (" +
+                                std::to_string(recorder.rows()) + ", " +
+                                std::to_string(recorder.cols()) + ")");
+  }
+  auto no_gil = pybind11::gil_scoped_release();
+  recorder.append(frame.data(), timestamp, metadata.value_or(FrameMetadata{}));
+}
+
+static void Recorder_append_frames_(
+    Recorder &recorder,
+    pybind11::array_t<uint16_t, pybind11::array::c_style> frames,
+    pybind11::array_t<std::int64_t, pybind11::array::c_style> timestamps,
+    std::optional<pybind11::array_t<FrameMetadata, pybind11::array::c_style>>
+        metadata) {
+  auto count = timestamps.size();
+  Recorder_check_frames_(recorder, frames, count);
+  if (timestamps.ndim() != 1 || (metadata && metadata->size() != count)) {
+    throw std::invalid_argument(
+        "Invalid timestamps/metadata: must have one element per frame");
+  }
+
+  const auto *frames_data = frames.data();
+  const auto *timestamps_data = timestamps.data();
+  const auto *metadata_data = metadata ? metadata->data() : nullptr;
+  auto frame_size = static_cast<std::size_t>(recorder.rows() * recorder.cols());
+  auto no_gil = pybind11::gil_scoped_release();
+  for (std::size_t i = 0; i < static_cast<std::size_t>(count); i++) {
+    auto timestamp = std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(timestamps_data[i])));
+    recorder.append(frames_data + i * frame_size, timestamp,
+                    metadata_data ? metadata_data[i] : FrameMetadata{});
+  }
+}
+
+/**
+ * Returns `[start, stop)`, or throws if it isn't a valid range of frames.
+ *
+ * If @p stop is not set, the range ends at the last frame.
+ */
+static std::tuple<std::size_t, std::size_t> RecordingReader_range_(
+    const RecordingReader &reader, std::size_t start,
+    std::optional<std::size_t> stop) {
+  auto end = stop.value_or(reader.size());
+  if (start > end || end > reader.size()) {
+    throw std::out_of_range("Invalid frame range [" + std::to_string(start) +
+                            ", " + std::to_string(end) +
+                            ") for a recording of " +
+                            std::to_string(reader.size()) + " frames");
+  }
+  return {start, end};
+}
+
+/**
+ * Creates a read-only numpy view of a field in each record of a recording.
+ *
+ * @param self The RecordingReader, which is kept alive by the view.
+ * @param offset The offset of the field inside each record.
+ * @param item_shape The shape of the field, e.g. `{rows, cols}` for frames.
+ */
+template <typename T>
+static pybind11::array_t<T> RecordingReader_view_(
+    pybind11::object self, std::size_t start, std::optional<std::size_t> stop,
+    std::size_t offset, std::vector<pybind11::ssize_t> item_shape) {
+  const auto &reader = self.cast<const RecordingReader &>();
+  auto [first, last] = RecordingReader_range_(reader, start, stop);
+
+  auto shape = std::vector<pybind11::ssize_t>{
+      static_cast<pybind11::ssize_t>(last - first)};
+  auto strides = std::vector<pybind11::ssize_t>{
+      static_cast<pybind11::ssize_t>(reader.record_size())};
+  shape.insert(shape.end(), item_shape.begin(), item_shape.end());
+  // items are C-contiguous inside each record
+  auto item_strides = std::vector<pybind11::ssize_t>(item_shape.size());
+  auto stride = static_cast<pybind11::ssize_t>(sizeof(T));
+  for (auto i = item_shape.size(); i-- > 0;) {
+    item_strides[i] = stride;
+    stride *= item_shape[i];
+  }
+  strides.insert(strides.end(), item_strides.begin(), item_strides.end());
+
+  // an empty recording may not have any records to point to
+  const auto *data = reader.size() == 0 ? nullptr
+                                        : reader.records() +
+                                              first * reader.record_size() +
+                                              offset;
+  auto view = pybind11::array_t<T>(shape, strides,
+                                   reinterpret_cast<const T *>(data), self);
+  // the recording is mapped read-only, so writing would crash
+  pybind11::detail::array_proxy(view.ptr())->flags &=
+      ~pybind11::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+  return view;
+}
+
+static constexpr auto RecordingReader_frames_doc_ =
+    R"(Return a range of frames, without copying them.
+
+Args:
+    start: The index of the first frame.
+    stop: The index after the last frame, or ``None`` for the end of the
+        recording.
+
+Returns:
+    A read-only ``(stop - start, rows, columns)`` ``uint16`` view of the
+    memory-mapped recording. Frames are only read from disk when they are
+    accessed. The view keeps the recording open.
+
+Raises:
+    IndexError: If ``start``/``stop`` are out of range.)";
+
+static constexpr auto RecordingReader_timestamps_doc_ =
+    R"(Return a view of the monotonic timestamps of a range of frames.
+
+Returns:
+    A read-only ``(stop - start,)`` ``int64`` array of timestamps, in
+    nanoseconds, see :py:meth:`frames`.)";
+
+static constexpr auto RecordingReader_metadata_doc_ =
+    R"(Return a view of the metadata of a range of frames.
+
+Returns:
+    A read-only ``(stop - start,)`` structured array of each frame's
+    :py:class:`FrameMetadata`, see :py:meth:`frames`.)";
+
+/**
+ * Converts each frame in @p frame_set to a `(frame, monotonic_time,
+ * metadata)` tuple.
+ */
+static pybind11::list CameraGroup_frame_set_to_list_(
+    CameraGroup &camera_group,
+    std::vector<CameraGroup::CameraFrame> frame_set) {
+  auto list = pybind11::list();
+  for (std::size_t i = 0; i < frame_set.size(); i++) {
+    auto &[thermal_frame, time_point, metadata] = frame_set[i];
+    list.append(pybind11::make_tuple(
+        IRImager_frame_to_numpy_(camera_group.camera(i),
+                                 std::move(thermal_frame)),
+        time_point, metadata));
+  }
+  return list;
+}
+
+static pybind11::list CameraGroup_get_frame_set_(
+    CameraGroup &camera_group, std::chrono::duration<double> tolerance) {
+  auto frame_set = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return camera_group.get_frame_set(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            tolerance));
+  }();
+  return CameraGroup_frame_set_to_list_(camera_group, std::move(frame_set));
+}
+
+static std::optional<pybind11::list> CameraGroup_try_get_frame_set_(
+    CameraGroup &camera_group, std::chrono::duration<double> tolerance,
+    std::chrono::duration<double> timeout) {
+  auto frame_set = [&]() {
+    auto no_gil = pybind11::gil_scoped_release();
+    return camera_group.try_get_frame_set(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            tolerance),
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            timeout));
+  }();
+  if (!frame_set) {
+    return std::nullopt;
+  }
+  return CameraGroup_frame_set_to_list_(camera_group, std::move(*frame_set));
+}
+
+static constexpr auto CameraGroup_get_frame_set_doc_ =
+    R"(Return a frame from every camera, all taken at around the same time.
+
+The reference time is the newest frame of the camera that is furthest behind,
+and every other camera's frame is the one closest to it. Each returned frame,
+and any older frames, are removed from the history, so consecutive frame sets
+never share frames.
+
+Args:
+    tolerance: The maximum skew, i.e. the time between the oldest and newest
+        frame in the set. If the closest frames are further apart than this,
+        wait for new frames.
+
+Raises:
+    RuntimeError: If no frame set arrives within 30 seconds, or if the cameras
+        aren't streaming.
+
+Returns:
+    A list with a ``(frame, monotonic_time, metadata)`` tuple for each camera,
+    in the same order as the cameras, see
+    :py:meth:`IRImager.get_frame_with_metadata`. ``monotonic_time`` is a
+    monotonic timestamp, see :py:meth:`IRImager.get_frame_monotonic`.)";
+
+static constexpr auto CameraGroup_try_get_frame_set_doc_ =
+    R"(Return a frame set, or ``None`` if none arrives within ``timeout``.
+
+Similar to :py:meth:`get_frame_set`, except that this never waits for longer
+than ``timeout``.)";
+
 PYBIND11_MODULE(irimager, m) {
   m.doc() = R"(Optris PI and XI imager IR camera controller
 
@@ -48,43 +654,753 @@ to control these cameras.)";
   m.def("monotonic_to_system_clock", &nqm::irimager::clock_cast,
         DOC(nqm, irimager, clock_cast), no_gil);
 
+  pybind11::enum_<TemperatureUnit>(m, "TemperatureUnit", DOC(TemperatureUnit))
+      .value("CELSIUS", TemperatureUnit::CELSIUS,
+             DOC(TemperatureUnit, CELSIUS))
+      .value("KELVIN", TemperatureUnit::KELVIN, DOC(TemperatureUnit, KELVIN));
+
+  m.def("raw_to_temperature", &raw_to_temperature_, pybind11::arg("raw"),
+        pybind11::arg("temp_range_decimal"),
+        pybind11::arg("unit") = TemperatureUnit::CELSIUS,
+        // don't convert, otherwise we'd write to a temporary copy
+        pybind11::arg("out").noconvert() = pybind11::none(),
+        R"(Converts raw thermal data to ``float32`` temperatures.
+
+Computes ``raw / 10 ** temp_range_decimal - 100`` (plus ``273.15`` for
+Kelvin) in a single vectorised pass, without any temporary arrays.
+
+Args:
+    raw: A C-contiguous ``uint16`` array of any shape, e.g. from
+        :py:meth:`IRImager.get_frame` or :py:meth:`IRImager.get_frames`.
+    temp_range_decimal: See :py:meth:`IRImager.get_temp_range_decimal`.
+    unit: The unit of temperature to output.
+    out: If set, a C-contiguous ``float32`` array with the same shape as
+        ``raw``, that the temperatures are written to.
+
+Returns:
+    The temperatures, in ``out`` if it was given.)");
+
+  pybind11::class_<Histogram>(m, "Histogram", DOC(Histogram))
+      .def(pybind11::init<std::uint16_t>(), pybind11::arg("bin_width") = 1,
+           DOC(Histogram, Histogram))
+      .def_property_readonly("bin_width", &Histogram::bin_width,
+                             DOC(Histogram, bin_width))
+      .def_property_readonly("count", &Histogram::count,
+                             DOC(Histogram, count))
+      .def("clear", &Histogram::clear, DOC(Histogram, clear), no_gil)
+      .def(
+          "add",
+          [](Histogram &histogram,
+             pybind11::array_t<std::uint16_t, pybind11::array::c_style>
+                 values) {
+            auto data = values.data();
+            auto size = static_cast<std::size_t>(values.size());
+            auto no_gil = pybind11::gil_scoped_release();
+            histogram.add(data, size);
+          },
+          pybind11::arg("values"),
+          R"(Adds raw thermal data to the histogram.
+
+Args:
+    values: A ``uint16`` array of any shape, e.g. a frame from
+        :py:meth:`IRImager.get_frame`, a slice of a frame, or the pixels
+        selected by a boolean mask.)")
+      .def(
+          "counts",
+          [](const Histogram &histogram) {
+            const auto &counts = histogram.counts();
+            return pybind11::array_t<std::uint64_t>(
+                static_cast<pybind11::ssize_t>(counts.size()), counts.data());
+          },
+          DOC(Histogram, counts))
+      .def("quantile", &Histogram::quantile, pybind11::arg("q"),
+           DOC(Histogram, quantile), no_gil)
+      .def(
+          "quantiles",
+          [](const Histogram &histogram,
+             pybind11::array_t<double, pybind11::array::c_style |
+                                           pybind11::array::forcecast>
+                 q) {
+            auto out = pybind11::array_t<std::uint16_t>(q.size());
+            auto q_data = q.data();
+            auto out_data = out.mutable_data();
+            auto size = static_cast<std::size_t>(q.size());
+            {
+              auto no_gil = pybind11::gil_scoped_release();
+              histogram.quantiles(q_data, out_data, size);
+            }
+            return out;
+          },
+          pybind11::arg("q"),
+          R"(Computes multiple quantiles, see :py:meth:`quantile`.
+
+If ``q`` is sorted, all quantiles are computed in a single pass.
+
+Args:
+    q: The quantiles to compute, from ``0.0`` to ``1.0``.
+
+Returns:
+    A ``uint16`` array of the raw value of each quantile.)");
+
+  pybind11::enum_<BinningMode>(m, "BinningMode", DOC(BinningMode))
+      .value("MEAN", BinningMode::MEAN, DOC(BinningMode, MEAN))
+      .value("MAX", BinningMode::MAX, DOC(BinningMode, MAX));
+
+  pybind11::class_<FrameTransform>(m, "FrameTransform", DOC(FrameTransform))
+      .def(pybind11::init([](Eigen::Index row, Eigen::Index col,
+                             Eigen::Index height, Eigen::Index width,
+                             Eigen::Index binning, BinningMode binning_mode) {
+             return FrameTransform{row,    col,     height,
+                                   width,  binning, binning_mode};
+           }),
+           pybind11::arg("row") = 0, pybind11::arg("col") = 0,
+           pybind11::arg("height") = 0, pybind11::arg("width") = 0,
+           pybind11::arg("binning") = 1,
+           pybind11::arg("binning_mode") = BinningMode::MEAN)
+      .def_readwrite("row", &FrameTransform::row, DOC(FrameTransform, row))
+      .def_readwrite("col", &FrameTransform::col, DOC(FrameTransform, col))
+      .def_readwrite("height", &FrameTransform::height,
+                     DOC(FrameTransform, height))
+      .def_readwrite("width", &FrameTransform::width,
+                     DOC(FrameTransform, width))
+      .def_readwrite("binning", &FrameTransform::binning,
+                     DOC(FrameTransform, binning))
+      .def_readwrite("binning_mode", &FrameTransform::binning_mode,
+                     DOC(FrameTransform, binning_mode));
+
+  pybind11::class_<FrameEncoder>(m, "FrameEncoder", DOC(FrameEncoder))
+      .def(pybind11::init<Eigen::Index, Eigen::Index, std::size_t>(),
+           pybind11::arg("rows"), pybind11::arg("cols"),
+           pybind11::arg("keyframe_interval") = 64,
+           DOC(FrameEncoder, FrameEncoder))
+      .def(
+          "encode",
+          [](FrameEncoder &encoder,
+             pybind11::array_t<std::uint16_t, pybind11::array::c_style>
+                 frame) {
+            if (frame.ndim() != 2 || frame.shape(0) != encoder.rows() ||
+                frame.shape(1) != encoder.cols()) {
+              throw std::invalid_argument(
+                  "Invalid frame: expected shape (" +
+                  std::to_string(encoder.rows()) + ", " +
+                  std::to_string(encoder.cols()) + ")");
+            }
+            auto encoded = std::vector<std::uint8_t>();
+            {
+              auto no_gil = pybind11::gil_scoped_release();
+              encoded.reserve(encoder.max_encoded_size());
+              encoder.encode(frame.data(), encoded);
+            }
+            return pybind11::bytes(
+                reinterpret_cast<const char *>(encoded.data()),
+                encoded.size());
+          },
+          pybind11::arg("frame"),
+          R"(Encodes a frame.
+
+Args:
+    frame: A C-contiguous ``uint16`` frame with shape ``(rows, cols)``,
+        e.g. from :py:meth:`IRImager.get_frame`.
+
+Returns:
+    The encoded frame, which must be decoded by a :py:class:`FrameDecoder`
+    in the same order as it was encoded.)")
+      .def_property_readonly("rows", &FrameEncoder::rows,
+                             DOC(FrameEncoder, rows))
+      .def_property_readonly("cols", &FrameEncoder::cols,
+                             DOC(FrameEncoder, cols))
+      .def("request_keyframe", &FrameEncoder::request_keyframe,
+           DOC(FrameEncoder, request_keyframe))
+      .def_property_readonly("max_encoded_size",
+                             &FrameEncoder::max_encoded_size,
+                             DOC(FrameEncoder, max_encoded_size));
+
+  pybind11::class_<FrameDecoder>(m, "FrameDecoder", DOC(FrameDecoder))
+      .def(pybind11::init<>())
+      .def(
+          "decode",
+          [](FrameDecoder &decoder, pybind11::buffer data) {
+            auto info = data.request();
+            if (info.itemsize != 1 || info.ndim != 1 || info.strides[0] != 1) {
+              throw std::invalid_argument(
+                  "Invalid encoded frame: must be a contiguous bytes-like "
+                  "object");
+            }
+            const auto *bytes = static_cast<const std::uint8_t *>(info.ptr);
+            auto size = static_cast<std::size_t>(info.size);
+            auto [rows, cols] = FrameDecoder::frame_shape(bytes, size);
+            auto frame = pybind11::array_t<std::uint16_t>({rows, cols});
+            auto frame_data = frame.mutable_data();
+            {
+              auto no_gil = pybind11::gil_scoped_release();
+              decoder.decode(bytes, size, frame_data);
+            }
+            return frame;
+          },
+          pybind11::arg("data"),
+          R"(Decodes a frame.
+
+Args:
+    data: A frame encoded by :py:meth:`FrameEncoder.encode`, e.g. as
+        ``bytes`` or a ``memoryview``.
+
+Returns:
+    The decoded ``uint16`` frame.
+
+Raises:
+    ValueError: If ``data`` is not a valid encoded frame.
+    RuntimeError: If ``data`` is not a keyframe, and the frame before it
+        was not decoded.)")
+      .def_static(
+          "is_keyframe",
+          [](pybind11::bytes data) {
+            auto view = std::string_view(data);
+            return FrameDecoder::is_keyframe(
+                reinterpret_cast<const std::uint8_t *>(view.data()),
+                view.size());
+          },
+          pybind11::arg("data"), DOC(FrameDecoder, is_keyframe))
+      .def("reset", &FrameDecoder::reset, DOC(FrameDecoder, reset));
+
+  pybind11::enum_<TemporalFilterMode>(m, "TemporalFilterMode",
+                                      DOC(TemporalFilterMode))
+      .value("EMA", TemporalFilterMode::EMA, DOC(TemporalFilterMode, EMA))
+      .value("MAX_HOLD", TemporalFilterMode::MAX_HOLD,
+             DOC(TemporalFilterMode, MAX_HOLD))
+      .value("MIN_HOLD", TemporalFilterMode::MIN_HOLD,
+             DOC(TemporalFilterMode, MIN_HOLD))
+      .value("MEAN", TemporalFilterMode::MEAN, DOC(TemporalFilterMode, MEAN));
+
+  pybind11::class_<TemporalFilter>(m, "TemporalFilter", DOC(TemporalFilter))
+      .def(pybind11::init<Eigen::Index, Eigen::Index, TemporalFilterMode,
+                          std::size_t, float>(),
+           pybind11::arg("rows"), pybind11::arg("cols"), pybind11::arg("mode"),
+           pybind11::arg("window") = 8, pybind11::arg("alpha") = 0.125f,
+           DOC(TemporalFilter, TemporalFilter))
+      .def_property_readonly("rows", &TemporalFilter::rows,
+                             DOC(TemporalFilter, rows))
+      .def_property_readonly("cols", &TemporalFilter::cols,
+                             DOC(TemporalFilter, cols))
+      .def_property_readonly("mode", &TemporalFilter::mode,
+                             DOC(TemporalFilter, mode))
+      .def_property_readonly("window", &TemporalFilter::window,
+                             DOC(TemporalFilter, window))
+      .def_property_readonly("alpha", &TemporalFilter::alpha,
+                             DOC(TemporalFilter, alpha))
+      .def_property_readonly("count", &TemporalFilter::count,
+                             DOC(TemporalFilter, count))
+      .def("push", &TemporalFilter::push, pybind11::arg("frame"),
+           DOC(TemporalFilter, push), no_gil)
+      // don't convert, otherwise we'd write to a temporary copy
+      .def("apply", &TemporalFilter::apply, pybind11::arg("frame").noconvert(),
+           DOC(TemporalFilter, apply), no_gil)
+      .def(
+          "snapshot",
+          [](const TemporalFilter &filter) {
+            // copy, since the snapshot is overwritten by the next push()
+            return TemporalFilter::Frame(filter.snapshot());
+          },
+          DOC(TemporalFilter, snapshot))
+      .def("reset", &TemporalFilter::reset, DOC(TemporalFilter, reset),
+           no_gil);
+
+  pybind11::enum_<RoiStat>(m, "RoiStat", DOC(RoiStat))
+      .value("MIN", RoiStat::MIN, DOC(RoiStat, MIN))
+      .value("MAX", RoiStat::MAX, DOC(RoiStat, MAX))
+      .value("MEAN", RoiStat::MEAN, DOC(RoiStat, MEAN))
+      .value("STDDEV", RoiStat::STDDEV, DOC(RoiStat, STDDEV));
+
+  pybind11::enum_<HotspotStat>(m, "HotspotStat", DOC(HotspotStat))
+      .value("AREA", HotspotStat::AREA, DOC(HotspotStat, AREA))
+      .value("CENTROID_ROW", HotspotStat::CENTROID_ROW,
+             DOC(HotspotStat, CENTROID_ROW))
+      .value("CENTROID_COL", HotspotStat::CENTROID_COL,
+             DOC(HotspotStat, CENTROID_COL))
+      .value("ROW", HotspotStat::ROW, DOC(HotspotStat, ROW))
+      .value("COL", HotspotStat::COL, DOC(HotspotStat, COL))
+      .value("HEIGHT", HotspotStat::HEIGHT, DOC(HotspotStat, HEIGHT))
+      .value("WIDTH", HotspotStat::WIDTH, DOC(HotspotStat, WIDTH))
+      .value("PEAK", HotspotStat::PEAK, DOC(HotspotStat, PEAK))
+      .value("MEAN", HotspotStat::MEAN, DOC(HotspotStat, MEAN));
+
+  pybind11::enum_<HotspotThreshold>(m, "HotspotThreshold",
+                                    DOC(HotspotThreshold))
+      .value("ABSOLUTE", HotspotThreshold::ABSOLUTE,
+             DOC(HotspotThreshold, ABSOLUTE))
+      .value("RELATIVE", HotspotThreshold::RELATIVE,
+             DOC(HotspotThreshold, RELATIVE));
+
+  pybind11::class_<HotspotDetector>(m, "HotspotDetector", DOC(HotspotDetector))
+      .def(pybind11::init<Eigen::Index, Eigen::Index, float, HotspotThreshold,
+                          std::size_t, int>(),
+           pybind11::arg("rows"), pybind11::arg("cols"),
+           pybind11::arg("threshold"),
+           pybind11::arg("threshold_mode") = HotspotThreshold::ABSOLUTE,
+           pybind11::arg("min_area") = 1, pybind11::arg("connectivity") = 8,
+           DOC(HotspotDetector, HotspotDetector))
+      .def_property_readonly("rows", &HotspotDetector::rows,
+                             DOC(HotspotDetector, rows))
+      .def_property_readonly("cols", &HotspotDetector::cols,
+                             DOC(HotspotDetector, cols))
+      .def_property_readonly("threshold", &HotspotDetector::threshold,
+                             DOC(HotspotDetector, threshold))
+      .def_property_readonly("threshold_mode",
+                             &HotspotDetector::threshold_mode,
+                             DOC(HotspotDetector, threshold_mode))
+      .def_property_readonly("min_area", &HotspotDetector::min_area,
+                             DOC(HotspotDetector, min_area))
+      .def_property_readonly("connectivity", &HotspotDetector::connectivity,
+                             DOC(HotspotDetector, connectivity))
+      .def("set_threshold", &HotspotDetector::set_threshold,
+           pybind11::arg("threshold"), pybind11::arg("threshold_mode"),
+           DOC(HotspotDetector, set_threshold))
+      .def("set_background_rectangle",
+           &HotspotDetector::set_background_rectangle, pybind11::arg("row"),
+           pybind11::arg("col"), pybind11::arg("height"),
+           pybind11::arg("width"),
+           DOC(HotspotDetector, set_background_rectangle))
+      .def("set_background_polygon", &HotspotDetector::set_background_polygon,
+           pybind11::arg("vertices"),
+           DOC(HotspotDetector, set_background_polygon))
+      .def("clear_background", &HotspotDetector::clear_background,
+           DOC(HotspotDetector, clear_background))
+      .def("detect", &HotspotDetector::detect, pybind11::arg("frame"),
+           pybind11::arg("temp_range_decimal"), DOC(HotspotDetector, detect),
+           no_gil);
+
+  pybind11::class_<BufferPoolStats>(m, "BufferPoolStats", DOC(BufferPoolStats))
+      .def_readonly("hits", &BufferPoolStats::hits, DOC(BufferPoolStats, hits))
+      .def_readonly("misses", &BufferPoolStats::misses,
+                    DOC(BufferPoolStats, misses))
+      .def_readonly("available", &BufferPoolStats::available,
+                    DOC(BufferPoolStats, available));
+
+  pybind11::class_<LatencyStats>(m, "LatencyStats", DOC(LatencyStats))
+      .def_readonly("count", &LatencyStats::count, DOC(LatencyStats, count))
+      .def_readonly("p50", &LatencyStats::p50, DOC(LatencyStats, p50))
+      .def_readonly("p99", &LatencyStats::p99, DOC(LatencyStats, p99))
+      .def_readonly("max", &LatencyStats::max, DOC(LatencyStats, max))
+      .def_readonly("mean", &LatencyStats::mean, DOC(LatencyStats, mean));
+
+  pybind11::class_<PipelineStats>(m, "PipelineStats", DOC(PipelineStats))
+      .def_readonly("acquire", &PipelineStats::acquire,
+                    DOC(PipelineStats, acquire))
+      .def_readonly("process", &PipelineStats::process,
+                    DOC(PipelineStats, process))
+      .def_readonly("handoff", &PipelineStats::handoff,
+                    DOC(PipelineStats, handoff))
+      .def_readonly("convert", &PipelineStats::convert,
+                    DOC(PipelineStats, convert))
+      .def_readonly("delivery", &PipelineStats::delivery,
+                    DOC(PipelineStats, delivery))
+      .def_readonly("flag_closures", &PipelineStats::flag_closures,
+                    DOC(PipelineStats, flag_closures))
+      .def_readonly("frames_acquired", &PipelineStats::frames_acquired,
+                    DOC(PipelineStats, frames_acquired))
+      .def_readonly("frames_shutter_closed",
+                    &PipelineStats::frames_shutter_closed,
+                    DOC(PipelineStats, frames_shutter_closed))
+      .def_readonly("frames_delivered", &PipelineStats::frames_delivered,
+                    DOC(PipelineStats, frames_delivered))
+      .def_readonly("frames_dropped", &PipelineStats::frames_dropped,
+                    DOC(PipelineStats, frames_dropped))
+      .def_readonly("frames_overrun", &PipelineStats::frames_overrun,
+                    DOC(PipelineStats, frames_overrun));
+
+  pybind11::class_<ThreadScheduling>(m, "ThreadScheduling",
+                                     DOC(ThreadScheduling))
+      .def(pybind11::init([](std::vector<std::size_t> cpus,
+                             std::optional<int> fifo_priority,
+                             std::optional<int> nice) {
+             auto thread_scheduling =
+                 ThreadScheduling{std::move(cpus), fifo_priority, nice};
+             thread_scheduling.validate();
+             return thread_scheduling;
+           }),
+           pybind11::arg("cpus") = std::vector<std::size_t>(),
+           pybind11::arg("fifo_priority") = std::nullopt,
+           pybind11::arg("nice") = std::nullopt)
+      .def_readwrite("cpus", &ThreadScheduling::cpus,
+                     DOC(ThreadScheduling, cpus))
+      .def_readwrite("fifo_priority", &ThreadScheduling::fifo_priority,
+                     DOC(ThreadScheduling, fifo_priority))
+      .def_readwrite("nice", &ThreadScheduling::nice,
+                     DOC(ThreadScheduling, nice));
+
+  pybind11::class_<AppliedThreadScheduling>(m, "AppliedThreadScheduling",
+                                            DOC(AppliedThreadScheduling))
+      .def_readonly("cpus", &AppliedThreadScheduling::cpus,
+                    DOC(AppliedThreadScheduling, cpus))
+      .def_readonly("fifo_priority", &AppliedThreadScheduling::fifo_priority,
+                    DOC(AppliedThreadScheduling, fifo_priority))
+      .def_readonly("nice", &AppliedThreadScheduling::nice,
+                    DOC(AppliedThreadScheduling, nice))
+      .def_readonly("errors", &AppliedThreadScheduling::errors,
+                    DOC(AppliedThreadScheduling, errors));
+
+  pybind11::enum_<FlagState>(m, "FlagState", DOC(FlagState))
+      .value("OPEN", FlagState::OPEN, DOC(FlagState, OPEN))
+      .value("CLOSED", FlagState::CLOSED, DOC(FlagState, CLOSED))
+      .value("OPENING", FlagState::OPENING, DOC(FlagState, OPENING))
+      .value("CLOSING", FlagState::CLOSING, DOC(FlagState, CLOSING))
+      .value("ERROR", FlagState::ERROR, DOC(FlagState, ERROR));
+
+  PYBIND11_NUMPY_DTYPE(FrameMetadata, counter, counter_hw, flag_state,
+                       temp_chip, temp_flag, temp_box, sequence);
+  pybind11::class_<FrameMetadata>(m, "FrameMetadata", DOC(FrameMetadata))
+      .def_readonly("counter", &FrameMetadata::counter,
+                    DOC(FrameMetadata, counter))
+      .def_readonly("counter_hw", &FrameMetadata::counter_hw,
+                    DOC(FrameMetadata, counter_hw))
+      .def_readonly("flag_state", &FrameMetadata::flag_state,
+                    DOC(FrameMetadata, flag_state))
+      .def_readonly("temp_chip", &FrameMetadata::temp_chip,
+                    DOC(FrameMetadata, temp_chip))
+      .def_readonly("temp_flag", &FrameMetadata::temp_flag,
+                    DOC(FrameMetadata, temp_flag))
+      .def_readonly("temp_box", &FrameMetadata::temp_box,
+                    DOC(FrameMetadata, temp_box))
+      .def_readonly("sequence", &FrameMetadata::sequence,
+                    DOC(FrameMetadata, sequence))
+      .def_property_readonly("stale", &FrameMetadata::is_stale,
+                             DOC(FrameMetadata, is_stale));
+
+  pybind11::class_<Recorder>(m, "Recorder", DOC(Recorder))
+      .def(pybind11::init<const std::filesystem::path &, Eigen::Index,
+                          Eigen::Index, short, std::size_t>(),
+           pybind11::arg("path"), pybind11::arg("rows"), pybind11::arg("cols"),
+           pybind11::arg("temp_range_decimal"),
+           pybind11::arg("frames_per_chunk") = 256,
+           DOC(Recorder, Recorder), no_gil)
+      .def("append", &Recorder_append_, pybind11::arg("frame"),
+           pybind11::arg("timestamp"), pybind11::arg("metadata") = std::nullopt,
+           R"(Appends a frame to the recording.
+
+Args:
+    frame: A C-contiguous ``uint16`` frame with shape ``(rows, cols)``,
+        e.g. from :py:meth:`IRImager.get_frame_monotonic`.
+    timestamp: The monotonic time of the frame, must not be earlier than the
+        timestamp of the previous frame.
+    metadata: The metadata of the frame, see
+        :py:meth:`IRImager.get_frame_with_metadata`.
+
+Raises:
+    ValueError: If ``frame`` has the wrong shape, or ``timestamp`` is out of
+        order.)")
+      .def("append_frames", &Recorder_append_frames_, pybind11::arg("frames"),
+           pybind11::arg("timestamps"),
+           pybind11::arg("metadata") = std::nullopt,
+           R"(Appends multiple frames to the recording.
+
+Accepts the arrays returned by :py:meth:`IRImager.get_frames`.
+
+Args:
+    frames: A C-contiguous ``(count, rows, cols)`` ``uint16`` array.
+    timestamps: A ``(count,)`` ``int64`` array of monotonic timestamps, in
+        nanoseconds.
+    metadata: A ``(count,)`` structured array of :py:class:`FrameMetadata`.)")
+      .def("close", &Recorder::close, DOC(Recorder, close), no_gil)
+      .def_property_readonly("closed", &Recorder::closed,
+                             DOC(Recorder, closed))
+      .def_property_readonly("rows", &Recorder::rows, DOC(Recorder, rows))
+      .def_property_readonly("cols", &Recorder::cols, DOC(Recorder, cols))
+      .def("__len__", &Recorder::size, DOC(Recorder, size))
+      .def("__enter__", [](pybind11::object self) { return self; })
+      .def("__exit__",
+           [](Recorder &recorder,
+              [[maybe_unused]] const std::optional<pybind11::type>,
+              [[maybe_unused]] const std::optional<pybind11::object>,
+              [[maybe_unused]] const std::optional<pybind11::object>) {
+             recorder.close();
+           });
+
+  pybind11::class_<RecordingReader>(m, "RecordingReader", DOC(RecordingReader))
+      .def(pybind11::init<const std::filesystem::path &>(),
+           pybind11::arg("path"), DOC(RecordingReader, RecordingReader), no_gil)
+      .def("__len__", &RecordingReader::size, DOC(RecordingReader, size))
+      .def_property_readonly("rows", &RecordingReader::rows,
+                             DOC(RecordingReader, rows))
+      .def_property_readonly("cols", &RecordingReader::cols,
+                             DOC(RecordingReader, cols))
+      .def_property_readonly("temp_range_decimal",
+                             &RecordingReader::temp_range_decimal,
+                             DOC(RecordingReader, temp_range_decimal))
+      .def_property_readonly("has_index", &RecordingReader::has_index,
+                             DOC(RecordingReader, has_index))
+      .def(
+          "frames",
+          [](pybind11::object self, std::size_t start,
+             std::optional<std::size_t> stop) {
+            const auto &reader = self.cast<const RecordingReader &>();
+            return RecordingReader_view_<uint16_t>(
+                self, start, stop, RecordingReader::FRAME_OFFSET,
+                {reader.rows(), reader.cols()});
+          },
+          pybind11::arg("start") = 0, pybind11::arg("stop") = std::nullopt,
+          RecordingReader_frames_doc_)
+      .def(
+          "timestamps",
+          [](pybind11::object self, std::size_t start,
+             std::optional<std::size_t> stop) {
+            return RecordingReader_view_<std::int64_t>(self, start, stop, 0,
+                                                       {});
+          },
+          pybind11::arg("start") = 0, pybind11::arg("stop") = std::nullopt,
+          RecordingReader_timestamps_doc_)
+      .def(
+          "metadata",
+          [](pybind11::object self, std::size_t start,
+             std::optional<std::size_t> stop) {
+            return RecordingReader_view_<FrameMetadata>(
+                self, start, stop, RecordingReader::METADATA_OFFSET, {});
+          },
+          pybind11::arg("start") = 0, pybind11::arg("stop") = std::nullopt,
+          RecordingReader_metadata_doc_)
+      .def("seek", &RecordingReader::seek, pybind11::arg("timestamp"),
+           DOC(RecordingReader, seek), no_gil);
+
+  pybind11::enum_<OverflowPolicy>(m, "OverflowPolicy", DOC(OverflowPolicy))
+      .value("BLOCK", OverflowPolicy::BLOCK, DOC(OverflowPolicy, BLOCK))
+      .value("DROP_OLDEST", OverflowPolicy::DROP_OLDEST,
+             DOC(OverflowPolicy, DROP_OLDEST))
+      .value("DROP_NEWEST", OverflowPolicy::DROP_NEWEST,
+             DOC(OverflowPolicy, DROP_NEWEST));
+
+  pybind11::enum_<ShutterPolicy>(m, "ShutterPolicy", DOC(ShutterPolicy))
+      .value("WAIT", ShutterPolicy::WAIT, DOC(ShutterPolicy, WAIT))
+      .value("RETURN_STALE", ShutterPolicy::RETURN_STALE,
+             DOC(ShutterPolicy, RETURN_STALE));
+
+  pybind11::class_<FrameStream>(
+      m, "FrameStream",
+      "Asynchronous iterator over frames, see :py:meth:`IRImager.stream`.")
+      .def("__aiter__", [](pybind11::object self) { return self; })
+      .def("__anext__", [](const FrameStream &frame_stream) {
+        return IRImager_next_frame_future_(frame_stream.irimager, true);
+      });
+
   pybind11::class_<IRImager>(m, "IRImager", DOC(IRImager))
       .def(pybind11::init<const std::filesystem::path &>(),
            DOC(IRImager, IRImager), no_gil)
-      .def("get_frame", &IRImager::get_frame, DOC(IRImager, get_frame), no_gil)
-      .def("get_frame_monotonic", &IRImager::get_frame_monotonic,
-           DOC(IRImager, get_frame_monotonic), no_gil)
+      .def("get_frame", &IRImager_get_frame_, DOC(IRImager, get_frame))
+      .def("get_frame_monotonic", &IRImager_get_frame_monotonic_,
+           DOC(IRImager, get_frame_monotonic))
+      .def("get_frame_celsius", &IRImager_get_frame_celsius_,
+           IRImager_get_frame_celsius_doc_)
+      .def("get_frame_with_metadata", &IRImager_get_frame_with_metadata_,
+           IRImager_get_frame_with_metadata_doc_)
+      .def("get_frame_async", &IRImager_get_frame_async_,
+           IRImager_get_frame_async_doc_)
+      .def(
+          "stream",
+          [](pybind11::object self) { return FrameStream{std::move(self)}; },
+          IRImager_stream_doc_)
+      .def("try_get_frame", &IRImager_try_get_frame_, pybind11::arg("timeout"),
+           IRImager_try_get_frame_doc_)
+      .def("try_get_frame_monotonic", &IRImager_try_get_frame_monotonic_,
+           pybind11::arg("timeout"), IRImager_try_get_frame_monotonic_doc_)
+      .def("get_frames", &IRImager_get_frames_, pybind11::arg("count"),
+           pybind11::arg("timeout") = std::chrono::duration<double>(30.0),
+           IRImager_get_frames_doc_)
+      .def("get_frame_shape", &IRImager::get_frame_shape,
+           DOC(IRImager, get_frame_shape), no_gil)
+      .def("get_frame_into", &IRImager::get_frame_into, pybind11::arg("out"),
+           DOC(IRImager, get_frame_into), no_gil)
+      .def("get_frame_monotonic_into", &IRImager::get_frame_monotonic_into,
+           pybind11::arg("out"), DOC(IRImager, get_frame_monotonic_into),
+           no_gil)
+      .def("get_temperature_frame_monotonic_into",
+           &IRImager::get_temperature_frame_monotonic_into,
+           pybind11::arg("out"),
+           pybind11::arg("unit") = TemperatureUnit::CELSIUS,
+           DOC(IRImager, get_temperature_frame_monotonic_into), no_gil)
+      .def("get_frame_event_fd", &IRImager::get_frame_event_fd,
+           DOC(IRImager, get_frame_event_fd), no_gil)
+      .def("is_streaming", &IRImager::is_streaming,
+           DOC(IRImager, is_streaming), no_gil)
+      .def("set_frame_callback", &IRImager_set_frame_callback_,
+           pybind11::arg("callback"), DOC(IRImager, set_frame_callback))
+      .def("set_acquisition_thread_scheduling",
+           &IRImager::set_acquisition_thread_scheduling,
+           pybind11::arg("thread_scheduling"),
+           DOC(IRImager, set_acquisition_thread_scheduling), no_gil)
+      .def("get_acquisition_thread_scheduling",
+           &IRImager::get_acquisition_thread_scheduling,
+           DOC(IRImager, get_acquisition_thread_scheduling), no_gil)
+      .def("get_frame_pool_stats", &IRImager::get_frame_pool_stats,
+           DOC(IRImager, get_frame_pool_stats), no_gil)
+      .def("get_stats", &IRImager::get_stats, DOC(IRImager, get_stats), no_gil)
+      .def("reset_stats", &IRImager::reset_stats, DOC(IRImager, reset_stats),
+           no_gil)
+      .def("set_frame_transform", &IRImager::set_frame_transform,
+           pybind11::arg("frame_transform"),
+           DOC(IRImager, set_frame_transform), no_gil)
+      .def("get_frame_transform", &IRImager::get_frame_transform,
+           DOC(IRImager, get_frame_transform), no_gil)
+      .def("add_roi_rectangle", &IRImager::add_roi_rectangle,
+           pybind11::arg("row"), pybind11::arg("col"), pybind11::arg("height"),
+           pybind11::arg("width"), DOC(IRImager, add_roi_rectangle), no_gil)
+      .def("add_roi_polygon", &IRImager::add_roi_polygon,
+           pybind11::arg("vertices"), DOC(IRImager, add_roi_polygon), no_gil)
+      .def("clear_rois", &IRImager::clear_rois, DOC(IRImager, clear_rois),
+           no_gil)
+      .def("get_roi_count", &IRImager::get_roi_count,
+           DOC(IRImager, get_roi_count), no_gil)
+      .def("set_roi_quantiles", &IRImager::set_roi_quantiles,
+           pybind11::arg("quantiles"), DOC(IRImager, set_roi_quantiles),
+           no_gil)
+      .def("get_roi_quantiles", &IRImager::get_roi_quantiles,
+           DOC(IRImager, get_roi_quantiles), no_gil)
+      .def("get_roi_stats", &IRImager_get_roi_stats_,
+           IRImager_get_roi_stats_doc_)
+      .def("get_roi_stats_monotonic_into",
+           &IRImager::get_roi_stats_monotonic_into, pybind11::arg("out"),
+           DOC(IRImager, get_roi_stats_monotonic_into), no_gil)
       .def("get_temp_range_decimal", &IRImager::get_temp_range_decimal,
            DOC(IRImager, get_temp_range_decimal), no_gil)
       .def("get_library_version", &IRImager::get_library_version,
            DOC(IRImager, get_library_version), no_gil)
       .def("start_streaming", &IRImager::start_streaming,
-           DOC(IRImager, start_streaming), no_gil)
+           DOC(IRImager, start_streaming),
+           pybind11::arg("frame_queue_size") = 0,
+           pybind11::arg("overflow_policy") = OverflowPolicy::DROP_NEWEST,
+           pybind11::arg("shutter_policy") = ShutterPolicy::WAIT,
+           no_gil)
       .def("stop_streaming", &IRImager::stop_streaming,
            DOC(IRImager, stop_streaming), no_gil)
       .def("__enter__", &IRImager_enter_,
            pybind11::return_value_policy::reference_internal, no_gil)
       .def("__exit__", &IRImager_exit_);
 
+  pybind11::enum_<ReplayTiming>(m, "ReplayTiming", DOC(ReplayTiming))
+      .value("ORIGINAL", ReplayTiming::ORIGINAL, DOC(ReplayTiming, ORIGINAL))
+      .value("AS_FAST_AS_POSSIBLE", ReplayTiming::AS_FAST_AS_POSSIBLE,
+             DOC(ReplayTiming, AS_FAST_AS_POSSIBLE));
+
+  pybind11::class_<SyntheticSceneOptions>(m, "SyntheticSceneOptions",
+                                         DOC(SyntheticSceneOptions))
+      .def(pybind11::init([](std::uint64_t seed, std::size_t hotspots,
+                             float noise, bool shutter_closures) {
+             return SyntheticSceneOptions{seed, hotspots, noise,
+                                          shutter_closures};
+           }),
+           pybind11::arg("seed") = 0, pybind11::arg("hotspots") = 3,
+           pybind11::arg("noise") = 0.5f,
+           pybind11::arg("shutter_closures") = true)
+      .def_readwrite("seed", &SyntheticSceneOptions::seed,
+                     DOC(SyntheticSceneOptions, seed))
+      .def_readwrite("hotspots", &SyntheticSceneOptions::hotspots,
+                     DOC(SyntheticSceneOptions, hotspots))
+      .def_readwrite("noise", &SyntheticSceneOptions::noise,
+                     DOC(SyntheticSceneOptions, noise))
+      .def_readwrite("shutter_closures",
+                     &SyntheticSceneOptions::shutter_closures,
+                     DOC(SyntheticSceneOptions, shutter_closures));
+
   pybind11::class_<IRImagerMock, IRImager>(m, "IRImagerMock", DOC(IRImagerMock))
       .def(pybind11::init<const std::filesystem::path &>(),
            DOC(IRImager, IRImager), no_gil)
-      .def("get_frame", &IRImagerMock::get_frame, DOC(IRImager, get_frame),
+      .def(pybind11::init<const std::filesystem::path &,
+                          const std::filesystem::path &, ReplayTiming, bool>(),
+           pybind11::arg("xml_path"), pybind11::arg("replay"),
+           pybind11::arg("replay_timing") = ReplayTiming::ORIGINAL,
+           pybind11::arg("loop") = true, DOC(IRImagerMock, IRImagerMock, 3),
+           no_gil)
+      .def(pybind11::init<const std::filesystem::path &,
+                          const SyntheticSceneOptions &>(),
+           pybind11::arg("xml_path"), pybind11::arg("scene"),
+           DOC(IRImagerMock, IRImagerMock, 4), no_gil)
+      .def("get_frame", &IRImager_get_frame_, DOC(IRImager, get_frame))
+      .def("get_frame_monotonic", &IRImager_get_frame_monotonic_,
+           DOC(IRImager, get_frame_monotonic))
+      .def("get_frame_celsius", &IRImager_get_frame_celsius_,
+           IRImager_get_frame_celsius_doc_)
+      .def("get_frame_with_metadata", &IRImager_get_frame_with_metadata_,
+           IRImager_get_frame_with_metadata_doc_)
+      .def("get_frame_async", &IRImager_get_frame_async_,
+           IRImager_get_frame_async_doc_)
+      .def(
+          "stream",
+          [](pybind11::object self) { return FrameStream{std::move(self)}; },
+          IRImager_stream_doc_)
+      .def("try_get_frame", &IRImager_try_get_frame_, pybind11::arg("timeout"),
+           IRImager_try_get_frame_doc_)
+      .def("try_get_frame_monotonic", &IRImager_try_get_frame_monotonic_,
+           pybind11::arg("timeout"), IRImager_try_get_frame_monotonic_doc_)
+      .def("get_frames", &IRImager_get_frames_, pybind11::arg("count"),
+           pybind11::arg("timeout") = std::chrono::duration<double>(30.0),
+           IRImager_get_frames_doc_)
+      .def("get_frame_shape", &IRImager::get_frame_shape,
+           DOC(IRImager, get_frame_shape), no_gil)
+      .def("get_frame_into", &IRImager::get_frame_into, pybind11::arg("out"),
+           DOC(IRImager, get_frame_into), no_gil)
+      .def("get_frame_monotonic_into", &IRImager::get_frame_monotonic_into,
+           pybind11::arg("out"), DOC(IRImager, get_frame_monotonic_into),
            no_gil)
-      .def("get_frame_monotonic", &IRImager::get_frame_monotonic,
-           DOC(IRImager, get_frame_monotonic), no_gil)
+      .def("get_temperature_frame_monotonic_into",
+           &IRImager::get_temperature_frame_monotonic_into,
+           pybind11::arg("out"),
+           pybind11::arg("unit") = TemperatureUnit::CELSIUS,
+           DOC(IRImager, get_temperature_frame_monotonic_into), no_gil)
       .def("get_temp_range_decimal", &IRImagerMock::get_temp_range_decimal,
            DOC(IRImager, get_temp_range_decimal), no_gil)
       .def("start_streaming", &IRImagerMock::start_streaming,
-           DOC(IRImager, start_streaming), no_gil)
+           DOC(IRImager, start_streaming),
+           pybind11::arg("frame_queue_size") = 0,
+           pybind11::arg("overflow_policy") = OverflowPolicy::DROP_NEWEST,
+           pybind11::arg("shutter_policy") = ShutterPolicy::WAIT,
+           no_gil)
       .def("stop_streaming", &IRImagerMock::stop_streaming,
            DOC(IRImager, stop_streaming), no_gil)
       .def("__enter__", &IRImager_enter_,
            pybind11::return_value_policy::reference_internal, no_gil)
       .def("__exit__", &IRImager_exit_);
 
+  pybind11::class_<CameraGroup>(m, "CameraGroup", DOC(CameraGroup))
+      .def(pybind11::init<const std::vector<std::filesystem::path> &>(),
+           pybind11::arg("xml_paths"), DOC(CameraGroup, CameraGroup), no_gil)
+      .def("__len__", &CameraGroup::size, DOC(CameraGroup, size))
+      .def("__getitem__", &CameraGroup::camera, pybind11::arg("index"),
+           pybind11::return_value_policy::reference_internal,
+           DOC(CameraGroup, camera))
+      .def("start_streaming", &CameraGroup::start_streaming,
+           pybind11::arg("history_size") = CameraGroup::DEFAULT_HISTORY_SIZE,
+           pybind11::arg("shutter_policy") = ShutterPolicy::WAIT,
+           DOC(CameraGroup, start_streaming), no_gil)
+      .def("stop_streaming", &CameraGroup::stop_streaming,
+           DOC(CameraGroup, stop_streaming), no_gil)
+      .def("is_streaming", &CameraGroup::is_streaming,
+           DOC(CameraGroup, is_streaming), no_gil)
+      .def("get_frame_set", &CameraGroup_get_frame_set_,
+           pybind11::arg("tolerance"), CameraGroup_get_frame_set_doc_)
+      .def("try_get_frame_set", &CameraGroup_try_get_frame_set_,
+           pybind11::arg("tolerance"), pybind11::arg("timeout"),
+           CameraGroup_try_get_frame_set_doc_)
+      .def("get_skew_stats", &CameraGroup::get_skew_stats,
+           DOC(CameraGroup, get_skew_stats), no_gil)
+      .def("reset_skew_stats", &CameraGroup::reset_skew_stats,
+           DOC(CameraGroup, reset_skew_stats), no_gil)
+      .def("__enter__",
+           [](CameraGroup &camera_group) -> CameraGroup & {
+             camera_group.start_streaming();
+             return camera_group;
+           },
+           pybind11::return_value_policy::reference_internal, no_gil)
+      .def("__exit__",
+           [](CameraGroup &camera_group,
+              [[maybe_unused]] const std::optional<pybind11::type>,
+              [[maybe_unused]] const std::optional<pybind11::object>,
+              [[maybe_unused]] const std::optional<pybind11::object>) {
+             auto no_gil = pybind11::gil_scoped_release();
+             camera_group.stop_streaming();
+           });
+
   pybind11::class_<Logger>(m, "Logger", DOC(Logger))
-      .def(pybind11::init<>(), DOC(Logger, Logger));
+      .def(pybind11::init<>(), DOC(Logger, Logger))
+      .def(pybind11::init<const ThreadScheduling &>(),
+           pybind11::arg("thread_scheduling"), DOC(Logger, Logger, 4))
+      .def("get_thread_scheduling", &Logger::get_thread_scheduling,
+           DOC(Logger, get_thread_scheduling));
 
   pybind11::class_<LoggerContextManager>(m, "LoggerContextManager",
                                          DOC(LoggerContextManager))
@@ -1,21 +1,40 @@
 #include "./irimager_class.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <exception>
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <stdexcept>
-#include <variant>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
 #include "./chrono.hpp"
+#include "./event_fd.hpp"
+#include "./frame_replay.hpp"
+#include "./frame_scheduler.hpp"
+#include "./roi.hpp"
+#include "./spmc_ring_buffer.hpp"
+#include "./synthetic_scene.hpp"
+#include "./temperature.hpp"
 
 struct IRImager::impl {
  public:
   impl() = default;
+  impl(const impl &other)
+      : streaming_{other.streaming_.load()},
+        frame_transform_{other.frame_transform_},
+        roi_stats_engine_{other.roi_stats_engine_},
+        acquisition_thread_scheduling_{other.acquisition_thread_scheduling_} {}
   impl(const std::filesystem::path &xml_path) {
     // do a basic check that the given file is readable, and is an XML file
     auto xml_stream = std::ifstream(xml_path, std::fstream::in);
@@ -45,6 +64,130 @@ struct IRImager::impl {
   /** @copydoc IRImager::stop_streaming() */
   virtual void stop_streaming() { streaming_ = false; }
 
+  /** @copydoc IRImager::is_streaming() */
+  bool is_streaming() { return streaming_; }
+
+  /**
+   * Starts a background thread that continuously calls acquire_frame() and
+   * pushes the frames into a ::frame_queue_ of @p frame_queue_size frames.
+   *
+   * @param overflow_policy What to do when the ::frame_queue_ is full.
+   */
+  void start_acquisition_thread(std::size_t frame_queue_size,
+                                OverflowPolicy overflow_policy) {
+    stop_acquisition_thread();
+
+    std::atomic_store(&frame_queue_,
+                      std::make_shared<SpmcRingBuffer<QueuedFrame>>(
+                          frame_queue_size, make_queued_frame()));
+    overflow_policy_ = overflow_policy;
+    temp_range_decimal_ = get_temp_range_decimal();
+    acquisition_error_ = nullptr;
+    stop_acquisition_ = false;
+
+    // wait for the thread to apply its scheduling, so that it can be reported
+    // by get_acquisition_thread_scheduling() as soon as we return
+    auto applied_promise = std::promise<AppliedThreadScheduling>();
+    auto applied_future = applied_promise.get_future();
+    acquisition_thread_ = std::thread(
+        [this, applied_promise = std::move(applied_promise)]() mutable {
+          try {
+            applied_promise.set_value(
+                apply_thread_scheduling(acquisition_thread_scheduling_));
+          } catch (...) {
+            applied_promise.set_exception(std::current_exception());
+            return;
+          }
+          acquisition_loop();
+        });
+
+    try {
+      applied_acquisition_thread_scheduling_ = applied_future.get();
+    } catch (...) {
+      stop_acquisition_thread();
+      throw;
+    }
+    for (const auto &error : applied_acquisition_thread_scheduling_->errors) {
+      spdlog::warn("Acquisition thread: {}", error);
+    }
+  }
+
+  /** @copydoc IRImager::set_acquisition_thread_scheduling() */
+  void set_acquisition_thread_scheduling(
+      const ThreadScheduling &thread_scheduling) {
+    thread_scheduling.validate();
+    acquisition_thread_scheduling_ = thread_scheduling;
+  }
+
+  /** @copydoc IRImager::get_acquisition_thread_scheduling() */
+  std::optional<AppliedThreadScheduling> get_acquisition_thread_scheduling() {
+    return applied_acquisition_thread_scheduling_;
+  }
+
+  /**
+   * Stops the thread started by start_acquisition_thread(), if any.
+   *
+   * Any frames still in the queue are discarded.
+   */
+  void stop_acquisition_thread() {
+    if (!acquisition_thread_.joinable()) {
+      return;
+    }
+    {
+      auto lock = std::scoped_lock(acquisition_mutex_);
+      stop_acquisition_ = true;
+    }
+    frame_queued_.notify_all();
+    frame_popped_.notify_all();
+    acquisition_thread_.join();
+    pipeline_latency_.count_dropped(frame_queue_->size());
+    // consumers that are still popping keep their own reference to the queue
+    std::atomic_store(&frame_queue_,
+                      std::shared_ptr<SpmcRingBuffer<QueuedFrame>>());
+  }
+
+  /**
+   * Sets what to do with frames taken while the shutter flag is closed, and
+   * forgets the last good frame.
+   *
+   * Must not be called while the acquisition thread is running.
+   */
+  void set_shutter_policy(ShutterPolicy shutter_policy) {
+    shutter_policy_ = shutter_policy;
+    last_good_frame_.resize(0, 0);
+    flag_closed_since_ = std::nullopt;
+  }
+
+  /**
+   * Creates a new ::frame_pool_ that keeps enough buffers to handle
+   * @p frame_queue_size queued frames.
+   */
+  void reset_frame_pool(std::size_t frame_queue_size) {
+    auto [rows, cols] = frame_shape();
+    frame_pool_ = IRImager::ThermalFramePool::create(
+        IRImager::ThermalFrame(rows, cols),
+        MIN_FRAME_POOL_SIZE + frame_queue_size);
+  }
+
+  /** @copydoc IRImager::get_frame_pool_stats() */
+  BufferPoolStats get_frame_pool_stats() {
+    if (!frame_pool_) {
+      return {};
+    }
+    return frame_pool_->stats();
+  }
+
+  /** @copydoc IRImager::get_stats() */
+  PipelineStats get_stats() { return pipeline_latency_.stats(); }
+
+  /** @copydoc IRImager::reset_stats() */
+  void reset_stats() { pipeline_latency_.reset(); }
+
+  /** @copydoc IRImager::record_latency() */
+  void record_latency(PipelineStage stage, std::chrono::nanoseconds latency) {
+    pipeline_latency_.record(stage, latency);
+  }
+
   /** @copydoc IRImager::get_frame() */
   std::tuple<IRImager::ThermalFrame, std::chrono::system_clock::time_point>
   get_frame() {
@@ -54,20 +197,288 @@ struct IRImager::impl {
   }
 
   /** @copydoc IRImager::get_frame_monotonic() */
-  virtual std::tuple<IRImager::ThermalFrame,
-                     std::chrono::steady_clock::time_point>
+  std::tuple<IRImager::ThermalFrame, std::chrono::steady_clock::time_point>
   get_frame_monotonic() {
-    if (!streaming_) {
+    check_streaming();
+
+    auto [rows, cols] = frame_shape();
+    auto thermal_frame = IRImager::ThermalFrame(rows, cols);
+    auto frame_info = read_frame(map_frame(thermal_frame));
+
+    return std::make_tuple(std::move(thermal_frame), frame_info.time_point);
+  }
+
+  /** @copydoc IRImager::get_frame_monotonic_into() */
+  std::chrono::steady_clock::time_point get_frame_monotonic_into(
+      Eigen::Ref<IRImager::ThermalFrame> out) {
+    check_streaming();
+    check_output_frame(out);
+
+    auto [rows, cols] = frame_shape();
+    return read_frame(
+               Eigen::Map<IRImager::ThermalFrame>(out.data(), rows, cols))
+        .time_point;
+  }
+
+  /** @copydoc IRImager::get_temperature_frame_monotonic_into() */
+  std::chrono::steady_clock::time_point get_temperature_frame_monotonic_into(
+      Eigen::Ref<IRImager::TemperatureFrame> out, TemperatureUnit unit) {
+    check_streaming();
+    check_output_frame(out);
+
+    auto [thermal_frame, time_point, metadata] = get_pooled_frame_monotonic();
+    raw_to_temperature(thermal_frame->data(), out.data(),
+                       static_cast<std::size_t>(thermal_frame->size()),
+                       get_temp_range_decimal(), unit);
+    return time_point;
+  }
+
+  /** @copydoc IRImager::set_frame_transform() */
+  void set_frame_transform(const FrameTransform &frame_transform) {
+    if (streaming_) {
+      throw std::runtime_error(
+          "Cannot change the frame transform while streaming, please call "
+          "stop_streaming() first");
+    }
+    if (get_roi_count() > 0) {
+      throw std::runtime_error(
+          "Cannot change the frame transform while there are regions of "
+          "interest, since they depend on the frame shape. Please call "
+          "clear_rois() first");
+    }
+    auto [rows, cols] = frame_transform.output_shape(sensor_shape());
+    frame_transform_ = frame_transform;
+
+    if (roi_stats_engine_) {
+      auto quantiles = roi_stats_engine_->quantiles();
+      roi_stats_engine_.emplace(rows, cols);
+      roi_stats_engine_->set_quantiles(std::move(quantiles));
+    }
+  }
+
+  /** @copydoc IRImager::get_frame_transform() */
+  FrameTransform get_frame_transform() { return frame_transform_; }
+
+  /** @copydoc IRImager::add_roi_rectangle() */
+  std::size_t add_roi_rectangle(Eigen::Index row, Eigen::Index col,
+                                Eigen::Index height, Eigen::Index width) {
+    return roi_stats_engine().add_rectangle(row, col, height, width);
+  }
+
+  /** @copydoc IRImager::add_roi_polygon() */
+  std::size_t add_roi_polygon(
+      const std::vector<RoiStatsEngine::Vertex> &vertices) {
+    return roi_stats_engine().add_polygon(vertices);
+  }
+
+  /** @copydoc IRImager::clear_rois() */
+  void clear_rois() { roi_stats_engine().clear(); }
+
+  /** @copydoc IRImager::get_roi_count() */
+  std::size_t get_roi_count() {
+    return roi_stats_engine_ ? roi_stats_engine_->size() : 0;
+  }
+
+  /** @copydoc IRImager::set_roi_quantiles() */
+  void set_roi_quantiles(std::vector<double> quantiles) {
+    roi_stats_engine().set_quantiles(std::move(quantiles));
+  }
+
+  /** @copydoc IRImager::get_roi_quantiles() */
+  std::vector<double> get_roi_quantiles() {
+    return roi_stats_engine_ ? roi_stats_engine_->quantiles()
+                             : std::vector<double>();
+  }
+
+  /** The number of columns in IRImager::RoiStats */
+  Eigen::Index get_roi_stat_count() {
+    return roi_stats_engine_ ? roi_stats_engine_->stat_count()
+                             : RoiStatsEngine::STAT_COUNT;
+  }
+
+  /** @copydoc IRImager::get_roi_stats_monotonic_into() */
+  std::chrono::steady_clock::time_point get_roi_stats_monotonic_into(
+      Eigen::Ref<IRImager::RoiStats> out) {
+    check_streaming();
+    if (get_roi_count() == 0) {
+      throw std::runtime_error(
+          "No regions of interest, please call add_roi_rectangle() or "
+          "add_roi_polygon() before start_streaming()");
+    }
+    if (static_cast<std::size_t>(out.rows()) != get_roi_count() ||
+        out.cols() != get_roi_stat_count()) {
+      throw std::invalid_argument(
+          "Invalid output array: expected shape (" +
+          std::to_string(get_roi_count()) + ", " +
+          std::to_string(get_roi_stat_count()) + "), but got (" +
+          std::to_string(out.rows()) + ", " + std::to_string(out.cols()) +
+          ")");
+    }
+
+    if (auto queue = frame_queue()) {
+      // the stats were computed by the acquisition thread, so we only need
+      // to copy the stats, not the whole frame
+      auto frame_info = try_pop_queued_frame(
+          *queue, [&](QueuedFrame &slot) { out = slot.roi_stats; },
+          std::chrono::steady_clock::now() + FRAME_TIMEOUT);
+      if (!frame_info) {
+        throw std::runtime_error(
+            "Timeout when waiting for a new thermal frame");
+      }
+      return frame_info->time_point;
+    }
+
+    auto [thermal_frame, time_point, metadata] = get_pooled_frame_monotonic();
+    roi_stats_engine_->compute(*thermal_frame, out, get_temp_range_decimal());
+    return time_point;
+  }
+
+  /** @copydoc IRImager::get_frames_monotonic_into() */
+  std::size_t get_frames_monotonic_into(
+      Eigen::Ref<IRImager::ThermalFrames> frames,
+      Eigen::Ref<IRImager::Timestamps> timestamps,
+      std::chrono::steady_clock::duration timeout, FrameMetadata *metadata) {
+    check_streaming();
+
+    auto [rows, cols] = frame_shape();
+    if (frames.cols() != rows * cols || frames.outerStride() != frames.cols()) {
+      throw std::invalid_argument(
+          "Invalid frames array: each row must be a contiguous frame of " +
+          std::to_string(rows) + "x" + std::to_string(cols) + " pixels");
+    }
+    if (timestamps.size() < frames.rows()) {
+      throw std::invalid_argument(
+          "Invalid timestamps array: must have one timestamp per frame");
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto queue = frame_queue();
+
+    for (Eigen::Index i = 0; i < frames.rows(); i++) {
+      // without a frame queue, try_read_frame() always grabs a frame, even
+      // after the deadline, which would make the timeout useless here
+      if (!queue && i > 0 &&
+          std::chrono::steady_clock::now() >= deadline) {
+        return static_cast<std::size_t>(i);
+      }
+      auto frame_info = try_read_frame(
+          queue.get(),
+          Eigen::Map<IRImager::ThermalFrame>(frames.row(i).data(), rows, cols),
+          deadline);
+      if (!frame_info) {
+        return static_cast<std::size_t>(i);
+      }
+
+      timestamps(i) = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          frame_info->time_point.time_since_epoch())
+                          .count();
+      if (metadata != nullptr) {
+        metadata[i] = frame_info->metadata;
+      }
+    }
+
+    return static_cast<std::size_t>(frames.rows());
+  }
+
+  /** @copydoc IRImager::get_frame_shape() */
+  std::tuple<Eigen::Index, Eigen::Index> get_frame_shape() {
+    auto [rows, cols] = frame_shape();
+    return {rows, cols};
+  }
+
+  /** @copydoc IRImager::get_pooled_frame_monotonic() */
+  std::tuple<IRImager::PooledThermalFrame,
+             std::chrono::steady_clock::time_point, FrameMetadata>
+  get_pooled_frame_monotonic() {
+    auto pooled_frame = try_get_pooled_frame_monotonic(FRAME_TIMEOUT);
+    if (!pooled_frame) {
+      throw std::runtime_error("Timeout when waiting for a new thermal frame");
+    }
+    return std::move(*pooled_frame);
+  }
+
+  /** @copydoc IRImager::try_get_pooled_frame_monotonic() */
+  std::optional<std::tuple<IRImager::PooledThermalFrame,
+                           std::chrono::steady_clock::time_point, FrameMetadata>>
+  try_get_pooled_frame_monotonic(std::chrono::steady_clock::duration timeout) {
+    check_streaming();
+    if (!frame_pool_) {
       throw std::runtime_error("IRIMAGER_STREAMOFF: Not streaming");
     }
 
-    auto frame_size = std::array<ssize_t, 2>{382, 288};
-    auto max_value = static_cast<uint16_t>(
-        (1800 + 100) * std::pow(10, get_temp_range_decimal()));
-    auto my_array = IRImager::ThermalFrame::Constant(frame_size[0],
-                                                     frame_size[1], max_value);
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto thermal_frame = frame_pool_->acquire();
+    std::optional<FrameInfo> frame_info;
+
+    if (auto queue = frame_queue()) {
+      // swapping only swaps the underlying pointers, so no data is copied
+      frame_info = try_pop_queued_frame(
+          *queue,
+          [&](QueuedFrame &slot) { thermal_frame->swap(slot.thermal_frame); },
+          deadline);
+    } else {
+      frame_info = try_acquire_good_frame(map_frame(*thermal_frame), deadline);
+    }
+
+    if (!frame_info) {
+      return std::nullopt;
+    }
+    return std::make_tuple(std::move(thermal_frame), frame_info->time_point,
+                           frame_info->metadata);
+  }
+
+  /** @copydoc IRImager::set_frame_callback() */
+  void set_frame_callback(IRImager::FrameCallback callback) {
+    if (callback && streaming_ && !acquisition_thread_.joinable()) {
+      throw std::runtime_error(
+          "Cannot set a frame callback while streaming without a frame queue, "
+          "please call set_frame_callback() before start_streaming()");
+    }
+    {
+      // waits for the acquisition thread to finish calling the old callback
+      auto lock = std::scoped_lock(frame_callback_mutex_);
+      std::swap(frame_callback_, callback);
+    }
+    // the old callback is destroyed here, never by the acquisition thread,
+    // since destroying it may need locks (e.g. the Python GIL) that the
+    // thread joining the acquisition thread holds
+  }
+
+  /** @copydoc IRImager::get_frame_event_fd() */
+  int get_frame_event_fd() {
+    if (!streaming_ || !frame_queue()) {
+      throw std::runtime_error(
+          "Waiting for frames asynchronously requires calling "
+          "start_streaming() with a frame_queue_size greater than 0");
+    }
+    if (has_frame_callback()) {
+      throw std::runtime_error(
+          "Frames are passed to the frame callback instead of the frame queue, "
+          "so waiting for queued frames would wait forever");
+    }
+
+    auto lock = std::scoped_lock(acquisition_mutex_);
+    if (!frame_event_owner_) {
+      frame_event_owner_ = std::make_unique<EventFd>();
+      frame_event_.store(frame_event_owner_.get(), std::memory_order_release);
+    }
+    return frame_event_owner_->fd();
+  }
+
+  /**
+   * Makes the fd returned by get_frame_event_fd() readable, if it exists.
+   */
+  void notify_frame_event() {
+    auto frame_event = frame_event_.load(std::memory_order_acquire);
+    if (frame_event != nullptr) {
+      frame_event->notify();
+    }
+  }
 
-    return std::make_tuple(my_array, std::chrono::steady_clock::now());
+  /** Whether set_frame_callback() has been called with a function */
+  bool has_frame_callback() {
+    auto lock = std::scoped_lock(frame_callback_mutex_);
+    return static_cast<bool>(frame_callback_);
   }
 
   /** @copydoc IRImager::get_temp_range_decimal() */
@@ -76,29 +487,817 @@ struct IRImager::impl {
   /** @copydoc IRImager::get_library_version() */
   virtual std::string_view get_library_version() = 0;
 
+  /**
+   * @remark Derived classes must call stop_acquisition_thread() in their
+   * destructor, since the acquisition thread calls their virtual methods.
+   */
   virtual ~impl() = default;
 
  protected:
-  bool streaming_ = false;
+  /** Read without a lock by consumers, e.g. check_streaming() */
+  std::atomic<bool> streaming_ = false;
+
+  /**
+   * Status of a frame returned by acquire_frame().
+   */
+  enum class FrameStatus {
+    /** The frame contains valid thermal data. */
+    GOOD,
+    /** The shutter was closed, so this frame is only for calibration */
+    SHUTTER_CLOSED,
+  };
+
+  /**
+   * Information about a frame, other than the thermal data.
+   */
+  struct FrameInfo {
+    /** The monotonic time the frame was taken. */
+    std::chrono::steady_clock::time_point time_point;
+    FrameMetadata metadata;
+  };
+
+  /**
+   * Latency of each stage of the frame pipeline.
+   *
+   * acquire_frame() must record PipelineStage::ACQUIRE and
+   * PipelineStage::PROCESS, the other stages are recorded by this class.
+   */
+  PipelineLatency pipeline_latency_;
+
+  /**
+   * Crop and binning that acquire_frame() applies to every frame.
+   *
+   * Only changed while we're not streaming.
+   */
+  FrameTransform frame_transform_;
+
+  /**
+   * The `{rows, cols}` of the frames from the camera, before the
+   * ::frame_transform_ is applied.
+   */
+  virtual std::array<Eigen::Index, 2> sensor_shape() = 0;
+
+  /**
+   * The `{rows, cols}` of the frames returned by acquire_frame().
+   */
+  std::array<Eigen::Index, 2> frame_shape() {
+    return frame_transform_.output_shape(sensor_shape());
+  }
+
+  /**
+   * Grabs a single frame from the camera.
+   *
+   * This function blocks until a frame is available.
+   *
+   * @param[out] thermal_frame Where to store the thermal data, after applying
+   *                           the ::frame_transform_. Must have the shape
+   *                           returned by frame_shape().
+   * @param[out] frame_info    The time the frame was taken, and any other
+   *                           metadata.
+   * @remark Only called by grab_frame(), while holding the ::grab_mutex_.
+   * @throws std::runtime_error if a frame cannot be loaded.
+   * @returns Whether @p thermal_frame contains valid data.
+   */
+  virtual FrameStatus acquire_frame(
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+      FrameInfo &frame_info) = 0;
+
+ private:
+  /** A preallocated slot in the ::frame_queue_ */
+  struct QueuedFrame {
+    IRImager::ThermalFrame thermal_frame;
+    FrameInfo frame_info;
+    /** Statistics of each ROI in the ::roi_stats_engine_ */
+    IRImager::RoiStats roi_stats;
+    /** When the frame was ready to be queued, for PipelineStage::HANDOFF */
+    std::chrono::steady_clock::time_point queued_time;
+  };
+
+  /** Allocates a QueuedFrame with the current frame shape and ROI count */
+  QueuedFrame make_queued_frame() {
+    auto [rows, cols] = frame_shape();
+    return QueuedFrame{
+        IRImager::ThermalFrame(rows, cols),
+        {},
+        IRImager::RoiStats(static_cast<Eigen::Index>(get_roi_count()),
+                           get_roi_stat_count()),
+        {},
+    };
+  }
+
+  /**
+   * The minimum number of free buffers the ::frame_pool_ keeps, so that the
+   * caller can hold onto a few frames without any new allocations.
+   */
+  static constexpr std::size_t MIN_FRAME_POOL_SIZE = 8;
+
+  /** How long to wait for a frame before giving up. */
+  static constexpr auto FRAME_TIMEOUT = std::chrono::seconds(30);
+
+  static Eigen::Map<IRImager::ThermalFrame> map_frame(
+      IRImager::ThermalFrame &thermal_frame) {
+    return Eigen::Map<IRImager::ThermalFrame>(
+        thermal_frame.data(), thermal_frame.rows(), thermal_frame.cols());
+  }
+
+  /**
+   * Frames grabbed by the ::acquisition_thread_, or `nullptr` if we're not
+   * using a background thread.
+   *
+   * Only replaced while the ::acquisition_thread_ isn't running, using
+   * `std::atomic_store()`, so the ::acquisition_thread_ can use it directly,
+   * but consumers must use a snapshot from frame_queue(), since
+   * stop_streaming() may be called while they are popping.
+   */
+  std::shared_ptr<SpmcRingBuffer<QueuedFrame>> frame_queue_;
+  /** What the ::acquisition_thread_ does when ::frame_queue_ is full */
+  OverflowPolicy overflow_policy_ = OverflowPolicy::DROP_NEWEST;
+  /**
+   * If set, the ::acquisition_thread_ passes frames to this function instead
+   * of the ::frame_queue_.
+   */
+  IRImager::FrameCallback frame_callback_;
+  /**
+   * Locks ::frame_callback_, and is held by the ::acquisition_thread_ while
+   * calling it.
+   */
+  std::mutex frame_callback_mutex_;
+  /** Owns the ::frame_event_, which is created by get_frame_event_fd() */
+  std::unique_ptr<EventFd> frame_event_owner_;
+  /**
+   * Notified whenever a frame is queued, or `nullptr` if nobody has called
+   * get_frame_event_fd().
+   */
+  std::atomic<EventFd *> frame_event_ = nullptr;
+  /**
+   * Regions of interest, whose statistics are computed by the
+   * ::acquisition_thread_ for every queued frame.
+   *
+   * Created on first use, since frame_shape() can't be called in our
+   * constructor.
+   */
+  std::optional<RoiStatsEngine> roi_stats_engine_;
+  /** What grab_frame() does with frames taken while the shutter is closed */
+  ShutterPolicy shutter_policy_ = ShutterPolicy::WAIT;
+  /**
+   * Copy of the last good frame, for ShutterPolicy::RETURN_STALE, or an
+   * empty frame if there hasn't been one since streaming started.
+   */
+  IRImager::ThermalFrame last_good_frame_;
+  /**
+   * When the shutter flag closed, or `std::nullopt` if it is open, so that
+   * grab_frame() can record how long it was closed for.
+   */
+  std::optional<std::chrono::steady_clock::time_point> flag_closed_since_;
+  /** The FrameMetadata::sequence of the last frame from grab_frame() */
+  std::uint64_t frame_sequence_ = 0;
+  /**
+   * Held by grab_frame(), so that only one frame is acquired at a time, since
+   * acquire_frame() and the shutter state aren't thread-safe.
+   */
+  std::mutex grab_mutex_;
+  /** Cached get_temp_range_decimal(), for the ::acquisition_thread_ */
+  short temp_range_decimal_ = 1;
+  /** Recycled buffers for get_pooled_frame_monotonic() */
+  std::shared_ptr<IRImager::ThermalFramePool> frame_pool_;
+  /** How the ::acquisition_thread_ asks to be scheduled when it starts */
+  ThreadScheduling acquisition_thread_scheduling_;
+  /** How the last ::acquisition_thread_ was actually scheduled, if any */
+  std::optional<AppliedThreadScheduling>
+      applied_acquisition_thread_scheduling_;
+  std::thread acquisition_thread_;
+
+  /**
+   * Locks ::stop_acquisition_ and ::acquisition_error_.
+   *
+   * ::frame_queue_ is lock-free, this mutex is only used so that consumers
+   * can sleep on ::frame_queued_.
+   */
+  std::mutex acquisition_mutex_;
+  /** Notifies that a frame was pushed, or that the thread has stopped */
+  std::condition_variable frame_queued_;
+  /**
+   * Notifies the ::acquisition_thread_ that a frame was popped, only used by
+   * OverflowPolicy::BLOCK.
+   */
+  std::condition_variable frame_popped_;
+  /** If `true`, stop the ::acquisition_thread_ */
+  bool stop_acquisition_ = false;
+  /** Exception thrown by the ::acquisition_thread_, if it crashed */
+  std::exception_ptr acquisition_error_;
+
+  /** A snapshot of the ::frame_queue_, which stays valid for consumers */
+  std::shared_ptr<SpmcRingBuffer<QueuedFrame>> frame_queue() {
+    return std::atomic_load(&frame_queue_);
+  }
+
+  /**
+   * Wakes up any consumer waiting in try_pop_queued_frame(), or waiting on
+   * the ::frame_event_.
+   */
+  void notify_frame_queued() {
+    {
+      // lock so that we can't notify in-between a consumer checking
+      // the queue and going to sleep
+      auto lock = std::scoped_lock(acquisition_mutex_);
+    }
+    frame_queued_.notify_one();
+    notify_frame_event();
+  }
+
+  /** Wakes up the ::acquisition_thread_, if it's waiting for a free slot */
+  void notify_frame_popped() {
+    if (overflow_policy_ != OverflowPolicy::BLOCK) {
+      return;
+    }
+    {
+      auto lock = std::scoped_lock(acquisition_mutex_);
+    }
+    frame_popped_.notify_one();
+  }
+
+  /**
+   * @throws std::invalid_argument if @p out does not have the shape returned
+   *                               by frame_shape(), or is not C-contiguous.
+   */
+  template <class Frame>
+  void check_output_frame(const Eigen::Ref<Frame> &out) {
+    auto [rows, cols] = frame_shape();
+    if (out.rows() != rows || out.cols() != cols) {
+      throw std::invalid_argument(
+          "Invalid output array: expected shape (" + std::to_string(rows) +
+          ", " + std::to_string(cols) + "), but got (" +
+          std::to_string(out.rows()) + ", " + std::to_string(out.cols()) +
+          ")");
+    }
+    if (out.outerStride() != out.cols()) {
+      throw std::invalid_argument(
+          "Invalid output array: the array must be C-contiguous");
+    }
+  }
+
+  /**
+   * Returns the ::roi_stats_engine_, so that ROIs can be changed.
+   *
+   * @throws std::runtime_error if we're streaming, since the
+   *                            ::acquisition_thread_ may be using it.
+   */
+  RoiStatsEngine &roi_stats_engine() {
+    if (streaming_) {
+      throw std::runtime_error(
+          "Cannot change the regions of interest while streaming, please call "
+          "stop_streaming() first");
+    }
+    if (!roi_stats_engine_) {
+      auto [rows, cols] = frame_shape();
+      roi_stats_engine_.emplace(rows, cols);
+    }
+    return *roi_stats_engine_;
+  }
+
+  /**
+   * Calls acquire_frame() for a ::frame_queue_ slot, then computes the
+   * statistics of each ROI, so that consumers that only want the ROI
+   * statistics don't need to copy the frame.
+   *
+   * @returns Whether @p slot contains valid data.
+   */
+  bool acquire_queued_frame(QueuedFrame &slot) {
+    if (!grab_frame(map_frame(slot.thermal_frame), slot.frame_info)) {
+      return false;
+    }
+    if (slot.roi_stats.rows() > 0) {
+      roi_stats_engine_->compute(slot.thermal_frame, slot.roi_stats,
+                                 temp_range_decimal_);
+    }
+    slot.queued_time = std::chrono::steady_clock::now();
+    return true;
+  }
+
+  /**
+   * Calls acquire_frame(), numbers and counts the frame in the
+   * ::pipeline_latency_, and applies the ::shutter_policy_.
+   *
+   * Thread-safe, since several consumers may grab frames at the same time
+   * when there is no ::frame_queue_.
+   *
+   * @returns Whether @p thermal_frame should be returned to the caller, i.e.
+   *          it contains valid data, or the last good frame.
+   */
+  bool grab_frame(Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+                  FrameInfo &frame_info) {
+    auto lock = std::scoped_lock(grab_mutex_);
+    auto frame_status = acquire_frame(thermal_frame, frame_info);
+    frame_info.metadata.sequence = ++frame_sequence_;
+    pipeline_latency_.count_acquired();
+
+    if (frame_status == FrameStatus::GOOD) {
+      if (flag_closed_since_) {
+        pipeline_latency_.record_flag_closure(frame_info.time_point -
+                                              *flag_closed_since_);
+        flag_closed_since_ = std::nullopt;
+      }
+      if (shutter_policy_ == ShutterPolicy::RETURN_STALE) {
+        last_good_frame_ = thermal_frame;
+      }
+      return true;
+    }
+
+    if (!flag_closed_since_) {
+      flag_closed_since_ = frame_info.time_point;
+    }
+    if (shutter_policy_ == ShutterPolicy::RETURN_STALE &&
+        last_good_frame_.size() == thermal_frame.size()) {
+      thermal_frame = last_good_frame_;
+      // acquire_frame() only marks frames as bad if the flag isn't open
+      if (frame_info.metadata.flag_state == FlagState::OPEN) {
+        frame_info.metadata.flag_state = FlagState::ERROR;
+      }
+      return true;
+    }
+    pipeline_latency_.count_shutter_closed();
+    return false;
+  }
+
+  /**
+   * @throws std::runtime_error if we're not streaming.
+   */
+  void check_streaming() {
+    if (!streaming_) {
+      throw std::runtime_error("IRIMAGER_STREAMOFF: Not streaming");
+    }
+  }
+
+  /**
+   * Calls acquire_frame() until we get a frame with the shutter open.
+   *
+   * @param deadline When to give up waiting for a frame. Since
+   *                 acquire_frame() blocks, this may return up to one frame
+   *                 period after @p deadline. At least one frame is always
+   *                 grabbed, even if @p deadline has already passed.
+   * @returns Information about the frame, or `std::nullopt` on timeout.
+   */
+  std::optional<FrameInfo> try_acquire_good_frame(
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+      std::chrono::steady_clock::time_point deadline) {
+    FrameInfo frame_info;
+    do {
+      if (grab_frame(thermal_frame, frame_info)) {
+        pipeline_latency_.count_delivered(frame_info.time_point);
+        return frame_info;
+      }
+      spdlog::debug("Shutter was down, trying to take a frame again");
+    } while (std::chrono::steady_clock::now() < deadline);
+    return std::nullopt;
+  }
+
+  /**
+   * Copies the next frame into @p thermal_frame, either from the
+   * @p queue, or by calling acquire_frame() directly.
+   *
+   * @param queue A snapshot of the ::frame_queue_, see frame_queue().
+   * @param deadline When to give up waiting for a frame.
+   * @returns Information about the frame, or `std::nullopt` on timeout.
+   */
+  std::optional<FrameInfo> try_read_frame(
+      SpmcRingBuffer<QueuedFrame> *queue,
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+      std::chrono::steady_clock::time_point deadline) {
+    if (queue != nullptr) {
+      return try_pop_queued_frame(
+          *queue,
+          [&](QueuedFrame &slot) { thermal_frame = slot.thermal_frame; },
+          deadline);
+    }
+
+    return try_acquire_good_frame(thermal_frame, deadline);
+  }
+
+  /**
+   * @copybrief try_read_frame()
+   *
+   * @throws std::runtime_error on timeout.
+   */
+  FrameInfo read_frame(Eigen::Map<IRImager::ThermalFrame> thermal_frame) {
+    auto queue = frame_queue();
+    auto frame_info =
+        try_read_frame(queue.get(), thermal_frame,
+                       std::chrono::steady_clock::now() + FRAME_TIMEOUT);
+    if (!frame_info) {
+      throw std::runtime_error("Timeout when waiting for a new thermal frame");
+    }
+    return *frame_info;
+  }
+
+  /** Body of ::acquisition_thread_ */
+  void acquisition_loop() {
+    // frames that we grab when the queue is full are written here
+    auto spare_frame = make_queued_frame();
+
+    try {
+      while (true) {
+        {
+          auto lock = std::scoped_lock(acquisition_mutex_);
+          if (stop_acquisition_) {
+            break;
+          }
+        }
+
+        if (has_frame_callback()) {
+          call_frame_callback();
+          continue;
+        }
+
+        auto result = frame_queue_->try_push(
+            [this](QueuedFrame &slot) { return acquire_queued_frame(slot); });
+
+        switch (result) {
+          case SpmcRingBuffer<QueuedFrame>::PushResult::PUSHED:
+            notify_frame_queued();
+            break;
+          case SpmcRingBuffer<QueuedFrame>::PushResult::REJECTED:
+            spdlog::debug("Shutter was down, skipping frame");
+            break;
+          case SpmcRingBuffer<QueuedFrame>::PushResult::FULL:
+            handle_full_frame_queue(spare_frame);
+            break;
+        }
+      }
+    } catch (...) {
+      auto lock = std::scoped_lock(acquisition_mutex_);
+      acquisition_error_ = std::current_exception();
+    }
+    frame_queued_.notify_all();
+    notify_frame_event();
+  }
+
+  /**
+   * Grabs a frame into a recycled buffer, and passes it to the
+   * ::frame_callback_.
+   */
+  void call_frame_callback() {
+    auto thermal_frame = frame_pool_->acquire();
+    FrameInfo frame_info;
+    if (!grab_frame(map_frame(*thermal_frame), frame_info)) {
+      spdlog::debug("Shutter was down, skipping frame");
+      return;
+    }
+    // only lock after grabbing, so that set_frame_callback() never waits for
+    // a whole frame period
+    auto lock = std::scoped_lock(frame_callback_mutex_);
+    if (!frame_callback_) {
+      spdlog::debug("Frame callback was removed, skipping frame");
+      return;
+    }
+    pipeline_latency_.count_delivered(frame_info.time_point);
+    frame_callback_(std::move(thermal_frame), frame_info.time_point,
+                    frame_info.metadata);
+  }
+
+  /**
+   * Called by the ::acquisition_thread_ when ::frame_queue_ is full.
+   *
+   * @param spare_frame Scratch space to grab a frame into, without touching
+   *                    the ::frame_queue_.
+   */
+  void handle_full_frame_queue(QueuedFrame &spare_frame) {
+    switch (overflow_policy_) {
+      case OverflowPolicy::BLOCK: {
+        auto lock = std::unique_lock(acquisition_mutex_);
+        // a popped slot is only free once its consumer has finished reading
+        // it, which is when notify_frame_popped() is called
+        frame_popped_.wait(lock, [this] {
+          return stop_acquisition_ || frame_queue_->can_push();
+        });
+        break;
+      }
+      case OverflowPolicy::DROP_NEWEST:
+        // we still need to grab the frame, otherwise the camera will stall
+        if (!grab_frame(map_frame(spare_frame.thermal_frame),
+                        spare_frame.frame_info)) {
+          break;  // already counted as skipped
+        }
+        pipeline_latency_.count_dropped();
+        spdlog::warn(
+            "Frame queue is full, dropping frame. You may need to call "
+            "`get_frame()` more often, or increase the frame_queue_size.");
+        break;
+      case OverflowPolicy::DROP_OLDEST:
+        if (!acquire_queued_frame(spare_frame)) {
+          spdlog::debug("Shutter was down, skipping frame");
+          break;
+        }
+        // swapping only swaps the underlying pointers, so no data is copied
+        while (frame_queue_->try_push([&spare_frame](QueuedFrame &slot) {
+          slot.thermal_frame.swap(spare_frame.thermal_frame);
+          slot.frame_info = spare_frame.frame_info;
+          slot.roi_stats.swap(spare_frame.roi_stats);
+          slot.queued_time = spare_frame.queued_time;
+          return true;
+        }) == SpmcRingBuffer<QueuedFrame>::PushResult::FULL) {
+          // if a consumer is still reading the oldest frame, wait for it,
+          // instead of throwing away even more frames
+          if (frame_queue_->size() < frame_queue_->capacity() ||
+              !frame_queue_->try_pop([](QueuedFrame &) {})) {
+            std::this_thread::yield();
+          } else {
+            pipeline_latency_.count_dropped();
+            spdlog::debug("Frame queue is full, dropped oldest frame");
+          }
+        }
+        notify_frame_queued();
+        break;
+    }
+  }
+
+  /**
+   * Waits for a frame from ::frame_queue_.
+   *
+   * @param queue A snapshot of the ::frame_queue_, see frame_queue().
+   * @param reader Function with the signature `void(QueuedFrame &slot)`, that
+   *               is called with the popped frame.
+   * @param deadline When to give up waiting for a frame.
+   * @throws ... any exception thrown by the ::acquisition_thread_.
+   * @returns Information about the frame, or `std::nullopt` on timeout.
+   */
+  template <class Reader>
+  std::optional<FrameInfo> try_pop_queued_frame(
+      SpmcRingBuffer<QueuedFrame> &queue, Reader &&reader,
+      std::chrono::steady_clock::time_point deadline) {
+    FrameInfo frame_info;
+    auto pop = [&]() {
+      return queue.try_pop([&](QueuedFrame &slot) {
+        reader(slot);
+        frame_info = slot.frame_info;
+        pipeline_latency_.record_since(PipelineStage::HANDOFF,
+                                       slot.queued_time);
+      });
+    };
+
+    if (pop()) {  // fast path, no locking needed
+      notify_frame_popped();
+      pipeline_latency_.count_delivered(frame_info.time_point);
+      return frame_info;
+    }
+
+    // the queue is empty, so reset the frame event until the next push.
+    // we pop again afterwards, in case a frame was pushed before the reset
+    auto frame_event = frame_event_.load(std::memory_order_acquire);
+    if (frame_event != nullptr) {
+      frame_event->clear();
+    }
+
+    auto lock = std::unique_lock(acquisition_mutex_);
+    auto popped = false;
+    if (frame_queued_.wait_until(lock, deadline, [&] {
+          popped = pop();
+          return popped || acquisition_error_ || stop_acquisition_;
+        }) == false) {
+      return std::nullopt;
+    }
+
+    if (!popped) {
+      if (acquisition_error_) {
+        std::rethrow_exception(acquisition_error_);
+      }
+      throw std::runtime_error("IRIMAGER_STREAMOFF: Not streaming");
+    }
+
+    lock.unlock();
+    notify_frame_popped();
+    pipeline_latency_.count_delivered(frame_info.time_point);
+    return frame_info;
+  }
 };
 
 /**
  * Mocked implentation, doesn't use irimager or a real camera.
+ *
+ * Returns constant frames, a SyntheticScene, or plays back recorded frames
+ * from a FrameReplay, at the frame rate in the XML config file.
  */
 struct IRImagerMockImpl final : public IRImager::impl {
  public:
   IRImagerMockImpl() { spdlog::warn("Creating a MOCKED IRImager object!"); }
   IRImagerMockImpl(const IRImager::impl &other) : IRImager::impl(other) {
     spdlog::warn("Creating a MOCKED IRImager object!");
+    auto other_mock = dynamic_cast<const IRImagerMockImpl *>(&other);
+    if (other_mock != nullptr) {
+      config_ = other_mock->config_;
+      scheduler_ = FrameScheduler(config_.frame_period());
+      scene_ = other_mock->scene_;
+      replay_ = other_mock->replay_;
+      replay_timing_ = other_mock->replay_timing_;
+      replay_loop_ = other_mock->replay_loop_;
+    }
   }
   IRImagerMockImpl(const std::filesystem::path &xml_path)
-      : IRImager::impl(xml_path) {
+      : IRImager::impl(xml_path),
+        config_{MockCameraConfig::from_xml(xml_path)},
+        scheduler_{config_.frame_period()} {
     spdlog::warn("Creating a MOCKED IRImager object!");
   }
+  IRImagerMockImpl(const std::filesystem::path &xml_path,
+                   const std::filesystem::path &replay_path,
+                   ReplayTiming replay_timing, bool loop)
+      : IRImager::impl(xml_path),
+        config_{MockCameraConfig::from_xml(xml_path)},
+        scheduler_{config_.frame_period()},
+        replay_{std::make_shared<const FrameReplay>(replay_path,
+                                                    config_.frame_period())},
+        replay_timing_{replay_timing},
+        replay_loop_{loop} {
+    spdlog::warn(
+        "Creating a MOCKED IRImager object, replaying {} frames from {}",
+        replay_->size(), replay_path.string());
+  }
+  IRImagerMockImpl(const std::filesystem::path &xml_path,
+                   const SyntheticSceneOptions &scene_options)
+      : IRImager::impl(xml_path),
+        config_{MockCameraConfig::from_xml(xml_path)},
+        scheduler_{config_.frame_period()} {
+    scene_.emplace(config_, scene_options, get_temp_range_decimal());
+    spdlog::warn(
+        "Creating a MOCKED IRImager object, with a synthetic {}x{} scene at "
+        "{} Hz",
+        config_.rows, config_.cols, config_.framerate);
+  }
+
+  void start_streaming() override {
+    // restart the replay/scene, so that every stream is deterministic
+    replay_index_ = 0;
+    scheduler_.reset();
+    streaming_ = true;
+  }
+
+  short get_temp_range_decimal() override {
+    return replay_ ? replay_->temp_range_decimal() : 1;
+  }
 
   std::string_view get_library_version() override { return "MOCKED"; }
 
-  virtual ~IRImagerMockImpl() = default;
+  virtual ~IRImagerMockImpl() { stop_acquisition_thread(); }
+
+ protected:
+  std::array<Eigen::Index, 2> sensor_shape() override {
+    if (replay_) {
+      return replay_->shape();
+    }
+    return {config_.rows, config_.cols};
+  }
+
+  FrameStatus acquire_frame(
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+      FrameInfo &frame_info) override {
+    if (!streaming_) {
+      throw std::runtime_error("IRIMAGER_STREAMOFF: Not streaming");
+    }
+
+    frame_counter_++;
+    if (replay_) {
+      auto frame_status = replay_frame(thermal_frame, frame_info);
+      frame_info.metadata.counter = frame_counter_;
+      frame_info.metadata.counter_hw = frame_counter_;
+      return frame_status;
+    }
+
+    // pretend to be a camera, so that the acquisition thread doesn't spin
+    auto start = std::chrono::steady_clock::now();
+    frame_info.time_point = scheduler_.wait();
+    auto acquired = std::chrono::steady_clock::now();
+    pipeline_latency_.record(PipelineStage::ACQUIRE, acquired - start);
+    // like a real camera, frames that nobody asked for in time are lost
+    pipeline_latency_.count_overrun(scheduler_.missed_frames());
+    frame_counter_hw_ +=
+        static_cast<std::uint32_t>(scheduler_.missed_frames()) + 1;
+
+    auto flag_state = FlagState::OPEN;
+    if (scene_) {
+      auto *out = sensor_frame_data(thermal_frame);
+      flag_state = scene_->render(scheduler_.frame_index(), out);
+      transform_sensor_frame(thermal_frame);
+    } else {
+      auto max_value = static_cast<uint16_t>(
+          (1800 + 100) * std::pow(10, get_temp_range_decimal()));
+      thermal_frame.setConstant(max_value);
+    }
+    pipeline_latency_.record_since(PipelineStage::PROCESS, acquired);
+
+    frame_info.metadata.counter = frame_counter_;
+    frame_info.metadata.counter_hw = frame_counter_hw_;
+    frame_info.metadata.flag_state = flag_state;
+    frame_info.metadata.temp_chip = 40.0f;
+    frame_info.metadata.temp_flag = 35.0f;
+    frame_info.metadata.temp_box = 30.0f;
+
+    return flag_state == FlagState::OPEN ? FrameStatus::GOOD
+                                         : FrameStatus::SHUTTER_CLOSED;
+  }
+
+ private:
+  /** Counts the number of frames that have been mocked */
+  std::uint32_t frame_counter_ = 0;
+  /**
+   * Counts the number of frames that the mocked camera took, including
+   * frames that were skipped by the ::scheduler_.
+   */
+  std::uint32_t frame_counter_hw_ = 0;
+
+  /** The camera that we're pretending to be */
+  MockCameraConfig config_;
+  /** Paces frames at the MockCameraConfig::framerate */
+  FrameScheduler scheduler_{config_.frame_period()};
+
+  /** The synthetic scene to return, or `std::nullopt` */
+  std::optional<SyntheticScene> scene_;
+
+  /**
+   * Recorded frames to return, or `nullptr` to return constant frames.
+   *
+   * Never modified, so it can be shared between copies.
+   */
+  std::shared_ptr<const FrameReplay> replay_;
+  ReplayTiming replay_timing_ = ReplayTiming::ORIGINAL;
+  /** Whether to go back to the first frame after the last frame */
+  bool replay_loop_ = true;
+  /** The index of the next frame in the ::replay_ */
+  std::size_t replay_index_ = 0;
+  /** When the first frame of the current pass through ::replay_ was taken */
+  std::chrono::steady_clock::time_point replay_start_;
+  /** The time of the previous replayed frame */
+  std::chrono::steady_clock::time_point replay_previous_time_point_;
+  /**
+   * Generated/recorded frames before the ::frame_transform_ is applied,
+   * unused if the transform doesn't change the frame.
+   */
+  IRImager::ThermalFrame sensor_frame_;
+
+  /**
+   * Where to write the frame from the sensor, i.e. @p thermal_frame, unless
+   * the ::frame_transform_ changes the frame.
+   */
+  std::uint16_t *sensor_frame_data(
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame) {
+    if (frame_transform_.is_identity()) {
+      return thermal_frame.data();
+    }
+    auto [rows, cols] = sensor_shape();
+    sensor_frame_.resize(rows, cols);
+    return sensor_frame_.data();
+  }
+
+  /** Copies the ::sensor_frame_ into @p thermal_frame, if needed */
+  void transform_sensor_frame(
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame) {
+    if (!frame_transform_.is_identity()) {
+      frame_transform_.apply(sensor_frame_.data(), sensor_shape(),
+                             thermal_frame);
+    }
+  }
+
+  /** Copies the next frame from the ::replay_ */
+  FrameStatus replay_frame(Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+                           FrameInfo &frame_info) {
+    if (replay_index_ == replay_->size()) {
+      if (!replay_loop_) {
+        throw std::runtime_error(
+            "Reached the end of the replayed frames, and loop is disabled");
+      }
+      replay_index_ = 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto *out = sensor_frame_data(thermal_frame);
+    auto offset = replay_->read(replay_index_, out, frame_info.metadata);
+    transform_sensor_frame(thermal_frame);
+    auto processed = std::chrono::steady_clock::now();
+    pipeline_latency_.record(PipelineStage::PROCESS, processed - start);
+
+    if (replay_index_ == 0) {
+      // start the next pass one frame period after the previous frame
+      replay_start_ =
+          std::max(std::chrono::steady_clock::now(),
+                   replay_previous_time_point_ + scheduler_.period());
+    }
+    replay_index_++;
+
+    switch (replay_timing_) {
+      case ReplayTiming::ORIGINAL:
+        frame_info.time_point = replay_start_ + offset;
+        FrameScheduler::precise_sleep_until(frame_info.time_point);
+        break;
+      case ReplayTiming::AS_FAST_AS_POSSIBLE:
+        frame_info.time_point = std::chrono::steady_clock::now();
+        break;
+    }
+    replay_previous_time_point_ = frame_info.time_point;
+    // replayed frames are read before waiting for the "camera"
+    pipeline_latency_.record_since(PipelineStage::ACQUIRE, processed);
+
+    return frame_info.metadata.flag_state == FlagState::OPEN
+               ? FrameStatus::GOOD
+               : FrameStatus::SHUTTER_CLOSED;
+  }
 };
 
 #ifdef IR_IMAGER_MOCK
@@ -151,6 +1350,24 @@ class IRDeviceException : public std::runtime_error {
   }
 };
 
+/**
+ * Converts the flag state in evo::IRFrameMetadata to our FlagState enum.
+ */
+FlagState to_flag_state(evo::EnumFlagState flag_state) {
+  switch (flag_state) {
+    case evo::irFlagOpen:
+      return FlagState::OPEN;
+    case evo::irFlagClose:
+      return FlagState::CLOSED;
+    case evo::irFlagOpening:
+      return FlagState::OPENING;
+    case evo::irFlagClosing:
+      return FlagState::CLOSING;
+    default:
+      return FlagState::ERROR;
+  }
+}
+
 template <class, class = void>
 struct has_get_temp_range_decimal : std::false_type {};
 
@@ -174,6 +1391,7 @@ struct IRImagerRealImpl final : public IRImager::impl {
     auto other_real = dynamic_cast<const IRImagerRealImpl *>(&other);
     if (other_real != nullptr) {
       ir_device_ = other_real->ir_device_;
+      raw_frame_bytes_.resize(other_real->raw_frame_bytes_.size());
     }
   }
 
@@ -206,9 +1424,11 @@ struct IRImagerRealImpl final : public IRImager::impl {
     ir_imager_.init(&params, ir_device_->getFrequency(), ir_device_->getWidth(),
                     ir_device_->getHeight(), ir_device_->controlledViaHID());
     ir_imager_.setThermalFrameCallback(&onThermalFrame);
+
+    raw_frame_bytes_.resize(ir_device_->getRawBufferSize());
   }
 
-  virtual ~IRImagerRealImpl() = default;
+  virtual ~IRImagerRealImpl() { stop_acquisition_thread(); }
 
   void start_streaming() override {
     // despite what the docs say, startStreaming() returns 0 on success, non-0
@@ -218,6 +1438,7 @@ struct IRImagerRealImpl final : public IRImager::impl {
           "Error occurred in starting stream. You may need to reconnect the "
           "camera.");
     }
+    streaming_ = true;
   }
 
   virtual void stop_streaming() override {
@@ -226,55 +1447,81 @@ struct IRImagerRealImpl final : public IRImager::impl {
     if (ir_device_->stopStreaming() != 0) {
       throw std::runtime_error("Error occurred in stopping stream.");
     }
+    streaming_ = false;
   }
 
-  std::tuple<IRImager::ThermalFrame, std::chrono::steady_clock::time_point>
-  get_frame_monotonic() override {
-    auto raw_frame_bytes =
-        std::vector<unsigned char>(ir_device_->getRawBufferSize());
+  short get_temp_range_decimal() override {
+    static_assert(has_get_temp_range_decimal<evo::IRImager>::value == false,
+                  "evo::IRImager has a get_temp_range_decimal function, which "
+                  "should be used instead of this override.");
+    return 1;
+  }
+
+  std::string_view get_library_version() override {
+    return evo::IRImager::getVersion();
+  }
+
+ protected:
+  std::array<Eigen::Index, 2> sensor_shape() override {
+    // TODO: evo::IRImager doesn't mention if data is RowMajor/ColumnMajor
+    //       so we're assuming it's RowMajor.
+    return {static_cast<Eigen::Index>(ir_device_->getWidth()),
+            static_cast<Eigen::Index>(ir_device_->getHeight())};
+  }
+
+  FrameStatus acquire_frame(
+      Eigen::Map<IRImager::ThermalFrame> thermal_frame,
+      FrameInfo &frame_info) override {
     /** time of frame, in monotonic seconds since std::chrono::steady_clock */
     double timestamp;
+    auto start = std::chrono::steady_clock::now();
     evo::IRDeviceError device_error =
-        ir_device_->getFrame(raw_frame_bytes.data(), &timestamp);
+        ir_device_->getFrame(raw_frame_bytes_.data(), &timestamp);
     if (device_error != evo::IRIMAGER_SUCCESS) {
       throw IRDeviceException(device_error);
     }
+    auto acquired = std::chrono::steady_clock::now();
+    pipeline_latency_.record(PipelineStage::ACQUIRE, acquired - start);
 
-    ir_imager_.process(raw_frame_bytes.data(), static_cast<void *>(this));
+    {
+      auto lock = std::scoped_lock(mutex_);
+      if (frame_status_.has_value()) {
+        pipeline_latency_.count_overrun();
+        spdlog::warn(
+            "frame_status_ is not empty, this might occur due to calling "
+            "`get_frame()` before the previous `get_frame()` is finished");
+      }
+      frame_status_ = std::nullopt;
+      frame_error_ = nullptr;
+      pending_frame_ = &thermal_frame;
+      pending_metadata_ = &frame_info.metadata;
+    }
+
+    ir_imager_.process(raw_frame_bytes_.data(), static_cast<void *>(this));
 
-    std::variant<IRImager::ThermalFrame, BadFrame, nullptr_t>
-        thermal_data_result = nullptr;
+    std::optional<FrameStatus> frame_status = std::nullopt;
     {
       // wait until ir_imager_.process() calls the
-      // IRImager::impl::onThermalFrame callback and fills @p thermal_data_
+      // IRImager::impl::onThermalFrame callback and fills @p thermal_frame
       auto lk = std::unique_lock(mutex_);
 
-      if (thermal_data_available_.wait_for(lk, std::chrono::seconds(30), [&] {
-            return !std::holds_alternative<nullptr_t>(thermal_data_);
-          }) == false) {
+      auto got_frame =
+          thermal_data_available_.wait_for(lk, std::chrono::seconds(30), [&] {
+            return frame_status_.has_value() || frame_error_;
+          });
+      pending_frame_ = nullptr;
+      pending_metadata_ = nullptr;
+      if (frame_error_) {
+        std::rethrow_exception(std::exchange(frame_error_, nullptr));
+      }
+      if (!got_frame) {
         throw std::runtime_error(
             "Timeout when waiting for a new thermal frame");
       }
 
-      thermal_data_result.swap(thermal_data_);
-    }
-
-    if (std::holds_alternative<BadFrame>(thermal_data_result)) {
-      switch (std::get<BadFrame>(thermal_data_result)) {
-        case BadFrame::SHUTTER_CLOSED:
-          spdlog::debug("Shutter was down, trying to take a frame again");
-#ifdef __clang__
-          // GCC will tail-call optimize too on x86_64 and ARM64, but even if it
-          // doesn't we're extremely unlikely to have a stack overflow, even if
-          // imaging at 1000Hz
-          [[clang::musttail]] return get_frame_monotonic();
-#else
-          return get_frame_monotonic();
-#endif
-      }
-
-      throw std::runtime_error("Failed to get a thermal frame");
+      frame_status.swap(frame_status_);
     }
+    pipeline_latency_.record_since(PipelineStage::PROCESS, acquired);
 
     auto seconds_since_epoch =
         std::chrono::duration<double, std::ratio<1> >(timestamp);
@@ -282,24 +1529,10 @@ struct IRImagerRealImpl final : public IRImager::impl {
         std::chrono::floor<std::chrono::nanoseconds>(seconds_since_epoch);
 
     // need to convert our double duration to an integer duration
-    auto monotonic_time_point =
-        std::chrono::time_point<std::chrono::steady_clock>(
-            nanoseconds_since_epoch);
-
-    return std::make_tuple(
-        std::get<IRImager::ThermalFrame>(std::move(thermal_data_result)),
-        std::move(monotonic_time_point));
-  }
-
-  short get_temp_range_decimal() override {
-    static_assert(has_get_temp_range_decimal<evo::IRImager>::value == false,
-                  "evo::IRImager has a get_temp_range_decimal function, which "
-                  "should be used instead of this override.");
-    return 1;
-  }
+    frame_info.time_point = std::chrono::time_point<std::chrono::steady_clock>(
+        nanoseconds_since_epoch);
 
-  std::string_view get_library_version() override {
-    return evo::IRImager::getVersion();
+    return *frame_status;
   }
 
  private:
@@ -307,36 +1540,51 @@ struct IRImagerRealImpl final : public IRImager::impl {
   evo::IRImager ir_imager_;
 
   /**
-   * Enum that explains why a frame might be bad.
+   * Buffer for the raw frame from the ::ir_device_.
+   *
+   * Allocated once, since only one frame is acquired at a time, see
+   * IRImager::impl::grab_mutex_.
    */
-  enum class BadFrame {
-    /** The shutter was closed, so this frame is only for calibration */
-    SHUTTER_CLOSED,
-  };
+  std::vector<unsigned char> raw_frame_bytes_;
 
   /**
-   * Locks the ::thermal_data_available_ and ::thermal_data_ attributes.
+   * Locks the ::thermal_data_available_, ::pending_frame_, ::frame_status_,
+   * and ::frame_error_ attributes.
    */
   std::mutex mutex_;
   /**
-   * Notifies that the ::thermal_data_ param holds data.
+   * Notifies that the ::frame_status_ param holds data.
    */
   std::condition_variable thermal_data_available_;
+  /**
+   * Where the next thermal frame should be written to, or `nullptr` if
+   * nobody is waiting for a frame.
+   */
+  Eigen::Map<IRImager::ThermalFrame> *pending_frame_ = nullptr;
+  /**
+   * Where the metadata of the next thermal frame should be written to.
+   */
+  FrameMetadata *pending_metadata_ = nullptr;
   /**
    * Either a:
-   *   - IRImager::ThermalFrame, containing the thermal frame,
-   *   - ::BadFrame, containing an enum on why the frame is bad,
-   *   - or `nullptr`, which means there is no frame data.
+   *   - ::FrameStatus, explaining whether ::pending_frame_ has been filled
+   *     with good data,
+   *   - or `std::nullopt`, which means there is no frame data.
    */
-  std::variant<IRImager::ThermalFrame, BadFrame, nullptr_t> thermal_data_ =
-      nullptr;
+  std::optional<FrameStatus> frame_status_ = std::nullopt;
+  /**
+   * Set instead of ::frame_status_ if the thermal frame could not be used,
+   * and rethrown by acquire_frame().
+   */
+  std::exception_ptr frame_error_;
 
   /**
    * Thermal frame callback function.
    *
-   * Stores the thermal frame in the ::thermal_data_ attribute, then sends a
-   * notification on ::thermal_data_available_ to let any listeners know that
-   * a frame has arrived.
+   * Copies the thermal frame into the ::pending_frame_, sets the
+   * ::frame_status_ (or ::frame_error_) attribute, then sends a notification on
+   * ::thermal_data_available_ to let any listeners know that a frame has
+   * arrived.
    *
    * @param[in] thermal Thermal data 2D-array.
    * @param w           Width of thermal data array.
@@ -349,27 +1597,49 @@ struct IRImagerRealImpl final : public IRImager::impl {
    */
   static void onThermalFrame(unsigned short *thermal, unsigned int w,
                              unsigned int h,
-                             [[maybe_unused]] evo::IRFrameMetadata meta,
-                             void *arg) {
+                             evo::IRFrameMetadata meta, void *arg) {
     auto data = static_cast<IRImagerRealImpl *>(arg);
     {
       auto lock = std::scoped_lock(data->mutex_);
 
-      if (!std::holds_alternative<nullptr_t>(data->thermal_data_)) {
-        spdlog::warn(
-            "thermal_data_ is not empty, this might occur due to calling "
-            "`get_frame()` before the previous `get_frame()` is finished");
+      if (data->pending_frame_ == nullptr) {
+        data->pipeline_latency_.count_overrun();
+        spdlog::warn("Received a thermal frame that nobody was waiting for");
+        return;
       }
 
-      if (data->ir_imager_.isFlagOpen()) {
-        // TODO: evo::IRImager doesn't mention if data is RowMajor/ColumnMajor
-        //       so we're assuming it's RowMajor.
-        auto array = Eigen::Map<IRImager::ThermalFrame>(thermal, w, h);
+      auto &metadata = *data->pending_metadata_;
+      metadata.counter = meta.counter;
+      metadata.counter_hw = meta.counterHW;
+      metadata.flag_state = to_flag_state(meta.flagState);
+      metadata.temp_chip = meta.tempChip;
+      metadata.temp_flag = meta.tempFlag;
+      metadata.temp_box = meta.tempBox;
 
-        data->thermal_data_ = std::move(array);
+      if (data->ir_imager_.isFlagOpen()) {
+        auto thermal_shape = std::array<Eigen::Index, 2>{
+            static_cast<Eigen::Index>(w), static_cast<Eigen::Index>(h)};
+        auto expected_shape = data->sensor_shape();
+        if (thermal_shape != expected_shape) {
+          // wake up acquire_frame() now, instead of letting it timeout
+          data->frame_error_ = std::make_exception_ptr(std::runtime_error(
+              "Thermal frame has unexpected shape (" + std::to_string(w) +
+              ", " + std::to_string(h) + "), expected (" +
+              std::to_string(expected_shape[0]) + ", " +
+              std::to_string(expected_shape[1]) + ")"));
+        } else {
+          // TODO: evo::IRImager doesn't mention if data is
+          //       RowMajor/ColumnMajor so we're assuming it's RowMajor.
+          // cropping/binning while copying means we never copy the full
+          // frame
+          data->frame_transform_.apply(thermal, thermal_shape,
+                                       *data->pending_frame_);
+
+          data->frame_status_ = FrameStatus::GOOD;
+        }
       } else {
         // shutter is down, frame data is bad
-        data->thermal_data_ = BadFrame::SHUTTER_CLOSED;
+        data->frame_status_ = FrameStatus::SHUTTER_CLOSED;
       }
     }
     data->thermal_data_available_.notify_one();
@@ -396,9 +1666,33 @@ IRImager::IRImager(const char *xml_path, std::size_t xml_path_len)
 
 IRImager::~IRImager() = default;
 
-void IRImager::start_streaming() { pImpl_->start_streaming(); }
+void IRImager::start_streaming(std::size_t frame_queue_size,
+                               OverflowPolicy overflow_policy,
+                               ShutterPolicy shutter_policy) {
+  // the acquisition thread reads the shutter policy, so stop it first
+  pImpl_->stop_acquisition_thread();
+  pImpl_->set_shutter_policy(shutter_policy);
+  pImpl_->start_streaming();
+  pImpl_->reset_frame_pool(frame_queue_size);
+  if (frame_queue_size > 0) {
+    pImpl_->start_acquisition_thread(frame_queue_size, overflow_policy);
+  } else if (pImpl_->has_frame_callback()) {
+    // the queue is unused while a callback is set, but needs a slot if the
+    // callback is removed
+    pImpl_->start_acquisition_thread(1, overflow_policy);
+  }
+}
 
-void IRImager::stop_streaming() { pImpl_->stop_streaming(); }
+void IRImager::stop_streaming() {
+  pImpl_->stop_acquisition_thread();
+  pImpl_->stop_streaming();
+  // wake up anybody waiting asynchronously, so they can see we've stopped
+  pImpl_->notify_frame_event();
+}
+
+bool IRImager::is_streaming() { return pImpl_->is_streaming(); }
+
+int IRImager::get_frame_event_fd() { return pImpl_->get_frame_event_fd(); }
 
 std::tuple<IRImager::ThermalFrame, std::chrono::system_clock::time_point>
 IRImager::get_frame() {
@@ -410,6 +1704,109 @@ IRImager::get_frame_monotonic() {
   return pImpl_->get_frame_monotonic();
 }
 
+std::chrono::system_clock::time_point IRImager::get_frame_into(
+    Eigen::Ref<ThermalFrame> out) {
+  return nqm::irimager::clock_cast(pImpl_->get_frame_monotonic_into(out));
+}
+
+std::chrono::steady_clock::time_point IRImager::get_frame_monotonic_into(
+    Eigen::Ref<ThermalFrame> out) {
+  return pImpl_->get_frame_monotonic_into(out);
+}
+
+std::chrono::steady_clock::time_point
+IRImager::get_temperature_frame_monotonic_into(Eigen::Ref<TemperatureFrame> out,
+                                               TemperatureUnit unit) {
+  return pImpl_->get_temperature_frame_monotonic_into(out, unit);
+}
+
+std::size_t IRImager::get_frames_monotonic_into(
+    Eigen::Ref<ThermalFrames> frames, Eigen::Ref<Timestamps> timestamps,
+    std::chrono::steady_clock::duration timeout, FrameMetadata *metadata) {
+  return pImpl_->get_frames_monotonic_into(frames, timestamps, timeout,
+                                           metadata);
+}
+
+std::tuple<Eigen::Index, Eigen::Index> IRImager::get_frame_shape() {
+  return pImpl_->get_frame_shape();
+}
+
+std::tuple<IRImager::PooledThermalFrame, std::chrono::steady_clock::time_point,
+           FrameMetadata>
+IRImager::get_pooled_frame_monotonic() {
+  return pImpl_->get_pooled_frame_monotonic();
+}
+
+std::optional<std::tuple<IRImager::PooledThermalFrame,
+                         std::chrono::steady_clock::time_point, FrameMetadata>>
+IRImager::try_get_pooled_frame_monotonic(
+    std::chrono::steady_clock::duration timeout) {
+  return pImpl_->try_get_pooled_frame_monotonic(timeout);
+}
+
+void IRImager::set_frame_callback(FrameCallback callback) {
+  pImpl_->set_frame_callback(std::move(callback));
+}
+
+void IRImager::set_acquisition_thread_scheduling(
+    const ThreadScheduling &thread_scheduling) {
+  pImpl_->set_acquisition_thread_scheduling(thread_scheduling);
+}
+
+std::optional<AppliedThreadScheduling>
+IRImager::get_acquisition_thread_scheduling() {
+  return pImpl_->get_acquisition_thread_scheduling();
+}
+
+BufferPoolStats IRImager::get_frame_pool_stats() {
+  return pImpl_->get_frame_pool_stats();
+}
+
+PipelineStats IRImager::get_stats() { return pImpl_->get_stats(); }
+
+void IRImager::reset_stats() { pImpl_->reset_stats(); }
+
+void IRImager::record_latency(PipelineStage stage,
+                              std::chrono::nanoseconds latency) {
+  pImpl_->record_latency(stage, latency);
+}
+
+void IRImager::set_frame_transform(const FrameTransform &frame_transform) {
+  pImpl_->set_frame_transform(frame_transform);
+}
+
+FrameTransform IRImager::get_frame_transform() {
+  return pImpl_->get_frame_transform();
+}
+
+std::size_t IRImager::add_roi_rectangle(Eigen::Index row, Eigen::Index col,
+                                        Eigen::Index height,
+                                        Eigen::Index width) {
+  return pImpl_->add_roi_rectangle(row, col, height, width);
+}
+
+std::size_t IRImager::add_roi_polygon(
+    const std::vector<std::array<double, 2>> &vertices) {
+  return pImpl_->add_roi_polygon(vertices);
+}
+
+void IRImager::clear_rois() { pImpl_->clear_rois(); }
+
+std::size_t IRImager::get_roi_count() { return pImpl_->get_roi_count(); }
+
+void IRImager::set_roi_quantiles(std::vector<double> quantiles) {
+  pImpl_->set_roi_quantiles(std::move(quantiles));
+}
+
+std::vector<double> IRImager::get_roi_quantiles() {
+  return pImpl_->get_roi_quantiles();
+}
+
+std::chrono::steady_clock::time_point IRImager::get_roi_stats_monotonic_into(
+    Eigen::Ref<RoiStats> out) {
+  return pImpl_->get_roi_stats_monotonic_into(out);
+}
+
 short IRImager::get_temp_range_decimal() {
   return pImpl_->get_temp_range_decimal();
 }
@@ -424,3 +1821,15 @@ IRImagerMock::IRImagerMock(const std::filesystem::path &xml_path) {
 
 IRImagerMock::IRImagerMock(const char *xml_path, std::size_t xml_path_len)
     : IRImagerMock(std::string(xml_path, xml_path_len)) {}
+
+IRImagerMock::IRImagerMock(const std::filesystem::path &xml_path,
+                           const std::filesystem::path &replay_path,
+                           ReplayTiming replay_timing, bool loop) {
+  pImpl_ = std::make_unique<IRImagerMockImpl>(xml_path, replay_path,
+                                              replay_timing, loop);
+}
+
+IRImagerMock::IRImagerMock(const std::filesystem::path &xml_path,
+                           const SyntheticSceneOptions &scene) {
+  pImpl_ = std::make_unique<IRImagerMockImpl>(xml_path, scene);
+}
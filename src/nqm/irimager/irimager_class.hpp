@@ -4,14 +4,158 @@
 #include <Eigen/Dense>
 
 #include <chrono>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
+#include <vector>
 
 #include "propagate_const.h"
 
+#include "./buffer_pool.hpp"
+#include "./frame_transform.hpp"
+#include "./latency_stats.hpp"
+#include "./roi.hpp"
+#include "./temperature.hpp"
+#include "./thread_scheduling.hpp"
+
+/**
+ * State of the shutter flag of the camera.
+ */
+enum class FlagState : std::uint8_t {
+  /** The flag is open, the frame contains valid thermal data. */
+  OPEN,
+  /** The flag is closed, e.g. for calibration. */
+  CLOSED,
+  /** The flag is opening. */
+  OPENING,
+  /** The flag is closing. */
+  CLOSING,
+  /** The flag is in an error/unknown state. */
+  ERROR,
+};
+
+/**
+ * Metadata about a thermal frame.
+ */
+struct FrameMetadata {
+  /** Frame counter, as counted by the IRImagerDirect SDK. */
+  std::uint32_t counter;
+  /** Frame counter, as counted by the camera hardware. */
+  std::uint32_t counter_hw;
+  /** State of the shutter flag when the frame was taken. */
+  FlagState flag_state;
+  /** Temperature of the camera's chip, in degrees Celsius. */
+  float temp_chip;
+  /** Temperature of the camera's shutter flag, in degrees Celsius. */
+  float temp_flag;
+  /** Temperature of the camera's housing, in degrees Celsius. */
+  float temp_box;
+  /**
+   * Sequence number of the frame, counted by IRImager from `1`.
+   *
+   * Every frame grabbed from the camera gets the next sequence number, even
+   * if it is later dropped or skipped, so a gap between two frames means
+   * that frames were lost in between. A gap in ::counter_hw instead means
+   * that the camera took frames that were never grabbed.
+   */
+  std::uint64_t sequence;
+
+  /**
+   * Whether the shutter flag was not open when this frame was taken, so the
+   * thermal data is from the last good frame.
+   *
+   * Only happens with ShutterPolicy::RETURN_STALE.
+   */
+  bool is_stale() const { return flag_state != FlagState::OPEN; }
+};
+
+/**
+ * What to do when the background frame queue is full.
+ *
+ * @see IRImager::start_streaming()
+ */
+enum class OverflowPolicy : std::uint8_t {
+  /**
+   * Stop grabbing frames until there is space in the queue.
+   *
+   * No frames are dropped by us, but the camera may drop frames internally.
+   */
+  BLOCK,
+  /**
+   * Throw away the oldest queued frame, so that the newest frame is always
+   * available. Use with a ``frame_queue_size`` of ``1`` to always get the
+   * latest frame.
+   */
+  DROP_OLDEST,
+  /** Throw away new frames until there is space in the queue. */
+  DROP_NEWEST,
+};
+
+/**
+ * What to do with frames taken while the shutter flag is not open, e.g.
+ * while the camera is calibrating itself.
+ *
+ * @see IRImager::start_streaming()
+ */
+enum class ShutterPolicy : std::uint8_t {
+  /**
+   * Skip the frames, so that getting a frame waits until the shutter flag
+   * is open again (usually around ~1s).
+   */
+  WAIT,
+  /**
+   * Immediately return the last good frame, with the metadata of the new
+   * frame, so that FrameMetadata::is_stale() is ``true``.
+   *
+   * Frames are still skipped if there hasn't been a good frame since
+   * streaming started. Every good frame is copied, so this is slightly
+   * slower than ShutterPolicy::WAIT.
+   */
+  RETURN_STALE,
+};
+
+/**
+ * How IRImagerMock plays back recorded frames.
+ */
+enum class ReplayTiming : std::uint8_t {
+  /** Wait between frames, so that they arrive as they were recorded. */
+  ORIGINAL,
+  /**
+   * Return each frame as soon as it is requested, e.g. to benchmark how
+   * quickly frames can be processed.
+   */
+  AS_FAST_AS_POSSIBLE,
+};
+
+/**
+ * @brief Options for the synthetic scene generated by IRImagerMock.
+ */
+struct SyntheticSceneOptions {
+  /**
+   * Seed for the random scene.
+   *
+   * The same seed always generates the same frames (on the same platform).
+   */
+  std::uint64_t seed = 0;
+  /** The number of hotspots that move around the scene. */
+  std::size_t hotspots = 3;
+  /** The standard deviation of the noise added to each pixel, in ℃. */
+  float noise = 0.5f;
+  /**
+   * Whether to periodically close the shutter flag, if `<autoflag>` is
+   * enabled in the XML config file.
+   *
+   * Frames taken while the shutter flag is not open are skipped, like with a
+   * real camera.
+   */
+  bool shutter_closures = true;
+};
+
 /**
  * IRImager object - interfaces with a camera.
  */
@@ -25,6 +169,57 @@ class IRImager {
   using ThermalFrame =
       Eigen::Matrix<uint16_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
 
+  /**
+   * Thermal frame in degrees Celsius or Kelvin.
+   *
+   * @see raw_to_temperature()
+   */
+  using TemperatureFrame =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  /**
+   * Multiple thermal frames, stored contiguously.
+   *
+   * Each row contains a single flattened ThermalFrame.
+   */
+  using ThermalFrames = ThermalFrame;
+
+  /**
+   * Monotonic timestamps, in nanoseconds.
+   */
+  using Timestamps = Eigen::Matrix<std::int64_t, Eigen::Dynamic, 1>;
+
+  /**
+   * Pool of recycled ThermalFrame buffers.
+   */
+  using ThermalFramePool = BufferPool<ThermalFrame>;
+
+  /**
+   * A ThermalFrame whose storage is returned to a ThermalFramePool when
+   * destroyed.
+   */
+  using PooledThermalFrame = ThermalFramePool::Handle;
+
+  /**
+   * Statistics of each region of interest, with one row per ROI, and one
+   * column per RoiStat.
+   */
+  using RoiStats = RoiStatsEngine::RoiStats;
+
+  /**
+   * @brief Function that is called with every new frame.
+   *
+   * @warning This function is called from the background acquisition thread,
+   * so it should return quickly, otherwise frames will be dropped.
+   * If it throws an exception, frame acquisition is stopped.
+   *
+   * @see set_frame_callback()
+   */
+  using FrameCallback =
+      std::function<void(PooledThermalFrame thermal_frame,
+                         std::chrono::steady_clock::time_point time_point,
+                         const FrameMetadata &metadata)>;
+
   /**
    * Copies and existing IRImager object.
    */
@@ -67,23 +262,43 @@ class IRImager {
    * Prefer using `with irimager: ...` to automatically start/stop streaming
    * on errors.
    *
+   * @param frame_queue_size If `0` (the default), frames are only grabbed from
+   * the camera when calling :py:meth:`~IRImager.get_frame`.
+   * Otherwise, a background thread continuously grabs frames from the camera
+   * and stores up to ``frame_queue_size`` frames in a queue, so that frames
+   * aren't lost if :py:meth:`~IRImager.get_frame` isn't called often enough.
+   * @param overflow_policy What to do with new frames when the queue is full.
+   * Ignored if ``frame_queue_size`` is ``0``.
+   * @param shutter_policy What to do with frames taken while the shutter flag
+   * is not open.
+   *
    * @throws RuntimeError if streaming cannot be started, e.g. if the camera
    *                      is not connected.
    */
-  void start_streaming();
+  void start_streaming(
+      std::size_t frame_queue_size = 0,
+      OverflowPolicy overflow_policy = OverflowPolicy::DROP_NEWEST,
+      ShutterPolicy shutter_policy = ShutterPolicy::WAIT);
 
   /**
    * Stop video grabbing
    */
   void stop_streaming();
 
+  /**
+   * Whether :py:meth:`start_streaming` has been called, and
+   * :py:meth:`stop_streaming` has not.
+   */
+  bool is_streaming();
+
   /**
    * Return a frame.
    *
    * If the shutter is down
    * (normally done automatically by the thermal camera for calibration),
    * this function will wait until the shutter is back up, before returning
-   * (usually around ~1s).
+   * (usually around ~1s), unless streaming was started with
+   * ShutterPolicy::RETURN_STALE.
    *
    * @throws RuntimeError if a frame cannot be loaded,
    *                      e.g. if the camera isn't streaming.
@@ -108,6 +323,335 @@ class IRImager {
   std::tuple<ThermalFrame, std::chrono::steady_clock::time_point>
   get_frame_monotonic();
 
+  /**
+   * @brief Write a frame into an existing array, instead of allocating one.
+   *
+   * Similar to :py:meth:`get_frame`, except that the thermal data is written
+   * directly into ``out``.
+   *
+   * @param[out] out A C-contiguous, writeable ``uint16`` array, with the same
+   * shape as the arrays returned by :py:meth:`get_frame`.
+   *
+   * @throws ValueError if ``out`` has the wrong shape or is not contiguous.
+   * @throws RuntimeError if a frame cannot be loaded,
+   *                      e.g. if the camera isn't streaming.
+   *
+   * @returns The approximate time the image was taken.
+   */
+  std::chrono::system_clock::time_point get_frame_into(
+      Eigen::Ref<ThermalFrame> out);
+
+  /**
+   * @brief Write a frame into an existing array, with a monotonic timestamp.
+   *
+   * Similar to :py:meth:`get_frame_into`, except returns a monotonic
+   * timepoint, see :py:meth:`get_frame_monotonic`.
+   */
+  std::chrono::steady_clock::time_point get_frame_monotonic_into(
+      Eigen::Ref<ThermalFrame> out);
+
+  /**
+   * @brief Write a frame, converted to temperatures, into an existing array.
+   *
+   * Similar to :py:meth:`get_frame_monotonic_into`, except that the raw
+   * thermal data is converted to ``float32`` temperatures in a single
+   * vectorised pass, without any temporary arrays.
+   *
+   * @param[out] out A C-contiguous, writeable ``float32`` array, with the
+   * same shape as the arrays returned by :py:meth:`get_frame`.
+   * @param unit The unit of temperature to output.
+   *
+   * @throws ValueError if ``out`` has the wrong shape or is not contiguous.
+   * @throws RuntimeError if a frame cannot be loaded,
+   *                      e.g. if the camera isn't streaming.
+   *
+   * @returns The monotonic time the frame was taken.
+   */
+  std::chrono::steady_clock::time_point get_temperature_frame_monotonic_into(
+      Eigen::Ref<TemperatureFrame> out,
+      TemperatureUnit unit = TemperatureUnit::CELSIUS);
+
+  /**
+   * @brief Write multiple frames into existing arrays.
+   *
+   * Used to implement :py:meth:`get_frames`, which avoids the per-frame
+   * overhead of calling :py:meth:`get_frame` from Python.
+   *
+   * @param[out] frames Each row is filled with a flattened frame.
+   * @param[out] timestamps Filled with the monotonic time of each frame, in
+   *                        nanoseconds.
+   * @param timeout Stop waiting for frames after this duration.
+   * @param[out] metadata If not `nullptr`, an array of `frames.rows()`
+   *                      elements, that is filled with each frame's metadata.
+   *
+   * @returns The number of frames written, which is less than
+   *          `frames.rows()` if the timeout expired.
+   */
+  std::size_t get_frames_monotonic_into(
+      Eigen::Ref<ThermalFrames> frames, Eigen::Ref<Timestamps> timestamps,
+      std::chrono::steady_clock::duration timeout,
+      FrameMetadata *metadata = nullptr);
+
+  /**
+   * The shape of the frames returned by :py:meth:`get_frame`.
+   *
+   * @returns A tuple of ``(rows, columns)``.
+   */
+  std::tuple<Eigen::Index, Eigen::Index> get_frame_shape();
+
+  /**
+   * @brief Return a frame stored in a recycled buffer.
+   *
+   * Similar to get_frame_monotonic(), except that the frame's storage
+   * comes from (and is returned to) a pool of buffers, so that once the pool
+   * is warmed up, getting a frame does not allocate any memory.
+   *
+   * @see get_frame_pool_stats()
+   *
+   * @returns A tuple containing:
+   *         1. The frame, see :py:meth:`get_frame`.
+   *         2. The monotonic time the frame was taken.
+   *         3. The frame's metadata.
+   */
+  std::tuple<PooledThermalFrame, std::chrono::steady_clock::time_point,
+             FrameMetadata>
+  get_pooled_frame_monotonic();
+
+  /**
+   * @brief Return a frame stored in a recycled buffer, or nothing on timeout.
+   *
+   * Similar to get_pooled_frame_monotonic(), except that this function gives
+   * up after @p timeout, instead of throwing an exception.
+   *
+   * If ``frame_queue_size`` is ``0``, frames are grabbed directly from the
+   * camera, so this function may wait for up to one extra frame period
+   * after @p timeout.
+   *
+   * @returns The frame, see get_pooled_frame_monotonic(), or `std::nullopt`
+   *          if no frame was available within @p timeout.
+   */
+  std::optional<std::tuple<PooledThermalFrame,
+                           std::chrono::steady_clock::time_point, FrameMetadata>>
+  try_get_pooled_frame_monotonic(std::chrono::steady_clock::duration timeout);
+
+  /**
+   * @brief Set the crop rectangle and binning applied to every frame.
+   *
+   * Frames are cropped and binned while they are copied out of the
+   * IRImagerDirect SDK's buffer, so the full frame is never copied, and
+   * every other method (e.g. :py:meth:`get_frame` and
+   * :py:meth:`get_frame_shape`) returns the smaller frame.
+   *
+   * @throws ValueError if the crop rectangle is not inside the camera's
+   * frame, or if the binning is invalid.
+   * @throws RuntimeError if we're streaming, or if any regions of interest
+   * have been added, since they depend on the frame shape.
+   */
+  void set_frame_transform(const FrameTransform &frame_transform);
+
+  /** The transform set by :py:meth:`set_frame_transform`. */
+  FrameTransform get_frame_transform();
+
+  /**
+   * @brief Add a rectangular region of interest (ROI).
+   *
+   * The min/max/mean/standard deviation of the temperature in each ROI is
+   * computed for every frame, see :py:meth:`get_roi_stats`.
+   *
+   * The rectangle is clipped to the frame.
+   *
+   * @param row The first row of the rectangle.
+   * @param col The first column of the rectangle.
+   * @param height The number of rows in the rectangle.
+   * @param width The number of columns in the rectangle.
+   *
+   * @throws ValueError if the rectangle does not contain any pixels.
+   * @throws RuntimeError if we're streaming.
+   *
+   * @returns The index of the ROI, i.e. its row in :py:meth:`get_roi_stats`.
+   */
+  std::size_t add_roi_rectangle(Eigen::Index row, Eigen::Index col,
+                                Eigen::Index height, Eigen::Index width);
+
+  /**
+   * @brief Add a polygonal region of interest (ROI).
+   *
+   * The polygon is rasterised once, when it is added. A pixel is in the
+   * polygon if its centre is inside the polygon (using the even-odd rule),
+   * where pixel ``(row, col)`` covers the area from ``(col, row)`` to
+   * ``(col + 1, row + 1)``.
+   *
+   * @param vertices The ``(x, y)`` (i.e. ``(column, row)``) coordinates of
+   * the vertices of the polygon, in order.
+   *
+   * @throws ValueError if the polygon has fewer than 3 vertices, or does not
+   * contain any pixels.
+   * @throws RuntimeError if we're streaming.
+   *
+   * @returns The index of the ROI, i.e. its row in :py:meth:`get_roi_stats`.
+   */
+  std::size_t add_roi_polygon(
+      const std::vector<std::array<double, 2>> &vertices);
+
+  /**
+   * @brief Remove all regions of interest.
+   *
+   * @throws RuntimeError if we're streaming.
+   */
+  void clear_rois();
+
+  /** The number of regions of interest. */
+  std::size_t get_roi_count();
+
+  /**
+   * @brief Set the quantiles computed for every region of interest.
+   *
+   * For example, ``[0.5, 0.95]`` computes the median and the 95th percentile
+   * temperature of every ROI.
+   * Quantiles are computed exactly from a counting histogram of the raw
+   * data, see :py:meth:`Histogram.quantile`, without sorting any pixels.
+   *
+   * @param quantiles Each quantile (from ``0.0`` to ``1.0``) adds a column to
+   * :py:meth:`get_roi_stats`, after the :py:class:`RoiStat` columns.
+   *
+   * @throws ValueError if a quantile is not between ``0.0`` and ``1.0``.
+   * @throws RuntimeError if we're streaming.
+   */
+  void set_roi_quantiles(std::vector<double> quantiles);
+
+  /** The quantiles set by :py:meth:`set_roi_quantiles`. */
+  std::vector<double> get_roi_quantiles();
+
+  /**
+   * @brief Write the statistics of each region of interest into an array.
+   *
+   * If ``frame_queue_size`` is greater than ``0``, the statistics are
+   * computed by the background thread as each frame is grabbed, and only
+   * the statistics are copied, not the frame itself.
+   *
+   * @param[out] out A ``(get_roi_count(), 4 + len(get_roi_quantiles()))``
+   * ``float32`` array, whose first columns are indexed by
+   * :py:class:`RoiStat`, followed by each quantile, in degrees Celsius.
+   *
+   * @throws ValueError if ``out`` has the wrong shape.
+   * @throws RuntimeError if there are no ROIs, or if a frame cannot be
+   *                      loaded, e.g. if the camera isn't streaming.
+   *
+   * @returns The monotonic time the frame was taken.
+   */
+  std::chrono::steady_clock::time_point get_roi_stats_monotonic_into(
+      Eigen::Ref<RoiStats> out);
+
+  /**
+   * @brief File descriptor that becomes readable when frames are queued.
+   *
+   * Can be passed to `poll()` or :py:meth:`asyncio.loop.add_reader`, to wait
+   * for frames from the frame queue without blocking a thread.
+   * The file descriptor is also made readable when streaming stops, or if the
+   * background thread crashes, so that any waiters can wake up.
+   *
+   * The file descriptor is reset when trying to get a frame from an empty frame
+   * queue, so callers should keep calling try_get_pooled_frame_monotonic() with
+   * a timeout of `0` until it returns `std::nullopt`, before waiting again.
+   *
+   * The same file descriptor is returned every time, and is owned by this
+   * object, so it must not be closed.
+   *
+   * @throws std::runtime_error if we're not streaming with a frame queue, or
+   *                            if a frame callback is set.
+   */
+  int get_frame_event_fd();
+
+  /**
+   * @brief Set a function that is called with every new frame.
+   *
+   * Instead of polling with :py:meth:`get_frame`, frames are pushed to
+   * ``callback`` from a background thread, as soon as they are grabbed.
+   * While a callback is set, frames are not stored in the frame queue.
+   *
+   * The callback is called with the frame (see :py:meth:`get_frame`), the
+   * monotonic time the frame was taken (see :py:meth:`get_frame_monotonic`),
+   * and the frame's :py:class:`FrameMetadata`.
+   *
+   * If the previous callback is being called, this waits for it to return,
+   * then the previous callback is destroyed by the calling thread.
+   *
+   * @param callback The function to call, or ``None`` to remove the current
+   * callback.
+   *
+   * @throws RuntimeError if a callback is set while streaming with a
+   * ``frame_queue_size`` of ``0``, since there is no background thread to call
+   * it. Set the callback before calling :py:meth:`start_streaming` instead.
+   */
+  void set_frame_callback(FrameCallback callback);
+
+  /**
+   * @brief Set the CPU affinity and scheduling of the background acquisition
+   * thread.
+   *
+   * Takes effect the next time :py:meth:`start_streaming` starts the
+   * background thread, i.e. with a ``frame_queue_size`` greater than ``0``,
+   * or with a frame callback. Without a background thread, frames are
+   * grabbed by whichever thread calls :py:meth:`get_frame`.
+   *
+   * @throws ValueError if ``thread_scheduling`` is out of range.
+   */
+  void set_acquisition_thread_scheduling(
+      const ThreadScheduling &thread_scheduling);
+
+  /**
+   * Get the CPU affinity and scheduling that the OS actually gave the most
+   * recently started acquisition thread.
+   *
+   * Settings that the OS refused, e.g. ``SCHED_FIFO`` without the
+   * ``CAP_SYS_NICE`` capability, are listed in
+   * :py:attr:`AppliedThreadScheduling.errors`.
+   *
+   * @returns The applied scheduling, or ``None`` if no acquisition thread has
+   *          been started yet.
+   */
+  std::optional<AppliedThreadScheduling> get_acquisition_thread_scheduling();
+
+  /**
+   * Get statistics on how often frame buffers were reused.
+   *
+   * The pool is created by :py:meth:`~IRImager.start_streaming`, so all
+   * statistics are `0` before streaming has started.
+   */
+  BufferPoolStats get_frame_pool_stats();
+
+  /**
+   * Get the latency of each stage of the frame pipeline.
+   *
+   * Latencies are always recorded, so this can be used to find out where the
+   * time went when frames arrive late, e.g. waiting for the camera,
+   * processing the raw frame, waiting in the frame queue, or converting the
+   * frame to a numpy array.
+   *
+   * Also counts how many frames were acquired, delivered, dropped because
+   * the frame queue was full, skipped because the shutter was closed, or
+   * never grabbed from the camera at all, so that sustained frame loss can
+   * be detected.
+   *
+   * Statistics are kept until :py:meth:`reset_stats` is called, even if
+   * streaming is stopped and restarted.
+   */
+  PipelineStats get_stats();
+
+  /**
+   * Reset all the statistics returned by :py:meth:`get_stats` to `0`.
+   *
+   * Frames that are still queued are counted when they are delivered, so
+   * call this when not streaming to keep the frame counters consistent.
+   */
+  void reset_stats();
+
+  /**
+   * Records the latency of a pipeline stage that happens outside of this
+   * class, e.g. PipelineStage::CONVERT by the Python bindings.
+   */
+  void record_latency(PipelineStage stage, std::chrono::nanoseconds latency);
+
   /**
    * The number of decimal places in the thermal data
    *
@@ -145,6 +689,11 @@ class IRImager {
  *
  * This class can be used to return dummy data when there isn't a camera
  * connected (e.g. for testing).
+ *
+ * The mock pretends to be the camera in the XML config file, i.e. frames are
+ * returned at its ``<framerate>``, and the resolution is read from a
+ * ``<rows>x<cols>`` prefix in the XML filename (e.g. ``382x288@27Hz.xml``),
+ * or is 382x288 otherwise.
  */
 class IRImagerMock : public IRImager {
  public:
@@ -166,6 +715,48 @@ class IRImagerMock : public IRImager {
 #endif
       gnu::nonnull(2)]] IRImagerMock(const char *xml_path,
                                      std::size_t xml_path_len);
+
+  /**
+   * @brief Creates a mocked IRImager that plays back recorded frames.
+   *
+   * @param xml_path The camera configuration, see IRImager::IRImager().
+   * @param replay_path Either a recording written by a :py:class:`Recorder`,
+   * or a directory of ``.npy`` files (e.g. saved with ``numpy.save()``),
+   * each containing a single ``uint16`` frame, played back in filename order.
+   * @param replay_timing Whether to wait between frames, to play them back at
+   * the recorded frame rate. Frames from ``.npy`` files are played back at
+   * the ``<framerate>`` in ``xml_path``.
+   * @param loop If ``true``, start again from the first frame after the last
+   * frame, otherwise getting a frame after the last frame throws a
+   * ``RuntimeError``.
+   *
+   * Recorded shutter flag states are replayed too, so frames recorded with
+   * the shutter closed are skipped, like with a real camera.
+   *
+   * @throws ValueError if ``replay_path`` is not a valid recording, or a
+   * directory of valid ``.npy`` files.
+   */
+  IRImagerMock(const std::filesystem::path &xml_path,
+               const std::filesystem::path &replay_path,
+               ReplayTiming replay_timing = ReplayTiming::ORIGINAL,
+               bool loop = true);
+
+  /**
+   * @brief Creates a mocked IRImager that generates a synthetic scene.
+   *
+   * Frames contain a few hotspots that move around a smooth background, with
+   * random noise. The same ``scene.seed`` always generates the same frames.
+   *
+   * @param xml_path The camera configuration, see IRImager::IRImager().
+   * @param scene What the synthetic scene contains.
+   *
+   * Like every IRImagerMock, frames are paced at the ``<framerate>`` in
+   * ``xml_path``. If ``<autoflag>`` is enabled, the shutter flag closes every
+   * ``<mininterval>`` seconds, and frames taken while it is closed are
+   * skipped.
+   */
+  IRImagerMock(const std::filesystem::path &xml_path,
+               const SyntheticSceneOptions &scene);
 };
 
 #endif /* NQM_IRIMAGER_IRIMAGER */
@@ -7,6 +7,7 @@
 #include <propagate_const.h>
 
 #include "./definitions.hpp"
+#include "./thread_scheduling.hpp"
 
 /**
  * Handles capturing evo::IRLogger logs and passing them to a C++ callback.
@@ -26,16 +27,24 @@ class IRLoggerToSpd {
    * - The socket is placed into `$XDG_RUNTIME_DIR/nqm-irimager/` if it exists.
    * - Otherwise, an `{std::filesystem::temp_directory_path()}/nqm-irimager/`
    *   is used.
+   *
+   * @param thread_scheduling How to schedule the thread that reads the
+   * socket.
    */
-  IRLoggerToSpd(const LoggingCallback &logging_callback);
+  IRLoggerToSpd(const LoggingCallback &logging_callback,
+                const ThreadScheduling &thread_scheduling = {});
   /**
    * Creates an IRLoggerToSpd using a socket on the given path.
    */
   IRLoggerToSpd(const LoggingCallback &logging_callback,
-                const std::filesystem::path &socket_path);
+                const std::filesystem::path &socket_path,
+                const ThreadScheduling &thread_scheduling = {});
 
   virtual ~IRLoggerToSpd();
 
+  /** How the OS actually scheduled the thread that reads the socket. */
+  AppliedThreadScheduling get_thread_scheduling() const;
+
   /** pImpl implementation */
   struct impl;
 
@@ -37,6 +37,7 @@ extern "C" {
 
 #include "./chrono.hpp"
 #include "./irlogger_parser.hpp"
+#include "./thread_scheduling.hpp"
 
 namespace {
 
@@ -122,9 +123,10 @@ class PosixFileReadOnly {
 class IRLoggerReader {
  public:
   IRLoggerReader(LoggingCallback logging_callback,
-                 const std::filesystem::path &socket_path)
+                 const std::filesystem::path &socket_path,
+                 const ThreadScheduling &thread_scheduling)
       : ir_logger_parser_{logging_callback} {
-    start_thread(socket_path);
+    start_thread(socket_path, thread_scheduling);
   }
 
   virtual ~IRLoggerReader() {
@@ -135,8 +137,15 @@ class IRLoggerReader {
     }
   }
 
+  /** How the OS actually scheduled the logger thread */
+  const AppliedThreadScheduling &thread_scheduling() const {
+    return applied_thread_scheduling_;
+  }
+
  private:
-  void start_thread(const std::filesystem::path &socket_path) {
+  void start_thread(const std::filesystem::path &socket_path,
+                    const ThreadScheduling &thread_scheduling) {
+    thread_scheduling.validate();
     spdlog::debug("Making FIFO at {} for logging", socket_path.string());
 
     if (mkfifo(socket_path.string().c_str(), 0600) != 0) {
@@ -150,7 +159,20 @@ class IRLoggerReader {
     }
 
     spdlog::debug("starting thread");
+    thread_scheduling_ = thread_scheduling;
+    auto applied_future = applied_thread_scheduling_promise_.get_future();
     logger_thread_ = std::async(std::launch::async, [this, socket_path]() {
+      // must be done before logging anything, since logging may need the
+      // Python GIL, which is held by whoever is waiting for us
+      try {
+        applied_thread_scheduling_promise_.set_value(
+            apply_thread_scheduling(thread_scheduling_));
+      } catch (...) {
+        applied_thread_scheduling_promise_.set_exception(
+            std::current_exception());
+        return;
+      }
+
       spdlog::debug("Started new thread to read from {}", socket_path.string());
 
       thread_handle_ = pthread_self();
@@ -221,6 +243,11 @@ class IRLoggerReader {
         }
       }
     });
+
+    applied_thread_scheduling_ = applied_future.get();
+    for (const auto &error : applied_thread_scheduling_.errors) {
+      spdlog::warn("IRLoggerReader thread: {}", error);
+    }
   }
 
   void stop_thread() {
@@ -247,6 +274,13 @@ class IRLoggerReader {
    */
   std::atomic<pthread_t> thread_handle_ = 0;
 
+  /** How the logger thread asks to be scheduled */
+  ThreadScheduling thread_scheduling_;
+  /** Set by the logger thread once it has applied ::thread_scheduling_ */
+  std::promise<AppliedThreadScheduling> applied_thread_scheduling_promise_;
+  /** How the OS actually scheduled the logger thread */
+  AppliedThreadScheduling applied_thread_scheduling_;
+
   /**
    * Handles parsing the logs.
    */
@@ -422,10 +456,17 @@ class IRLoggerImpl {
 struct IRLoggerToSpd::impl {
  public:
   impl(const LoggingCallback &logging_callback,
-       const std::filesystem::path &socket_path)
-      : log_file_reader_(logging_callback, irlogger_log_path(socket_path)),
+       const std::filesystem::path &socket_path,
+       const ThreadScheduling &thread_scheduling)
+      : log_file_reader_(logging_callback, irlogger_log_path(socket_path),
+                         thread_scheduling),
         irlogger_impl_(socket_path) {}
 
+  /** @copydoc IRLoggerToSpd::get_thread_scheduling() */
+  AppliedThreadScheduling get_thread_scheduling() const {
+    return log_file_reader_.thread_scheduling();
+  }
+
  private:
   IRLoggerReader log_file_reader_;
   IRLoggerImpl irlogger_impl_;
@@ -455,13 +496,21 @@ static std::filesystem::path default_socket_path() {
   return temp_dir / "irlogger.fifo";
 }
 
-IRLoggerToSpd::IRLoggerToSpd(const LoggingCallback &logging_callback)
-    : IRLoggerToSpd(logging_callback, default_socket_path()) {}
+IRLoggerToSpd::IRLoggerToSpd(const LoggingCallback &logging_callback,
+                             const ThreadScheduling &thread_scheduling)
+    : IRLoggerToSpd(logging_callback, default_socket_path(),
+                    thread_scheduling) {}
 
 IRLoggerToSpd::IRLoggerToSpd(const LoggingCallback &logging_callback,
-                             const std::filesystem::path &socket_path) {
+                             const std::filesystem::path &socket_path,
+                             const ThreadScheduling &thread_scheduling) {
   auto gil = pybind11::gil_scoped_acquire();
-  pImpl_ = std::make_unique<IRLoggerToSpd::impl>(logging_callback, socket_path);
+  pImpl_ = std::make_unique<IRLoggerToSpd::impl>(logging_callback, socket_path,
+                                                 thread_scheduling);
+}
+
+AppliedThreadScheduling IRLoggerToSpd::get_thread_scheduling() const {
+  return pImpl_->get_thread_scheduling();
 }
 
 IRLoggerToSpd::~IRLoggerToSpd() {
@@ -0,0 +1,136 @@
+#include "./latency_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) noexcept {
+  auto value_ns = static_cast<std::uint64_t>(
+      std::max(latency.count(), std::chrono::nanoseconds::rep{0}));
+
+  buckets_[bucket_index(value_ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(value_ns, std::memory_order_relaxed);
+
+  // on failure, compare_exchange_weak() reloads max_ns
+  auto max_ns = max_ns_.load(std::memory_order_relaxed);
+  while (value_ns > max_ns &&
+         !max_ns_.compare_exchange_weak(max_ns, value_ns,
+                                        std::memory_order_relaxed)) {
+  }
+}
+
+std::chrono::nanoseconds LatencyHistogram::quantile(double q) const {
+  if (!(q >= 0.0 && q <= 1.0)) {
+    throw std::invalid_argument("Invalid quantile: must be between 0 and 1");
+  }
+
+  // the bucket counts may be incremented while we're reading them, so sum
+  // them instead of trusting ::count_
+  auto counts = std::array<std::uint64_t, BUCKET_COUNT>();
+  std::uint64_t count = 0;
+  for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    count += counts[i];
+  }
+  if (count == 0) {
+    return std::chrono::nanoseconds(0);
+  }
+
+  auto rank = std::max(
+      std::uint64_t{1},
+      static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count))));
+  auto max_ns = max_ns_.load(std::memory_order_relaxed);
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+    cumulative += counts[i];
+    if (cumulative >= rank) {
+      return std::chrono::nanoseconds(
+          std::min(bucket_highest_value(i), max_ns));
+    }
+  }
+  return std::chrono::nanoseconds(max_ns);
+}
+
+LatencyStats LatencyHistogram::summary() const {
+  auto count = count_.load(std::memory_order_relaxed);
+  auto total_ns = total_ns_.load(std::memory_order_relaxed);
+  return LatencyStats{
+      count,
+      quantile(0.50),
+      quantile(0.99),
+      std::chrono::nanoseconds(max_ns_.load(std::memory_order_relaxed)),
+      std::chrono::nanoseconds(count == 0 ? 0 : total_ns / count),
+  };
+}
+
+void LatencyHistogram::reset() noexcept {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  total_ns_.store(0, std::memory_order_relaxed);
+  max_ns_.store(0, std::memory_order_relaxed);
+}
+
+std::size_t LatencyHistogram::bucket_index(std::uint64_t value_ns) noexcept {
+  value_ns = std::min(value_ns, MAX_TRACKABLE_NS);
+  if (value_ns < 2 * SUB_BUCKET_COUNT) {
+    return static_cast<std::size_t>(value_ns);
+  }
+  // the index of the highest set bit, i.e. floor(log2(value_ns))
+  auto magnitude = static_cast<unsigned>(63 - __builtin_clzll(value_ns));
+  auto shift = magnitude - SUB_BUCKET_BITS;
+  // `value_ns >> shift` is from SUB_BUCKET_COUNT to 2 * SUB_BUCKET_COUNT - 1
+  return shift * SUB_BUCKET_COUNT + static_cast<std::size_t>(value_ns >> shift);
+}
+
+std::uint64_t LatencyHistogram::bucket_highest_value(
+    std::size_t index) noexcept {
+  if (index < 2 * SUB_BUCKET_COUNT) {
+    return index;
+  }
+  auto shift = index / SUB_BUCKET_COUNT - 1;
+  auto sub_bucket = index % SUB_BUCKET_COUNT + SUB_BUCKET_COUNT;
+  return ((std::uint64_t{sub_bucket} + 1) << shift) - 1;
+}
+
+PipelineStats PipelineLatency::stats() const {
+  auto stage = [this](PipelineStage pipeline_stage) {
+    return histograms_[static_cast<std::size_t>(pipeline_stage)].summary();
+  };
+  // read the counters in the reverse order to which a frame is counted, so
+  // that every frame that we've seen leave the pipeline is also counted as
+  // acquired
+  auto frames_delivered = frames_delivered_.load(std::memory_order_acquire);
+  auto frames_dropped = frames_dropped_.load(std::memory_order_acquire);
+  auto frames_shutter_closed =
+      frames_shutter_closed_.load(std::memory_order_acquire);
+  auto frames_acquired = frames_acquired_.load(std::memory_order_acquire);
+
+  return PipelineStats{
+      stage(PipelineStage::ACQUIRE),
+      stage(PipelineStage::PROCESS),
+      stage(PipelineStage::HANDOFF),
+      stage(PipelineStage::CONVERT),
+      stage(PipelineStage::DELIVERY),
+      flag_closures_.summary(),
+      frames_acquired,
+      frames_shutter_closed,
+      frames_delivered,
+      frames_dropped,
+      frames_overrun_.load(std::memory_order_relaxed),
+  };
+}
+
+void PipelineLatency::reset() noexcept {
+  for (auto &histogram : histograms_) {
+    histogram.reset();
+  }
+  flag_closures_.reset();
+  frames_acquired_.store(0, std::memory_order_relaxed);
+  frames_shutter_closed_.store(0, std::memory_order_relaxed);
+  frames_delivered_.store(0, std::memory_order_relaxed);
+  frames_dropped_.store(0, std::memory_order_relaxed);
+  frames_overrun_.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,256 @@
+/**
+ * @file
+ * @brief Lock-free latency histograms for each stage of the frame pipeline.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_LATENCY_STATS
+#define NQM_IRIMAGER_LATENCY_STATS
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Summary of the latencies recorded by a LatencyHistogram.
+ *
+ * All durations are `0` if nothing has been recorded.
+ */
+struct LatencyStats {
+  /** Number of latencies that have been recorded. */
+  std::uint64_t count;
+  /** The median latency. */
+  std::chrono::nanoseconds p50;
+  /** The 99th percentile latency. */
+  std::chrono::nanoseconds p99;
+  /** The highest latency. */
+  std::chrono::nanoseconds max;
+  /** The mean latency. */
+  std::chrono::nanoseconds mean;
+};
+
+/**
+ * @brief Lock-free histogram of latencies, with a bounded relative error.
+ *
+ * Similar to an HDR histogram: latencies below `2 * SUB_BUCKET_COUNT`
+ * nanoseconds are counted exactly, then every power of two is split into
+ * ::SUB_BUCKET_COUNT linear buckets, so quantiles are accurate to within
+ * `1 / SUB_BUCKET_COUNT` (~3%) of the true value.
+ *
+ * Recording a latency is a few relaxed atomic increments, with no locks or
+ * allocations, so it can be called by multiple threads on every frame.
+ * summary() may be called at the same time as record(), in which case it
+ * may be missing some of the concurrently recorded latencies.
+ */
+class LatencyHistogram {
+ public:
+  /** `log2()` of ::SUB_BUCKET_COUNT */
+  static constexpr unsigned SUB_BUCKET_BITS = 5;
+  /** Number of linear buckets per power of two. */
+  static constexpr std::size_t SUB_BUCKET_COUNT = std::size_t{1}
+                                                  << SUB_BUCKET_BITS;
+  /** `log2()` of the highest latency that can be counted, in nanoseconds. */
+  static constexpr unsigned MAX_BITS = 36;  // ~68 seconds
+  /** Latencies at or above this are counted as this, except by max(). */
+  static constexpr std::uint64_t MAX_TRACKABLE_NS =
+      (std::uint64_t{1} << MAX_BITS) - 1;
+  static constexpr std::size_t BUCKET_COUNT =
+      (MAX_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+  /**
+   * Records a latency.
+   *
+   * Negative latencies (e.g. from clocks with different resolutions) are
+   * recorded as `0`.
+   */
+  void record(std::chrono::nanoseconds latency) noexcept;
+
+  /** The number of latencies that have been recorded. */
+  std::uint64_t count() const noexcept {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Estimates a quantile of the recorded latencies.
+   *
+   * Returns the highest latency that is counted in the same bucket as the
+   * true quantile, so the result is never lower than the true quantile, and
+   * never higher than max().
+   *
+   * @param q The quantile to compute, from ``0.0`` to ``1.0``.
+   * @throws std::invalid_argument if @p q is not between ``0.0`` and ``1.0``.
+   * @returns The quantile, or `0` if nothing has been recorded.
+   */
+  std::chrono::nanoseconds quantile(double q) const;
+
+  /** The count, p50, p99, max, and mean of the recorded latencies. */
+  LatencyStats summary() const;
+
+  /** Removes all recorded latencies. */
+  void reset() noexcept;
+
+ private:
+  std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};
+  std::atomic<std::uint64_t> count_{0};
+  std::atomic<std::uint64_t> total_ns_{0};
+  std::atomic<std::uint64_t> max_ns_{0};
+
+  /** The index of the bucket that counts @p value_ns */
+  static std::size_t bucket_index(std::uint64_t value_ns) noexcept;
+  /** The highest value, in nanoseconds, counted by bucket @p index */
+  static std::uint64_t bucket_highest_value(std::size_t index) noexcept;
+};
+
+/**
+ * A stage of the frame pipeline, whose latency is recorded by
+ * PipelineLatency.
+ */
+enum class PipelineStage : std::uint8_t {
+  /** Waiting for the camera to return a raw frame. */
+  ACQUIRE,
+  /** Converting the raw frame into a thermal frame. */
+  PROCESS,
+  /**
+   * Passing the frame from the background acquisition thread to the caller,
+   * i.e. time spent in the frame queue, and waking up the caller.
+   */
+  HANDOFF,
+  /** Converting the frame into a Python object. */
+  CONVERT,
+  /** From when the frame was taken, until it was returned to the caller. */
+  DELIVERY,
+};
+
+/**
+ * Per-stage latencies, and frame counters, of an IRImager.
+ *
+ * The frame counters are a consistent snapshot, so
+ * `frames_acquired >= frames_delivered + frames_dropped +
+ * frames_shutter_closed` always holds, even while streaming. The difference
+ * is the number of frames that are still queued, or being processed.
+ */
+struct PipelineStats {
+  /** @copydoc PipelineStage::ACQUIRE */
+  LatencyStats acquire;
+  /** @copydoc PipelineStage::PROCESS */
+  LatencyStats process;
+  /** @copydoc PipelineStage::HANDOFF */
+  LatencyStats handoff;
+  /** @copydoc PipelineStage::CONVERT */
+  LatencyStats convert;
+  /** @copydoc PipelineStage::DELIVERY */
+  LatencyStats delivery;
+  /**
+   * How long the shutter flag stayed closed, counted once the flag reopens.
+   */
+  LatencyStats flag_closures;
+  /** Number of frames grabbed from the camera, including bad frames. */
+  std::uint64_t frames_acquired;
+  /**
+   * Number of frames skipped because the shutter flag was not open.
+   *
+   * Frames replaced by the last good frame, see ShutterPolicy::RETURN_STALE,
+   * are delivered, not skipped.
+   */
+  std::uint64_t frames_shutter_closed;
+  /** Number of frames returned to the caller, or to the frame callback. */
+  std::uint64_t frames_delivered;
+  /**
+   * Number of grabbed frames that we threw away, because the frame queue was
+   * full, or because streaming stopped before they were read.
+   */
+  std::uint64_t frames_dropped;
+  /**
+   * Number of frames taken by the camera that were never grabbed, because
+   * nobody asked for a frame in time.
+   *
+   * These are not counted in ::frames_acquired.
+   */
+  std::uint64_t frames_overrun;
+};
+
+/**
+ * @brief Always-on latency instrumentation of the frame pipeline.
+ *
+ * Holds a LatencyHistogram for every PipelineStage, and counts frames.
+ * Every method is lock-free, so it can be shared by the acquisition thread
+ * and any number of consumers.
+ *
+ * Every frame must be counted by count_acquired() before it is counted by
+ * count_shutter_closed(), count_delivered(), or count_dropped(), so that
+ * stats() can return a consistent snapshot of the counters.
+ */
+class PipelineLatency {
+ public:
+  /** Records how long a frame spent in @p stage. */
+  void record(PipelineStage stage, std::chrono::nanoseconds latency) noexcept {
+    histograms_[static_cast<std::size_t>(stage)].record(latency);
+  }
+
+  /** Records how long a frame spent in @p stage, from @p start until now. */
+  void record_since(PipelineStage stage,
+                    std::chrono::steady_clock::time_point start) noexcept {
+    record(stage, std::chrono::steady_clock::now() - start);
+  }
+
+  /** Counts a frame that was grabbed from the camera. */
+  void count_acquired() noexcept {
+    frames_acquired_.fetch_add(1, std::memory_order_release);
+  }
+
+  /** Counts a frame that was skipped because the shutter was not open. */
+  void count_shutter_closed() noexcept {
+    frames_shutter_closed_.fetch_add(1, std::memory_order_release);
+  }
+
+  /** Counts @p frames grabbed frames that were thrown away. */
+  void count_dropped(std::uint64_t frames = 1) noexcept {
+    frames_dropped_.fetch_add(frames, std::memory_order_release);
+  }
+
+  /** Counts @p frames frames that the camera took, but we never grabbed. */
+  void count_overrun(std::uint64_t frames = 1) noexcept {
+    frames_overrun_.fetch_add(frames, std::memory_order_relaxed);
+  }
+
+  /**
+   * Counts a frame that was returned to the caller, and records its
+   * PipelineStage::DELIVERY latency.
+   *
+   * @param time_point When the frame was taken.
+   */
+  void count_delivered(
+      std::chrono::steady_clock::time_point time_point) noexcept {
+    frames_delivered_.fetch_add(1, std::memory_order_release);
+    record_since(PipelineStage::DELIVERY, time_point);
+  }
+
+  /** Records how long the shutter flag stayed closed. */
+  void record_flag_closure(std::chrono::nanoseconds duration) noexcept {
+    flag_closures_.record(duration);
+  }
+
+  /** The summary of every stage, and the frame counters. */
+  PipelineStats stats() const;
+
+  /** Resets every histogram and counter to `0`. */
+  void reset() noexcept;
+
+ private:
+  static constexpr std::size_t STAGE_COUNT =
+      static_cast<std::size_t>(PipelineStage::DELIVERY) + 1;
+
+  std::array<LatencyHistogram, STAGE_COUNT> histograms_;
+  LatencyHistogram flag_closures_;
+  std::atomic<std::uint64_t> frames_acquired_{0};
+  std::atomic<std::uint64_t> frames_shutter_closed_{0};
+  std::atomic<std::uint64_t> frames_delivered_{0};
+  std::atomic<std::uint64_t> frames_dropped_{0};
+  std::atomic<std::uint64_t> frames_overrun_{0};
+};
+
+#endif /* NQM_IRIMAGER_LATENCY_STATS */
@@ -43,15 +43,18 @@ struct Logger::impl {
    * singleton_mutex_.
    *
    * @param logging_callback The function to call with log data.
+   * @param thread_scheduling How to schedule the IRLoggerToSpd thread.
    */
-  impl(LoggingCallback logging_callback) {
+  impl(LoggingCallback logging_callback,
+       const ThreadScheduling &thread_scheduling) {
     redirect_spd(logging_callback);
 
     spdlog::debug("set up Python logging callback");
 
     // construct after calling redirect_spd, so we can see logs during
     // construction
-    ir_logger_to_spd_ = std::make_unique<IRLoggerToSpd>(logging_callback);
+    ir_logger_to_spd_ =
+        std::make_unique<IRLoggerToSpd>(logging_callback, thread_scheduling);
   }
 
   virtual ~impl() {
@@ -59,6 +62,11 @@ struct Logger::impl {
     reset_spd_redirect();
   }
 
+  /** @copydoc Logger::get_thread_scheduling() */
+  AppliedThreadScheduling get_thread_scheduling() const {
+    return ir_logger_to_spd_->get_thread_scheduling();
+  }
+
  private:
   /** If we've called redirect_spd(), this var stores the original logger */
   std::shared_ptr<spdlog::logger> old_logger_;
@@ -116,7 +124,8 @@ static pybind11::object default_logger() {
   return pybind11::module_::import("logging").attr("getLogger")("nqm.irimager");
 }
 
-Logger::Logger(LoggingCallback logging_callback) {
+Logger::Logger(LoggingCallback logging_callback,
+               const ThreadScheduling &thread_scheduling) {
   auto no_gil =
       pybind11::gil_scoped_release();  // release gil to avoid deadlock
   auto singleton_lock = std::scoped_lock(Logger::impl::singleton_mutex_);
@@ -128,16 +137,21 @@ Logger::Logger(LoggingCallback logging_callback) {
 
   {
     auto gil = pybind11::gil_scoped_acquire();
-    pImpl_ = std::make_shared<Logger::impl>(logging_callback);
+    pImpl_ =
+        std::make_shared<Logger::impl>(logging_callback, thread_scheduling);
     Logger::impl::singleton_ = pImpl_;
   }
 }
 
-Logger::Logger(pybind11::object logger)
-    : Logger::Logger(log_to_python(logger)) {}
+Logger::Logger(pybind11::object logger,
+               const ThreadScheduling &thread_scheduling)
+    : Logger::Logger(log_to_python(logger), thread_scheduling) {}
 
 Logger::Logger() : Logger::Logger(default_logger()) {}
 
+Logger::Logger(const ThreadScheduling &thread_scheduling)
+    : Logger::Logger(default_logger(), thread_scheduling) {}
+
 Logger::~Logger() {
   // release Python GIL, to avoid deadlocks
   auto no_gil = pybind11::gil_scoped_release();
@@ -148,3 +162,7 @@ Logger::~Logger() {
     pImpl_ = nullptr;
   }
 }
+
+AppliedThreadScheduling Logger::get_thread_scheduling() const {
+  return pImpl_->get_thread_scheduling();
+}
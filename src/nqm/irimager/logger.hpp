@@ -7,6 +7,7 @@
 #include <pybind11/pybind11.h>
 
 #include "./definitions.hpp"
+#include "./thread_scheduling.hpp"
 
 /**
  * Handles converting C++ logs to Python :py:class:`logging.Logger`.
@@ -24,22 +25,40 @@ class Logger {
  public:
   /**
    * Creates a new logger with a custom logging callback.
+   *
+   * @param thread_scheduling How to schedule the thread that reads the
+   * evo::IRLogger logs.
    */
-  Logger(LoggingCallback logging_callback);
+  Logger(LoggingCallback logging_callback,
+         const ThreadScheduling &thread_scheduling = {});
 
   /**
    * Creates a new logger using a custom Python :py:class:`logging.Logger`
    * object
    */
-  Logger(pybind11::object logger);
+  Logger(pybind11::object logger,
+         const ThreadScheduling &thread_scheduling = {});
 
   /**
    * Creates a new logger using the default Python :py:class:`logging.Logger`
    */
   Logger();
 
+  /**
+   * Creates a new logger using the default Python :py:class:`logging.Logger`,
+   * whose background thread is scheduled with ``thread_scheduling``, e.g. to
+   * keep it off the CPUs used by the acquisition thread.
+   */
+  explicit Logger(const ThreadScheduling &thread_scheduling);
+
   virtual ~Logger();
 
+  /**
+   * Get the CPU affinity and scheduling that the OS actually gave the
+   * background thread that reads evo::IRLogger logs.
+   */
+  AppliedThreadScheduling get_thread_scheduling() const;
+
   /** pImpl implementation */
   struct impl;
 
@@ -0,0 +1,140 @@
+#include "./python_frame_callback.hpp"
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <pybind11/chrono.h>
+#include <spdlog/spdlog.h>
+
+pybind11::array_t<uint16_t> pooled_frame_to_numpy(
+    IRImager::PooledThermalFrame &&thermal_frame) {
+  auto owned_frame =
+      std::make_unique<IRImager::PooledThermalFrame>(std::move(thermal_frame));
+  const auto &matrix = **owned_frame;
+  auto shape = std::array<pybind11::ssize_t, 2>{matrix.rows(), matrix.cols()};
+  auto strides = std::array<pybind11::ssize_t, 2>{
+      static_cast<pybind11::ssize_t>(sizeof(uint16_t)) * matrix.cols(),
+      static_cast<pybind11::ssize_t>(sizeof(uint16_t))};
+  auto data = matrix.data();
+
+  auto capsule = pybind11::capsule(owned_frame.release(), [](void *frame) {
+    delete static_cast<IRImager::PooledThermalFrame *>(frame);
+  });
+  return pybind11::array_t<uint16_t>(shape, strides, data, capsule);
+}
+
+PythonFrameCallback::PythonFrameCallback(pybind11::function callback,
+                                         std::size_t max_pending_frames)
+    : state_{std::make_shared<State>()} {
+  state_->callback = std::move(callback);
+  state_->max_pending_frames = max_pending_frames;
+  // reserve now, so that queueing frames never reallocates
+  state_->pending_frames.reserve(max_pending_frames);
+  thread_ = std::thread([state = state_]() { dispatch_loop(state); });
+}
+
+PythonFrameCallback::~PythonFrameCallback() {
+  // the dispatch thread may be waiting for the GIL, so we can't hold it
+  auto no_gil = std::optional<pybind11::gil_scoped_release>();
+  if (PyGILState_Check()) {
+    no_gil.emplace();
+  }
+
+  {
+    auto lock = std::scoped_lock(state_->mutex);
+    state_->stop = true;
+  }
+  state_->frames_pending.notify_all();
+
+  if (std::this_thread::get_id() == thread_.get_id()) {
+    // the Python function removed or replaced itself, so we can't join the
+    // thread that we're running on, instead it releases the Python function
+    // and stops once the Python function returns
+    thread_.detach();
+    return;
+  }
+  thread_.join();
+  no_gil.reset();
+
+  state_->pending_frames.clear();
+
+  auto gil = pybind11::gil_scoped_acquire();
+  state_->callback = pybind11::function();
+}
+
+void PythonFrameCallback::operator()(
+    IRImager::PooledThermalFrame thermal_frame,
+    std::chrono::steady_clock::time_point time_point,
+    const FrameMetadata &metadata) {
+  {
+    auto lock = std::scoped_lock(state_->mutex);
+    if (state_->pending_frames.size() >= state_->max_pending_frames) {
+      spdlog::warn(
+          "Python frame callback is too slow, dropping frame. The callback "
+          "should return quickly, e.g. by passing frames to another thread.");
+      return;
+    }
+    state_->pending_frames.push_back(
+        PendingFrame{std::move(thermal_frame), time_point, metadata});
+  }
+  state_->frames_pending.notify_one();
+}
+
+void PythonFrameCallback::dispatch_loop(const std::shared_ptr<State> &state) {
+  // frames are swapped out of State::pending_frames into here, so that the
+  // acquisition thread can keep queueing frames while we call Python code
+  auto batch = std::vector<PendingFrame>();
+  batch.reserve(state->max_pending_frames);
+
+  auto stopped = [&state]() {
+    auto lock = std::scoped_lock(state->mutex);
+    return state->stop;
+  };
+
+  while (true) {
+    {
+      auto lock = std::unique_lock(state->mutex);
+      state->frames_pending.wait(lock, [&state] {
+        return state->stop || !state->pending_frames.empty();
+      });
+      if (state->stop) {
+        return;
+      }
+      std::swap(batch, state->pending_frames);
+    }
+
+    {
+      auto gil = pybind11::gil_scoped_acquire();
+      for (auto &pending_frame : batch) {
+        // the Python function may have destroyed our PythonFrameCallback
+        if (stopped()) {
+          break;
+        }
+        try {
+          auto frame =
+              pooled_frame_to_numpy(std::move(pending_frame.thermal_frame));
+          state->callback(frame, pending_frame.time_point,
+                          pending_frame.metadata);
+        } catch (pybind11::error_already_set &error) {
+          // same as an uncaught exception in a Python threading.Thread
+          error.discard_as_unraisable(state->callback);
+        } catch (const std::exception &error) {
+          spdlog::error("Failed to call Python frame callback: {}",
+                        error.what());
+        }
+      }
+
+      if (stopped()) {
+        // if our PythonFrameCallback was destroyed by the Python function,
+        // this thread was detached, so nobody else can release the function
+        state->callback = pybind11::function();
+        return;
+      }
+    }
+
+    batch.clear();
+  }
+}
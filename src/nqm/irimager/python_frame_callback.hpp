@@ -0,0 +1,114 @@
+/**
+ * @file
+ * @brief Dispatches thermal frames from C++ threads to Python callbacks.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_PYTHON_FRAME_CALLBACK
+#define NQM_IRIMAGER_PYTHON_FRAME_CALLBACK
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include "./irimager_class.hpp"
+
+/**
+ * Wraps a pooled frame in a numpy array, without copying any pixel data.
+ *
+ * The frame's buffer is returned to its pool once the numpy array has been
+ * garbage collected.
+ *
+ * @remark The Python GIL must be held when calling this function.
+ */
+pybind11::array_t<uint16_t> pooled_frame_to_numpy(
+    IRImager::PooledThermalFrame &&thermal_frame);
+
+/**
+ * @brief Calls a Python function with frames from an IRImager::FrameCallback.
+ *
+ * Calling Python code needs the GIL, which may be held by another Python
+ * thread for a long time, so instead of calling the Python function directly
+ * from the acquisition thread, frames are stored and passed to the Python
+ * function from a dedicated thread.
+ *
+ * This thread only takes the GIL once per batch of frames, instead of once per
+ * frame, which keeps the overhead low even at high frame rates.
+ */
+class PythonFrameCallback {
+ public:
+  /**
+   * Starts the dispatch thread.
+   *
+   * @param callback Python function, called with ``(frame, timestamp,
+   *                 metadata)``.
+   * @param max_pending_frames The maximum number of frames to store while
+   *                           waiting for the Python function. Any extra frames
+   *                           are dropped.
+   */
+  PythonFrameCallback(pybind11::function callback,
+                      std::size_t max_pending_frames = 64);
+
+  PythonFrameCallback(const PythonFrameCallback &) = delete;
+  PythonFrameCallback &operator=(const PythonFrameCallback &) = delete;
+
+  /**
+   * Stops the dispatch thread, discarding any pending frames.
+   *
+   * Can be called with or without the GIL, and from the Python function
+   * itself, e.g. if it removes or replaces itself, in which case the dispatch
+   * thread stops once the Python function returns.
+   */
+  virtual ~PythonFrameCallback();
+
+  /**
+   * Queues a frame for the Python function.
+   *
+   * Has the same signature as IRImager::FrameCallback, and does not need the
+   * GIL.
+   */
+  void operator()(IRImager::PooledThermalFrame thermal_frame,
+                  std::chrono::steady_clock::time_point time_point,
+                  const FrameMetadata &metadata);
+
+ private:
+  struct PendingFrame {
+    IRImager::PooledThermalFrame thermal_frame;
+    std::chrono::steady_clock::time_point time_point;
+    FrameMetadata metadata;
+  };
+
+  /**
+   * Everything used by the dispatch thread, which keeps it alive, so that the
+   * thread can safely finish calling the Python function, even if the
+   * Python function destroyed this PythonFrameCallback.
+   */
+  struct State {
+    pybind11::function callback;
+    std::size_t max_pending_frames;
+
+    /** Locks ::pending_frames and ::stop */
+    std::mutex mutex;
+    std::condition_variable frames_pending;
+    /** Frames that haven't yet been passed to the Python function */
+    std::vector<PendingFrame> pending_frames;
+    bool stop = false;
+  };
+
+  /** Body of ::thread_ */
+  static void dispatch_loop(const std::shared_ptr<State> &state);
+
+  std::shared_ptr<State> state_;
+  std::thread thread_;
+};
+
+#endif /* NQM_IRIMAGER_PYTHON_FRAME_CALLBACK */
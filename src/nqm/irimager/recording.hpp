@@ -0,0 +1,228 @@
+/**
+ * @file
+ * @brief Append-only, memory-mapped recordings of thermal frames.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_RECORDING
+#define NQM_IRIMAGER_RECORDING
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "./irimager_class.hpp"
+
+/**
+ * @brief Writes thermal frames to a single append-only recording file.
+ *
+ * A recording starts with a small header, followed by one fixed-size record
+ * per frame, and ends with a time index:
+ *
+ * | Offset                        | Contents                               |
+ * | ----------------------------- | -------------------------------------- |
+ * | `0`                           | 64-byte header, see RecordingReader    |
+ * | `64 + i * record_size`        | `int64` monotonic timestamp (ns)       |
+ * | `64 + i * record_size + 8`    | FrameMetadata (32 bytes)               |
+ * | `64 + i * record_size + 40`   | `rows x cols` `uint16` frame           |
+ * | after the last record         | `int64` first timestamp of each chunk  |
+ *
+ * Since every record has the same size, any range of frames can be read
+ * as a single zero-copy strided array, see RecordingReader::records().
+ *
+ * The file is grown one chunk (of `frames_per_chunk` frames) at a time, and
+ * each chunk is written through a memory mapping, so appending a frame is a
+ * single `memcpy()`, without any system calls.
+ *
+ * The frame count in the header is updated after every frame, so
+ * a recording that was not closed (e.g. if the process crashed) can still be
+ * read, just without the time index.
+ *
+ * All numbers are stored in the native (in practice, little-endian) byte
+ * order.
+ */
+class Recorder {
+ public:
+  /**
+   * Creates a new recording, overwriting any existing file.
+   *
+   * @param path The file to write to.
+   * @param rows The number of rows in each frame.
+   * @param cols The number of columns in each frame.
+   * @param temp_range_decimal See IRImager::get_temp_range_decimal(), stored
+   *                           so that the recording can be converted to
+   *                           temperatures later.
+   * @param frames_per_chunk The number of frames that the file grows by.
+   *
+   * @throws std::invalid_argument if @p rows, @p cols, or
+   *                               @p frames_per_chunk are `0`.
+   * @throws std::system_error if the file could not be created.
+   */
+  Recorder(const std::filesystem::path &path, Eigen::Index rows,
+           Eigen::Index cols, short temp_range_decimal,
+           std::size_t frames_per_chunk = 256);
+
+  Recorder(const Recorder &) = delete;
+  Recorder &operator=(const Recorder &) = delete;
+
+  /** Closes the recording, see close(). */
+  virtual ~Recorder();
+
+  /**
+   * Appends a frame to the recording.
+   *
+   * @param frame A C-contiguous frame, with the shape given in the
+   *              constructor.
+   * @param timestamp The monotonic time of the frame, must not be earlier
+   *                  than the timestamp of the previous frame.
+   * @param metadata The metadata of the frame.
+   *
+   * @throws std::invalid_argument if @p timestamp is out of order.
+   * @throws std::logic_error if the recording is closed.
+   * @throws std::system_error if the file could not be grown.
+   */
+  void append(const std::uint16_t *frame,
+              std::chrono::steady_clock::time_point timestamp,
+              const FrameMetadata &metadata);
+
+  /**
+   * Writes the time index, and closes the file.
+   *
+   * Does nothing if the recording is already closed.
+   *
+   * @throws std::system_error if the file could not be written.
+   */
+  void close();
+
+  /** The number of frames that have been appended. */
+  std::size_t size() const { return frame_count_; }
+
+  /** The number of rows in each frame. */
+  Eigen::Index rows() const { return static_cast<Eigen::Index>(rows_); }
+
+  /** The number of columns in each frame. */
+  Eigen::Index cols() const { return static_cast<Eigen::Index>(cols_); }
+
+  /** Whether close() has been called. */
+  bool closed() const { return fd_ == -1; }
+
+ private:
+  int fd_ = -1;
+  std::size_t rows_;
+  std::size_t cols_;
+  std::size_t frames_per_chunk_;
+  std::size_t record_size_;
+  std::size_t frame_count_ = 0;
+
+  /** Memory mapping of the file header */
+  void *header_ = nullptr;
+  /** Page-aligned memory mapping of the current chunk */
+  void *chunk_mapping_ = nullptr;
+  std::size_t chunk_mapping_size_ = 0;
+  /** The first record of the current chunk, inside ::chunk_mapping_ */
+  std::uint8_t *chunk_ = nullptr;
+
+  /** The first timestamp of each chunk, written as the time index */
+  std::vector<std::int64_t> chunk_timestamps_;
+  std::int64_t last_timestamp_ = 0;
+
+  /** Grows the file by a chunk, and maps it */
+  void map_next_chunk();
+  void unmap_chunk() noexcept;
+};
+
+/**
+ * @brief Reads a recording written by a Recorder.
+ *
+ * The whole file is memory-mapped, so frames are only read from disk when
+ * they are accessed, and can be used without copying them.
+ */
+class RecordingReader {
+ public:
+  /** Size of the file header, before the first record. */
+  static constexpr std::size_t HEADER_SIZE = 64;
+  /** Offset of the FrameMetadata inside each record. */
+  static constexpr std::size_t METADATA_OFFSET = 8;
+  /** Offset of the frame inside each record. */
+  static constexpr std::size_t FRAME_OFFSET = 40;
+
+  /**
+   * Opens and memory-maps a recording.
+   *
+   * @throws std::system_error if the file could not be opened.
+   * @throws std::invalid_argument if the file is not a valid recording.
+   */
+  explicit RecordingReader(const std::filesystem::path &path);
+
+  RecordingReader(const RecordingReader &) = delete;
+  RecordingReader &operator=(const RecordingReader &) = delete;
+
+  virtual ~RecordingReader();
+
+  /** The number of frames in the recording. */
+  std::size_t size() const { return frame_count_; }
+
+  /** The number of rows in each frame. */
+  Eigen::Index rows() const { return rows_; }
+
+  /** The number of columns in each frame. */
+  Eigen::Index cols() const { return cols_; }
+
+  /** See IRImager::get_temp_range_decimal(). */
+  short temp_range_decimal() const { return temp_range_decimal_; }
+
+  /** Whether the recording was closed, and so has a time index. */
+  bool has_index() const { return index_ != nullptr; }
+
+  /** The number of bytes between consecutive frames/timestamps/metadata. */
+  std::size_t record_size() const { return record_size_; }
+
+  /**
+   * The first record, followed by size() - 1 records, each
+   * record_size() bytes long.
+   */
+  const std::uint8_t *records() const { return records_; }
+
+  /** The frame at @p index, a C-contiguous `rows() x cols()` array. */
+  const std::uint16_t *frame(std::size_t index) const;
+
+  /** The monotonic timestamp of the frame at @p index. */
+  std::chrono::steady_clock::time_point timestamp(std::size_t index) const;
+
+  /** The metadata of the frame at @p index. */
+  FrameMetadata metadata(std::size_t index) const;
+
+  /**
+   * Finds the first frame with a timestamp at or after @p timestamp.
+   *
+   * Uses a binary search of the time index (or, if the recording was not
+   * closed, of the records), so only `O(log n)` pages of the file are read.
+   *
+   * @returns The index of the frame, or size() if every frame is earlier.
+   */
+  std::size_t seek(std::chrono::steady_clock::time_point timestamp) const;
+
+ private:
+  void *mapping_ = nullptr;
+  std::size_t mapping_size_ = 0;
+  const std::uint8_t *records_ = nullptr;
+
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  short temp_range_decimal_;
+  std::size_t record_size_;
+  std::size_t frames_per_chunk_;
+  std::size_t frame_count_;
+
+  /** The first `int64` timestamp of each chunk, if there is a time index */
+  const std::uint8_t *index_ = nullptr;
+  std::size_t chunk_count_ = 0;
+
+  std::int64_t timestamp_ns(std::size_t index) const;
+};
+
+#endif /* NQM_IRIMAGER_RECORDING */
@@ -0,0 +1,380 @@
+#include "./recording.hpp"
+
+#if __has_include(<unistd.h>)
+// this is fine!! Expected behavior
+#else
+#error \
+    "This file requires OS functions that are only available on POSIX systems"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>  // POSIX errno
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+extern "C" {
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+}
+
+namespace {
+
+/** Marks the start of every recording */
+constexpr char MAGIC[8] = {'N', 'Q', 'M', 'I', 'R', 'R', 'E', 'C'};
+/** Incremented whenever the recording format changes */
+constexpr std::uint32_t FORMAT_VERSION = 2;
+
+/**
+ * The first RecordingReader::HEADER_SIZE bytes of a recording.
+ *
+ * Only ever accessed with `memcpy()`, so it doesn't matter that the mapping
+ * may not be aligned for this struct.
+ */
+struct Header {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t rows;
+  std::uint32_t cols;
+  std::int16_t temp_range_decimal;
+  std::uint16_t reserved;
+  std::uint64_t record_size;
+  std::uint64_t frames_per_chunk;
+  /** Updated after every frame, so that unclosed recordings can be read */
+  std::uint64_t frame_count;
+  /** Offset of the time index, or `0` if the recording was not closed */
+  std::uint64_t index_offset;
+  /** The number of `int64` timestamps in the time index */
+  std::uint64_t chunk_count;
+};
+static_assert(sizeof(Header) <= RecordingReader::HEADER_SIZE);
+static_assert(sizeof(FrameMetadata) ==
+              RecordingReader::FRAME_OFFSET - RecordingReader::METADATA_OFFSET);
+
+std::system_error errno_error(const std::string &what) {
+  return std::system_error(std::error_code(errno, std::system_category()),
+                           what);
+}
+
+std::size_t page_size() {
+  static const auto size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+std::int64_t to_ns(std::chrono::steady_clock::time_point timestamp) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             timestamp.time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+Recorder::Recorder(const std::filesystem::path &path, Eigen::Index rows,
+                   Eigen::Index cols, short temp_range_decimal,
+                   std::size_t frames_per_chunk)
+    : rows_{static_cast<std::size_t>(rows)},
+      cols_{static_cast<std::size_t>(cols)},
+      frames_per_chunk_{frames_per_chunk} {
+  if (rows <= 0 || cols <= 0 || frames_per_chunk == 0) {
+    throw std::invalid_argument(
+        "Invalid recording: rows, cols, and frames_per_chunk must be greater "
+        "than 0");
+  }
+  // keep every record's timestamp 8-byte aligned
+  record_size_ = (RecordingReader::FRAME_OFFSET +
+                  rows_ * cols_ * sizeof(std::uint16_t) + 7) &
+                 ~std::size_t{7};
+
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ == -1) {
+    throw errno_error("Failed to create recording " + path.string());
+  }
+
+  if (ftruncate(fd_, RecordingReader::HEADER_SIZE) == -1) {
+    auto error = errno_error("Failed to write recording header");
+    ::close(fd_);
+    throw error;
+  }
+  header_ = mmap(nullptr, RecordingReader::HEADER_SIZE, PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd_, 0);
+  if (header_ == MAP_FAILED) {
+    auto error = errno_error("Failed to map recording header");
+    ::close(fd_);
+    throw error;
+  }
+
+  auto header = Header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = FORMAT_VERSION;
+  header.rows = static_cast<std::uint32_t>(rows_);
+  header.cols = static_cast<std::uint32_t>(cols_);
+  header.temp_range_decimal = temp_range_decimal;
+  header.record_size = record_size_;
+  header.frames_per_chunk = frames_per_chunk_;
+  std::memcpy(header_, &header, sizeof(header));
+}
+
+Recorder::~Recorder() {
+  try {
+    close();
+  } catch (const std::system_error &) {
+    // can't throw from a destructor, the frame count is still in the header
+  }
+}
+
+void Recorder::append(const std::uint16_t *frame,
+                      std::chrono::steady_clock::time_point timestamp,
+                      const FrameMetadata &metadata) {
+  if (closed()) {
+    throw std::logic_error("Cannot append to a closed recording");
+  }
+  auto timestamp_ns = to_ns(timestamp);
+  if (frame_count_ != 0 && timestamp_ns < last_timestamp_) {
+    throw std::invalid_argument(
+        "Invalid timestamp: frames must be appended in time order");
+  }
+
+  auto index_in_chunk = frame_count_ % frames_per_chunk_;
+  if (index_in_chunk == 0) {
+    map_next_chunk();
+    chunk_timestamps_.push_back(timestamp_ns);
+  }
+
+  auto record = chunk_ + index_in_chunk * record_size_;
+  std::memcpy(record, &timestamp_ns, sizeof(timestamp_ns));
+  std::memcpy(record + RecordingReader::METADATA_OFFSET, &metadata,
+              sizeof(metadata));
+  std::memcpy(record + RecordingReader::FRAME_OFFSET, frame,
+              rows_ * cols_ * sizeof(std::uint16_t));
+
+  last_timestamp_ = timestamp_ns;
+  frame_count_++;
+  auto frame_count = std::uint64_t{frame_count_};
+  std::memcpy(static_cast<std::uint8_t *>(header_) +
+                  offsetof(Header, frame_count),
+              &frame_count, sizeof(frame_count));
+}
+
+void Recorder::close() {
+  if (closed()) {
+    return;
+  }
+  unmap_chunk();
+
+  auto index_offset =
+      RecordingReader::HEADER_SIZE + frame_count_ * record_size_;
+  auto index_size = chunk_timestamps_.size() * sizeof(std::int64_t);
+
+  // also throws away the unused records of the last chunk
+  auto result = ftruncate(fd_, static_cast<off_t>(index_offset + index_size));
+  if (result == 0 && index_size != 0) {
+    auto written = pwrite(fd_, chunk_timestamps_.data(), index_size,
+                          static_cast<off_t>(index_offset));
+    result = written == static_cast<ssize_t>(index_size) ? 0 : -1;
+  }
+  if (result == 0) {
+    auto index_fields =
+        std::array<std::uint64_t, 2>{index_offset, chunk_timestamps_.size()};
+    std::memcpy(static_cast<std::uint8_t *>(header_) +
+                    offsetof(Header, index_offset),
+                index_fields.data(), sizeof(index_fields));
+  }
+  auto error = result == 0 ? std::error_code()
+                           : std::error_code(errno, std::system_category());
+
+  munmap(header_, RecordingReader::HEADER_SIZE);
+  header_ = nullptr;
+  ::close(fd_);
+  fd_ = -1;
+
+  if (error) {
+    throw std::system_error(error, "Failed to write recording time index");
+  }
+}
+
+void Recorder::map_next_chunk() {
+  unmap_chunk();
+
+  auto chunk_offset =
+      RecordingReader::HEADER_SIZE + frame_count_ * record_size_;
+  auto chunk_end = chunk_offset + frames_per_chunk_ * record_size_;
+  if (ftruncate(fd_, static_cast<off_t>(chunk_end)) == -1) {
+    throw errno_error("Failed to grow recording");
+  }
+
+  // mmap() offsets must be page-aligned
+  auto mapping_offset = chunk_offset & ~(page_size() - 1);
+  auto mapping_size = chunk_end - mapping_offset;
+  auto mapping = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd_, static_cast<off_t>(mapping_offset));
+  if (mapping == MAP_FAILED) {
+    throw errno_error("Failed to map recording");
+  }
+  chunk_mapping_ = mapping;
+  chunk_mapping_size_ = mapping_size;
+  chunk_ = static_cast<std::uint8_t *>(mapping) +
+           (chunk_offset - mapping_offset);
+}
+
+void Recorder::unmap_chunk() noexcept {
+  if (chunk_mapping_ != nullptr) {
+    munmap(chunk_mapping_, chunk_mapping_size_);
+    chunk_mapping_ = nullptr;
+    chunk_mapping_size_ = 0;
+    chunk_ = nullptr;
+  }
+}
+
+RecordingReader::RecordingReader(const std::filesystem::path &path) {
+  auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    throw errno_error("Failed to open recording " + path.string());
+  }
+  struct stat file_stat = {};
+  if (fstat(fd, &file_stat) == -1) {
+    auto error = errno_error("Failed to stat recording " + path.string());
+    ::close(fd);
+    throw error;
+  }
+  mapping_size_ = static_cast<std::size_t>(file_stat.st_size);
+  if (mapping_size_ < HEADER_SIZE) {
+    ::close(fd);
+    throw std::invalid_argument("Invalid recording: file is too small");
+  }
+  mapping_ = mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0);
+  // the mapping keeps the file open
+  ::close(fd);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw errno_error("Failed to map recording " + path.string());
+  }
+
+  auto header = Header{};
+  std::memcpy(&header, mapping_, sizeof(header));
+  const auto *bytes = static_cast<const std::uint8_t *>(mapping_);
+  try {
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::invalid_argument("Invalid recording: bad magic number");
+    }
+    if (header.version != FORMAT_VERSION) {
+      throw std::invalid_argument("Invalid recording: unsupported version " +
+                                  std::to_string(header.version));
+    }
+    auto frame_size = std::uint64_t{header.rows} * header.cols *
+                      sizeof(std::uint16_t);
+    if (header.rows == 0 || header.cols == 0 ||
+        header.record_size < FRAME_OFFSET + frame_size ||
+        header.record_size % 8 != 0 || header.frames_per_chunk == 0) {
+      throw std::invalid_argument("Invalid recording: corrupt header");
+    }
+    auto records_end = HEADER_SIZE + header.frame_count * header.record_size;
+    if (header.frame_count > mapping_size_ / header.record_size ||
+        records_end > mapping_size_) {
+      throw std::invalid_argument("Invalid recording: file is truncated");
+    }
+    if (header.index_offset != 0) {
+      auto expected_chunks =
+          (header.frame_count + header.frames_per_chunk - 1) /
+          header.frames_per_chunk;
+      if (header.index_offset != records_end ||
+          header.chunk_count != expected_chunks ||
+          records_end + header.chunk_count * sizeof(std::int64_t) >
+              mapping_size_) {
+        throw std::invalid_argument("Invalid recording: corrupt time index");
+      }
+      index_ = bytes + header.index_offset;
+      chunk_count_ = header.chunk_count;
+    }
+  } catch (...) {
+    munmap(mapping_, mapping_size_);
+    throw;
+  }
+
+  records_ = bytes + HEADER_SIZE;
+  rows_ = header.rows;
+  cols_ = header.cols;
+  temp_range_decimal_ = header.temp_range_decimal;
+  record_size_ = header.record_size;
+  frames_per_chunk_ = header.frames_per_chunk;
+  frame_count_ = header.frame_count;
+}
+
+RecordingReader::~RecordingReader() { munmap(mapping_, mapping_size_); }
+
+const std::uint16_t *RecordingReader::frame(std::size_t index) const {
+  if (index >= frame_count_) {
+    throw std::out_of_range("Frame index out of range");
+  }
+  return reinterpret_cast<const std::uint16_t *>(
+      records_ + index * record_size_ + FRAME_OFFSET);
+}
+
+std::chrono::steady_clock::time_point RecordingReader::timestamp(
+    std::size_t index) const {
+  if (index >= frame_count_) {
+    throw std::out_of_range("Frame index out of range");
+  }
+  return std::chrono::steady_clock::time_point(
+      std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::nanoseconds(timestamp_ns(index))));
+}
+
+FrameMetadata RecordingReader::metadata(std::size_t index) const {
+  if (index >= frame_count_) {
+    throw std::out_of_range("Frame index out of range");
+  }
+  auto metadata = FrameMetadata{};
+  std::memcpy(&metadata, records_ + index * record_size_ + METADATA_OFFSET,
+              sizeof(metadata));
+  return metadata;
+}
+
+std::size_t RecordingReader::seek(
+    std::chrono::steady_clock::time_point timestamp) const {
+  auto target = to_ns(timestamp);
+  auto first = std::size_t{0};
+  auto last = frame_count_;
+
+  if (has_index()) {
+    // find the last chunk that starts before the target, since the target may
+    // be in the middle of it
+    auto chunk_first = std::size_t{0};
+    auto chunk_last = chunk_count_;
+    while (chunk_first < chunk_last) {
+      auto middle = chunk_first + (chunk_last - chunk_first) / 2;
+      auto chunk_timestamp = std::int64_t{0};
+      std::memcpy(&chunk_timestamp, index_ + middle * sizeof(std::int64_t),
+                  sizeof(chunk_timestamp));
+      if (chunk_timestamp < target) {
+        chunk_first = middle + 1;
+      } else {
+        chunk_last = middle;
+      }
+    }
+    if (chunk_first != 0) {
+      first = (chunk_first - 1) * frames_per_chunk_;
+    }
+    last = std::min(chunk_first * frames_per_chunk_, frame_count_);
+  }
+
+  while (first < last) {
+    auto middle = first + (last - first) / 2;
+    if (timestamp_ns(middle) < target) {
+      first = middle + 1;
+    } else {
+      last = middle;
+    }
+  }
+  return first;
+}
+
+std::int64_t RecordingReader::timestamp_ns(std::size_t index) const {
+  auto timestamp = std::int64_t{0};
+  std::memcpy(&timestamp, records_ + index * record_size_, sizeof(timestamp));
+  return timestamp;
+}
@@ -0,0 +1,212 @@
+#include "./roi.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+RoiStatsEngine::RoiStatsEngine(Eigen::Index rows, Eigen::Index cols)
+    : rows_{rows}, cols_{cols} {}
+
+std::size_t RoiStatsEngine::add_rectangle(Eigen::Index row, Eigen::Index col,
+                                          Eigen::Index height,
+                                          Eigen::Index width) {
+  auto row_begin = std::max(row, Eigen::Index{0});
+  auto row_end = std::min(row + height, rows_);
+  auto col_begin = std::max(col, Eigen::Index{0});
+  auto col_end = std::min(col + width, cols_);
+
+  if (col_begin < col_end) {
+    for (auto r = row_begin; r < row_end; r++) {
+      runs_.push_back({r, col_begin, col_end - col_begin});
+    }
+  }
+  return finish_roi();
+}
+
+std::size_t RoiStatsEngine::add_polygon(const std::vector<Vertex> &vertices) {
+  if (vertices.size() < 3) {
+    throw std::invalid_argument(
+        "Invalid polygon: must have at least 3 vertices, but got " +
+        std::to_string(vertices.size()));
+  }
+
+  auto [min_y, max_y] = std::minmax_element(
+      vertices.begin(), vertices.end(),
+      [](const Vertex &a, const Vertex &b) { return a[1] < b[1]; });
+  // only rasterise the rows that the polygon covers
+  auto row_begin = static_cast<Eigen::Index>(
+      std::clamp(std::floor((*min_y)[1]), 0.0, static_cast<double>(rows_)));
+  auto row_end = static_cast<Eigen::Index>(
+      std::clamp(std::ceil((*max_y)[1]), 0.0, static_cast<double>(rows_)));
+
+  auto to_col = [this](double x) {
+    // first pixel whose centre is at or to the right of `x`
+    return static_cast<Eigen::Index>(
+        std::clamp(std::ceil(x - 0.5), 0.0, static_cast<double>(cols_)));
+  };
+
+  auto crossings = std::vector<double>();
+  for (auto r = row_begin; r < row_end; r++) {
+    // sample at the centre of each pixel
+    auto y = static_cast<double>(r) + 0.5;
+
+    crossings.clear();
+    for (std::size_t i = 0; i < vertices.size(); i++) {
+      const auto &a = vertices[i];
+      const auto &b = vertices[(i + 1) % vertices.size()];
+      if ((a[1] <= y) != (b[1] <= y)) {
+        crossings.push_back(a[0] + (y - a[1]) * (b[0] - a[0]) / (b[1] - a[1]));
+      }
+    }
+    std::sort(crossings.begin(), crossings.end());
+
+    // even-odd rule, pixels between each pair of crossings are inside
+    for (std::size_t i = 0; i + 1 < crossings.size(); i += 2) {
+      auto col_begin = to_col(crossings[i]);
+      auto col_end = to_col(crossings[i + 1]);
+      if (col_begin < col_end) {
+        runs_.push_back({r, col_begin, col_end - col_begin});
+      }
+    }
+  }
+  return finish_roi();
+}
+
+void RoiStatsEngine::set_quantiles(std::vector<double> quantiles) {
+  for (auto quantile : quantiles) {
+    if (!(quantile >= 0.0 && quantile <= 1.0)) {
+      throw std::invalid_argument(
+          "Invalid quantile: must be between 0 and 1, but got " +
+          std::to_string(quantile));
+    }
+  }
+  quantiles_ = std::move(quantiles);
+  quantile_values_.resize(quantiles_.size());
+}
+
+void RoiStatsEngine::clear() {
+  runs_.clear();
+  roi_run_offsets_ = {0};
+  pixel_counts_.clear();
+}
+
+std::size_t RoiStatsEngine::finish_roi() {
+  auto first_run = runs_.begin() +
+                   static_cast<std::ptrdiff_t>(roi_run_offsets_.back());
+  std::size_t pixel_count = 0;
+  for (auto run = first_run; run != runs_.end(); run++) {
+    pixel_count += static_cast<std::size_t>(run->length);
+  }
+
+  if (pixel_count == 0) {
+    runs_.erase(first_run, runs_.end());
+    throw std::invalid_argument(
+        "Invalid ROI: does not contain any pixels of the " +
+        std::to_string(rows_) + "x" + std::to_string(cols_) + " frame");
+  }
+
+  roi_run_offsets_.push_back(runs_.size());
+  pixel_counts_.push_back(pixel_count);
+  return size() - 1;
+}
+
+void RoiStatsEngine::check_frame(const Eigen::Ref<const Frame> &frame) const {
+  if (frame.rows() != rows_ || frame.cols() != cols_) {
+    throw std::invalid_argument(
+        "Invalid frame: expected shape (" + std::to_string(rows_) + ", " +
+        std::to_string(cols_) + "), but got (" + std::to_string(frame.rows()) +
+        ", " + std::to_string(frame.cols()) + ")");
+  }
+}
+
+void RoiStatsEngine::add_to_histogram(const Eigen::Ref<const Frame> &frame,
+                                      std::size_t index,
+                                      Histogram &histogram) const {
+  check_frame(frame);
+  for (auto run = roi_run_offsets_.at(index);
+       run < roi_run_offsets_.at(index + 1); run++) {
+    const auto &[row, col, length] = runs_[run];
+    histogram.add(frame.data() + row * frame.outerStride() + col,
+                  static_cast<std::size_t>(length));
+  }
+}
+
+void RoiStatsEngine::compute(const Eigen::Ref<const Frame> &frame,
+                             Eigen::Ref<RoiStats> out,
+                             short temp_range_decimal) {
+  check_frame(frame);
+  if (static_cast<std::size_t>(out.rows()) != size() ||
+      out.cols() != stat_count()) {
+    throw std::invalid_argument(
+        "Invalid output array: expected shape (" + std::to_string(size()) +
+        ", " + std::to_string(stat_count()) + "), but got (" +
+        std::to_string(out.rows()) + ", " + std::to_string(out.cols()) + ")");
+  }
+
+  const auto scale =
+      1.0 / std::pow(10.0, static_cast<double>(temp_range_decimal));
+  // the raw data is offset from -100 ℃
+  constexpr auto offset = -100.0;
+
+  for (std::size_t roi = 0; roi < size(); roi++) {
+    auto roi_min = std::numeric_limits<std::uint16_t>::max();
+    auto roi_max = std::numeric_limits<std::uint16_t>::min();
+    std::uint64_t sum = 0;
+    std::uint64_t sum_of_squares = 0;
+
+    for (auto run = roi_run_offsets_[roi]; run < roi_run_offsets_[roi + 1];
+         run++) {
+      const auto &[row, col, length] = runs_[run];
+      const auto *pixels = frame.data() + row * frame.outerStride() + col;
+
+      // keep the accumulators local and the loop branch-free, so that the
+      // compiler vectorises it
+      auto run_min = std::numeric_limits<std::uint16_t>::max();
+      auto run_max = std::numeric_limits<std::uint16_t>::min();
+      std::uint64_t run_sum = 0;
+      std::uint64_t run_sum_of_squares = 0;
+      for (Eigen::Index i = 0; i < length; i++) {
+        auto pixel = pixels[i];
+        run_min = std::min(run_min, pixel);
+        run_max = std::max(run_max, pixel);
+        run_sum += pixel;
+        run_sum_of_squares += std::uint32_t{pixel} * pixel;
+      }
+
+      roi_min = std::min(roi_min, run_min);
+      roi_max = std::max(roi_max, run_max);
+      sum += run_sum;
+      sum_of_squares += run_sum_of_squares;
+    }
+
+    auto pixel_count = static_cast<double>(pixel_counts_[roi]);
+    auto mean = static_cast<double>(sum) / pixel_count;
+    auto variance =
+        static_cast<double>(sum_of_squares) / pixel_count - mean * mean;
+    auto index = static_cast<Eigen::Index>(roi);
+
+    out(index, static_cast<Eigen::Index>(RoiStat::MIN)) =
+        static_cast<float>(roi_min * scale + offset);
+    out(index, static_cast<Eigen::Index>(RoiStat::MAX)) =
+        static_cast<float>(roi_max * scale + offset);
+    out(index, static_cast<Eigen::Index>(RoiStat::MEAN)) =
+        static_cast<float>(mean * scale + offset);
+    // rounding errors may make the variance slightly negative
+    out(index, static_cast<Eigen::Index>(RoiStat::STDDEV)) =
+        static_cast<float>(std::sqrt(std::max(variance, 0.0)) * scale);
+
+    if (!quantiles_.empty()) {
+      histogram_.clear();
+      add_to_histogram(frame, roi, histogram_);
+      histogram_.quantiles(quantiles_.data(), quantile_values_.data(),
+                           quantiles_.size());
+      for (std::size_t i = 0; i < quantiles_.size(); i++) {
+        out(index, STAT_COUNT + static_cast<Eigen::Index>(i)) =
+            static_cast<float>(quantile_values_[i] * scale + offset);
+      }
+    }
+  }
+}
@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Computes statistics over regions of interest (ROIs) of a frame.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_ROI
+#define NQM_IRIMAGER_ROI
+
+#include <Eigen/Dense>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "./histogram.hpp"
+
+/**
+ * Columns of the array returned by RoiStatsEngine::compute().
+ *
+ * Followed by one column for each RoiStatsEngine::quantiles().
+ */
+enum class RoiStat : std::uint8_t {
+  /** The minimum temperature in the region. */
+  MIN,
+  /** The maximum temperature in the region. */
+  MAX,
+  /** The mean temperature in the region. */
+  MEAN,
+  /** The (population) standard deviation of the temperature in the region. */
+  STDDEV,
+};
+
+/**
+ * Computes statistics over many regions of interest (ROIs) of a frame.
+ *
+ * Regions are registered up front, and are stored as row runs (i.e. a
+ * run-length encoded mask), so that polygons are only rasterised once.
+ * Computing the statistics is then a single pass over each run, which the
+ * compiler can vectorise.
+ */
+class RoiStatsEngine {
+ public:
+  /** The number of RoiStat columns in RoiStats. */
+  static constexpr Eigen::Index STAT_COUNT = 4;
+
+  /**
+   * Raw thermal frame, see IRImager::ThermalFrame.
+   */
+  using Frame = Eigen::Matrix<std::uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>;
+
+  /**
+   * Statistics of each ROI, with one row per ROI, and stat_count() columns.
+   */
+  using RoiStats =
+      Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  /**
+   * A polygon vertex, as an `{x, y}` coordinate, where `x` is the column and
+   * `y` is the row.
+   */
+  using Vertex = std::array<double, 2>;
+
+  /**
+   * @param rows The number of rows in each frame.
+   * @param cols The number of columns in each frame.
+   */
+  RoiStatsEngine(Eigen::Index rows, Eigen::Index cols);
+
+  /**
+   * Registers a rectangular ROI.
+   *
+   * The rectangle is clipped to the frame.
+   *
+   * @throws std::invalid_argument if the rectangle does not contain any
+   *                               pixels of the frame.
+   * @returns The index of the ROI, i.e. its row in RoiStats.
+   */
+  std::size_t add_rectangle(Eigen::Index row, Eigen::Index col,
+                            Eigen::Index height, Eigen::Index width);
+
+  /**
+   * Registers a polygonal ROI.
+   *
+   * A pixel is in the polygon if its centre is inside the polygon, using the
+   * even-odd rule, so self-intersecting polygons are supported.
+   * Pixel `(row, col)` covers the area from `{col, row}` to
+   * `{col + 1, row + 1}`.
+   *
+   * @param vertices The vertices of the polygon, in order.
+   *
+   * @throws std::invalid_argument if the polygon has fewer than 3 vertices,
+   *                               or does not contain any pixels of the frame.
+   * @returns The index of the ROI, i.e. its row in RoiStats.
+   */
+  std::size_t add_polygon(const std::vector<Vertex> &vertices);
+
+  /** Removes all ROIs. */
+  void clear();
+
+  /** The number of registered ROIs. */
+  std::size_t size() const { return roi_run_offsets_.size() - 1; }
+
+  /**
+   * Sets the quantiles (e.g. `0.5` for the median) computed for every ROI.
+   *
+   * Quantiles are computed exactly, using a Histogram, see
+   * Histogram::quantile().
+   *
+   * @param quantiles Each quantile adds a column to RoiStats, after the
+   *                  RoiStat columns.
+   * @throws std::invalid_argument if a quantile is not between `0.0` and
+   *                               `1.0`.
+   */
+  void set_quantiles(std::vector<double> quantiles);
+
+  /** The quantiles set by set_quantiles() */
+  const std::vector<double> &quantiles() const { return quantiles_; }
+
+  /** The number of columns in RoiStats */
+  Eigen::Index stat_count() const {
+    return STAT_COUNT + static_cast<Eigen::Index>(quantiles_.size());
+  }
+
+  /** The number of pixels in the ROI at @p index */
+  std::size_t pixel_count(std::size_t index) const {
+    return pixel_counts_.at(index);
+  }
+
+  /**
+   * Adds the pixels of the ROI at @p index to @p histogram.
+   *
+   * @throws std::invalid_argument if @p frame has the wrong shape.
+   */
+  void add_to_histogram(const Eigen::Ref<const Frame> &frame,
+                        std::size_t index, Histogram &histogram) const;
+
+  /**
+   * Computes the statistics of every ROI.
+   *
+   * @param frame The raw thermal frame, with the shape given in the
+   *              constructor.
+   * @param[out] out Where to store the statistics, must have size() rows
+   *                 and stat_count() columns.
+   * @param temp_range_decimal Used to convert the raw data to temperatures,
+   *                           see IRImager::get_temp_range_decimal().
+   *
+   * @throws std::invalid_argument if @p frame or @p out has the wrong shape.
+   */
+  void compute(const Eigen::Ref<const Frame> &frame, Eigen::Ref<RoiStats> out,
+               short temp_range_decimal);
+
+ private:
+  /** A horizontal run of pixels in a ROI. */
+  struct Run {
+    Eigen::Index row;
+    Eigen::Index col;
+    Eigen::Index length;
+  };
+
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+
+  /** The runs of every ROI, sorted by ROI, then by row, then by column */
+  std::vector<Run> runs_;
+  /**
+   * The runs of ROI `i` are `runs_[roi_run_offsets_[i]]` to
+   * `runs_[roi_run_offsets_[i + 1]]`.
+   */
+  std::vector<std::size_t> roi_run_offsets_ = {0};
+  std::vector<std::size_t> pixel_counts_;
+
+  std::vector<double> quantiles_;
+  /** Reused by compute(), to avoid allocating memory for every frame */
+  Histogram histogram_;
+  /** Reused by compute(), to store the raw values of ::quantiles_ */
+  std::vector<std::uint16_t> quantile_values_;
+
+  /** @throws std::invalid_argument if @p frame has the wrong shape. */
+  void check_frame(const Eigen::Ref<const Frame> &frame) const;
+
+  /**
+   * Finishes registering the runs added since the last ROI.
+   *
+   * @throws std::invalid_argument if the ROI is empty.
+   */
+  std::size_t finish_roi();
+};
+
+#endif /* NQM_IRIMAGER_ROI */
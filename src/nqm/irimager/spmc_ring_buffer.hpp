@@ -0,0 +1,212 @@
+/**
+ * @file
+ * @brief Lock-free ring buffer used to hand frames between threads.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_SPMC_RING_BUFFER
+#define NQM_IRIMAGER_SPMC_RING_BUFFER
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Bounded, lock-free, single-producer/multi-consumer ring buffer.
+ *
+ * Every slot is constructed once, when the ring buffer is created, and is
+ * then reused forever. Instead of copying values in and out, the producer and
+ * consumer are given a reference to the slot, so that large objects (e.g.
+ * thermal frames) can be written/read in-place without any heap allocations.
+ *
+ * Each slot has its own sequence number (see
+ * https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue),
+ * so a slot is only ever visible to either the producer or to whoever
+ * successfully claimed it in try_pop().
+ * Sequence number `2 * n` means the slot is free for the `n`th push, and
+ * `2 * n + 1` means it holds the `n`th pushed value, which (unlike the
+ * original algorithm) works even when the capacity is `1`.
+ *
+ * Any number of threads may call try_pop() at the same time, e.g. the
+ * producer itself pops the oldest value when it drops old frames
+ * (OverflowPolicy::DROP_OLDEST) while a consumer is also popping.
+ *
+ * @warning Only a single thread may call try_push() at a time.
+ *
+ * @tparam T The type of each slot.
+ */
+template <class T>
+class SpmcRingBuffer {
+ public:
+  /** Result of SpmcRingBuffer::try_push() */
+  enum class PushResult {
+    /** The slot was filled and is now visible to the consumer. */
+    PUSHED,
+    /** The ring buffer is full, the writer function was not called. */
+    FULL,
+    /** The writer function returned `false`, so nothing was pushed. */
+    REJECTED,
+  };
+
+  /**
+   * @brief Creates a new ring buffer.
+   *
+   * @param capacity The number of slots.
+   * @param prototype Every slot is initialised as a copy of this value.
+   * @throws std::invalid_argument if @p capacity is `0`.
+   */
+  SpmcRingBuffer(std::size_t capacity, const T &prototype = T())
+      : capacity_{capacity} {
+    if (capacity_ == 0) {
+      throw std::invalid_argument("SpmcRingBuffer capacity must not be 0");
+    }
+    slots_ = std::make_unique<Slot[]>(capacity_);
+    for (std::size_t i = 0; i < capacity_; i++) {
+      slots_[i].sequence.store(free_sequence(i), std::memory_order_relaxed);
+      slots_[i].value = prototype;
+    }
+  }
+
+  SpmcRingBuffer(const SpmcRingBuffer &) = delete;
+  SpmcRingBuffer &operator=(const SpmcRingBuffer &) = delete;
+
+  /**
+   * @brief Fills the next free slot in-place.
+   *
+   * @param writer Function with the signature `bool(T &slot)`.
+   *               If it returns `false`, the slot is not published and will be
+   *               passed to the next call of try_push().
+   *               If it throws, nothing is pushed.
+   */
+  template <class Writer>
+  PushResult try_push(Writer &&writer) {
+    auto position = push_position_.load(std::memory_order_relaxed);
+    auto &slot = slots_[static_cast<std::size_t>(position % capacity_)];
+
+    if (slot.sequence.load(std::memory_order_acquire) !=
+        free_sequence(position)) {
+      return PushResult::FULL;
+    }
+
+    if (!std::forward<Writer>(writer)(slot.value)) {
+      return PushResult::REJECTED;
+    }
+
+    slot.sequence.store(filled_sequence(position), std::memory_order_release);
+    push_position_.store(position + 1, std::memory_order_release);
+    return PushResult::PUSHED;
+  }
+
+  /**
+   * @brief Reads the oldest slot in-place, then releases it to the producer.
+   *
+   * Thread-safe: concurrent callers each claim a different slot.
+   *
+   * @param reader Function with the signature `void(T &slot)`.
+   *               The reader may move data out of the slot, as long as it
+   *               leaves the slot in a state that the producer can write to.
+   * @retval true if a slot was read.
+   * @retval false if the ring buffer was empty.
+   */
+  template <class Reader>
+  bool try_pop(Reader &&reader) {
+    auto position = pop_position_.load(std::memory_order_relaxed);
+    Slot *slot = nullptr;
+
+    while (true) {
+      slot = &slots_[static_cast<std::size_t>(position % capacity_)];
+      auto sequence = slot->sequence.load(std::memory_order_acquire);
+
+      if (sequence == filled_sequence(position)) {
+        // claim the slot, in case somebody else is also trying to pop
+        if (pop_position_.compare_exchange_weak(position, position + 1,
+                                                std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (sequence < filled_sequence(position)) {
+        return false;  // empty
+      } else {
+        position = pop_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    std::forward<Reader>(reader)(slot->value);
+
+    slot->sequence.store(free_sequence(position + capacity_),
+                         std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Whether try_push() would find a free slot.
+   *
+   * Unlike comparing size() to capacity(), this is `false` while a consumer
+   * is still reading the slot that would be pushed to next.
+   *
+   * @remark Only meaningful when called by the producer.
+   */
+  bool can_push() const {
+    auto position = push_position_.load(std::memory_order_relaxed);
+    const auto &slot = slots_[static_cast<std::size_t>(position % capacity_)];
+    return slot.sequence.load(std::memory_order_acquire) ==
+           free_sequence(position);
+  }
+
+  /**
+   * @brief The approximate number of filled slots.
+   *
+   * This value may be out-of-date by the time it is returned, if another
+   * thread is pushing/popping at the same time.
+   */
+  std::size_t size() const {
+    auto pop_position = pop_position_.load(std::memory_order_acquire);
+    auto push_position = push_position_.load(std::memory_order_acquire);
+    return push_position > pop_position
+               ? static_cast<std::size_t>(push_position - pop_position)
+               : 0;
+  }
+
+  /**
+   * @brief Whether the ring buffer is (approximately) empty.
+   *
+   * @see size()
+   */
+  bool empty() const { return size() == 0; }
+
+  /** The maximum number of filled slots. */
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  /** Sequence number of a slot that is ready for the push at @p position */
+  static constexpr std::uint64_t free_sequence(std::uint64_t position) {
+    return 2 * position;
+  }
+  /** Sequence number of a slot that was filled by the push at @p position */
+  static constexpr std::uint64_t filled_sequence(std::uint64_t position) {
+    return 2 * position + 1;
+  }
+
+  struct Slot {
+    std::atomic<std::uint64_t> sequence;
+    T value;
+  };
+
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+
+  /**
+   * Index of the next slot to push.
+   *
+   * Only written to by the producer, but may be read by anybody in size().
+   */
+  alignas(64) std::atomic<std::uint64_t> push_position_ = 0;
+
+  /** Index of the next slot to pop. */
+  alignas(64) std::atomic<std::uint64_t> pop_position_ = 0;
+};
+
+#endif /* NQM_IRIMAGER_SPMC_RING_BUFFER */
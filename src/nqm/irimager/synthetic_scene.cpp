@@ -0,0 +1,325 @@
+#include "./synthetic_scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/** The temperature of the closed shutter flag, in ℃ */
+constexpr float FLAG_TEMPERATURE = 35.0f;
+
+/** The number of random values in SyntheticScene::noise_, excluding padding */
+constexpr std::size_t NOISE_TABLE_SIZE = 1 << 16;
+
+constexpr float PI = 3.14159265358979f;
+
+/** Removes `<!-- comments -->`, so that commented-out settings are ignored */
+std::string strip_xml_comments(std::string xml) {
+  for (auto start = xml.find("<!--"); start != std::string::npos;
+       start = xml.find("<!--", start)) {
+    auto end = xml.find("-->", start);
+    xml.erase(start, end == std::string::npos ? end : end + 3 - start);
+  }
+  return xml;
+}
+
+/**
+ * Returns the text inside the first `<tag>...</tag>` in @p xml.
+ *
+ * The IRImagerDirect XML config files are simple enough that we don't need a
+ * full XML parser.
+ */
+std::optional<std::string> xml_element_text(const std::string &xml,
+                                            const std::string &tag) {
+  auto start = xml.find("<" + tag + ">");
+  if (start == std::string::npos) {
+    return std::nullopt;
+  }
+  start += tag.size() + 2;
+  auto end = xml.find("</" + tag + ">", start);
+  if (end == std::string::npos) {
+    return std::nullopt;
+  }
+  return xml.substr(start, end - start);
+}
+
+/**
+ * Parses the number inside `<tag>...</tag>`, if the element exists.
+ *
+ * @throws std::invalid_argument if the element doesn't contain a number.
+ */
+std::optional<double> xml_element_number(const std::string &xml,
+                                         const std::string &tag) {
+  auto text = xml_element_text(xml, tag);
+  if (!text) {
+    return std::nullopt;
+  }
+  auto parsed = std::size_t{0};
+  auto value = 0.0;
+  try {
+    value = std::stod(*text, &parsed);
+  } catch (const std::logic_error &) {
+    parsed = 0;
+  }
+  if (parsed == 0 || text->find_first_not_of(" \t\r\n", parsed) !=
+                         std::string::npos) {
+    throw std::invalid_argument("Invalid XML file: <" + tag + "> contains " +
+                                *text + ", not a number");
+  }
+  return value;
+}
+
+/** Mixes the bits of @p x, see https://prng.di.unimi.it/splitmix64.c */
+std::uint64_t splitmix64(std::uint64_t x) {
+  x += 0x9E3779B97F4A7C15;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EB;
+  return x ^ (x >> 31);
+}
+
+/**
+ * Reflects @p position into `[0, max]`, like a ball bouncing between two
+ * walls.
+ */
+float reflect(float position, float max) {
+  if (max <= 0.0f) {
+    return 0.0f;
+  }
+  auto period = 2.0f * max;
+  auto wrapped = std::fmod(position, period);
+  if (wrapped < 0.0f) {
+    wrapped += period;
+  }
+  return wrapped <= max ? wrapped : period - wrapped;
+}
+
+}  // namespace
+
+std::chrono::steady_clock::duration MockCameraConfig::frame_period() const {
+  if (!(framerate > 0.0) || !std::isfinite(framerate)) {
+    throw std::invalid_argument("Invalid framerate " +
+                                std::to_string(framerate) +
+                                ", must be positive");
+  }
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(1.0 / framerate));
+}
+
+MockCameraConfig MockCameraConfig::from_xml(
+    const std::filesystem::path &xml_path) {
+  auto config = MockCameraConfig{};
+
+  auto rows = Eigen::Index{0};
+  auto cols = Eigen::Index{0};
+  // e.g. `382x288@27Hz.xml`
+  if (std::sscanf(xml_path.filename().c_str(), "%tdx%td", &rows, &cols) == 2 &&
+      rows > 0 && cols > 0) {
+    config.rows = rows;
+    config.cols = cols;
+  }
+
+  auto xml_stream = std::ifstream(xml_path);
+  if (!xml_stream) {
+    throw std::runtime_error("Failed to open file " + xml_path.string());
+  }
+  auto xml_buffer = std::ostringstream();
+  xml_buffer << xml_stream.rdbuf();
+  auto xml = strip_xml_comments(xml_buffer.str());
+
+  if (auto framerate = xml_element_number(xml, "framerate")) {
+    config.framerate = *framerate;
+    config.frame_period();  // validates the framerate
+  }
+
+  if (auto temperature = xml_element_text(xml, "temperature")) {
+    if (auto min = xml_element_number(*temperature, "min")) {
+      config.temperature_min = static_cast<float>(*min);
+    }
+    if (auto max = xml_element_number(*temperature, "max")) {
+      config.temperature_max = static_cast<float>(*max);
+    }
+    if (!(config.temperature_min < config.temperature_max)) {
+      throw std::invalid_argument(
+          "Invalid XML file: <temperature><min> must be less than <max>");
+    }
+  }
+
+  if (auto autoflag = xml_element_text(xml, "autoflag")) {
+    auto enable = xml_element_number(*autoflag, "enable");
+    auto min_interval = xml_element_number(*autoflag, "mininterval");
+    if (enable.value_or(0.0) > 0.0 && min_interval) {
+      if (!(*min_interval > 0.0)) {
+        throw std::invalid_argument(
+            "Invalid XML file: <autoflag><mininterval> must be positive");
+      }
+      config.flag_interval =
+          std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+              std::chrono::duration<double>(*min_interval));
+    }
+  }
+
+  return config;
+}
+
+SyntheticScene::SyntheticScene(const MockCameraConfig &config,
+                               const SyntheticSceneOptions &options,
+                               short temp_range_decimal)
+    : rows_{config.rows},
+      cols_{config.cols},
+      seed_{options.seed},
+      frame_period_{config.frame_period()},
+      flag_interval_{options.shutter_closures
+                         ? config.flag_interval
+                         : std::chrono::steady_clock::duration::zero()} {
+  if (rows_ <= 0 || cols_ <= 0) {
+    throw std::invalid_argument("SyntheticScene resolution must not be empty");
+  }
+  if (!(options.noise >= 0.0f)) {
+    throw std::invalid_argument("SyntheticScene noise must not be negative");
+  }
+
+  auto scale = static_cast<float>(std::pow(10.0, temp_range_decimal));
+  auto to_raw = [scale](float celsius) { return (celsius + 100.0f) * scale; };
+  auto min = config.temperature_min;
+  auto range = config.temperature_max - config.temperature_min;
+  auto rows = static_cast<float>(rows_);
+  auto cols = static_cast<float>(cols_);
+
+  flag_raw_value_ =
+      to_raw(std::clamp(FLAG_TEMPERATURE, min, config.temperature_max));
+
+  // a vertical gradient, with some horizontal ripples, near the minimum
+  background_.resize(static_cast<std::size_t>(rows_ * cols_));
+  for (Eigen::Index row = 0; row < rows_; row++) {
+    for (Eigen::Index col = 0; col < cols_; col++) {
+      auto gradient = 0.1f * static_cast<float>(row) / rows;
+      auto ripple =
+          0.02f * (1.0f + std::sin(2.0f * PI * static_cast<float>(col) / cols));
+      background_[static_cast<std::size_t>(row * cols_ + col)] =
+          to_raw(min + range * (0.05f + gradient + ripple));
+    }
+  }
+
+  auto rng = std::mt19937_64(seed_);
+  auto uniform = [&rng](float low, float high) {
+    return std::uniform_real_distribution<float>(low, high)(rng);
+  };
+  auto size = std::min(rows, cols);
+  for (std::size_t i = 0; i < options.hotspots; i++) {
+    auto speed = uniform(0.05f, 0.25f) * size;
+    auto direction = uniform(0.0f, 2.0f * PI);
+    hotspots_.push_back(Hotspot{
+        uniform(0.0f, rows - 1.0f),
+        uniform(0.0f, cols - 1.0f),
+        speed * std::cos(direction),
+        speed * std::sin(direction),
+        std::max(1.0f, uniform(0.02f, 0.06f) * size),
+        uniform(0.4f, 0.9f) * range * scale,
+    });
+  }
+
+  // padded, so that each row can start anywhere in the first NOISE_TABLE_SIZE
+  noise_.resize(NOISE_TABLE_SIZE + static_cast<std::size_t>(cols_));
+  if (options.noise > 0.0f) {
+    auto normal = std::normal_distribution<float>(0.0f, options.noise * scale);
+    std::generate(noise_.begin(), noise_.end(), [&] { return normal(rng); });
+  }
+
+  scratch_.resize(background_.size());
+  column_weights_.resize(static_cast<std::size_t>(cols_));
+}
+
+FlagState SyntheticScene::flag_state(std::uint64_t frame_index) const {
+  if (flag_interval_ <= std::chrono::steady_clock::duration::zero()) {
+    return FlagState::OPEN;
+  }
+  auto elapsed = frame_period_ * static_cast<std::int64_t>(frame_index);
+  // the camera starts with a freshly calibrated, open, flag
+  if (elapsed < flag_interval_) {
+    return FlagState::OPEN;
+  }
+  auto phase = elapsed % flag_interval_;
+  if (phase < FLAG_CLOSING_DURATION) {
+    return FlagState::CLOSING;
+  } else if (phase < FLAG_CLOSING_DURATION + FLAG_CLOSED_DURATION) {
+    return FlagState::CLOSED;
+  } else if (phase < FLAG_CLOSING_DURATION + FLAG_CLOSED_DURATION +
+                         FLAG_OPENING_DURATION) {
+    return FlagState::OPENING;
+  }
+  return FlagState::OPEN;
+}
+
+FlagState SyntheticScene::render(std::uint64_t frame_index,
+                                 std::uint16_t *out) {
+  auto state = flag_state(frame_index);
+
+  if (state == FlagState::OPEN) {
+    std::copy(background_.begin(), background_.end(), scratch_.begin());
+
+    auto seconds =
+        std::chrono::duration<float>(frame_period_ *
+                                     static_cast<std::int64_t>(frame_index))
+            .count();
+    for (const auto &hotspot : hotspots_) {
+      auto center_row = reflect(hotspot.row + hotspot.row_velocity * seconds,
+                                static_cast<float>(rows_ - 1));
+      auto center_col = reflect(hotspot.col + hotspot.col_velocity * seconds,
+                                static_cast<float>(cols_ - 1));
+      // the gaussian is negligible more than 3 sigma away from the center
+      auto radius = 3.0f * hotspot.sigma;
+      auto row_begin = std::max(
+          Eigen::Index{0}, static_cast<Eigen::Index>(center_row - radius));
+      auto row_end = std::min(
+          rows_, static_cast<Eigen::Index>(center_row + radius) + 1);
+      auto col_begin = std::max(
+          Eigen::Index{0}, static_cast<Eigen::Index>(center_col - radius));
+      auto col_end = std::min(
+          cols_, static_cast<Eigen::Index>(center_col + radius) + 1);
+
+      auto inverse_variance = 1.0f / (2.0f * hotspot.sigma * hotspot.sigma);
+      for (auto col = col_begin; col < col_end; col++) {
+        auto distance = static_cast<float>(col) - center_col;
+        column_weights_[static_cast<std::size_t>(col)] =
+            std::exp(-distance * distance * inverse_variance);
+      }
+      for (auto row = row_begin; row < row_end; row++) {
+        auto distance = static_cast<float>(row) - center_row;
+        auto row_weight =
+            hotspot.amplitude * std::exp(-distance * distance * inverse_variance);
+        auto *scratch_row = scratch_.data() + row * cols_;
+        for (auto col = col_begin; col < col_end; col++) {
+          scratch_row[col] +=
+              row_weight * column_weights_[static_cast<std::size_t>(col)];
+        }
+      }
+    }
+  } else {
+    std::fill(scratch_.begin(), scratch_.end(), flag_raw_value_);
+  }
+
+  auto frame_seed = splitmix64(seed_ ^ frame_index);
+  for (Eigen::Index row = 0; row < rows_; row++) {
+    auto noise_offset =
+        splitmix64(frame_seed + static_cast<std::uint64_t>(row)) %
+        NOISE_TABLE_SIZE;
+    const auto *noise_row = noise_.data() + noise_offset;
+    const auto *scratch_row = scratch_.data() + row * cols_;
+    auto *out_row = out + row * cols_;
+    for (Eigen::Index col = 0; col < cols_; col++) {
+      // round to the nearest raw value
+      out_row[col] = static_cast<std::uint16_t>(std::clamp(
+          scratch_row[col] + noise_row[col] + 0.5f, 0.0f, 65535.0f));
+    }
+  }
+
+  return state;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file
+ * @brief Generates synthetic thermal frames for IRImagerMock.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_SYNTHETIC_SCENE
+#define NQM_IRIMAGER_SYNTHETIC_SCENE
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "./irimager_class.hpp"
+
+/**
+ * @brief The camera settings that IRImagerMock pretends to use.
+ *
+ * The default value is a 382x288 camera at 80 Hz.
+ */
+struct MockCameraConfig {
+  /** The number of rows in each frame. */
+  Eigen::Index rows = 382;
+  /** The number of columns in each frame. */
+  Eigen::Index cols = 288;
+  /** The number of frames per second, from `<framerate>`. */
+  double framerate = 80.0;
+  /** The minimum temperature in ℃, from `<temperature><min>`. */
+  float temperature_min = -20.0f;
+  /** The maximum temperature in ℃, from `<temperature><max>`. */
+  float temperature_max = 100.0f;
+  /**
+   * The time between shutter flag cycles, from `<autoflag><mininterval>`,
+   * or `0` if `<autoflag><enable>` is not set.
+   */
+  std::chrono::steady_clock::duration flag_interval{0};
+
+  /** The time between frames. */
+  std::chrono::steady_clock::duration frame_period() const;
+
+  /**
+   * Reads the camera settings from an IRImagerDirect XML config file.
+   *
+   * Settings that are missing from the XML file keep their default value.
+   *
+   * The XML file doesn't say what resolution the camera has, since the
+   * IRImagerDirect SDK asks the camera, so the resolution is instead read
+   * from a `<rows>x<cols>` prefix in the filename, e.g. `382x288@27Hz.xml`.
+   *
+   * @throws std::invalid_argument if a setting in the XML file is invalid.
+   * @throws std::runtime_error if @p xml_path could not be read.
+   */
+  static MockCameraConfig from_xml(const std::filesystem::path &xml_path);
+};
+
+/**
+ * @brief Seeded, procedurally-generated thermal scene.
+ *
+ * Each frame is a smooth background, a few gaussian hotspots that move
+ * around and bounce off the edges of the frame, and per-pixel noise.
+ * Every MockCameraConfig::flag_interval, the shutter flag closes for a few
+ * hundred milliseconds, during which frames only show the flag.
+ *
+ * Frames only depend on the frame index, not on when they are rendered, so
+ * rendering is deterministic, and frames can be rendered as fast as
+ * possible, e.g. for benchmarks.
+ *
+ * To make rendering cheap enough for high frame rates, the background and
+ * noise are computed up-front, and each hotspot is only rendered inside its
+ * bounding box, as the product of a row and a column gaussian.
+ */
+class SyntheticScene {
+ public:
+  /** How long the shutter flag takes to close. */
+  static constexpr auto FLAG_CLOSING_DURATION = std::chrono::milliseconds(100);
+  /** How long the shutter flag stays closed. */
+  static constexpr auto FLAG_CLOSED_DURATION = std::chrono::milliseconds(150);
+  /** How long the shutter flag takes to open. */
+  static constexpr auto FLAG_OPENING_DURATION = std::chrono::milliseconds(50);
+
+  /**
+   * @param config The resolution, frame rate, temperature range, and flag
+   *               interval of the scene.
+   * @param options The seed, and the contents of the scene.
+   * @param temp_range_decimal See IRImager::get_temp_range_decimal().
+   * @throws std::invalid_argument if @p config has an empty resolution, or a
+   *                               non-positive frame rate.
+   */
+  SyntheticScene(const MockCameraConfig &config,
+                 const SyntheticSceneOptions &options,
+                 short temp_range_decimal);
+
+  /** The `{rows, cols}` of each frame. */
+  std::array<Eigen::Index, 2> shape() const { return {rows_, cols_}; }
+
+  /** The state of the shutter flag when frame @p frame_index is taken. */
+  FlagState flag_state(std::uint64_t frame_index) const;
+
+  /**
+   * Renders a frame.
+   *
+   * @param frame_index The index of the frame since streaming started.
+   * @param[out] out Where to write the C-contiguous frame, with the shape().
+   *
+   * @returns The state of the shutter flag, see flag_state().
+   */
+  FlagState render(std::uint64_t frame_index, std::uint16_t *out);
+
+ private:
+  /** A gaussian hotspot that moves in a straight line, bouncing off edges */
+  struct Hotspot {
+    /** The position at frame `0`, in pixels */
+    float row;
+    float col;
+    /** The velocity, in pixels per second */
+    float row_velocity;
+    float col_velocity;
+    /** The standard deviation of the gaussian, in pixels */
+    float sigma;
+    /** The peak temperature above the background, in raw units */
+    float amplitude;
+  };
+
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  std::uint64_t seed_;
+  std::chrono::steady_clock::duration frame_period_;
+  std::chrono::steady_clock::duration flag_interval_;
+
+  /** The raw value of the closed shutter flag */
+  float flag_raw_value_;
+  /** The raw value of every pixel, without hotspots or noise */
+  std::vector<float> background_;
+  std::vector<Hotspot> hotspots_;
+  /**
+   * Random noise, in raw units.
+   *
+   * Each row of each frame uses a random window of `cols_` values, which is
+   * much faster than generating random numbers for every pixel.
+   */
+  std::vector<float> noise_;
+
+  /** The frame before noise is added, reused to avoid allocations */
+  std::vector<float> scratch_;
+  /** The column gaussian of a hotspot, reused to avoid allocations */
+  std::vector<float> column_weights_;
+};
+
+#endif /* NQM_IRIMAGER_SYNTHETIC_SCENE */
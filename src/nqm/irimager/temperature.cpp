@@ -0,0 +1,137 @@
+#include "./temperature.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// x86-64 wheels are built for CPUs without AVX2, so check for it at runtime
+#if defined(__SSE2__) && !defined(__AVX2__) && defined(__GNUC__)
+#define NQM_IRIMAGER_AVX2_DISPATCH
+#define NQM_IRIMAGER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NQM_IRIMAGER_TARGET_AVX2
+#endif
+
+namespace {
+
+/** Converts every element, one at a time. */
+void convert_scalar(const std::uint16_t *raw, float *out, std::size_t size,
+                    float scale, float offset) {
+  for (std::size_t i = 0; i < size; i++) {
+    out[i] = static_cast<float>(raw[i]) * scale + offset;
+  }
+}
+
+#if defined(__SSE2__) && !defined(__AVX2__)
+/** Converts 8 elements at a time, returning how many were converted. */
+std::size_t convert_sse2(const std::uint16_t *raw, float *out,
+                         std::size_t size, float scale, float offset) {
+  const auto zero = _mm_setzero_si128();
+  const auto scale_v = _mm_set1_ps(scale);
+  const auto offset_v = _mm_set1_ps(offset);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    auto raw_v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(raw + i));
+    // zero-extending to int32 means the conversion to float is exact
+    auto low = _mm_cvtepi32_ps(_mm_unpacklo_epi16(raw_v, zero));
+    auto high = _mm_cvtepi32_ps(_mm_unpackhi_epi16(raw_v, zero));
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(low, scale_v), offset_v));
+    _mm_storeu_ps(out + i + 4,
+                  _mm_add_ps(_mm_mul_ps(high, scale_v), offset_v));
+  }
+  return i;
+}
+#endif
+
+#if defined(__AVX2__) || defined(NQM_IRIMAGER_AVX2_DISPATCH)
+/** Converts 16 elements at a time, returning how many were converted. */
+NQM_IRIMAGER_TARGET_AVX2 std::size_t convert_avx2(const std::uint16_t *raw,
+                                                  float *out, std::size_t size,
+                                                  float scale, float offset) {
+  const auto scale_v = _mm256_set1_ps(scale);
+  const auto offset_v = _mm256_set1_ps(offset);
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    auto raw_v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(raw + i));
+    auto low = _mm256_cvtepi32_ps(
+        _mm256_cvtepu16_epi32(_mm256_castsi256_si128(raw_v)));
+    auto high = _mm256_cvtepi32_ps(
+        _mm256_cvtepu16_epi32(_mm256_extracti128_si256(raw_v, 1)));
+    _mm256_storeu_ps(out + i,
+                     _mm256_add_ps(_mm256_mul_ps(low, scale_v), offset_v));
+    _mm256_storeu_ps(out + i + 8,
+                     _mm256_add_ps(_mm256_mul_ps(high, scale_v), offset_v));
+  }
+  return i;
+}
+#endif
+
+#if defined(__ARM_NEON)
+/** Converts 8 elements at a time, returning how many were converted. */
+std::size_t convert_neon(const std::uint16_t *raw, float *out,
+                         std::size_t size, float scale, float offset) {
+  const auto scale_v = vdupq_n_f32(scale);
+  const auto offset_v = vdupq_n_f32(offset);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    auto raw_v = vld1q_u16(raw + i);
+    auto low = vcvtq_f32_u32(vmovl_u16(vget_low_u16(raw_v)));
+    auto high = vcvtq_f32_u32(vmovl_u16(vget_high_u16(raw_v)));
+    vst1q_f32(out + i, vaddq_f32(vmulq_f32(low, scale_v), offset_v));
+    vst1q_f32(out + i + 4, vaddq_f32(vmulq_f32(high, scale_v), offset_v));
+  }
+  return i;
+}
+#endif
+
+/**
+ * Converts as many elements as possible using SIMD instructions.
+ *
+ * @returns The number of elements converted, the rest must be converted by
+ *          convert_scalar().
+ */
+std::size_t convert_simd(const std::uint16_t *raw, float *out,
+                         std::size_t size, float scale, float offset) {
+#if defined(__AVX2__)
+  return convert_avx2(raw, out, size, scale, offset);
+#else
+#if defined(NQM_IRIMAGER_AVX2_DISPATCH)
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  if (has_avx2) {
+    return convert_avx2(raw, out, size, scale, offset);
+  }
+#endif
+#if defined(__SSE2__)
+  return convert_sse2(raw, out, size, scale, offset);
+#elif defined(__ARM_NEON)
+  return convert_neon(raw, out, size, scale, offset);
+#else
+  static_cast<void>(raw);
+  static_cast<void>(out);
+  static_cast<void>(size);
+  static_cast<void>(scale);
+  static_cast<void>(offset);
+  return 0;
+#endif
+#endif
+}
+
+}  // namespace
+
+void raw_to_temperature(const std::uint16_t *raw, float *out, std::size_t size,
+                        short temp_range_decimal, TemperatureUnit unit) {
+  const auto scale =
+      1.0f / std::pow(10.0f, static_cast<float>(temp_range_decimal));
+  // the raw data is offset from -100 ℃
+  const auto offset =
+      unit == TemperatureUnit::KELVIN ? 273.15f - 100.0f : -100.0f;
+
+  auto converted = convert_simd(raw, out, size, scale, offset);
+  convert_scalar(raw + converted, out + converted, size - converted, scale,
+                 offset);
+}
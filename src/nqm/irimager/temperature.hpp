@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @brief Converts raw thermal data to temperatures.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_TEMPERATURE
+#define NQM_IRIMAGER_TEMPERATURE
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Unit of temperature.
+ */
+enum class TemperatureUnit : std::uint8_t {
+  /** Degrees Celsius (℃). */
+  CELSIUS,
+  /** Kelvin (K). */
+  KELVIN,
+};
+
+/**
+ * @brief Converts raw thermal data to ``float32`` temperatures.
+ *
+ * Computes ``raw / 10 ** temp_range_decimal - 100`` (plus ``273.15`` for
+ * Kelvin) in a single pass, without any temporary arrays.
+ *
+ * Uses SIMD instructions to convert 16 elements at a time with AVX2 (if
+ * the CPU supports it), or 8 elements at a time with SSE2 on x86 or NEON on
+ * ARM, then converts any remaining elements one at a time.
+ *
+ * Multiplies by the reciprocal of ``10 ** temp_range_decimal``, so results
+ * may differ from a division by up to one unit in the last place.
+ *
+ * @param[in] raw The raw thermal data, e.g. from IRImager::get_frame().
+ * @param[out] out Where to store the temperatures, may not overlap @p raw.
+ * @param size The number of elements in @p raw and @p out.
+ * @param temp_range_decimal The number of decimal places in the raw data,
+ *                           see IRImager::get_temp_range_decimal().
+ * @param unit The unit of temperature to output.
+ */
+void raw_to_temperature(const std::uint16_t *raw, float *out, std::size_t size,
+                        short temp_range_decimal,
+                        TemperatureUnit unit = TemperatureUnit::CELSIUS);
+
+#endif /* NQM_IRIMAGER_TEMPERATURE */
@@ -0,0 +1,169 @@
+#include "./temporal_filter.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+/**
+ * Stores the element-wise maximum (if @p is_max), or minimum, of @p a and
+ * @p b in @p out, which may be the same frame as @p a or @p b.
+ */
+void combine(const TemporalFilter::Frame &a, const TemporalFilter::Frame &b,
+             bool is_max, TemporalFilter::Frame &out) {
+  if (is_max) {
+    out.array() = a.array().max(b.array());
+  } else {
+    out.array() = a.array().min(b.array());
+  }
+}
+
+}  // namespace
+
+TemporalFilter::TemporalFilter(Eigen::Index rows, Eigen::Index cols,
+                               TemporalFilterMode mode, std::size_t window,
+                               float alpha)
+    : mode_{mode}, window_{window}, alpha_{alpha} {
+  if (rows <= 0 || cols <= 0) {
+    throw std::invalid_argument("Invalid frame shape: (" +
+                                std::to_string(rows) + ", " +
+                                std::to_string(cols) + ") is empty");
+  }
+  if (window == 0 || window > MAX_WINDOW) {
+    throw std::invalid_argument("Invalid window " + std::to_string(window) +
+                                ": must be from 1 to " +
+                                std::to_string(MAX_WINDOW));
+  }
+  if (!(alpha > 0.0f && alpha <= 1.0f)) {
+    throw std::invalid_argument(
+        "Invalid alpha: must be greater than 0 and at most 1");
+  }
+
+  snapshot_.resize(rows, cols);
+  switch (mode_) {
+    case TemporalFilterMode::EMA:
+      ema_.resize(rows, cols);
+      break;
+    case TemporalFilterMode::MEAN:
+      sums_.resize(rows, cols);
+      history_.assign(window_, Frame(rows, cols));
+      break;
+    case TemporalFilterMode::MAX_HOLD:
+    case TemporalFilterMode::MIN_HOLD:
+      history_.assign(window_, Frame(rows, cols));
+      suffixes_.assign(window_, Frame(rows, cols));
+      prefix_.resize(rows, cols);
+      break;
+  }
+  reset();
+}
+
+void TemporalFilter::check_frame(const Eigen::Ref<const Frame> &frame) const {
+  if (frame.rows() != rows() || frame.cols() != cols()) {
+    throw std::invalid_argument(
+        "Invalid frame: expected shape (" + std::to_string(rows()) + ", " +
+        std::to_string(cols()) + "), but got (" + std::to_string(frame.rows()) +
+        ", " + std::to_string(frame.cols()) + ")");
+  }
+}
+
+void TemporalFilter::push(const Eigen::Ref<const Frame> &frame) {
+  check_frame(frame);
+  switch (mode_) {
+    case TemporalFilterMode::EMA:
+      push_ema(frame);
+      break;
+    case TemporalFilterMode::MEAN:
+      push_mean(frame);
+      break;
+    case TemporalFilterMode::MAX_HOLD:
+      push_hold(frame, true);
+      break;
+    case TemporalFilterMode::MIN_HOLD:
+      push_hold(frame, false);
+      break;
+  }
+  count_++;
+}
+
+void TemporalFilter::apply(Eigen::Ref<Frame> frame) {
+  push(frame);
+  frame = snapshot_;
+}
+
+const TemporalFilter::Frame &TemporalFilter::snapshot() const {
+  if (count_ == 0) {
+    throw std::runtime_error(
+        "The TemporalFilter is empty: no frames have been pushed");
+  }
+  return snapshot_;
+}
+
+void TemporalFilter::reset() {
+  count_ = 0;
+  // the sums and the previous block's suffixes are read before the window is
+  // full, so must start out as the identity of their operation
+  sums_.setZero();
+  auto identity = mode_ == TemporalFilterMode::MIN_HOLD
+                      ? std::numeric_limits<std::uint16_t>::max()
+                      : std::uint16_t{0};
+  for (auto &suffix : suffixes_) {
+    suffix.setConstant(identity);
+  }
+}
+
+void TemporalFilter::push_ema(const Eigen::Ref<const Frame> &frame) {
+  if (count_ == 0) {
+    ema_ = frame.cast<float>().array();
+  } else {
+    ema_ += alpha_ * (frame.cast<float>().array() - ema_);
+  }
+  // the EMA is always between 0 and 65535, so this can't overflow
+  snapshot_ = (ema_ + 0.5f).cast<std::uint16_t>().matrix();
+}
+
+void TemporalFilter::push_mean(const Eigen::Ref<const Frame> &frame) {
+  auto &slot = history_[static_cast<std::size_t>(count_ % window_)];
+  if (count_ >= window_) {
+    sums_ -= slot.cast<std::uint32_t>().array();
+  }
+  slot = frame;
+  sums_ += slot.cast<std::uint32_t>().array();
+
+  auto frames = std::min<std::uint64_t>(count_ + 1, window_);
+  // a double can exactly represent every sum, unlike a float
+  auto scale = 1.0 / static_cast<double>(frames);
+  snapshot_ =
+      (sums_.cast<double>() * scale + 0.5).cast<std::uint16_t>().matrix();
+}
+
+void TemporalFilter::push_hold(const Eigen::Ref<const Frame> &frame,
+                               bool is_max) {
+  auto position = static_cast<std::size_t>(count_ % window_);
+  auto &slot = history_[position];
+  slot = frame;
+  if (position == 0) {
+    prefix_ = slot;
+  } else {
+    combine(prefix_, slot, is_max, prefix_);
+  }
+
+  // the window is the end of the previous block, then the current block
+  if (position + 1 < window_) {
+    combine(suffixes_[position + 1], prefix_, is_max, snapshot_);
+  } else {
+    snapshot_ = prefix_;
+  }
+
+  if (position + 1 == window_) {
+    // the block is full, so compute its suffixes in-place, and start a new
+    // block in the old suffixes' memory
+    for (auto j = window_ - 1; j-- > 0;) {
+      combine(history_[j], history_[j + 1], is_max, history_[j]);
+    }
+    std::swap(history_, suffixes_);
+  }
+}
@@ -0,0 +1,182 @@
+/**
+ * @file
+ * @brief Incrementally updated filters over consecutive thermal frames.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_TEMPORAL_FILTER
+#define NQM_IRIMAGER_TEMPORAL_FILTER
+
+#include <Eigen/Dense>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * How TemporalFilter combines each pixel over consecutive frames.
+ */
+enum class TemporalFilterMode : std::uint8_t {
+  /**
+   * Exponential moving average, where each new frame has a weight of
+   * ``alpha``.
+   */
+  EMA,
+  /** The maximum of each pixel over the last ``window`` frames. */
+  MAX_HOLD,
+  /** The minimum of each pixel over the last ``window`` frames. */
+  MIN_HOLD,
+  /** The mean of each pixel over the last ``window`` frames (boxcar). */
+  MEAN,
+};
+
+/**
+ * @brief Filters each pixel over consecutive frames, e.g. to smooth noise.
+ *
+ * Every pushed frame updates the filter's state incrementally, instead of
+ * re-reading the whole history, and the result is stored in a snapshot
+ * frame, so reading it never recomputes anything:
+ *
+ * - TemporalFilterMode::EMA keeps a running ``float`` average.
+ * - TemporalFilterMode::MEAN keeps a running sum of the window, subtracting
+ *   the frame that leaves the window.
+ * - TemporalFilterMode::MAX_HOLD and TemporalFilterMode::MIN_HOLD use the
+ *   van Herk/Gil-Werman algorithm: the window is split into the current
+ *   block of frames, whose running maximum is kept, and the previous block,
+ *   whose suffix maxima are computed all at once when the block is full.
+ *   This costs about four passes over each frame, whatever the window size.
+ *
+ * Each pass is a single Eigen array expression, so no temporary frames are
+ * created. Eigen can't vectorise ``uint16_t`` data itself, so whether these
+ * passes use SIMD instructions depends on the compiler's auto-vectoriser
+ * (e.g. GCC only does this at ``-O3``).
+ *
+ * All memory is allocated by the constructor, so pushing frames never
+ * allocates.
+ *
+ * @remark This class is not thread-safe, even the `const` methods.
+ */
+class TemporalFilter {
+ public:
+  /**
+   * Raw thermal frame, see IRImager::ThermalFrame.
+   */
+  using Frame = Eigen::Matrix<std::uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                              Eigen::RowMajor>;
+
+  /**
+   * The largest ``window``, so that the sum of a window of raw values fits
+   * in a ``uint32``.
+   */
+  static constexpr std::size_t MAX_WINDOW = 65536;
+
+  /**
+   * @param rows The number of rows in each frame.
+   * @param cols The number of columns in each frame.
+   * @param mode How to combine each pixel over consecutive frames.
+   * @param window The number of frames to combine, ignored by
+   *               TemporalFilterMode::EMA. Uses ``window`` frames of memory.
+   * @param alpha The weight of each new frame, from ``0.0`` (exclusive) to
+   *              ``1.0``, only used by TemporalFilterMode::EMA.
+   *
+   * @throws std::invalid_argument if the frame is empty, if @p window is `0`
+   *                               or larger than ::MAX_WINDOW, or if
+   *                               @p alpha is out of range.
+   */
+  TemporalFilter(Eigen::Index rows, Eigen::Index cols, TemporalFilterMode mode,
+                 std::size_t window = 8, float alpha = 0.125f);
+
+  /** The number of rows in each frame. */
+  Eigen::Index rows() const { return snapshot_.rows(); }
+  /** The number of columns in each frame. */
+  Eigen::Index cols() const { return snapshot_.cols(); }
+  /** How pixels are combined over consecutive frames. */
+  TemporalFilterMode mode() const { return mode_; }
+  /** The number of frames that are combined. */
+  std::size_t window() const { return window_; }
+  /** The weight of each new frame in TemporalFilterMode::EMA. */
+  float alpha() const { return alpha_; }
+  /** The number of frames pushed since construction, or since reset(). */
+  std::uint64_t count() const { return count_; }
+
+  /**
+   * Adds a frame to the filter, and updates the snapshot().
+   *
+   * Until ``window`` frames have been pushed, the window only contains the
+   * frames pushed so far.
+   *
+   * @throws std::invalid_argument if @p frame has the wrong shape.
+   */
+  void push(const Eigen::Ref<const Frame> &frame);
+
+  /**
+   * Adds a frame to the filter, then overwrites it with the snapshot().
+   *
+   * @throws std::invalid_argument if @p frame has the wrong shape.
+   */
+  void apply(Eigen::Ref<Frame> frame);
+
+  /**
+   * The filtered frame, as of the last push(), rounded to the nearest raw
+   * value.
+   *
+   * @throws std::runtime_error if no frames have been pushed since
+   *                            construction, or since reset().
+   */
+  const Frame &snapshot() const;
+
+  /** Forgets every pushed frame. */
+  void reset();
+
+ private:
+  TemporalFilterMode mode_;
+  std::size_t window_;
+  float alpha_;
+  std::uint64_t count_ = 0;
+
+  /** The result of the last push() */
+  Frame snapshot_;
+
+  /** TemporalFilterMode::EMA: the unrounded average */
+  Eigen::Array<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> ema_;
+
+  /** TemporalFilterMode::MEAN: the sum of the frames in ::history_ */
+  Eigen::Array<std::uint32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      sums_;
+
+  /**
+   * TemporalFilterMode::MEAN: the last ::window_ frames, where frame `i` is
+   * stored at `i % window_`.
+   *
+   * TemporalFilterMode::MAX_HOLD/MIN_HOLD: the frames of the current block,
+   * where frame `i` is stored at `i % window_`.
+   */
+  std::vector<Frame> history_;
+  /**
+   * TemporalFilterMode::MAX_HOLD/MIN_HOLD: element `j` is the maximum/minimum
+   * of the frames from `j` to the end of the previous block.
+   */
+  std::vector<Frame> suffixes_;
+  /**
+   * TemporalFilterMode::MAX_HOLD/MIN_HOLD: the maximum/minimum of the
+   * frames in the current block.
+   */
+  Frame prefix_;
+
+  /** @throws std::invalid_argument if @p frame has the wrong shape. */
+  void check_frame(const Eigen::Ref<const Frame> &frame) const;
+
+  /** Updates the EMA, see TemporalFilterMode::EMA */
+  void push_ema(const Eigen::Ref<const Frame> &frame);
+  /** Updates the running sum, see TemporalFilterMode::MEAN */
+  void push_mean(const Eigen::Ref<const Frame> &frame);
+  /**
+   * Updates the sliding maximum (if @p is_max), or minimum, see
+   * TemporalFilterMode::MAX_HOLD.
+   */
+  void push_hold(const Eigen::Ref<const Frame> &frame, bool is_max);
+};
+
+#endif /* NQM_IRIMAGER_TEMPORAL_FILTER */
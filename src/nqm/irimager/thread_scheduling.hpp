@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @brief CPU affinity and real-time scheduling of background threads.
+ *
+ * @copyright
+ * SPDX-FileCopyrightText: © 2023 NquiringMinds Ltd.
+ */
+
+#ifndef NQM_IRIMAGER_THREAD_SCHEDULING
+#define NQM_IRIMAGER_THREAD_SCHEDULING
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief How a background thread should be scheduled by the OS.
+ *
+ * By default, nothing is changed, so the thread inherits the scheduling of
+ * the thread that started it.
+ *
+ * For example, pinning the acquisition thread to a CPU that isn't used by
+ * any heavy numpy processing, and giving it a real-time priority, stops other
+ * threads from delaying frames.
+ */
+struct ThreadScheduling {
+  /**
+   * The CPUs that the thread may run on, numbered from ``0``, or empty to
+   * allow any CPU.
+   */
+  std::vector<std::size_t> cpus;
+  /**
+   * If set, use the real-time ``SCHED_FIFO`` policy with this priority,
+   * from ``1`` (lowest) to ``99`` (highest).
+   *
+   * This normally needs the ``CAP_SYS_NICE`` capability, or a high enough
+   * ``RLIMIT_RTPRIO`` limit (e.g. ``ulimit -r``).
+   */
+  std::optional<int> fifo_priority;
+  /**
+   * If set, the niceness of the thread, from ``-20`` (highest priority) to
+   * ``19`` (lowest priority). Ignored by the OS while the thread uses
+   * ``SCHED_FIFO``.
+   *
+   * Lowering the niceness normally needs the ``CAP_SYS_NICE`` capability, or
+   * a high enough ``RLIMIT_NICE`` limit.
+   */
+  std::optional<int> nice;
+
+  /**
+   * Checks that the requested settings are in range, so that mistakes are
+   * reported immediately, instead of when the thread is started.
+   *
+   * @throws std::invalid_argument if a CPU, the ::fifo_priority, or the
+   *                               ::nice value is out of range.
+   */
+  void validate() const;
+};
+
+/**
+ * @brief The scheduling that a thread actually got, after trying to apply a
+ * ThreadScheduling.
+ *
+ * The OS may refuse some of the requested settings, e.g. if we don't have
+ * permission to use ``SCHED_FIFO``. Instead of stopping the thread, the
+ * settings are left unchanged, and the reason is added to ::errors.
+ */
+struct AppliedThreadScheduling {
+  /** The CPUs that the thread may run on. */
+  std::vector<std::size_t> cpus;
+  /**
+   * The ``SCHED_FIFO`` priority of the thread, or `std::nullopt` if it does
+   * not use ``SCHED_FIFO``.
+   */
+  std::optional<int> fifo_priority;
+  /** The niceness of the thread. */
+  int nice = 0;
+  /** Why each setting that wasn't applied was refused, if any. */
+  std::vector<std::string> errors;
+};
+
+/**
+ * Applies @p thread_scheduling to the calling thread, then reads back how it
+ * is scheduled.
+ *
+ * Never throws if the OS refuses a setting, since a thread that isn't pinned
+ * is better than no thread at all.
+ *
+ * @throws std::invalid_argument if @p thread_scheduling is not valid, see
+ *                               ThreadScheduling::validate().
+ */
+AppliedThreadScheduling apply_thread_scheduling(
+    const ThreadScheduling &thread_scheduling);
+
+#endif /* NQM_IRIMAGER_THREAD_SCHEDULING */
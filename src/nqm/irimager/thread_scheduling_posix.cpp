@@ -0,0 +1,179 @@
+#include "./thread_scheduling.hpp"
+
+#if __has_include(<unistd.h>)
+// this is fine!! Expected behavior
+#else
+#error \
+    "This file requires OS functions that are only available on POSIX systems"
+#endif
+
+#include <cerrno>  // POSIX errno
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+extern "C" {
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+}
+
+namespace {
+
+constexpr int MIN_NICE = -20;
+constexpr int MAX_NICE = 19;
+
+std::string error_message(int error_number) {
+  return std::system_category().message(error_number);
+}
+
+#ifdef __linux__
+/**
+ * On Linux, niceness is per-thread, so setpriority() needs the thread ID,
+ * not the process ID.
+ */
+id_t current_thread_id() { return static_cast<id_t>(syscall(SYS_gettid)); }
+#endif
+
+/** Pins the calling thread to @p cpus, or adds an error to @p applied */
+void apply_cpu_affinity(const std::vector<std::size_t> &cpus,
+                        AppliedThreadScheduling &applied) {
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &cpu_set);
+  }
+  int error_number =
+      pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+  if (error_number != 0) {
+    applied.errors.push_back("Failed to set the CPU affinity due to " +
+                             error_message(error_number));
+  }
+#else
+  (void)cpus;
+  applied.errors.push_back(
+      "Failed to set the CPU affinity: not supported on this OS");
+#endif
+}
+
+/** Reads the CPUs that the calling thread may run on */
+std::vector<std::size_t> current_cpu_affinity() {
+  auto cpus = std::vector<std::size_t>();
+#ifdef __linux__
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) ==
+      0) {
+    for (std::size_t cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &cpu_set)) {
+        cpus.push_back(cpu);
+      }
+    }
+    return cpus;
+  }
+#endif
+  for (std::size_t cpu = 0; cpu < std::thread::hardware_concurrency(); cpu++) {
+    cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+/** Sets the niceness of the calling thread, or adds an error to @p applied */
+void apply_nice(int nice, AppliedThreadScheduling &applied) {
+#ifdef __linux__
+  if (setpriority(PRIO_PROCESS, current_thread_id(), nice) != 0) {
+    applied.errors.push_back("Failed to set the niceness to " +
+                             std::to_string(nice) + " due to " +
+                             error_message(errno));
+  }
+#else
+  (void)nice;
+  applied.errors.push_back(
+      "Failed to set the niceness: per-thread niceness is not supported on "
+      "this OS");
+#endif
+}
+
+/** Reads the niceness of the calling thread */
+int current_nice() {
+#ifdef __linux__
+  auto who = current_thread_id();
+#else
+  id_t who = 0;
+#endif
+  // getpriority() can legitimately return -1, so check errno instead
+  errno = 0;
+  int nice = getpriority(PRIO_PROCESS, who);
+  return errno == 0 ? nice : 0;
+}
+
+}  // namespace
+
+void ThreadScheduling::validate() const {
+  for (auto cpu : cpus) {
+#ifdef __linux__
+    if (cpu >= CPU_SETSIZE) {
+      throw std::invalid_argument("Invalid CPU " + std::to_string(cpu) +
+                                  ": must be less than " +
+                                  std::to_string(CPU_SETSIZE));
+    }
+#else
+    (void)cpu;
+#endif
+  }
+  if (fifo_priority) {
+    auto min_priority = sched_get_priority_min(SCHED_FIFO);
+    auto max_priority = sched_get_priority_max(SCHED_FIFO);
+    if (*fifo_priority < min_priority || *fifo_priority > max_priority) {
+      throw std::invalid_argument(
+          "Invalid SCHED_FIFO priority " + std::to_string(*fifo_priority) +
+          ": must be from " + std::to_string(min_priority) + " to " +
+          std::to_string(max_priority));
+    }
+  }
+  if (nice && (*nice < MIN_NICE || *nice > MAX_NICE)) {
+    throw std::invalid_argument("Invalid niceness " + std::to_string(*nice) +
+                                ": must be from " + std::to_string(MIN_NICE) +
+                                " to " + std::to_string(MAX_NICE));
+  }
+}
+
+AppliedThreadScheduling apply_thread_scheduling(
+    const ThreadScheduling &thread_scheduling) {
+  thread_scheduling.validate();
+
+  auto applied = AppliedThreadScheduling();
+  if (!thread_scheduling.cpus.empty()) {
+    apply_cpu_affinity(thread_scheduling.cpus, applied);
+  }
+  if (thread_scheduling.nice) {
+    apply_nice(*thread_scheduling.nice, applied);
+  }
+  if (thread_scheduling.fifo_priority) {
+    auto param = sched_param{};
+    param.sched_priority = *thread_scheduling.fifo_priority;
+    int error_number =
+        pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (error_number != 0) {
+      applied.errors.push_back("Failed to use SCHED_FIFO with priority " +
+                               std::to_string(param.sched_priority) +
+                               " due to " + error_message(error_number));
+    }
+  }
+
+  applied.cpus = current_cpu_affinity();
+  applied.nice = current_nice();
+  int policy = SCHED_OTHER;
+  auto param = sched_param{};
+  if (pthread_getschedparam(pthread_self(), &policy, &param) == 0 &&
+      policy == SCHED_FIFO) {
+    applied.fifo_priority = param.sched_priority;
+  }
+  return applied;
+}
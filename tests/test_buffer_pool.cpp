@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "../src/nqm/irimager/buffer_pool.hpp"
+
+TEST(test_buffer_pool, ReusesBuffers) {
+  auto pool = BufferPool<std::vector<int>>::create(std::vector<int>(16), 2);
+
+  const int *first_data = nullptr;
+  {
+    auto buffer = pool->acquire();
+    EXPECT_EQ(buffer->size(), 16);
+    first_data = buffer->data();
+  }
+  EXPECT_EQ(pool->stats().misses, 1);
+  EXPECT_EQ(pool->stats().available, 1);
+
+  auto buffer = pool->acquire();
+  EXPECT_EQ(buffer->data(), first_data);
+  EXPECT_EQ(pool->stats().hits, 1);
+  EXPECT_EQ(pool->stats().misses, 1);
+  EXPECT_EQ(pool->stats().available, 0);
+}
+
+// should not store more than max_available buffers
+TEST(test_buffer_pool, MaxAvailable) {
+  auto pool = BufferPool<int>::create(0, 2);
+
+  {
+    auto buffers = std::vector<BufferPool<int>::Handle>();
+    for (int i = 0; i < 4; i++) {
+      buffers.push_back(pool->acquire());
+    }
+  }
+
+  EXPECT_EQ(pool->stats().misses, 4);
+  EXPECT_EQ(pool->stats().available, 2);
+}
+
+// handles should keep the pool alive, even if the original owner is gone
+TEST(test_buffer_pool, HandleOutlivesPool) {
+  auto pool = BufferPool<int>::create(42, 1);
+  auto buffer = pool->acquire();
+  pool = nullptr;
+
+  EXPECT_EQ(*buffer, 42);
+
+  auto moved_buffer = std::move(buffer);
+  EXPECT_FALSE(buffer);
+  EXPECT_EQ(*moved_buffer, 42);
+}
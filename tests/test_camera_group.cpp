@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/camera_group.hpp"
+
+using namespace std::chrono_literals;
+
+static std::filesystem::path FIXTURES;
+
+/**
+ * Should open every camera, and throw if any of them can't be opened.
+ */
+TEST(test_camera_group, Open) {
+  auto camera_group = CameraGroup(std::vector<std::filesystem::path>{
+      FIXTURES / "382x288@80Hz.xml", FIXTURES / "72x56@1000Hz.xml"});
+  EXPECT_EQ(camera_group.size(), 2);
+  EXPECT_EQ(camera_group.camera(1).get_frame_shape(),
+            std::make_tuple(Eigen::Index{72}, Eigen::Index{56}));
+  EXPECT_THROW(camera_group.camera(2), std::out_of_range);
+
+  // the other cameras are still opened, then the error is rethrown
+  auto missing = std::vector<std::filesystem::path>{
+      FIXTURES / "382x288@80Hz.xml", "this-file-should-not-exist"};
+  EXPECT_THROW(CameraGroup{missing}, std::runtime_error);
+  EXPECT_THROW(CameraGroup(std::vector<std::filesystem::path>{}),
+               std::invalid_argument);
+}
+
+/**
+ * Should return a frame from every camera, taken at around the same time.
+ */
+TEST(test_camera_group, GetFrameSet) {
+  auto cameras = std::vector<std::unique_ptr<IRImager>>();
+  cameras.push_back(std::make_unique<IRImagerMock>(
+      FIXTURES / "382x288@80Hz.xml", SyntheticSceneOptions{}));
+  cameras.push_back(
+      std::make_unique<IRImagerMock>(FIXTURES / "72x56@1000Hz.xml"));
+  auto camera_group = CameraGroup(std::move(cameras));
+
+  EXPECT_THROW(camera_group.get_frame_set(1ms), std::runtime_error);
+  EXPECT_THROW(camera_group.start_streaming(0), std::invalid_argument);
+
+  camera_group.start_streaming();
+  EXPECT_TRUE(camera_group.is_streaming());
+  auto previous_time_points =
+      std::vector<std::chrono::steady_clock::time_point>(2);
+  for (int i = 0; i < 10; i++) {
+    auto frame_set = camera_group.get_frame_set(2ms);
+    ASSERT_EQ(frame_set.size(), 2);
+
+    auto &[slow_frame, slow_time_point, slow_metadata] = frame_set[0];
+    auto &[fast_frame, fast_time_point, fast_metadata] = frame_set[1];
+    EXPECT_EQ(slow_frame->rows(), 382);
+    EXPECT_EQ(fast_frame->rows(), 72);
+    EXPECT_LE(slow_time_point - fast_time_point, 2ms);
+    EXPECT_LE(fast_time_point - slow_time_point, 2ms);
+
+    // frame sets never share frames
+    EXPECT_GT(slow_time_point, previous_time_points[0]);
+    EXPECT_GT(fast_time_point, previous_time_points[1]);
+    previous_time_points = {slow_time_point, fast_time_point};
+  }
+
+  // frames are never exactly simultaneous
+  EXPECT_EQ(camera_group.try_get_frame_set(0ns, 50ms), std::nullopt);
+
+  camera_group.stop_streaming();
+  EXPECT_FALSE(camera_group.is_streaming());
+  EXPECT_THROW(camera_group.try_get_frame_set(2ms, 0ms), std::runtime_error);
+
+  auto skew = camera_group.get_skew_stats();
+  EXPECT_EQ(skew.count, 10);
+  EXPECT_LE(skew.max, 2ms);
+  camera_group.reset_skew_stats();
+  EXPECT_EQ(camera_group.get_skew_stats().count, 0);
+
+  // the cameras can be restarted
+  camera_group.start_streaming(1);
+  EXPECT_EQ(camera_group.get_frame_set(2ms).size(), 2);
+}
+
+int main(int argc, char **argv) {
+  FIXTURES = std::filesystem::path(argv[0]).parent_path() / "__fixtures__";
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+extern "C" {
+#include <poll.h>
+}
+
+#include "../src/nqm/irimager/event_fd.hpp"
+
+static bool is_readable(const EventFd &event_fd, int timeout_ms = 0) {
+  auto poll_fd = pollfd{event_fd.fd(), POLLIN, 0};
+  return poll(&poll_fd, 1, timeout_ms) == 1 && (poll_fd.revents & POLLIN);
+}
+
+TEST(test_event_fd, NotifyAndClear) {
+  auto event_fd = EventFd();
+  EXPECT_FALSE(is_readable(event_fd));
+
+  event_fd.notify();
+  EXPECT_TRUE(is_readable(event_fd));
+
+  // multiple notifications should be merged
+  event_fd.notify();
+  event_fd.clear();
+  EXPECT_FALSE(is_readable(event_fd));
+
+  // clearing an already cleared fd should not block
+  event_fd.clear();
+  EXPECT_FALSE(is_readable(event_fd));
+}
+
+TEST(test_event_fd, NotifyFromOtherThread) {
+  auto event_fd = EventFd();
+
+  auto thread = std::thread([&event_fd]() { event_fd.notify(); });
+  EXPECT_TRUE(is_readable(event_fd, 5000));
+  thread.join();
+}
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/frame_codec.hpp"
+
+using Frame = Eigen::Matrix<std::uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                            Eigen::RowMajor>;
+
+/** A smooth thermal-like scene around 25 ℃, with a little sensor noise */
+static Frame make_frame(Eigen::Index rows, Eigen::Index cols,
+                        std::mt19937 &rng) {
+  auto noise = std::uniform_int_distribution<int>(-3, 3);
+  auto frame = Frame(rows, cols);
+  for (Eigen::Index row = 0; row < rows; row++) {
+    for (Eigen::Index col = 0; col < cols; col++) {
+      frame(row, col) =
+          static_cast<std::uint16_t>(1250 + row + col / 2 + noise(rng));
+    }
+  }
+  return frame;
+}
+
+static Frame decode(FrameDecoder &decoder, const std::uint8_t *data,
+                    std::size_t size) {
+  auto [rows, cols] = FrameDecoder::frame_shape(data, size);
+  auto frame = Frame(rows, cols);
+  decoder.decode(data, size, frame.data());
+  return frame;
+}
+
+TEST(test_frame_codec, RoundTrip) {
+  auto rng = std::mt19937(42);
+  // not a multiple of the block size, to test the last partial block
+  auto encoder = FrameEncoder(13, 7, 4);
+  auto decoder = FrameDecoder();
+
+  auto encoded = std::vector<std::uint8_t>();
+  for (int i = 0; i < 10; i++) {
+    auto frame = make_frame(13, 7, rng);
+    if (i == 5) {
+      // extreme values must survive the wrap-around of the prediction errors
+      frame(0, 0) = 0;
+      frame(0, 1) = 65535;
+      frame(12, 6) = 65535;
+    }
+
+    encoded.clear();
+    auto size = encoder.encode(frame.data(), encoded);
+    ASSERT_EQ(size, encoded.size());
+    ASSERT_LE(size, encoder.max_encoded_size());
+    EXPECT_EQ(FrameDecoder::is_keyframe(encoded.data(), size), i % 4 == 0);
+    EXPECT_EQ(decode(decoder, encoded.data(), size), frame);
+  }
+}
+
+TEST(test_frame_codec, Compresses) {
+  auto rng = std::mt19937(42);
+  auto frame = make_frame(288, 382, rng);
+  auto encoder = FrameEncoder(288, 382);
+
+  auto encoded = std::vector<std::uint8_t>();
+  auto keyframe_size = encoder.encode(frame.data(), encoded);
+  auto unchanged_size = encoder.encode(frame.data(), encoded);
+
+  auto raw_size = static_cast<std::size_t>(frame.size()) * 2;
+  EXPECT_LT(keyframe_size, raw_size / 2);
+  // a single byte per block of 16 pixels, plus the header
+  EXPECT_LT(unchanged_size, raw_size / 30);
+}
+
+TEST(test_frame_codec, Errors) {
+  auto rng = std::mt19937(42);
+  auto frame = make_frame(4, 4, rng);
+  auto encoder = FrameEncoder(4, 4);
+  auto encoded = std::vector<std::uint8_t>();
+  encoder.encode(frame.data(), encoded);
+  auto keyframe_size = encoded.size();
+  encoder.encode(frame.data(), encoded);
+
+  auto decoder = FrameDecoder();
+  auto out = Frame(4, 4);
+  // delta frame without the keyframe before it
+  EXPECT_THROW(decoder.decode(encoded.data() + keyframe_size,
+                              encoded.size() - keyframe_size, out.data()),
+               std::runtime_error);
+  // truncated data
+  EXPECT_THROW(decoder.decode(encoded.data(), keyframe_size - 1, out.data()),
+               std::invalid_argument);
+  // wrong magic bytes
+  auto corrupt = std::vector<std::uint8_t>(encoded.data(),
+                                           encoded.data() + keyframe_size);
+  corrupt[0] = 0;
+  EXPECT_THROW(decoder.decode(corrupt.data(), corrupt.size(), out.data()),
+               std::invalid_argument);
+
+  EXPECT_THROW(FrameEncoder(0, 4), std::invalid_argument);
+  EXPECT_THROW(FrameEncoder(4, 4, 0), std::invalid_argument);
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../src/nqm/irimager/frame_replay.hpp"
+
+using namespace std::chrono_literals;
+
+static std::filesystem::path temp_test_path() {
+  const auto *test_info = testing::UnitTest::GetInstance()->current_test_info();
+  return std::filesystem::temp_directory_path() /
+         (std::string("test_frame_replay_") + test_info->name());
+}
+
+/** Writes a version 1.0 `.npy` file, like `numpy.save()` */
+static void write_npy(const std::filesystem::path &path,
+                      const std::string &descr, std::size_t rows,
+                      std::size_t cols, std::uint16_t value) {
+  auto header = "{'descr': '" + descr +
+                "', 'fortran_order': False, 'shape': (" +
+                std::to_string(rows) + ", " + std::to_string(cols) + "), }";
+  // the header is padded with spaces, and ends with a newline
+  header.append(64 - (10 + header.size() + 1) % 64, ' ');
+  header.push_back('\n');
+
+  auto file = std::ofstream(path, std::ios::binary);
+  file.write("\x93NUMPY\x01\x00", 8);
+  file.put(static_cast<char>(header.size() & 0xFF));
+  file.put(static_cast<char>(header.size() >> 8));
+  file << header;
+  for (std::size_t i = 0; i < rows * cols; i++) {
+    auto pixel = static_cast<std::uint16_t>(value + i);
+    file.put(static_cast<char>(pixel & 0xFF));
+    file.put(static_cast<char>(pixel >> 8));
+  }
+}
+
+TEST(test_frame_replay, NpyDirectory) {
+  auto path = temp_test_path();
+  std::filesystem::create_directories(path);
+  // should be played back in filename order, not creation order
+  write_npy(path / "2.npy", "<u2", 3, 2, 200);
+  write_npy(path / "1.npy", "<u2", 3, 2, 100);
+  std::ofstream(path / "ignored.txt") << "not a frame";
+
+  auto replay = FrameReplay(path, 10ms);
+  EXPECT_EQ(replay.size(), 2);
+  EXPECT_EQ(replay.shape()[0], 3);
+  EXPECT_EQ(replay.shape()[1], 2);
+  EXPECT_EQ(replay.temp_range_decimal(), 1);
+
+  auto frame = std::vector<std::uint16_t>(6);
+  auto metadata = FrameMetadata{};
+  EXPECT_EQ(replay.read(0, frame.data(), metadata), 0ms);
+  EXPECT_EQ(frame[0], 100);
+  EXPECT_EQ(frame[5], 105);
+  EXPECT_EQ(metadata.flag_state, FlagState::OPEN);
+  EXPECT_EQ(replay.read(1, frame.data(), metadata), 10ms);
+  EXPECT_EQ(frame[0], 200);
+  EXPECT_THROW(replay.read(2, frame.data(), metadata), std::out_of_range);
+
+  // every frame must have the same shape
+  write_npy(path / "3.npy", "<u2", 2, 3, 300);
+  EXPECT_THROW(FrameReplay{path}, std::invalid_argument);
+  std::filesystem::remove(path / "3.npy");
+
+  write_npy(path / "3.npy", "<f4", 3, 2, 300);
+  EXPECT_THROW(FrameReplay{path}, std::invalid_argument);
+
+  std::filesystem::remove_all(path);
+  std::filesystem::create_directories(path);
+  EXPECT_THROW(FrameReplay{path}, std::invalid_argument);
+  std::filesystem::remove_all(path);
+}
+
+TEST(test_frame_replay, Recording) {
+  auto path = temp_test_path();
+  auto start = std::chrono::steady_clock::time_point(1h);
+  {
+    auto recorder = Recorder(path, 2, 2, 2);
+    auto frame = std::vector<std::uint16_t>{1, 2, 3, 4};
+    auto metadata = FrameMetadata{};
+    metadata.flag_state = FlagState::CLOSED;
+    recorder.append(frame.data(), start, metadata);
+    recorder.append(frame.data(), start + 30ms, FrameMetadata{});
+  }
+
+  auto replay = FrameReplay(path);
+  EXPECT_EQ(replay.size(), 2);
+  EXPECT_EQ(replay.temp_range_decimal(), 2);
+
+  auto frame = std::vector<std::uint16_t>(4);
+  auto metadata = FrameMetadata{};
+  EXPECT_EQ(replay.read(0, frame.data(), metadata), 0ms);
+  EXPECT_EQ(metadata.flag_state, FlagState::CLOSED);
+  EXPECT_EQ(replay.read(1, frame.data(), metadata), 30ms);
+  EXPECT_EQ(frame, (std::vector<std::uint16_t>{1, 2, 3, 4}));
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "../src/nqm/irimager/frame_scheduler.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(test_frame_scheduler, Pacing) {
+  auto scheduler = FrameScheduler(5ms);
+
+  auto start = std::chrono::steady_clock::now();
+  auto first = scheduler.wait();
+  EXPECT_EQ(scheduler.frame_index(), 0);
+  for (std::uint64_t i = 1; i <= 20; i++) {
+    auto deadline = scheduler.wait();
+    EXPECT_EQ(scheduler.frame_index(), i);
+    EXPECT_EQ(scheduler.missed_frames(), 0);
+    // deadlines are absolute, so they never drift
+    EXPECT_EQ(deadline - first, i * 5ms);
+    EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+  }
+  EXPECT_GE(std::chrono::steady_clock::now() - start, 100ms);
+}
+
+// frames that are missed should be skipped, not returned in a burst
+TEST(test_frame_scheduler, SkipsMissedFrames) {
+  auto scheduler = FrameScheduler(5ms);
+  auto first = scheduler.wait();
+
+  std::this_thread::sleep_for(23ms);
+  auto deadline = scheduler.wait();
+  EXPECT_GE(scheduler.frame_index(), 4);
+  EXPECT_EQ(scheduler.missed_frames(), scheduler.frame_index() - 1);
+  EXPECT_EQ(deadline - first, scheduler.frame_index() * 5ms);
+  EXPECT_LE(std::chrono::steady_clock::now() - deadline, 5ms);
+
+  scheduler.reset();
+  scheduler.wait();
+  EXPECT_EQ(scheduler.frame_index(), 0);
+  EXPECT_EQ(scheduler.missed_frames(), 0);
+}
+
+TEST(test_frame_scheduler, PreciseSleepUntil) {
+  auto deadline = std::chrono::steady_clock::now() + 2ms;
+  FrameScheduler::precise_sleep_until(deadline);
+  EXPECT_GE(std::chrono::steady_clock::now(), deadline);
+
+  EXPECT_THROW(FrameScheduler(0ms), std::invalid_argument);
+}
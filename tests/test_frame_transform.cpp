@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+#include "../src/nqm/irimager/frame_transform.hpp"
+
+using Frame = Eigen::Matrix<std::uint16_t, Eigen::Dynamic, Eigen::Dynamic,
+                            Eigen::RowMajor>;
+
+/** A 6x8 frame, where each pixel is `row * 10 + col` */
+static Frame make_sensor_frame() {
+  auto frame = Frame(6, 8);
+  for (Eigen::Index row = 0; row < frame.rows(); row++) {
+    for (Eigen::Index col = 0; col < frame.cols(); col++) {
+      frame(row, col) = static_cast<std::uint16_t>(row * 10 + col);
+    }
+  }
+  return frame;
+}
+
+static Frame apply(const FrameTransform &transform, const Frame &sensor_frame) {
+  auto [rows, cols] =
+      transform.output_shape({sensor_frame.rows(), sensor_frame.cols()});
+  auto out = Frame(rows, cols);
+  transform.apply(sensor_frame.data(),
+                  {sensor_frame.rows(), sensor_frame.cols()},
+                  Eigen::Map<Frame>(out.data(), rows, cols));
+  return out;
+}
+
+TEST(test_frame_transform, Identity) {
+  auto sensor_frame = make_sensor_frame();
+  auto transform = FrameTransform();
+  EXPECT_TRUE(transform.is_identity());
+  EXPECT_EQ(apply(transform, sensor_frame), sensor_frame);
+}
+
+TEST(test_frame_transform, Crop) {
+  auto sensor_frame = make_sensor_frame();
+  auto transform = FrameTransform();
+  transform.row = 1;
+  transform.col = 2;
+  transform.height = 3;
+
+  auto out = apply(transform, sensor_frame);
+  EXPECT_EQ(out, sensor_frame.block(1, 2, 3, 6));
+
+  transform.height = 6;
+  EXPECT_THROW(apply(transform, sensor_frame), std::invalid_argument);
+  transform.height = 0;
+  transform.row = -1;
+  EXPECT_THROW(apply(transform, sensor_frame), std::invalid_argument);
+}
+
+TEST(test_frame_transform, Binning) {
+  auto sensor_frame = make_sensor_frame();
+  auto transform = FrameTransform();
+  transform.col = 1;
+  transform.binning = 2;
+
+  // the last column doesn't fill a bin, so is dropped
+  auto out = apply(transform, sensor_frame);
+  ASSERT_EQ(out.rows(), 3);
+  ASSERT_EQ(out.cols(), 3);
+  // mean of {1, 2, 11, 12} is 6.5, which rounds to 7
+  EXPECT_EQ(out(0, 0), 7);
+  EXPECT_EQ(out(2, 2), (45 + 46 + 55 + 56 + 2) / 4);
+
+  transform.binning_mode = BinningMode::MAX;
+  out = apply(transform, sensor_frame);
+  EXPECT_EQ(out(0, 0), 12);
+  EXPECT_EQ(out(2, 2), 56);
+
+  transform.binning = 7;
+  EXPECT_THROW(apply(transform, sensor_frame), std::invalid_argument);
+  transform.binning = 0;
+  EXPECT_THROW(apply(transform, sensor_frame), std::invalid_argument);
+}
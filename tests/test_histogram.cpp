@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/histogram.hpp"
+
+/**
+ * numpy.quantile(values, q, method="inverted_cdf")
+ */
+static std::uint16_t inverted_cdf(std::vector<std::uint16_t> values, double q) {
+  std::sort(values.begin(), values.end());
+  auto rank = static_cast<std::size_t>(
+      std::ceil(q * static_cast<double>(values.size())));
+  return values[std::max(rank, std::size_t{1}) - 1];
+}
+
+TEST(test_histogram, Quantiles) {
+  auto values = std::vector<std::uint16_t>();
+  for (std::uint16_t i = 0; i < 1001; i++) {
+    // not in order, with lots of duplicates
+    values.push_back(static_cast<std::uint16_t>(19000 + (i * 7919) % 501));
+  }
+
+  auto histogram = Histogram();
+  // add in odd-sized chunks, to test the unrolled loop's tail
+  histogram.add(values.data(), 3);
+  histogram.add(values.data() + 3, values.size() - 3);
+  EXPECT_EQ(histogram.count(), values.size());
+
+  for (auto q : {0.0, 0.01, 0.25, 0.5, 0.95, 0.999, 1.0}) {
+    EXPECT_EQ(histogram.quantile(q), inverted_cdf(values, q)) << "q = " << q;
+  }
+
+  // unsorted quantiles should give the same results
+  auto q = std::array<double, 3>{0.95, 0.5, 0.99};
+  auto out = std::array<std::uint16_t, 3>();
+  histogram.quantiles(q.data(), out.data(), q.size());
+  for (std::size_t i = 0; i < q.size(); i++) {
+    EXPECT_EQ(out[i], inverted_cdf(values, q[i]));
+  }
+
+  const auto &counts = histogram.counts();
+  EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), std::uint64_t{0}),
+            values.size());
+
+  EXPECT_THROW(histogram.quantile(1.5), std::invalid_argument);
+  EXPECT_THROW(histogram.quantile(std::nan("")), std::invalid_argument);
+}
+
+TEST(test_histogram, ClearAndReuse) {
+  auto histogram = Histogram();
+  EXPECT_THROW(histogram.quantile(0.5), std::runtime_error);
+
+  auto values = std::array<std::uint16_t, 5>{100, 200, 300, 400, 500};
+  histogram.add(values.data(), values.size());
+  EXPECT_EQ(histogram.quantile(0.5), 300);
+
+  histogram.clear();
+  EXPECT_EQ(histogram.count(), 0);
+  histogram.add(values.data() + 3, 2);
+  EXPECT_EQ(histogram.quantile(0.0), 400);
+  EXPECT_EQ(histogram.counts()[300], 0);
+}
+
+TEST(test_histogram, BinWidth) {
+  EXPECT_THROW(Histogram(0), std::invalid_argument);
+
+  for (std::uint16_t bin_width :
+       std::array<std::uint16_t, 5>{2, 3, 10, 1000, 65535}) {
+    auto histogram = Histogram(bin_width);
+    auto values = std::vector<std::uint16_t>(65536);
+    std::iota(values.begin(), values.end(), 0);
+    histogram.add(values.data(), values.size());
+
+    // every value should be counted in the right bin
+    const auto &counts = histogram.counts();
+    EXPECT_EQ(counts.size(), (65536 + bin_width - 1) / bin_width);
+    for (std::size_t i = 0; i + 1 < counts.size(); i++) {
+      ASSERT_EQ(counts[i], bin_width) << "bin_width = " << bin_width;
+    }
+    EXPECT_EQ(counts.back(), 65536 - (counts.size() - 1) * bin_width);
+
+    // the median is 32767, but the lowest value of its bin is returned
+    EXPECT_EQ(histogram.quantile(0.5), (32767 / bin_width) * bin_width);
+  }
+}
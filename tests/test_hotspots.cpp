@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/hotspots.hpp"
+
+using Frame = HotspotDetector::Frame;
+
+static constexpr auto AREA = static_cast<Eigen::Index>(HotspotStat::AREA);
+static constexpr auto CENTROID_ROW =
+    static_cast<Eigen::Index>(HotspotStat::CENTROID_ROW);
+static constexpr auto CENTROID_COL =
+    static_cast<Eigen::Index>(HotspotStat::CENTROID_COL);
+static constexpr auto ROW = static_cast<Eigen::Index>(HotspotStat::ROW);
+static constexpr auto COL = static_cast<Eigen::Index>(HotspotStat::COL);
+static constexpr auto HEIGHT = static_cast<Eigen::Index>(HotspotStat::HEIGHT);
+static constexpr auto WIDTH = static_cast<Eigen::Index>(HotspotStat::WIDTH);
+static constexpr auto PEAK = static_cast<Eigen::Index>(HotspotStat::PEAK);
+static constexpr auto MEAN = static_cast<Eigen::Index>(HotspotStat::MEAN);
+
+/**
+ * Areas of each connected component of pixels hotter than @p min_raw, in
+ * the order of their first pixel, using a naive flood fill.
+ */
+static std::vector<float> flood_fill_areas(const Frame &frame, int min_raw,
+                                           int connectivity) {
+  auto visited = Eigen::Array<bool, Eigen::Dynamic, Eigen::Dynamic>(
+      frame.rows(), frame.cols());
+  visited.setConstant(false);
+  auto areas = std::vector<float>();
+  for (Eigen::Index row = 0; row < frame.rows(); row++) {
+    for (Eigen::Index col = 0; col < frame.cols(); col++) {
+      if (visited(row, col) || frame(row, col) < min_raw) {
+        continue;
+      }
+      auto area = 0.0f;
+      auto stack = std::vector<std::pair<Eigen::Index, Eigen::Index>>{
+          {row, col}};
+      visited(row, col) = true;
+      while (!stack.empty()) {
+        auto [r, c] = stack.back();
+        stack.pop_back();
+        area++;
+        for (Eigen::Index dr = -1; dr <= 1; dr++) {
+          for (Eigen::Index dc = -1; dc <= 1; dc++) {
+            auto diagonal = dr != 0 && dc != 0;
+            auto nr = r + dr;
+            auto nc = c + dc;
+            if ((diagonal && connectivity == 4) || nr < 0 ||
+                nr >= frame.rows() || nc < 0 || nc >= frame.cols() ||
+                visited(nr, nc) || frame(nr, nc) < min_raw) {
+              continue;
+            }
+            visited(nr, nc) = true;
+            stack.push_back({nr, nc});
+          }
+        }
+      }
+      areas.push_back(area);
+    }
+  }
+  return areas;
+}
+
+TEST(test_hotspots, InvalidArguments) {
+  EXPECT_THROW(HotspotDetector(0, 6, 20.0f), std::invalid_argument);
+  EXPECT_THROW(HotspotDetector(4, 6, 20.0f, HotspotThreshold::ABSOLUTE, 0),
+               std::invalid_argument);
+  EXPECT_THROW(HotspotDetector(4, 6, 20.0f, HotspotThreshold::ABSOLUTE, 1, 6),
+               std::invalid_argument);
+
+  auto detector = HotspotDetector(4, 6, 20.0f);
+  EXPECT_THROW(detector.detect(Frame(6, 4), 1), std::invalid_argument);
+  EXPECT_THROW(detector.set_background_rectangle(4, 0, 1, 1),
+               std::invalid_argument);
+}
+
+/**
+ * Should compute the statistics of each hot spot.
+ */
+TEST(test_hotspots, Stats) {
+  // raw value of 1000 is 0 ℃ with a temp_range_decimal of 1
+  auto frame = Frame(5, 6);
+  frame.setConstant(1000);
+  // an L-shaped hot spot
+  frame(1, 1) = 1300;
+  frame(2, 1) = 1200;
+  frame(2, 2) = 1100;
+  // only touches the L diagonally
+  frame(3, 3) = 1500;
+  // exactly at the threshold, so not hot
+  frame(0, 5) = 1050;
+
+  auto detector = HotspotDetector(5, 6, 5.0f);
+  auto hotspots = detector.detect(frame, 1);
+  ASSERT_EQ(hotspots.rows(), 1);
+  ASSERT_EQ(hotspots.cols(), HotspotDetector::STAT_COUNT);
+  EXPECT_FLOAT_EQ(hotspots(0, AREA), 4.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, CENTROID_ROW), 2.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, CENTROID_COL), 1.75f);
+  EXPECT_FLOAT_EQ(hotspots(0, ROW), 1.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, COL), 1.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, HEIGHT), 3.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, WIDTH), 3.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, PEAK), 50.0f);
+  EXPECT_FLOAT_EQ(hotspots(0, MEAN), 27.5f);
+
+  // the diagonal pixel is a separate hot spot with 4-connectivity, which is
+  // then ignored by min_area
+  auto detector4 =
+      HotspotDetector(5, 6, 5.0f, HotspotThreshold::ABSOLUTE, 1, 4);
+  EXPECT_EQ(detector4.detect(frame, 1).rows(), 2);
+  detector4 = HotspotDetector(5, 6, 5.0f, HotspotThreshold::ABSOLUTE, 2, 4);
+  auto large_hotspots = detector4.detect(frame, 1);
+  ASSERT_EQ(large_hotspots.rows(), 1);
+  EXPECT_FLOAT_EQ(large_hotspots(0, AREA), 3.0f);
+
+  detector.set_threshold(100.0f, HotspotThreshold::ABSOLUTE);
+  EXPECT_EQ(detector.detect(frame, 1).rows(), 0);
+  detector.set_threshold(-1000.0f, HotspotThreshold::ABSOLUTE);
+  EXPECT_FLOAT_EQ(detector.detect(frame, 1)(0, AREA), 30.0f);
+}
+
+/**
+ * Should compare the threshold to the median of the background region.
+ */
+TEST(test_hotspots, RelativeThreshold) {
+  auto frame = Frame(4, 8);
+  frame.setConstant(1000);
+  // the right of the frame is a warmer background
+  frame.rightCols(3).setConstant(1200);
+  frame(1, 1) = 1100;
+  frame(1, 6) = 1300;
+
+  auto detector = HotspotDetector(4, 8, 5.0f, HotspotThreshold::RELATIVE);
+  // the median of the whole frame is 1000, so the warmer background is hot
+  EXPECT_EQ(detector.detect(frame, 1).rows(), 2);
+
+  detector.set_background_rectangle(0, 5, 4, 3);
+  auto hotspots = detector.detect(frame, 1);
+  ASSERT_EQ(hotspots.rows(), 1);
+  EXPECT_FLOAT_EQ(hotspots(0, COL), 6.0f);
+
+  detector.clear_background();
+  EXPECT_EQ(detector.detect(frame, 1).rows(), 2);
+}
+
+/**
+ * Should find the same components as a naive flood fill, e.g. for U-shaped
+ * components whose runs are only merged on a later row.
+ */
+TEST(test_hotspots, MatchesFloodFill) {
+  auto random = std::mt19937(42);
+  auto distribution = std::uniform_int_distribution<std::uint16_t>(0, 99);
+  auto frame = Frame(37, 53);
+  for (Eigen::Index i = 0; i < frame.size(); i++) {
+    frame.data()[i] = static_cast<std::uint16_t>(1000 + distribution(random));
+  }
+
+  for (auto connectivity : {4, 8}) {
+    auto detector = HotspotDetector(37, 53, 0.0f, HotspotThreshold::ABSOLUTE,
+                                    1, connectivity);
+    for (auto min_raw : {1001, 1040, 1060, 1090}) {
+      // halfway between raw values, so rounding errors don't matter
+      detector.set_threshold(static_cast<float>(min_raw - 1000) / 10.0f - 0.05f,
+                             HotspotThreshold::ABSOLUTE);
+      auto hotspots = detector.detect(frame, 1);
+      auto expected = flood_fill_areas(frame, min_raw, connectivity);
+      ASSERT_EQ(static_cast<std::size_t>(hotspots.rows()), expected.size())
+          << "connectivity " << connectivity << ", min_raw " << min_raw;
+      for (Eigen::Index i = 0; i < hotspots.rows(); i++) {
+        EXPECT_FLOAT_EQ(hotspots(i, AREA),
+                        expected[static_cast<std::size_t>(i)]);
+      }
+    }
+  }
+}
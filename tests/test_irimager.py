@@ -1,12 +1,41 @@
 """Tests for nqm.irimager.IRImager"""
+import asyncio
 import datetime
+import os
 import pathlib
+import threading
+import time
 
 import numpy as np
 import pytest
 
 from nqm.irimager import IRImagerMock as IRImager
-from nqm.irimager import Logger, monotonic_to_system_clock
+from nqm.irimager import (
+    BinningMode,
+    CameraGroup,
+    FlagState,
+    FrameDecoder,
+    FrameEncoder,
+    FrameTransform,
+    Histogram,
+    HotspotDetector,
+    HotspotStat,
+    HotspotThreshold,
+    Logger,
+    OverflowPolicy,
+    Recorder,
+    RecordingReader,
+    ReplayTiming,
+    RoiStat,
+    ShutterPolicy,
+    SyntheticSceneOptions,
+    TemperatureUnit,
+    TemporalFilter,
+    TemporalFilterMode,
+    ThreadScheduling,
+    monotonic_to_system_clock,
+    raw_to_temperature,
+)
 
 XML_FILE = pathlib.Path(__file__).parent / "__fixtures__" / "382x288@27Hz.xml"
 README_FILE = pathlib.Path(__file__).parent.parent / "README.md"
@@ -104,6 +133,746 @@ def test_irimager_get_frame_monotonic():
     ) > datetime.datetime.now() - datetime.timedelta(seconds=30)
 
 
+def test_irimager_get_frame_with_frame_queue():
+    """Tests nqm.irimager.IRImager#get_frame with a background thread"""
+    irimager = IRImager(XML_FILE)
+
+    irimager.start_streaming(frame_queue_size=8)
+    try:
+        _, steady_time = irimager.get_frame_monotonic()
+        array, steady_time_2 = irimager.get_frame_monotonic()
+
+        assert array.dtype == np.uint16
+        assert array.shape == (382, 288)
+        assert steady_time_2 > steady_time
+    finally:
+        irimager.stop_streaming()
+
+    with pytest.raises(RuntimeError, match="IRIMAGER_STREAMOFF"):
+        irimager.get_frame()
+
+
+def test_irimager_get_frame_is_zero_copy():
+    """get_frame() should return frame buffers to the pool once garbage collected"""
+    irimager = IRImager(XML_FILE)
+
+    with irimager:
+        array, _ = irimager.get_frame()
+        # numpy doesn't own the data, our C++ frame does
+        assert not array.flags["OWNDATA"]
+        assert array.flags["WRITEABLE"]
+
+        array_2, _ = irimager.get_frame()
+        # both arrays are alive, so they can't share a buffer
+        assert not np.shares_memory(array, array_2)
+
+        del array
+        del array_2
+        hits_before = irimager.get_frame_pool_stats().hits
+        irimager.get_frame()
+        assert irimager.get_frame_pool_stats().hits == hits_before + 1
+
+
+def test_irimager_get_frame_into():
+    """Tests nqm.irimager.IRImager#get_frame_into"""
+    irimager = IRImager(XML_FILE)
+    out = np.zeros((382, 288), dtype=np.uint16)
+
+    with irimager:
+        timestamp = irimager.get_frame_into(out)
+        assert timestamp > datetime.datetime.now() - datetime.timedelta(seconds=30)
+        assert out.any()
+
+        steady_time = irimager.get_frame_monotonic_into(out)
+        assert steady_time > datetime.timedelta(seconds=0)
+
+        # should write into a view of a larger circular buffer
+        circular_buffer = np.zeros((4, 382, 288), dtype=np.uint16)
+        irimager.get_frame_into(circular_buffer[2])
+        assert circular_buffer[2].any()
+        assert not circular_buffer[1].any()
+
+        with pytest.raises(ValueError, match="expected shape"):
+            irimager.get_frame_into(np.zeros((288, 382), dtype=np.uint16))
+
+        with pytest.raises(TypeError):
+            irimager.get_frame_into(np.zeros((382, 288), dtype=np.float32))
+
+
+def test_irimager_get_frame_celsius():
+    """Tests nqm.irimager.IRImager#get_frame_celsius"""
+    irimager = IRImager(XML_FILE)
+
+    with irimager:
+        frame, timestamp = irimager.get_frame_celsius()
+        assert frame.dtype == np.float32
+        assert frame.shape == irimager.get_frame_shape()
+        assert timestamp > datetime.datetime.now() - datetime.timedelta(seconds=30)
+        # mock frames are all 1800 ℃
+        np.testing.assert_allclose(frame, 1800.0)
+
+        out = np.zeros(irimager.get_frame_shape(), dtype=np.float32)
+        irimager.get_temperature_frame_monotonic_into(out, TemperatureUnit.KELVIN)
+        np.testing.assert_allclose(out, 1800.0 + 273.15)
+
+        with pytest.raises(ValueError, match="expected shape"):
+            irimager.get_temperature_frame_monotonic_into(
+                np.zeros((288, 382), dtype=np.float32)
+            )
+
+
+def test_raw_to_temperature():
+    """Tests nqm.irimager.raw_to_temperature"""
+    raw = np.array([[0, 1000], [1250, 19000]], dtype=np.uint16)
+
+    celsius = raw_to_temperature(raw, 1)
+    assert celsius.dtype == np.float32
+    np.testing.assert_allclose(celsius, raw / 10 - 100, rtol=1e-6)
+
+    out = np.zeros(raw.shape, dtype=np.float32)
+    assert raw_to_temperature(raw, 1, TemperatureUnit.KELVIN, out=out) is out
+    np.testing.assert_allclose(out, raw / 10 + 173.15, rtol=1e-6)
+
+    with pytest.raises(ValueError, match="same shape"):
+        raw_to_temperature(raw, 1, out=np.zeros((4,), dtype=np.float32))
+
+    with pytest.raises(TypeError):
+        # would otherwise silently write into a temporary float32 copy
+        raw_to_temperature(raw, 1, out=np.zeros(raw.shape, dtype=np.float64))
+
+
+def test_irimager_set_frame_transform():
+    """Tests nqm.irimager.IRImager#set_frame_transform"""
+    irimager = IRImager(XML_FILE)
+
+    irimager.set_frame_transform(
+        FrameTransform(row=10, height=100, binning=2, binning_mode=BinningMode.MAX)
+    )
+    assert irimager.get_frame_transform().binning_mode == BinningMode.MAX
+    assert irimager.get_frame_shape() == (50, 144)
+
+    with irimager:
+        frame, _ = irimager.get_frame()
+        assert frame.shape == (50, 144)
+        np.testing.assert_allclose(irimager.get_frame_celsius()[0], 1800.0)
+
+        with pytest.raises(RuntimeError, match="while streaming"):
+            irimager.set_frame_transform(FrameTransform())
+
+    with pytest.raises(ValueError, match="crop rectangle"):
+        irimager.set_frame_transform(FrameTransform(height=1000))
+
+    irimager.set_frame_transform(FrameTransform())
+    assert irimager.get_frame_shape() == (382, 288)
+
+
+def test_histogram():
+    """Tests nqm.irimager.Histogram"""
+    rng = np.random.default_rng(0)
+    frame = rng.integers(18000, 19000, size=(382, 288), dtype=np.uint16)
+    histogram = Histogram()
+
+    histogram.add(frame)
+    assert histogram.count == frame.size
+    for q in [0.0, 0.5, 0.95, 1.0]:
+        assert histogram.quantile(q) == np.quantile(frame, q, method="inverted_cdf")
+    np.testing.assert_array_equal(
+        histogram.quantiles([0.95, 0.5]),
+        np.quantile(frame, [0.95, 0.5], method="inverted_cdf"),
+    )
+    assert histogram.counts().sum() == frame.size
+
+    # non-contiguous slices and masks should work too
+    histogram.clear()
+    histogram.add(frame[10:20, 30:40])
+    assert histogram.count == 100
+    assert histogram.quantile(0.5) == np.quantile(
+        frame[10:20, 30:40], 0.5, method="inverted_cdf"
+    )
+
+    with pytest.raises(ValueError):
+        histogram.quantile(2.0)
+
+    binned = Histogram(bin_width=10)
+    binned.add(frame)
+    assert binned.bin_width == 10
+    median = np.quantile(frame, 0.5, method="inverted_cdf")
+    assert binned.quantile(0.5) == median // 10 * 10
+
+
+def test_hotspot_detector():
+    """Tests nqm.irimager.HotspotDetector"""
+    # raw value of 1000 is 0 ℃ with a temp_range_decimal of 1
+    frame = np.full((56, 72), 1000, dtype=np.uint16)
+    frame[10:13, 20:24] = 1300
+    frame[11, 22] = 1500
+    frame[40, 60] = 1200  # a single hot pixel
+    frame[:, 70:] = 1040  # warm background
+
+    detector = HotspotDetector(56, 72, threshold=10.0)
+    hotspots = detector.detect(frame, 1)
+    assert hotspots.dtype == np.float32
+    assert hotspots.shape == (2, 9)
+    np.testing.assert_allclose(
+        hotspots[0],
+        [12, 11.0, 21.5, 10, 20, 3, 4, 50.0, (11 * 30 + 50) / 12],
+        rtol=1e-6,
+    )
+    assert hotspots[1, HotspotStat.PEAK.value] == pytest.approx(20.0)
+
+    detector = HotspotDetector(
+        56, 72, threshold=3.0, threshold_mode=HotspotThreshold.RELATIVE, min_area=2
+    )
+    # relative to the median of the whole frame, so the background is hot
+    assert detector.detect(frame, 1).shape[0] == 2
+    detector.set_background_rectangle(0, 70, 56, 2)
+    assert detector.detect(frame, 1).shape[0] == 1
+
+    with pytest.raises(ValueError, match="shape"):
+        detector.detect(frame[:10], 1)
+    with pytest.raises(ValueError, match="connectivity"):
+        HotspotDetector(56, 72, threshold=10.0, connectivity=6)
+
+
+def test_frame_codec():
+    """Tests nqm.irimager.FrameEncoder and nqm.irimager.FrameDecoder"""
+    rng = np.random.default_rng(0)
+    scene = rng.integers(18000, 18010, size=(288, 382), dtype=np.uint16)
+    frames = [
+        scene + rng.integers(0, 4, size=scene.shape, dtype=np.uint16)
+        for _ in range(5)
+    ]
+
+    encoder = FrameEncoder(288, 382, keyframe_interval=3)
+    encoded = [encoder.encode(frame) for frame in frames]
+    assert [FrameDecoder.is_keyframe(data) for data in encoded] == [
+        True,
+        False,
+        False,
+        True,
+        False,
+    ]
+    assert all(len(data) < frames[0].nbytes / 2 for data in encoded)
+
+    decoder = FrameDecoder()
+    for frame, data in zip(frames, encoded):
+        np.testing.assert_array_equal(decoder.decode(memoryview(data)), frame)
+
+    # can only start decoding from a keyframe
+    decoder.reset()
+    with pytest.raises(RuntimeError, match="keyframe"):
+        decoder.decode(encoded[1])
+    np.testing.assert_array_equal(decoder.decode(encoded[3]), frames[3])
+
+    with pytest.raises(ValueError):
+        decoder.decode(encoded[0][:-1])
+    with pytest.raises(ValueError, match="shape"):
+        encoder.encode(frames[0][:10])
+
+
+def test_temporal_filter():
+    """Tests nqm.irimager.TemporalFilter"""
+    rng = np.random.default_rng(0)
+    frames = rng.integers(0, 65536, size=(20, 56, 72), dtype=np.uint16)
+
+    max_hold = TemporalFilter(56, 72, TemporalFilterMode.MAX_HOLD, window=5)
+    mean = TemporalFilter(56, 72, TemporalFilterMode.MEAN, window=5)
+    with pytest.raises(RuntimeError, match="empty"):
+        max_hold.snapshot()
+    for i, frame in enumerate(frames):
+        max_hold.push(frame)
+        mean.push(frame)
+        window = frames[max(0, i - 4) : i + 1]
+        np.testing.assert_array_equal(max_hold.snapshot(), window.max(axis=0))
+        np.testing.assert_allclose(mean.snapshot(), window.mean(axis=0), atol=0.5)
+    assert max_hold.count == len(frames)
+
+    ema = TemporalFilter(56, 72, TemporalFilterMode.EMA, alpha=0.5)
+    frame = np.full((56, 72), 100, dtype=np.uint16)
+    ema.apply(frame)
+    frame[...] = 200
+    ema.apply(frame)  # overwrites the frame in-place
+    np.testing.assert_array_equal(frame, 150)
+
+    ema.reset()
+    assert ema.count == 0
+    with pytest.raises(ValueError, match="shape"):
+        ema.push(frames[0][:10])
+    with pytest.raises(ValueError, match="window"):
+        TemporalFilter(56, 72, TemporalFilterMode.MEAN, window=0)
+
+
+def test_recording(tmp_path):
+    """Tests nqm.irimager.Recorder and nqm.irimager.RecordingReader"""
+    path = tmp_path / "test.nqmrec"
+    irimager = IRImager(XML_FILE)
+
+    with irimager:
+        frames, timestamps, metadata = irimager.get_frames(5)
+        frame, timestamp = irimager.get_frame_monotonic()
+
+    with Recorder(path, *irimager.get_frame_shape(), 1, frames_per_chunk=2) as rec:
+        rec.append_frames(frames, timestamps, metadata)
+        rec.append(frame, timestamp)
+        assert len(rec) == 6
+        with pytest.raises(ValueError, match="order"):
+            rec.append(frame, datetime.timedelta(0))
+    assert rec.closed
+
+    reader = RecordingReader(path)
+    assert len(reader) == 6
+    assert (reader.rows, reader.cols) == irimager.get_frame_shape()
+    assert reader.temp_range_decimal == 1
+    assert reader.has_index
+
+    # views of the memory-mapped file
+    recorded_frames = reader.frames(0, 5)
+    assert not recorded_frames.flags["OWNDATA"]
+    assert not recorded_frames.flags["WRITEABLE"]
+    np.testing.assert_array_equal(recorded_frames, frames)
+    np.testing.assert_array_equal(reader.frames(5)[0], frame)
+    np.testing.assert_array_equal(reader.timestamps(0, 5), timestamps)
+    np.testing.assert_array_equal(
+        reader.metadata(0, 5)["counter"], metadata["counter"]
+    )
+    assert reader.metadata()["counter"][5] == 0
+
+    third = datetime.timedelta(microseconds=int(timestamps[2]) // 1000)
+    assert reader.seek(third) <= 2
+    assert reader.seek(timestamp + datetime.timedelta(seconds=1)) == 6
+
+    with pytest.raises(IndexError):
+        reader.frames(4, 7)
+
+    del reader
+    # views keep the recording mapped
+    np.testing.assert_array_equal(recorded_frames[-1], frames[-1])
+
+
+def test_irimager_mock_replay_npy(tmp_path):
+    """Tests replaying a directory of .npy files with nqm.irimager.IRImagerMock"""
+    frames = [np.full((4, 3), i, dtype=np.uint16) for i in range(3)]
+    for i, frame in enumerate(frames):
+        np.save(tmp_path / f"{i:04}.npy", frame)
+
+    irimager = IRImager(
+        XML_FILE, tmp_path, replay_timing=ReplayTiming.AS_FAST_AS_POSSIBLE
+    )
+    assert irimager.get_frame_shape() == (4, 3)
+
+    with irimager:
+        replayed_frames, _, _ = irimager.get_frames(4)
+
+    # should loop back to the first frame
+    for replayed_frame, frame in zip(replayed_frames, frames + frames[:1]):
+        np.testing.assert_array_equal(replayed_frame, frame)
+
+    with pytest.raises(RuntimeError):
+        IRImager(XML_FILE, tmp_path / "does-not-exist")
+
+
+def test_irimager_mock_synthetic_scene():
+    """Tests generating a synthetic scene with nqm.irimager.IRImagerMock"""
+    xml_path = XML_FILE.parent / "72x56@1000Hz.xml"
+    options = SyntheticSceneOptions(seed=42, hotspots=2)
+    assert options.seed == 42
+
+    irimager = IRImager(xml_path, scene=options)
+    assert irimager.get_frame_shape() == (72, 56)
+    with irimager:
+        frames, timestamps, metadata = irimager.get_frames(20)
+    with IRImager(xml_path, scene=options) as same_seed:
+        same_seed_frames, _, _ = same_seed.get_frames(1)
+
+    np.testing.assert_array_equal(frames[0], same_seed_frames[0])
+    # hotspots should be hotter than the background
+    assert frames[0].max() > frames[0].min()
+    assert (metadata["flag_state"] == FlagState.OPEN.value).all()
+    # paced at the XML framerate of 1000 Hz
+    assert timestamps[-1] - timestamps[0] >= 19 * 1_000_000
+
+
+@pytest.mark.parametrize("frame_queue_size", [0, 8])
+def test_irimager_shutter_policy(tmp_path, frame_queue_size):
+    """Tests that ShutterPolicy.RETURN_STALE doesn't wait for the flag to open"""
+    xml_path = tmp_path / "16x16@200Hz.xml"
+    xml_path.write_text(
+        '<?xml version="1.0"?><imager><framerate>200.0</framerate>'
+        "<autoflag><enable>1</enable><mininterval>0.4</mininterval></autoflag>"
+        "</imager>"
+    )
+    irimager = IRImager(xml_path, scene=SyntheticSceneOptions())
+
+    # the flag closes after 0.4s, for 0.3s
+    irimager.start_streaming(
+        frame_queue_size=frame_queue_size,
+        overflow_policy=OverflowPolicy.BLOCK,
+        shutter_policy=ShutterPolicy.RETURN_STALE,
+    )
+    try:
+        previous = None
+        stale_frames = 0
+        for _ in range(160):
+            start = time.monotonic()
+            frame, _, metadata = irimager.get_frame_with_metadata()
+            assert time.monotonic() - start < 0.1
+            if metadata.stale:
+                stale_frames += 1
+                np.testing.assert_array_equal(frame, previous)
+            previous = frame
+    finally:
+        irimager.stop_streaming()
+
+    assert stale_frames >= 40
+    flag_closures = irimager.get_stats().flag_closures
+    assert flag_closures.count == 1
+    assert flag_closures.max >= datetime.timedelta(milliseconds=250)
+
+
+@pytest.mark.parametrize("frame_queue_size", [0, 8])
+def test_irimager_get_roi_stats(frame_queue_size):
+    """Tests nqm.irimager.IRImager#get_roi_stats"""
+    irimager = IRImager(XML_FILE)
+
+    assert irimager.add_roi_rectangle(0, 0, 10, 20) == 0
+    assert irimager.add_roi_polygon([(0, 0), (100, 0), (50, 80)]) == 1
+    assert irimager.get_roi_count() == 2
+    irimager.set_roi_quantiles([0.5, 0.95])
+    assert irimager.get_roi_quantiles() == [0.5, 0.95]
+
+    with pytest.raises(ValueError, match="does not contain any pixels"):
+        irimager.add_roi_rectangle(1000, 1000, 10, 10)
+
+    irimager.start_streaming(frame_queue_size=frame_queue_size)
+    try:
+        with pytest.raises(RuntimeError, match="while streaming"):
+            irimager.clear_rois()
+
+        stats, timestamp = irimager.get_roi_stats()
+        assert stats.shape == (2, 6)
+        assert stats.dtype == np.float32
+        assert timestamp > datetime.datetime.now() - datetime.timedelta(seconds=30)
+        # mock frames are all 1800 ℃
+        np.testing.assert_allclose(stats[:, RoiStat.MAX.value], 1800.0)
+        np.testing.assert_allclose(stats[:, RoiStat.STDDEV.value], 0.0)
+        np.testing.assert_allclose(stats[:, 4:], 1800.0)
+
+        out = np.zeros((2, 6), dtype=np.float32)
+        irimager.get_roi_stats_monotonic_into(out)
+        np.testing.assert_allclose(out[:, RoiStat.MEAN.value], 1800.0)
+    finally:
+        irimager.stop_streaming()
+
+    irimager.clear_rois()
+    assert irimager.get_roi_count() == 0
+
+
+@pytest.mark.parametrize("frame_queue_size", [0, 8])
+def test_irimager_get_frames(frame_queue_size):
+    """Tests nqm.irimager.IRImager#get_frames"""
+    irimager = IRImager(XML_FILE)
+    assert irimager.get_frame_shape() == (382, 288)
+
+    irimager.start_streaming(frame_queue_size=frame_queue_size)
+    try:
+        frames, timestamps, metadata = irimager.get_frames(4)
+
+        assert frames.dtype == np.uint16
+        assert frames.shape == (4, 382, 288)
+        assert frames.flags["C_CONTIGUOUS"]
+        assert frames.all()
+
+        assert timestamps.dtype == np.int64
+        assert timestamps.shape == (4,)
+        assert (np.diff(timestamps) > 0).all()
+
+        assert metadata.shape == (4,)
+        assert (np.diff(metadata["counter"]) > 0).all()
+        assert (metadata["flag_state"] == FlagState.OPEN.value).all()
+    finally:
+        irimager.stop_streaming()
+
+
+def test_irimager_get_frame_with_metadata():
+    """Tests nqm.irimager.IRImager#get_frame_with_metadata"""
+    irimager = IRImager(XML_FILE)
+
+    with irimager:
+        _, first_time, first_metadata = irimager.get_frame_with_metadata()
+        frame, second_time, second_metadata = irimager.get_frame_with_metadata()
+
+    assert frame.shape == (382, 288)
+    assert isinstance(second_time, datetime.datetime)
+    assert second_time >= first_time
+    assert second_metadata.counter > first_metadata.counter
+    assert second_metadata.flag_state == FlagState.OPEN
+    assert isinstance(second_metadata.temp_chip, float)
+
+
+def test_irimager_try_get_frame():
+    """Tests nqm.irimager.IRImager#try_get_frame"""
+    irimager = IRImager(XML_FILE)
+
+    with irimager:
+        # without a frame queue, a frame is always grabbed, even with no timeout
+        frame, _ = irimager.try_get_frame(0.0)
+        assert frame.shape == (382, 288)
+        frame, timestamp = irimager.try_get_frame(datetime.timedelta(seconds=5))
+        assert frame.shape == (382, 288)
+        assert isinstance(timestamp, datetime.datetime)
+
+        frame, timestamp = irimager.try_get_frame_monotonic(5.0)
+        assert frame.shape == (382, 288)
+        assert isinstance(timestamp, datetime.timedelta)
+
+
+def test_irimager_overflow_policy_drop_oldest():
+    """Tests that OverflowPolicy.DROP_OLDEST always returns the latest frame"""
+    irimager = IRImager(XML_FILE)
+
+    irimager.start_streaming(
+        frame_queue_size=1, overflow_policy=OverflowPolicy.DROP_OLDEST
+    )
+    try:
+        time.sleep(0.2)
+        _, _, metadata = irimager.get_frame_with_metadata()
+        assert metadata.counter > 2
+    finally:
+        irimager.stop_streaming()
+
+
+def test_irimager_set_frame_callback():
+    """Tests nqm.irimager.IRImager#set_frame_callback"""
+    irimager = IRImager(XML_FILE)
+    received = []
+    enough_frames = threading.Event()
+
+    def callback(frame, timestamp, metadata):
+        received.append((frame, timestamp, metadata))
+        if len(received) >= 5:
+            enough_frames.set()
+
+    irimager.set_frame_callback(callback)
+    with irimager:
+        assert enough_frames.wait(timeout=5)
+        irimager.set_frame_callback(None)
+
+    frame, timestamp, metadata = received[0]
+    assert frame.shape == (382, 288)
+    assert isinstance(timestamp, datetime.timedelta)
+    assert metadata.flag_state == FlagState.OPEN
+
+    counters = [metadata.counter for _, _, metadata in received]
+    assert counters == sorted(counters)
+
+
+def test_irimager_swap_frame_callback_while_streaming():
+    """Replacing the callback while streaming then stopping must not deadlock"""
+    irimager = IRImager(XML_FILE)
+    received = threading.Event()
+
+    irimager.set_frame_callback(lambda *_: received.set())
+    with irimager:
+        for _ in range(10):
+            assert received.wait(timeout=5)
+            received.clear()
+            # frames may be in flight while the old callback is replaced
+            irimager.set_frame_callback(lambda *_: received.set())
+    assert not irimager.is_streaming()
+
+
+def test_irimager_replace_frame_callback_from_callback():
+    """The callback may remove or replace itself while it is being called"""
+    irimager = IRImager(XML_FILE)
+    replaced = threading.Event()
+    removed = threading.Event()
+
+    def remove_self(*_):
+        irimager.set_frame_callback(None)
+        removed.set()
+
+    def replace_self(*_):
+        irimager.set_frame_callback(remove_self)
+        replaced.set()
+
+    irimager.set_frame_callback(replace_self)
+    with irimager:
+        assert replaced.wait(timeout=5)
+        assert removed.wait(timeout=5)
+    assert not irimager.is_streaming()
+
+
+def test_irimager_get_frame_async():
+    """Tests nqm.irimager.IRImager#get_frame_async"""
+    irimager = IRImager(XML_FILE)
+
+    async def get_two_frames():
+        return await asyncio.gather(
+            irimager.get_frame_async(), irimager.get_frame_async()
+        )
+
+    with pytest.raises(RuntimeError, match="frame_queue_size"):
+        asyncio.run(get_two_frames())
+
+    irimager.start_streaming(frame_queue_size=4)
+    try:
+        (first_frame, first_time), (second_frame, second_time) = asyncio.run(
+            get_two_frames()
+        )
+    finally:
+        irimager.stop_streaming()
+
+    assert first_frame.shape == (382, 288)
+    assert second_frame.shape == (382, 288)
+    assert first_time != second_time
+
+
+def test_irimager_stream():
+    """Tests nqm.irimager.IRImager#stream"""
+    irimager = IRImager(XML_FILE)
+
+    async def stream_frames():
+        frames = []
+        async for frame, timestamp in irimager.stream():
+            assert isinstance(timestamp, datetime.datetime)
+            frames.append(frame)
+            if len(frames) == 3:
+                irimager.stop_streaming()
+        return frames
+
+    irimager.start_streaming(frame_queue_size=4)
+    frames = asyncio.run(stream_frames())
+
+    assert len(frames) == 3
+    assert not irimager.is_streaming()
+
+
+def test_irimager_get_frame_pool_stats():
+    """Tests nqm.irimager.IRImager#get_frame_pool_stats"""
+    irimager = IRImager(XML_FILE)
+
+    stats = irimager.get_frame_pool_stats()
+    assert stats.hits == 0
+    assert stats.misses == 0
+
+    with irimager:
+        for _ in range(4):
+            # the frame is released straight away, so its buffer is reused
+            irimager.get_frame()
+
+        stats = irimager.get_frame_pool_stats()
+        assert stats.misses == 1
+        assert stats.hits == 3
+        assert stats.available == 1
+
+
+def test_irimager_get_stats():
+    """Tests nqm.irimager.IRImager#get_stats"""
+    irimager = IRImager(XML_FILE)
+
+    stats = irimager.get_stats()
+    assert stats.frames_acquired == 0
+    assert stats.acquire.count == 0
+    assert stats.acquire.p99 == datetime.timedelta(0)
+
+    with irimager:
+        for _ in range(3):
+            irimager.get_frame()
+
+    stats = irimager.get_stats()
+    assert stats.frames_acquired == 3
+    assert stats.frames_delivered == 3
+    for latency in [stats.acquire, stats.process, stats.convert, stats.delivery]:
+        assert latency.count == 3
+        assert latency.p50 <= latency.p99 <= latency.max
+
+    irimager.reset_stats()
+    assert irimager.get_stats().frames_delivered == 0
+
+
+def test_irimager_frame_accounting():
+    """Tests that nqm.irimager.IRImager counts dropped and overrun frames"""
+    irimager = IRImager(XML_FILE)
+
+    with irimager:
+        _, _, first = irimager.get_frame_with_metadata()
+        time.sleep(0.2)
+        _, _, second = irimager.get_frame_with_metadata()
+
+    assert second.sequence == first.sequence + 1
+    overrun = second.counter_hw - first.counter_hw - 1
+    assert overrun > 0
+    assert irimager.get_stats().frames_overrun == overrun
+
+    irimager.reset_stats()
+    irimager.start_streaming(frame_queue_size=2)
+    try:
+        time.sleep(0.2)
+        _, _, metadata = irimager.get_frames(2)
+        assert metadata["sequence"][1] > metadata["sequence"][0]
+    finally:
+        irimager.stop_streaming()
+
+    stats = irimager.get_stats()
+    assert stats.frames_delivered == 2
+    assert stats.frames_dropped > 0
+    assert stats.frames_acquired == (
+        stats.frames_delivered + stats.frames_dropped + stats.frames_shutter_closed
+    )
+
+
+def test_irimager_acquisition_thread_scheduling():
+    """Tests pinning nqm.irimager.IRImager's acquisition thread to a CPU"""
+    irimager = IRImager(XML_FILE)
+    with pytest.raises(ValueError, match="Invalid niceness"):
+        ThreadScheduling(nice=20)
+
+    assert irimager.get_acquisition_thread_scheduling() is None
+
+    # any CPU that we're allowed to run on
+    cpu = sorted(os.sched_getaffinity(0))[-1]
+    irimager.set_acquisition_thread_scheduling(ThreadScheduling(cpus=[cpu], nice=19))
+    irimager.start_streaming(frame_queue_size=2)
+    try:
+        irimager.get_frame()
+    finally:
+        irimager.stop_streaming()
+
+    applied = irimager.get_acquisition_thread_scheduling()
+    assert applied.cpus == [cpu]
+    assert applied.nice == 19
+    assert applied.errors == []
+
+
+def test_camera_group():
+    """Tests nqm.irimager.CameraGroup"""
+    camera_group = CameraGroup([XML_FILE.parent / "72x56@1000Hz.xml", XML_FILE])
+    assert len(camera_group) == 2
+    assert [camera.get_frame_shape() for camera in camera_group] == [
+        (72, 56),
+        (382, 288),
+    ]
+    with pytest.raises(IndexError):
+        camera_group[2]  # pylint: disable=pointless-statement
+
+    with pytest.raises(RuntimeError, match="Not streaming"):
+        camera_group.get_frame_set(0.001)
+
+    tolerance = datetime.timedelta(milliseconds=20)
+    with camera_group:
+        for _ in range(3):
+            frame_set = camera_group.get_frame_set(tolerance)
+            assert len(frame_set) == 2
+            (_, first_time, _), (frame, second_time, metadata) = frame_set
+            assert abs(first_time - second_time) <= tolerance
+            assert frame.shape == camera_group[1].get_frame_shape()
+            assert metadata.flag_state == FlagState.OPEN
+
+    skew = camera_group.get_skew_stats()
+    assert skew.count == 3
+    assert skew.max <= tolerance
+
+
 def test_irimager_get_temp_range_decimal():
     """Tests that nqm.irimager.IRImager#get_temp_range_decimal returns an int"""
     irimager = IRImager(XML_FILE)
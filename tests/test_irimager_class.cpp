@@ -1,8 +1,20 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <condition_variable>
 #include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <poll.h>
+}
 
 #include "../src/nqm/irimager/irimager_class.hpp"
+#include "../src/nqm/irimager/recording.hpp"
 
 static std::filesystem::path XML_FILE;
 
@@ -23,6 +35,744 @@ TEST(test_irimager_class, NonExistentFile) {
                std::runtime_error);
 }
 
+/**
+ * Should return frames from the background acquisition thread.
+ */
+TEST(test_irimager_class, BackgroundAcquisition) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  irimager.start_streaming(4);
+
+  auto [first_frame, first_time_point] = irimager.get_frame_monotonic();
+  EXPECT_EQ(first_frame.rows(), 382);
+  EXPECT_EQ(first_frame.cols(), 288);
+
+  auto [second_frame, second_time_point] = irimager.get_frame_monotonic();
+  EXPECT_GT(second_time_point, first_time_point);
+
+  irimager.stop_streaming();
+  EXPECT_THROW(irimager.get_frame_monotonic(), std::runtime_error);
+}
+
+/**
+ * Should be safe to stop streaming while other threads are popping frames.
+ */
+TEST(test_irimager_class, StopStreamingWhileConsuming) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  irimager.start_streaming(4);
+
+  auto consumers = std::vector<std::thread>();
+  for (int i = 0; i < 4; i++) {
+    consumers.emplace_back([&irimager]() {
+      try {
+        while (
+            irimager.try_get_pooled_frame_monotonic(std::chrono::seconds(1))) {
+        }
+      } catch (const std::runtime_error &) {
+        // expected once streaming has stopped
+      }
+    });
+  }
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  irimager.stop_streaming();
+  for (auto &consumer : consumers) {
+    consumer.join();
+  }
+}
+
+/**
+ * Should reuse frame buffers, instead of allocating new ones.
+ */
+TEST(test_irimager_class, PooledFrames) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  for (std::size_t frame_queue_size : {0u, 4u}) {
+    irimager.start_streaming(frame_queue_size);
+
+    for (int i = 0; i < 4; i++) {
+      auto [thermal_frame, time_point, metadata] =
+          irimager.get_pooled_frame_monotonic();
+      EXPECT_EQ(thermal_frame->rows(), 382);
+      EXPECT_EQ(thermal_frame->cols(), 288);
+    }
+
+    auto stats = irimager.get_frame_pool_stats();
+    EXPECT_EQ(stats.misses, 1);
+    EXPECT_EQ(stats.hits, 3);
+
+    irimager.stop_streaming();
+  }
+}
+
+/**
+ * Should record the latency of every pipeline stage.
+ */
+TEST(test_irimager_class, PipelineStats) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  EXPECT_EQ(irimager.get_stats().frames_acquired, 0);
+
+  irimager.start_streaming();
+  for (int i = 0; i < 3; i++) {
+    irimager.get_pooled_frame_monotonic();
+  }
+  irimager.stop_streaming();
+
+  auto stats = irimager.get_stats();
+  EXPECT_EQ(stats.frames_acquired, 3);
+  EXPECT_EQ(stats.frames_shutter_closed, 0);
+  EXPECT_EQ(stats.frames_delivered, 3);
+  EXPECT_EQ(stats.acquire.count, 3);
+  EXPECT_EQ(stats.process.count, 3);
+  EXPECT_EQ(stats.delivery.count, 3);
+  // frames aren't queued, so there is no handoff
+  EXPECT_EQ(stats.handoff.count, 0);
+  EXPECT_LE(stats.process.p50, stats.process.max);
+
+  irimager.reset_stats();
+  irimager.start_streaming(4);
+  for (int i = 0; i < 3; i++) {
+    irimager.get_pooled_frame_monotonic();
+  }
+  irimager.stop_streaming();
+
+  stats = irimager.get_stats();
+  EXPECT_GE(stats.frames_acquired, 3);
+  EXPECT_EQ(stats.frames_delivered, 3);
+  EXPECT_EQ(stats.handoff.count, 3);
+  EXPECT_GE(stats.delivery.max, stats.handoff.max);
+
+  irimager.record_latency(PipelineStage::CONVERT,
+                          std::chrono::microseconds(10));
+  EXPECT_EQ(irimager.get_stats().convert.count, 1);
+}
+
+/**
+ * Should return metadata for every frame.
+ */
+TEST(test_irimager_class, FrameMetadata) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  auto [rows, cols] = irimager.get_frame_shape();
+  auto frames = IRImager::ThermalFrames(2, rows * cols);
+  auto timestamps = IRImager::Timestamps(2);
+  FrameMetadata metadata[2];
+
+  for (std::size_t frame_queue_size : {0u, 4u}) {
+    irimager.start_streaming(frame_queue_size);
+
+    auto [thermal_frame, time_point, first_metadata] =
+        irimager.get_pooled_frame_monotonic();
+    EXPECT_EQ(first_metadata.flag_state, FlagState::OPEN);
+
+    EXPECT_EQ(irimager.get_frames_monotonic_into(
+                  frames, timestamps, std::chrono::seconds(5), metadata),
+              2);
+    EXPECT_GT(metadata[0].counter, first_metadata.counter);
+    EXPECT_GT(metadata[1].counter, metadata[0].counter);
+    EXPECT_GT(metadata[1].counter_hw, metadata[0].counter_hw);
+    EXPECT_GT(metadata[0].sequence, first_metadata.sequence);
+    EXPECT_GT(metadata[1].sequence, metadata[0].sequence);
+
+    irimager.stop_streaming();
+  }
+}
+
+/**
+ * Should count every frame that is lost, and where it was lost.
+ */
+TEST(test_irimager_class, FrameAccounting) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  // frames that nobody asks for in time are never grabbed from the camera
+  irimager.start_streaming();
+  auto first = std::get<2>(irimager.get_pooled_frame_monotonic());
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  auto second = std::get<2>(irimager.get_pooled_frame_monotonic());
+  irimager.stop_streaming();
+
+  EXPECT_EQ(second.sequence, first.sequence + 1);
+  EXPECT_GE(second.counter_hw - first.counter_hw, 5);
+  auto stats = irimager.get_stats();
+  EXPECT_EQ(stats.frames_overrun, second.counter_hw - first.counter_hw - 1);
+  EXPECT_EQ(stats.frames_dropped, 0);
+
+  // frames that don't fit in the queue are grabbed, then dropped
+  for (auto overflow_policy :
+       {OverflowPolicy::DROP_NEWEST, OverflowPolicy::DROP_OLDEST}) {
+    irimager.reset_stats();
+    irimager.start_streaming(2, overflow_policy);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto queued = std::get<2>(irimager.get_pooled_frame_monotonic());
+    auto next = std::get<2>(irimager.get_pooled_frame_monotonic());
+    EXPECT_GT(next.sequence, queued.sequence);
+    irimager.stop_streaming();
+
+    stats = irimager.get_stats();
+    EXPECT_EQ(stats.frames_delivered, 2);
+    EXPECT_GE(stats.frames_dropped, 3);
+    EXPECT_EQ(stats.frames_acquired, stats.frames_delivered +
+                                         stats.frames_dropped +
+                                         stats.frames_shutter_closed);
+  }
+}
+
+/**
+ * Should pin the acquisition thread, and report how it was scheduled.
+ */
+TEST(test_irimager_class, AcquisitionThreadScheduling) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  EXPECT_THROW(
+      irimager.set_acquisition_thread_scheduling(ThreadScheduling{{}, 0, {}}),
+      std::invalid_argument);
+
+  // frames are grabbed by the caller without a frame queue
+  irimager.start_streaming();
+  EXPECT_EQ(irimager.get_acquisition_thread_scheduling(), std::nullopt);
+
+  // any CPU that we're allowed to run on, and the lowest priority niceness
+  auto cpu = apply_thread_scheduling(ThreadScheduling{}).cpus.front();
+  irimager.set_acquisition_thread_scheduling(ThreadScheduling{{cpu}, {}, 19});
+  irimager.start_streaming(2);
+  auto applied = irimager.get_acquisition_thread_scheduling();
+  ASSERT_TRUE(applied.has_value());
+  EXPECT_EQ(applied->cpus, std::vector<std::size_t>{cpu});
+  EXPECT_EQ(applied->nice, 19);
+  EXPECT_TRUE(applied->errors.empty());
+  irimager.get_frame();
+  irimager.stop_streaming();
+}
+
+/**
+ * Should give up waiting for a frame after the timeout.
+ */
+TEST(test_irimager_class, TryGetFrame) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  EXPECT_THROW(
+      irimager.try_get_pooled_frame_monotonic(std::chrono::seconds(5)),
+      std::runtime_error);
+
+  irimager.start_streaming();
+  // without a frame queue, a frame is always grabbed, even with no timeout
+  EXPECT_TRUE(
+      irimager.try_get_pooled_frame_monotonic(std::chrono::nanoseconds(0)));
+  EXPECT_TRUE(irimager.try_get_pooled_frame_monotonic(std::chrono::seconds(5)));
+  irimager.stop_streaming();
+}
+
+/**
+ * Should grab a separate frame for each thread, without a frame queue.
+ */
+TEST(test_irimager_class, ConcurrentGetFrame) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  irimager.start_streaming();
+
+  auto sequences_mutex = std::mutex();
+  auto sequences = std::vector<std::uint64_t>();
+  auto consumers = std::vector<std::thread>();
+  for (int i = 0; i < 4; i++) {
+    consumers.emplace_back([&]() {
+      for (int j = 0; j < 3; j++) {
+        auto [thermal_frame, time_point, metadata] =
+            irimager.get_pooled_frame_monotonic();
+        auto lock = std::scoped_lock(sequences_mutex);
+        sequences.push_back(metadata.sequence);
+      }
+    });
+  }
+  for (auto &consumer : consumers) {
+    consumer.join();
+  }
+  irimager.stop_streaming();
+
+  std::sort(sequences.begin(), sequences.end());
+  EXPECT_EQ(sequences.size(), 12);
+  EXPECT_EQ(std::adjacent_find(sequences.begin(), sequences.end()),
+            sequences.end());
+}
+
+/**
+ * Should handle a full frame queue according to the OverflowPolicy.
+ */
+TEST(test_irimager_class, OverflowPolicy) {
+  auto get_counter = [](IRImager &irimager) {
+    auto [thermal_frame, time_point, metadata] =
+        irimager.get_pooled_frame_monotonic();
+    return metadata.counter;
+  };
+
+  {
+    auto irimager =
+        IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+    irimager.start_streaming(1, OverflowPolicy::DROP_NEWEST);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // only the first frame should be kept
+    EXPECT_EQ(get_counter(irimager), 1);
+    irimager.stop_streaming();
+  }
+
+  {
+    auto irimager =
+        IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+    irimager.start_streaming(1, OverflowPolicy::DROP_OLDEST);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // old frames should be thrown away
+    EXPECT_GT(get_counter(irimager), 2);
+    irimager.stop_streaming();
+  }
+
+  {
+    auto irimager =
+        IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+    irimager.start_streaming(1, OverflowPolicy::BLOCK);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // no frames should be skipped
+    for (std::uint32_t i = 1; i <= 4; i++) {
+      EXPECT_EQ(get_counter(irimager), i);
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    irimager.stop_streaming();
+  }
+}
+
+/**
+ * Should push frames to the frame callback.
+ */
+TEST(test_irimager_class, FrameCallback) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  std::mutex mutex;
+  std::condition_variable frame_received;
+  std::vector<std::uint32_t> counters;
+
+  irimager.set_frame_callback(
+      [&](IRImager::PooledThermalFrame thermal_frame,
+          [[maybe_unused]] std::chrono::steady_clock::time_point time_point,
+          const FrameMetadata &metadata) {
+        EXPECT_EQ(thermal_frame->rows(), 382);
+        {
+          auto lock = std::scoped_lock(mutex);
+          counters.push_back(metadata.counter);
+        }
+        frame_received.notify_all();
+      });
+
+  irimager.start_streaming();
+  {
+    auto lock = std::unique_lock(mutex);
+    EXPECT_TRUE(frame_received.wait_for(lock, std::chrono::seconds(5),
+                                        [&] { return counters.size() >= 3; }));
+  }
+
+  // replaced callbacks must be destroyed by the thread that replaced them,
+  // never by the acquisition thread, which may be being joined
+  auto destroyed_by = std::thread::id();
+  {
+    auto guard = std::shared_ptr<int>(new int(0), [&](int *pointer) {
+      destroyed_by = std::this_thread::get_id();
+      delete pointer;
+    });
+    irimager.set_frame_callback(
+        [guard](IRImager::PooledThermalFrame,
+                std::chrono::steady_clock::time_point,
+                const FrameMetadata &) {});
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  irimager.set_frame_callback(nullptr);
+  EXPECT_EQ(destroyed_by, std::this_thread::get_id());
+  irimager.stop_streaming();
+
+  auto lock = std::scoped_lock(mutex);
+  EXPECT_TRUE(std::is_sorted(counters.begin(), counters.end()));
+
+  // can't set a callback without a background thread
+  irimager.start_streaming();
+  EXPECT_THROW(irimager.set_frame_callback(
+                   [](IRImager::PooledThermalFrame,
+                      std::chrono::steady_clock::time_point,
+                      const FrameMetadata &) {}),
+               std::runtime_error);
+  irimager.stop_streaming();
+}
+
+/**
+ * Should signal the frame event fd when frames are queued.
+ */
+TEST(test_irimager_class, FrameEventFd) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  auto is_readable = [](int fd) {
+    auto poll_fd = pollfd{fd, POLLIN, 0};
+    return poll(&poll_fd, 1, 5000) == 1 && (poll_fd.revents & POLLIN);
+  };
+
+  EXPECT_THROW(irimager.get_frame_event_fd(), std::runtime_error);
+  irimager.start_streaming();
+  EXPECT_THROW(irimager.get_frame_event_fd(), std::runtime_error);
+  irimager.stop_streaming();
+
+  irimager.start_streaming(4);
+  EXPECT_TRUE(irimager.is_streaming());
+  auto fd = irimager.get_frame_event_fd();
+  EXPECT_EQ(irimager.get_frame_event_fd(), fd);
+
+  EXPECT_TRUE(is_readable(fd));
+  EXPECT_TRUE(
+      irimager.try_get_pooled_frame_monotonic(std::chrono::nanoseconds(0)));
+
+  irimager.stop_streaming();
+  EXPECT_FALSE(irimager.is_streaming());
+  // should wake up waiters when streaming stops
+  EXPECT_TRUE(is_readable(fd));
+}
+
+/**
+ * Should write frames into the given array, and validate its shape.
+ */
+TEST(test_irimager_class, GetFrameInto) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  auto out = IRImager::ThermalFrame(382, 288);
+  out.setZero();
+
+  EXPECT_THROW(irimager.get_frame_monotonic_into(out), std::runtime_error);
+
+  irimager.start_streaming();
+
+  irimager.get_frame_monotonic_into(out);
+  EXPECT_NE(out(0, 0), 0);
+
+  auto wrong_shape = IRImager::ThermalFrame(288, 382);
+  EXPECT_THROW(irimager.get_frame_monotonic_into(wrong_shape),
+               std::invalid_argument);
+
+  auto too_big = IRImager::ThermalFrame(382, 300);
+  EXPECT_THROW(irimager.get_frame_monotonic_into(too_big.leftCols(288)),
+               std::invalid_argument);
+
+  irimager.stop_streaming();
+}
+
+/**
+ * Should convert frames to temperatures.
+ */
+TEST(test_irimager_class, GetTemperatureFrameInto) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  auto out = IRImager::TemperatureFrame(382, 288);
+
+  irimager.start_streaming();
+
+  irimager.get_temperature_frame_monotonic_into(out);
+  // the mock returns the maximum temperature of 1800 ℃
+  EXPECT_FLOAT_EQ(out.minCoeff(), 1800.0f);
+  EXPECT_FLOAT_EQ(out.maxCoeff(), 1800.0f);
+
+  irimager.get_temperature_frame_monotonic_into(out, TemperatureUnit::KELVIN);
+  EXPECT_FLOAT_EQ(out(0, 0), 2073.15f);
+
+  auto wrong_shape = IRImager::TemperatureFrame(288, 382);
+  EXPECT_THROW(irimager.get_temperature_frame_monotonic_into(wrong_shape),
+               std::invalid_argument);
+
+  irimager.stop_streaming();
+}
+
+/**
+ * Should compute ROI statistics, both with and without a frame queue.
+ */
+TEST(test_irimager_class, RoiStats) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  auto stats = IRImager::RoiStats(2, RoiStatsEngine::STAT_COUNT);
+
+  irimager.start_streaming();
+  EXPECT_THROW(irimager.get_roi_stats_monotonic_into(stats),
+               std::runtime_error);
+  EXPECT_THROW(irimager.add_roi_rectangle(0, 0, 10, 10), std::runtime_error);
+  irimager.stop_streaming();
+
+  EXPECT_EQ(irimager.add_roi_rectangle(0, 0, 10, 10), 0);
+  EXPECT_EQ(irimager.add_roi_polygon({{0, 0}, {100, 0}, {0, 100}}), 1);
+  EXPECT_EQ(irimager.get_roi_count(), 2);
+  irimager.set_roi_quantiles({0.5});
+  stats.resize(2, RoiStatsEngine::STAT_COUNT + 1);
+
+  for (auto frame_queue_size : {0, 4}) {
+    irimager.start_streaming(static_cast<std::size_t>(frame_queue_size));
+    stats.setZero();
+    irimager.get_roi_stats_monotonic_into(stats);
+    // the mock returns the maximum temperature of 1800 ℃
+    EXPECT_FLOAT_EQ(stats(0, static_cast<Eigen::Index>(RoiStat::MIN)), 1800.0f);
+    EXPECT_FLOAT_EQ(stats(1, static_cast<Eigen::Index>(RoiStat::MEAN)),
+                    1800.0f);
+    EXPECT_FLOAT_EQ(stats(1, static_cast<Eigen::Index>(RoiStat::STDDEV)),
+                    0.0f);
+    EXPECT_FLOAT_EQ(stats(1, RoiStatsEngine::STAT_COUNT), 1800.0f);
+
+    auto wrong_shape = IRImager::RoiStats(2, RoiStatsEngine::STAT_COUNT);
+    EXPECT_THROW(irimager.get_roi_stats_monotonic_into(wrong_shape),
+                 std::invalid_argument);
+    irimager.stop_streaming();
+  }
+
+  irimager.clear_rois();
+  EXPECT_EQ(irimager.get_roi_count(), 0);
+}
+
+/**
+ * Should crop and bin frames before they are queued.
+ */
+TEST(test_irimager_class, FrameTransform) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+
+  auto transform = FrameTransform();
+  transform.row = 10;
+  transform.height = 101;
+  transform.binning = 2;
+  irimager.set_frame_transform(transform);
+  EXPECT_EQ(irimager.get_frame_transform().binning, 2);
+  EXPECT_EQ(irimager.get_frame_shape(), std::make_tuple(50, 144));
+
+  irimager.start_streaming(2);
+  auto [thermal_frame, time_point] = irimager.get_frame_monotonic();
+  EXPECT_EQ(thermal_frame.rows(), 50);
+  EXPECT_EQ(thermal_frame.cols(), 144);
+  EXPECT_THROW(irimager.set_frame_transform(FrameTransform()),
+               std::runtime_error);
+  irimager.stop_streaming();
+
+  irimager.add_roi_rectangle(0, 0, 10, 10);
+  EXPECT_THROW(irimager.set_frame_transform(FrameTransform()),
+               std::runtime_error);
+  irimager.clear_rois();
+
+  transform.height = 1000;
+  EXPECT_THROW(irimager.set_frame_transform(transform),
+               std::invalid_argument);
+
+  irimager.set_frame_transform(FrameTransform());
+  EXPECT_EQ(irimager.get_frame_shape(), std::make_tuple(382, 288));
+}
+
+/**
+ * Should write multiple frames into a contiguous array.
+ */
+TEST(test_irimager_class, GetFramesInto) {
+  auto irimager =
+      IRImagerMock(XML_FILE.string().data(), XML_FILE.string().size());
+  auto [rows, cols] = irimager.get_frame_shape();
+  auto frames = IRImager::ThermalFrames(3, rows * cols);
+  auto timestamps = IRImager::Timestamps(3);
+
+  for (std::size_t frame_queue_size : {0u, 4u}) {
+    frames.setZero();
+    irimager.start_streaming(frame_queue_size);
+
+    EXPECT_EQ(irimager.get_frames_monotonic_into(frames, timestamps,
+                                                 std::chrono::seconds(5)),
+              3);
+    EXPECT_NE(frames.minCoeff(), 0);
+    EXPECT_LT(timestamps(0), timestamps(1));
+    EXPECT_LT(timestamps(1), timestamps(2));
+
+    if (frame_queue_size == 0) {
+      // should grab one frame, like try_get_pooled_frame_monotonic(), then
+      // stop early on timeout
+      EXPECT_EQ(irimager.get_frames_monotonic_into(
+                    frames, timestamps, std::chrono::nanoseconds(0)),
+                1);
+    }
+
+    irimager.stop_streaming();
+  }
+
+  auto wrong_shape = IRImager::ThermalFrames(3, rows);
+  irimager.start_streaming();
+  EXPECT_THROW(irimager.get_frames_monotonic_into(wrong_shape, timestamps,
+                                                  std::chrono::seconds(5)),
+               std::invalid_argument);
+  irimager.stop_streaming();
+}
+
+/**
+ * Should play back recorded frames, skipping frames with the shutter closed.
+ */
+TEST(test_irimager_class, Replay) {
+  auto recording_path =
+      std::filesystem::temp_directory_path() / "test_irimager_class_replay";
+  auto start = std::chrono::steady_clock::time_point(std::chrono::hours(1));
+  {
+    auto recorder = Recorder(recording_path, 4, 3, 2);
+    for (std::uint16_t i = 0; i < 3; i++) {
+      auto frame = std::vector<std::uint16_t>(12, i);
+      auto metadata = FrameMetadata{};
+      metadata.flag_state = i == 1 ? FlagState::CLOSED : FlagState::OPEN;
+      recorder.append(frame.data(), start + i * std::chrono::milliseconds(20),
+                      metadata);
+    }
+  }
+
+  {
+    auto irimager = IRImagerMock(XML_FILE, recording_path,
+                                 ReplayTiming::AS_FAST_AS_POSSIBLE, false);
+    EXPECT_EQ(irimager.get_frame_shape(), std::make_tuple(4, 3));
+    EXPECT_EQ(irimager.get_temp_range_decimal(), 2);
+
+    irimager.start_streaming();
+    auto [first_frame, first_time_point] = irimager.get_frame_monotonic();
+    EXPECT_EQ(first_frame(0, 0), 0);
+    auto [second_frame, second_time_point] = irimager.get_frame_monotonic();
+    EXPECT_EQ(second_frame(0, 0), 2);
+    // loop is disabled
+    EXPECT_THROW(irimager.get_frame_monotonic(), std::runtime_error);
+    irimager.stop_streaming();
+
+    // should restart from the first frame
+    irimager.start_streaming(4);
+    EXPECT_EQ(std::get<0>(irimager.get_frame_monotonic())(0, 0), 0);
+    irimager.stop_streaming();
+  }
+
+  {
+    auto irimager = IRImagerMock(XML_FILE, recording_path,
+                                 ReplayTiming::ORIGINAL, true);
+    irimager.start_streaming();
+    auto time_points = std::vector<std::chrono::steady_clock::time_point>();
+    for (int i = 0; i < 4; i++) {
+      time_points.push_back(std::get<1>(irimager.get_frame_monotonic()));
+    }
+    irimager.stop_streaming();
+    // the frame in-between was skipped, since the shutter was closed
+    EXPECT_GE(time_points[1] - time_points[0], std::chrono::milliseconds(40));
+    EXPECT_TRUE(std::is_sorted(time_points.begin(), time_points.end()));
+  }
+
+  std::filesystem::remove(recording_path);
+}
+
+/**
+ * Should pace frames at the XML framerate, with the XML resolution.
+ */
+TEST(test_irimager_class, XmlConfig) {
+  auto xml_path = XML_FILE.parent_path() / "72x56@1000Hz.xml";
+  auto irimager = IRImagerMock(xml_path);
+  EXPECT_EQ(irimager.get_frame_shape(), std::make_tuple(72, 56));
+
+  irimager.start_streaming();
+  auto first_time_point = std::get<1>(irimager.get_frame_monotonic());
+  auto last_time_point = first_time_point;
+  for (int i = 0; i < 50; i++) {
+    last_time_point = std::get<1>(irimager.get_frame_monotonic());
+  }
+  irimager.stop_streaming();
+  // frames are scheduled every 1ms, but may be skipped if we're too slow
+  EXPECT_GE(last_time_point - first_time_point, std::chrono::milliseconds(50));
+  EXPECT_EQ((last_time_point - first_time_point) %
+                std::chrono::microseconds(1000),
+            std::chrono::steady_clock::duration::zero());
+}
+
+/**
+ * Should generate the same synthetic scene for the same seed.
+ */
+TEST(test_irimager_class, SyntheticScene) {
+  auto xml_path = XML_FILE.parent_path() / "72x56@1000Hz.xml";
+  auto options = SyntheticSceneOptions{};
+  options.seed = 1234;
+  auto irimager = IRImagerMock(xml_path, options);
+  auto same_seed = IRImagerMock(xml_path, options);
+
+  irimager.start_streaming();
+  same_seed.start_streaming();
+  auto [frame, time_point, metadata] = irimager.get_pooled_frame_monotonic();
+  auto [same_seed_frame, same_seed_time_point, same_seed_metadata] =
+      same_seed.get_pooled_frame_monotonic();
+  EXPECT_EQ(frame->rows(), 72);
+  EXPECT_EQ(frame->cols(), 56);
+  EXPECT_EQ(metadata.flag_state, FlagState::OPEN);
+  EXPECT_EQ(*frame, *same_seed_frame);
+  EXPECT_NE(frame->minCoeff(), frame->maxCoeff());
+  irimager.stop_streaming();
+  same_seed.stop_streaming();
+
+  // frames should be cropped/binned like frames from a real camera
+  irimager.set_frame_transform(FrameTransform{0, 0, 0, 0, 2});
+  irimager.start_streaming();
+  auto binned_frame = std::get<0>(irimager.get_frame_monotonic());
+  EXPECT_EQ(binned_frame.rows(), 36);
+  EXPECT_EQ(binned_frame.cols(), 28);
+  irimager.stop_streaming();
+}
+
+/**
+ * Should return the last good frame while the shutter flag is closed,
+ * instead of waiting for it to open.
+ */
+TEST(test_irimager_class, ShutterPolicy) {
+  auto xml_path = std::filesystem::temp_directory_path() / "16x16@200Hz.xml";
+  std::ofstream(xml_path) << R"(<?xml version="1.0"?>
+<imager>
+  <framerate>200.0</framerate>
+  <autoflag><enable>1</enable><mininterval>0.4</mininterval></autoflag>
+</imager>)";
+  auto irimager = IRImagerMock(xml_path, SyntheticSceneOptions{});
+  std::filesystem::remove(xml_path);
+
+  // the flag closes after 0.4s, for 0.3s
+  irimager.start_streaming(0, OverflowPolicy::DROP_NEWEST,
+                           ShutterPolicy::RETURN_STALE);
+  auto previous_frame = IRImager::ThermalFrame();
+  auto previous_time_point = std::chrono::steady_clock::now();
+  auto longest_wait = std::chrono::steady_clock::duration::zero();
+  int stale_frames = 0;
+  for (int i = 0; i < 160; i++) {
+    auto [frame, time_point, metadata] = irimager.get_pooled_frame_monotonic();
+    auto now = std::chrono::steady_clock::now();
+    longest_wait = std::max(longest_wait, now - previous_time_point);
+    previous_time_point = now;
+
+    if (metadata.is_stale()) {
+      stale_frames++;
+      EXPECT_EQ(*frame, previous_frame);
+    }
+    previous_frame = *frame;
+  }
+  irimager.stop_streaming();
+
+  EXPECT_GE(stale_frames, 40);
+  EXPECT_LT(longest_wait, std::chrono::milliseconds(100));
+  // stale frames are delivered, not skipped
+  EXPECT_EQ(irimager.get_stats().frames_shutter_closed, 0);
+
+  auto flag_closures = irimager.get_stats().flag_closures;
+  EXPECT_EQ(flag_closures.count, 1);
+  EXPECT_GE(flag_closures.max, std::chrono::milliseconds(250));
+  EXPECT_LE(flag_closures.max, std::chrono::milliseconds(350));
+
+  // by default, getting a frame waits for the flag to open
+  irimager.reset_stats();
+  irimager.start_streaming();
+  for (int i = 0; i < 100; i++) {
+    auto [frame, time_point, metadata] = irimager.get_pooled_frame_monotonic();
+    EXPECT_FALSE(metadata.is_stale());
+  }
+  irimager.stop_streaming();
+  EXPECT_GE(irimager.get_stats().frames_shutter_closed, 40);
+}
+
 int main(int argc, char **argv) {
   XML_FILE = std::filesystem::path(argv[0]).parent_path() / "__fixtures__" /
              "382x288@27Hz.xml";
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../src/nqm/irimager/latency_stats.hpp"
+
+using namespace std::chrono_literals;
+
+TEST(test_latency_stats, Empty) {
+  auto histogram = LatencyHistogram();
+  auto summary = histogram.summary();
+  EXPECT_EQ(summary.count, 0);
+  EXPECT_EQ(summary.p50, 0ns);
+  EXPECT_EQ(summary.p99, 0ns);
+  EXPECT_EQ(summary.max, 0ns);
+  EXPECT_EQ(summary.mean, 0ns);
+
+  EXPECT_THROW(histogram.quantile(-0.1), std::invalid_argument);
+  EXPECT_THROW(histogram.quantile(1.1), std::invalid_argument);
+}
+
+TEST(test_latency_stats, Quantiles) {
+  auto histogram = LatencyHistogram();
+
+  // small latencies are counted exactly
+  for (int i = 1; i <= 50; i++) {
+    histogram.record(std::chrono::nanoseconds(i));
+  }
+  EXPECT_EQ(histogram.quantile(0.5), 25ns);
+  EXPECT_EQ(histogram.quantile(1.0), 50ns);
+
+  histogram.reset();
+  EXPECT_EQ(histogram.count(), 0);
+
+  // 1µs to 1000µs
+  for (int i = 1; i <= 1000; i++) {
+    histogram.record(std::chrono::microseconds(i));
+  }
+  auto summary = histogram.summary();
+  EXPECT_EQ(summary.count, 1000);
+  EXPECT_EQ(summary.max, 1000us);
+  EXPECT_EQ(summary.mean, 500500ns);
+
+  auto expect_near = [](std::chrono::nanoseconds actual,
+                        std::chrono::nanoseconds expected) {
+    // never underestimated, and accurate to 1/32
+    EXPECT_GE(actual, expected);
+    EXPECT_LE(actual, expected + expected / 32);
+  };
+  expect_near(summary.p50, 500us);
+  expect_near(summary.p99, 990us);
+  expect_near(histogram.quantile(0.0), 1us);
+
+  // negative latencies are clamped, huge latencies are saturated
+  histogram.reset();
+  histogram.record(-5ns);
+  histogram.record(1h);
+  EXPECT_EQ(histogram.quantile(0.0), 0ns);
+  EXPECT_EQ(histogram.summary().max, 1h);
+  EXPECT_LE(histogram.quantile(1.0),
+            std::chrono::nanoseconds(LatencyHistogram::MAX_TRACKABLE_NS));
+}
+
+TEST(test_latency_stats, ConcurrentRecord) {
+  auto histogram = LatencyHistogram();
+  constexpr int THREADS = 4;
+  constexpr int RECORDS = 10000;
+
+  auto threads = std::vector<std::thread>();
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&histogram, t]() {
+      for (int i = 0; i < RECORDS; i++) {
+        histogram.record(std::chrono::microseconds(t + 1));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  auto summary = histogram.summary();
+  EXPECT_EQ(summary.count, THREADS * RECORDS);
+  EXPECT_EQ(summary.max, std::chrono::microseconds(THREADS));
+}
+
+TEST(test_latency_stats, PipelineLatency) {
+  auto pipeline_latency = PipelineLatency();
+  pipeline_latency.record(PipelineStage::ACQUIRE, 10ms);
+  pipeline_latency.record(PipelineStage::PROCESS, 2ms);
+  pipeline_latency.count_acquired();
+  pipeline_latency.count_acquired();
+  pipeline_latency.count_acquired();
+  pipeline_latency.count_shutter_closed();
+  pipeline_latency.count_delivered(std::chrono::steady_clock::now() - 5ms);
+  pipeline_latency.count_dropped();
+  pipeline_latency.count_overrun(4);
+  pipeline_latency.record_flag_closure(300ms);
+
+  auto stats = pipeline_latency.stats();
+  EXPECT_EQ(stats.acquire.count, 1);
+  EXPECT_EQ(stats.acquire.max, 10ms);
+  EXPECT_EQ(stats.process.max, 2ms);
+  EXPECT_EQ(stats.handoff.count, 0);
+  EXPECT_EQ(stats.convert.count, 0);
+  EXPECT_EQ(stats.delivery.count, 1);
+  EXPECT_GE(stats.delivery.max, 5ms);
+  EXPECT_EQ(stats.flag_closures.count, 1);
+  EXPECT_EQ(stats.flag_closures.max, 300ms);
+  EXPECT_EQ(stats.frames_acquired, 3);
+  EXPECT_EQ(stats.frames_shutter_closed, 1);
+  EXPECT_EQ(stats.frames_delivered, 1);
+  EXPECT_EQ(stats.frames_dropped, 1);
+  EXPECT_EQ(stats.frames_overrun, 4);
+
+  pipeline_latency.reset();
+  stats = pipeline_latency.stats();
+  EXPECT_EQ(stats.acquire.count, 0);
+  EXPECT_EQ(stats.flag_closures.count, 0);
+  EXPECT_EQ(stats.frames_acquired, 0);
+  EXPECT_EQ(stats.frames_overrun, 0);
+}
+
+// a consumer must never see more frames leave the pipeline than entered it
+TEST(test_latency_stats, ConsistentFrameCounters) {
+  auto pipeline_latency = PipelineLatency();
+  constexpr int FRAMES = 100000;
+
+  auto producer = std::thread([&pipeline_latency]() {
+    for (int i = 0; i < FRAMES; i++) {
+      pipeline_latency.count_acquired();
+      switch (i % 3) {
+        case 0:
+          pipeline_latency.count_delivered(std::chrono::steady_clock::now());
+          break;
+        case 1:
+          pipeline_latency.count_dropped();
+          break;
+        default:
+          pipeline_latency.count_shutter_closed();
+      }
+    }
+  });
+
+  while (true) {
+    auto stats = pipeline_latency.stats();
+    auto left = stats.frames_delivered + stats.frames_dropped +
+                stats.frames_shutter_closed;
+    ASSERT_GE(stats.frames_acquired, left);
+    if (left == FRAMES) {
+      break;
+    }
+  }
+  producer.join();
+}
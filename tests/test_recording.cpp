@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/recording.hpp"
+
+using namespace std::chrono_literals;
+
+static std::filesystem::path temp_recording_path() {
+  const auto *test_info = testing::UnitTest::GetInstance()->current_test_info();
+  return std::filesystem::temp_directory_path() /
+         (std::string("test_recording_") + test_info->name() + ".nqmrec");
+}
+
+static std::vector<std::uint16_t> make_frame(std::size_t size,
+                                             std::uint16_t value) {
+  auto frame = std::vector<std::uint16_t>(size);
+  for (std::size_t i = 0; i < size; i++) {
+    frame[i] = static_cast<std::uint16_t>(value + i);
+  }
+  return frame;
+}
+
+TEST(test_recording, RoundTrip) {
+  auto path = temp_recording_path();
+  constexpr Eigen::Index rows = 5;
+  constexpr Eigen::Index cols = 3;
+  auto start = std::chrono::steady_clock::time_point(1h);
+
+  {
+    // not a multiple of the chunk size, to test the last partial chunk
+    auto recorder = Recorder(path, rows, cols, 2, 4);
+    for (std::uint16_t i = 0; i < 10; i++) {
+      auto metadata = FrameMetadata{};
+      metadata.counter = i;
+      metadata.flag_state = i == 3 ? FlagState::CLOSED : FlagState::OPEN;
+      recorder.append(make_frame(rows * cols, i).data(), start + i * 10ms,
+                      metadata);
+    }
+    EXPECT_EQ(recorder.size(), 10);
+  }
+
+  auto reader = RecordingReader(path);
+  EXPECT_EQ(reader.size(), 10);
+  EXPECT_EQ(reader.rows(), rows);
+  EXPECT_EQ(reader.cols(), cols);
+  EXPECT_EQ(reader.temp_range_decimal(), 2);
+  EXPECT_TRUE(reader.has_index());
+  for (std::uint16_t i = 0; i < 10; i++) {
+    EXPECT_EQ(reader.timestamp(i), start + i * 10ms);
+    EXPECT_EQ(reader.metadata(i).counter, i);
+    EXPECT_EQ(reader.metadata(i).flag_state,
+              i == 3 ? FlagState::CLOSED : FlagState::OPEN);
+    auto expected = make_frame(rows * cols, i);
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), reader.frame(i)));
+  }
+  // frames are evenly spaced, so they can be viewed as a strided array
+  EXPECT_EQ(reader.frame(1) - reader.frame(0),
+            static_cast<std::ptrdiff_t>(reader.record_size() / 2));
+  EXPECT_THROW(reader.frame(10), std::out_of_range);
+
+  std::filesystem::remove(path);
+}
+
+TEST(test_recording, Seek) {
+  auto path = temp_recording_path();
+  auto start = std::chrono::steady_clock::time_point(1h);
+  {
+    auto recorder = Recorder(path, 2, 2, 1, 3);
+    auto frame = make_frame(4, 0);
+    for (int i = 0; i < 10; i++) {
+      recorder.append(frame.data(), start + i * 10ms, FrameMetadata{});
+    }
+  }
+
+  auto reader = RecordingReader(path);
+  EXPECT_EQ(reader.seek(start - 1s), 0);
+  for (std::size_t i = 0; i < 10; i++) {
+    EXPECT_EQ(reader.seek(start + i * 10ms), i);
+    EXPECT_EQ(reader.seek(start + i * 10ms - 5ms), i);
+  }
+  EXPECT_EQ(reader.seek(start + 1s), 10);
+
+  std::filesystem::remove(path);
+}
+
+// a recording that was never closed should still be readable, without index
+TEST(test_recording, Unclosed) {
+  auto path = temp_recording_path();
+  auto start = std::chrono::steady_clock::time_point(1h);
+  auto recorder = Recorder(path, 2, 2, 1, 4);
+  for (std::uint16_t i = 0; i < 6; i++) {
+    recorder.append(make_frame(4, i).data(), start + i * 1ms, FrameMetadata{});
+  }
+
+  auto reader = RecordingReader(path);
+  EXPECT_EQ(reader.size(), 6);
+  EXPECT_FALSE(reader.has_index());
+  EXPECT_EQ(reader.frame(5)[0], 5);
+  EXPECT_EQ(reader.seek(start + 3ms), 3);
+
+  recorder.close();
+  EXPECT_THROW(
+      recorder.append(make_frame(4, 0).data(), start + 1s, FrameMetadata{}),
+      std::logic_error);
+  std::filesystem::remove(path);
+}
+
+TEST(test_recording, InvalidInput) {
+  auto path = temp_recording_path();
+  EXPECT_THROW(Recorder(path, 0, 2, 1), std::invalid_argument);
+
+  auto start = std::chrono::steady_clock::time_point(1h);
+  {
+    auto recorder = Recorder(path, 2, 2, 1);
+    auto frame = make_frame(4, 0);
+    recorder.append(frame.data(), start, FrameMetadata{});
+    EXPECT_THROW(recorder.append(frame.data(), start - 1ms, FrameMetadata{}),
+                 std::invalid_argument);
+  }
+
+  {
+    auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    file << std::string(RecordingReader::HEADER_SIZE, 'x');
+  }
+  EXPECT_THROW(RecordingReader{path}, std::invalid_argument);
+  EXPECT_THROW(RecordingReader{path.string() + ".missing"}, std::system_error);
+
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <stdexcept>
+
+#include "../src/nqm/irimager/roi.hpp"
+
+static constexpr auto MIN = static_cast<Eigen::Index>(RoiStat::MIN);
+static constexpr auto MAX = static_cast<Eigen::Index>(RoiStat::MAX);
+static constexpr auto MEAN = static_cast<Eigen::Index>(RoiStat::MEAN);
+static constexpr auto STDDEV = static_cast<Eigen::Index>(RoiStat::STDDEV);
+
+TEST(test_roi, Rectangle) {
+  auto frame = RoiStatsEngine::Frame(4, 6);
+  // raw value of 1000 is 0 ℃ with a temp_range_decimal of 1
+  frame.setConstant(1000);
+  frame(1, 2) = 1010;
+  frame(2, 3) = 990;
+
+  auto engine = RoiStatsEngine(4, 6);
+  EXPECT_EQ(engine.add_rectangle(1, 2, 2, 2), 0);
+  // should be clipped to the frame
+  EXPECT_EQ(engine.add_rectangle(-1, -1, 2, 100), 1);
+  EXPECT_EQ(engine.size(), 2);
+  EXPECT_EQ(engine.pixel_count(0), 4);
+  EXPECT_EQ(engine.pixel_count(1), 6);
+
+  auto stats = RoiStatsEngine::RoiStats(2, RoiStatsEngine::STAT_COUNT);
+  engine.compute(frame, stats, 1);
+
+  EXPECT_FLOAT_EQ(stats(0, MIN), -1.0f);
+  EXPECT_FLOAT_EQ(stats(0, MAX), 1.0f);
+  EXPECT_NEAR(stats(0, MEAN), 0.0f, 1e-5);
+  EXPECT_FLOAT_EQ(stats(0, STDDEV), std::sqrt(0.5f));
+
+  EXPECT_FLOAT_EQ(stats(1, MIN), 0.0f);
+  EXPECT_FLOAT_EQ(stats(1, MAX), 0.0f);
+  EXPECT_FLOAT_EQ(stats(1, STDDEV), 0.0f);
+
+  EXPECT_THROW(engine.add_rectangle(4, 0, 1, 1), std::invalid_argument);
+  EXPECT_THROW(engine.add_rectangle(0, 0, 0, 1), std::invalid_argument);
+  // failed ROIs should not be registered
+  EXPECT_EQ(engine.size(), 2);
+
+  auto wrong_stats = RoiStatsEngine::RoiStats(1, RoiStatsEngine::STAT_COUNT);
+  EXPECT_THROW(engine.compute(frame, wrong_stats, 1), std::invalid_argument);
+
+  engine.clear();
+  EXPECT_EQ(engine.size(), 0);
+}
+
+TEST(test_roi, Polygon) {
+  auto frame = RoiStatsEngine::Frame(10, 10);
+  for (Eigen::Index row = 0; row < frame.rows(); row++) {
+    for (Eigen::Index col = 0; col < frame.cols(); col++) {
+      frame(row, col) = static_cast<std::uint16_t>(1000 + row * 10 + col);
+    }
+  }
+
+  auto engine = RoiStatsEngine(10, 10);
+  // an axis-aligned square is the same as a rectangle
+  engine.add_polygon({{2, 1}, {5, 1}, {5, 4}, {2, 4}});
+  engine.add_rectangle(1, 2, 3, 3);
+  // a right-angled triangle, which contains the pixel centres left of the
+  // diagonal, i.e. 0 + 1 + 2 + 3 pixels
+  engine.add_polygon({{0, 0}, {4, 4}, {0, 4}});
+  EXPECT_EQ(engine.pixel_count(0), 9);
+  EXPECT_EQ(engine.pixel_count(2), 6);
+
+  auto stats = RoiStatsEngine::RoiStats(3, RoiStatsEngine::STAT_COUNT);
+  engine.compute(frame, stats, 1);
+  EXPECT_EQ(stats.row(0), stats.row(1));
+
+  EXPECT_FLOAT_EQ(stats(2, MIN), 1.0f);   // row 1, col 0
+  EXPECT_FLOAT_EQ(stats(2, MAX), 3.2f);   // row 3, col 2
+
+  EXPECT_THROW(engine.add_polygon({{0, 0}, {4, 4}}), std::invalid_argument);
+  // entirely outside the frame
+  EXPECT_THROW(engine.add_polygon({{20, 20}, {30, 20}, {30, 30}}),
+               std::invalid_argument);
+}
+
+TEST(test_roi, Quantiles) {
+  auto frame = RoiStatsEngine::Frame(4, 5);
+  for (Eigen::Index row = 0; row < frame.rows(); row++) {
+    for (Eigen::Index col = 0; col < frame.cols(); col++) {
+      frame(row, col) = static_cast<std::uint16_t>(1000 + row * 5 + col);
+    }
+  }
+
+  auto engine = RoiStatsEngine(4, 5);
+  engine.add_rectangle(0, 0, 4, 5);
+  engine.add_rectangle(1, 1, 2, 2);
+  EXPECT_THROW(engine.set_quantiles({0.5, 1.5}), std::invalid_argument);
+  engine.set_quantiles({0.5, 0.95});
+  EXPECT_EQ(engine.stat_count(), RoiStatsEngine::STAT_COUNT + 2);
+
+  auto stats = RoiStatsEngine::RoiStats(2, engine.stat_count());
+  // computing twice should reuse (and correctly clear) the histogram
+  for (int i = 0; i < 2; i++) {
+    engine.compute(frame, stats, 1);
+    // the 10th and 19th smallest of the 20 raw values from 1000 to 1019
+    EXPECT_FLOAT_EQ(stats(0, RoiStatsEngine::STAT_COUNT), 0.9f);
+    EXPECT_FLOAT_EQ(stats(0, RoiStatsEngine::STAT_COUNT + 1), 1.8f);
+    // the 2nd and 4th smallest of 1006, 1007, 1011, 1012
+    EXPECT_FLOAT_EQ(stats(1, RoiStatsEngine::STAT_COUNT), 0.7f);
+    EXPECT_FLOAT_EQ(stats(1, RoiStatsEngine::STAT_COUNT + 1), 1.2f);
+  }
+
+  auto histogram = Histogram();
+  engine.add_to_histogram(frame, 1, histogram);
+  EXPECT_EQ(histogram.count(), 4);
+  EXPECT_EQ(histogram.quantile(0.0), 1006);
+}
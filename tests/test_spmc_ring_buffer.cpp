@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "../src/nqm/irimager/spmc_ring_buffer.hpp"
+
+using PushResult = SpmcRingBuffer<int>::PushResult;
+
+TEST(test_spmc_ring_buffer, BasicAssertions) {
+  auto ring_buffer = SpmcRingBuffer<int>(3);
+  EXPECT_EQ(ring_buffer.capacity(), 3);
+  EXPECT_TRUE(ring_buffer.empty());
+
+  int value = -1;
+  EXPECT_FALSE(ring_buffer.try_pop([&](int &slot) { value = slot; }));
+
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(ring_buffer.try_push([i](int &slot) {
+      slot = i;
+      return true;
+    }),
+              PushResult::PUSHED);
+  }
+  EXPECT_EQ(ring_buffer.size(), 3);
+
+  auto writer_called = false;
+  EXPECT_EQ(ring_buffer.try_push([&](int &) {
+    writer_called = true;
+    return true;
+  }),
+            PushResult::FULL);
+  EXPECT_FALSE(writer_called);
+
+  EXPECT_TRUE(ring_buffer.try_pop([&](int &slot) { value = slot; }));
+  EXPECT_EQ(value, 0);
+  EXPECT_EQ(ring_buffer.size(), 2);
+
+  // should wrap around
+  EXPECT_EQ(ring_buffer.try_push([](int &slot) {
+    slot = 3;
+    return true;
+  }),
+            PushResult::PUSHED);
+
+  for (int expected = 1; expected <= 3; expected++) {
+    EXPECT_TRUE(ring_buffer.try_pop([&](int &slot) { value = slot; }));
+    EXPECT_EQ(value, expected);
+  }
+  EXPECT_TRUE(ring_buffer.empty());
+}
+
+// a single slot should alternate between full and empty
+TEST(test_spmc_ring_buffer, SingleSlot) {
+  auto ring_buffer = SpmcRingBuffer<int>(1);
+  int value = -1;
+
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(ring_buffer.try_push([i](int &slot) {
+      slot = i;
+      return true;
+    }),
+              PushResult::PUSHED);
+    EXPECT_EQ(ring_buffer.try_push([](int &) { return true; }),
+              PushResult::FULL);
+
+    EXPECT_TRUE(ring_buffer.try_pop([&](int &slot) { value = slot; }));
+    EXPECT_EQ(value, i);
+    EXPECT_FALSE(ring_buffer.try_pop([&](int &slot) { value = slot; }));
+  }
+}
+
+// slots should be preallocated from the prototype, and reused in-place
+TEST(test_spmc_ring_buffer, ReusesSlots) {
+  auto ring_buffer = SpmcRingBuffer<std::vector<int>>(2, std::vector<int>(4));
+
+  const int *first_slot_data = nullptr;
+  ring_buffer.try_push([&](std::vector<int> &slot) {
+    EXPECT_EQ(slot.size(), 4);
+    first_slot_data = slot.data();
+    return true;
+  });
+  ring_buffer.try_pop([](std::vector<int> &) {});
+  ring_buffer.try_push([](std::vector<int> &) { return true; });
+  ring_buffer.try_pop([](std::vector<int> &) {});
+
+  ring_buffer.try_push([&](std::vector<int> &slot) {
+    EXPECT_EQ(slot.data(), first_slot_data);
+    return true;
+  });
+}
+
+// rejected slots should not be visible to the consumer
+TEST(test_spmc_ring_buffer, RejectedPush) {
+  auto ring_buffer = SpmcRingBuffer<int>(1);
+
+  EXPECT_EQ(ring_buffer.try_push([](int &slot) {
+    slot = 1;
+    return false;
+  }),
+            PushResult::REJECTED);
+  EXPECT_TRUE(ring_buffer.empty());
+  EXPECT_FALSE(ring_buffer.try_pop([](int &) {}));
+
+  EXPECT_THROW(SpmcRingBuffer<int>(0), std::invalid_argument);
+}
+
+// a slot that is still being read should not be free yet, even though it
+// is no longer counted by size()
+TEST(test_spmc_ring_buffer, CanPush) {
+  auto ring_buffer = SpmcRingBuffer<int>(2);
+  EXPECT_TRUE(ring_buffer.can_push());
+
+  for (int i = 0; i < 2; i++) {
+    ring_buffer.try_push([i](int &slot) {
+      slot = i;
+      return true;
+    });
+  }
+  EXPECT_FALSE(ring_buffer.can_push());
+
+  EXPECT_TRUE(ring_buffer.try_pop([&](int &) {
+    EXPECT_LT(ring_buffer.size(), ring_buffer.capacity());
+    EXPECT_FALSE(ring_buffer.can_push());
+  }));
+  EXPECT_TRUE(ring_buffer.can_push());
+}
+
+// values should arrive in order, even when used by different threads
+TEST(test_spmc_ring_buffer, ThreadSafe) {
+  constexpr int COUNT = 100000;
+  auto ring_buffer = SpmcRingBuffer<int>(16);
+
+  auto producer = std::thread([&]() {
+    for (int i = 0; i < COUNT;) {
+      if (ring_buffer.try_push([i](int &slot) {
+            slot = i;
+            return true;
+          }) == PushResult::PUSHED) {
+        i++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int expected = 0;
+  while (expected < COUNT) {
+    if (!ring_buffer.try_pop([&](int &slot) {
+          EXPECT_EQ(slot, expected);
+          expected++;
+        })) {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  EXPECT_TRUE(ring_buffer.empty());
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/synthetic_scene.hpp"
+
+using namespace std::chrono_literals;
+
+static std::filesystem::path FIXTURES;
+
+TEST(test_synthetic_scene, FromXml) {
+  auto config = MockCameraConfig::from_xml(FIXTURES / "72x56@1000Hz.xml");
+  EXPECT_EQ(config.rows, 72);
+  EXPECT_EQ(config.cols, 56);
+  EXPECT_DOUBLE_EQ(config.framerate, 1000.0);
+  EXPECT_EQ(config.frame_period(), 1ms);
+  EXPECT_FLOAT_EQ(config.temperature_min, 600.0f);
+  EXPECT_FLOAT_EQ(config.temperature_max, 1800.0f);
+  EXPECT_EQ(config.flag_interval, 15s);
+
+  config = MockCameraConfig::from_xml(FIXTURES / "764x480@32Hz.xml");
+  EXPECT_EQ(config.rows, 764);
+  EXPECT_EQ(config.cols, 480);
+  EXPECT_DOUBLE_EQ(config.framerate, 32.0);
+
+  // without a resolution in the filename, the default resolution is used
+  auto path = std::filesystem::temp_directory_path() /
+              "test_synthetic_scene_FromXml.xml";
+  std::ofstream(path) << R"(<?xml version="1.0"?>
+<imager>
+  <!-- <framerate>1.0</framerate> -->
+  <framerate> 50.0 </framerate>
+  <autoflag><enable>0</enable><mininterval>15.0</mininterval></autoflag>
+</imager>)";
+  config = MockCameraConfig::from_xml(path);
+  EXPECT_EQ(config.rows, MockCameraConfig{}.rows);
+  EXPECT_EQ(config.cols, MockCameraConfig{}.cols);
+  EXPECT_DOUBLE_EQ(config.framerate, 50.0);
+  EXPECT_EQ(config.flag_interval, 0s);
+
+  std::ofstream(path) << "<imager><framerate>fast</framerate></imager>";
+  EXPECT_THROW(MockCameraConfig::from_xml(path), std::invalid_argument);
+  std::ofstream(path) << "<imager><framerate>0</framerate></imager>";
+  EXPECT_THROW(MockCameraConfig::from_xml(path), std::invalid_argument);
+  std::filesystem::remove(path);
+
+  EXPECT_THROW(MockCameraConfig::from_xml(FIXTURES / "missing.xml"),
+               std::runtime_error);
+}
+
+TEST(test_synthetic_scene, Render) {
+  auto config = MockCameraConfig{};
+  config.rows = 48;
+  config.cols = 64;
+  config.temperature_min = 0.0f;
+  config.temperature_max = 100.0f;
+  auto options = SyntheticSceneOptions{};
+  options.seed = 42;
+
+  auto scene = SyntheticScene(config, options, 1);
+  auto same_seed = SyntheticScene(config, options, 1);
+  options.seed = 43;
+  auto other_seed = SyntheticScene(config, options, 1);
+
+  auto frame = std::vector<std::uint16_t>(48 * 64);
+  auto same_seed_frame = frame;
+  auto other_seed_frame = frame;
+  auto next_frame = frame;
+  EXPECT_EQ(scene.render(10, frame.data()), FlagState::OPEN);
+  same_seed.render(10, same_seed_frame.data());
+  other_seed.render(10, other_seed_frame.data());
+  scene.render(11, next_frame.data());
+
+  EXPECT_EQ(frame, same_seed_frame);
+  EXPECT_NE(frame, other_seed_frame);
+  // hotspots move, and noise changes, between frames
+  EXPECT_NE(frame, next_frame);
+
+  // every pixel should be within the temperature range, in raw units, with
+  // the hotspots hotter than the background
+  auto [min, max] = std::minmax_element(frame.begin(), frame.end());
+  EXPECT_GE(*min, (0 + 100) * 10 - 20);
+  EXPECT_LE(*max, (100 + 100) * 10 + 20);
+  EXPECT_GT(*max - *min, 300);
+}
+
+TEST(test_synthetic_scene, ShutterClosures) {
+  auto config = MockCameraConfig{};
+  config.framerate = 100.0;
+  config.flag_interval = 1s;
+  auto scene = SyntheticScene(config, SyntheticSceneOptions{}, 1);
+
+  // the flag never closes before the first interval
+  for (std::uint64_t i = 0; i < 100; i++) {
+    EXPECT_EQ(scene.flag_state(i), FlagState::OPEN);
+  }
+  EXPECT_EQ(scene.flag_state(100), FlagState::CLOSING);
+  EXPECT_EQ(scene.flag_state(115), FlagState::CLOSED);
+  EXPECT_EQ(scene.flag_state(127), FlagState::OPENING);
+  EXPECT_EQ(scene.flag_state(130), FlagState::OPEN);
+  EXPECT_EQ(scene.flag_state(200), FlagState::CLOSING);
+
+  // frames only show the flag while it is closed
+  auto frame = std::vector<std::uint16_t>(
+      static_cast<std::size_t>(config.rows * config.cols));
+  EXPECT_EQ(scene.render(115, frame.data()), FlagState::CLOSED);
+  auto [min, max] = std::minmax_element(frame.begin(), frame.end());
+  EXPECT_LT(*max - *min, 100);
+
+  auto options = SyntheticSceneOptions{};
+  options.shutter_closures = false;
+  EXPECT_EQ(SyntheticScene(config, options, 1).flag_state(115),
+            FlagState::OPEN);
+}
+
+int main(int argc, char **argv) {
+  FIXTURES = std::filesystem::path(argv[0]).parent_path() / "__fixtures__";
+
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
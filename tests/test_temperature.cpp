@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "../src/nqm/irimager/temperature.hpp"
+
+TEST(test_temperature, Celsius) {
+  auto raw = std::array<std::uint16_t, 7>{0, 1000, 1250, 1001, 19000, 65535, 2};
+  auto out = std::array<float, 7>();
+
+  raw_to_temperature(raw.data(), out.data(), raw.size(), 1);
+
+  for (std::size_t i = 0; i < raw.size(); i++) {
+    EXPECT_FLOAT_EQ(out[i], static_cast<float>(raw[i]) / 10.0f - 100.0f);
+  }
+  EXPECT_FLOAT_EQ(out[1], 0.0f);
+  EXPECT_FLOAT_EQ(out[2], 25.0f);
+}
+
+/**
+ * Should convert every element, whether it's converted by the SIMD loop or
+ * by the scalar tail, even if the arrays aren't aligned.
+ */
+TEST(test_temperature, SimdAndTail) {
+  // 2 iterations of 16 elements (or 4 iterations of 8), plus a tail of 5
+  constexpr std::size_t SIZE = 37;
+  // one spare element, so that unaligned arrays can be tested
+  auto raw = std::array<std::uint16_t, SIZE + 1>();
+  for (std::size_t i = 0; i < raw.size(); i++) {
+    // spread over the whole uint16 range
+    raw[i] = static_cast<std::uint16_t>(i * 40503 % 65536);
+  }
+  raw[SIZE - 1] = 65535;
+  auto out = std::array<float, SIZE + 1>();
+
+  for (std::size_t start : {0u, 1u}) {
+    out.fill(-1.0f);
+    raw_to_temperature(raw.data() + start, out.data() + start, SIZE, 1);
+    for (std::size_t i = 0; i < out.size(); i++) {
+      auto expected = i >= start && i < start + SIZE
+                          ? static_cast<float>(raw[i]) / 10.0f - 100.0f
+                          : -1.0f;
+      EXPECT_FLOAT_EQ(out[i], expected) << "element " << i;
+    }
+  }
+}
+
+TEST(test_temperature, Kelvin) {
+  auto raw = std::array<std::uint16_t, 3>{0, 10000, 12500};
+  auto out = std::array<float, 3>();
+
+  raw_to_temperature(raw.data(), out.data(), raw.size(), 2,
+                     TemperatureUnit::KELVIN);
+
+  EXPECT_FLOAT_EQ(out[0], 173.15f);
+  EXPECT_FLOAT_EQ(out[1], 273.15f);
+  EXPECT_FLOAT_EQ(out[2], 298.15f);
+}
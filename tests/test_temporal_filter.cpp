@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../src/nqm/irimager/temporal_filter.hpp"
+
+using Frame = TemporalFilter::Frame;
+
+/** Random frames, so that every pixel has a different history */
+static std::vector<Frame> random_frames(std::size_t count) {
+  auto random = std::mt19937(42);
+  auto distribution = std::uniform_int_distribution<std::uint16_t>(900, 1100);
+  auto frames = std::vector<Frame>(count, Frame(5, 7));
+  for (auto &frame : frames) {
+    for (Eigen::Index i = 0; i < frame.size(); i++) {
+      frame.data()[i] = distribution(random);
+    }
+  }
+  return frames;
+}
+
+TEST(test_temporal_filter, InvalidArguments) {
+  EXPECT_THROW(TemporalFilter(0, 7, TemporalFilterMode::MEAN),
+               std::invalid_argument);
+  EXPECT_THROW(TemporalFilter(5, 7, TemporalFilterMode::MEAN, 0),
+               std::invalid_argument);
+  EXPECT_THROW(TemporalFilter(5, 7, TemporalFilterMode::MEAN,
+                              TemporalFilter::MAX_WINDOW + 1),
+               std::invalid_argument);
+  EXPECT_THROW(TemporalFilter(5, 7, TemporalFilterMode::EMA, 8, 0.0f),
+               std::invalid_argument);
+  EXPECT_THROW(TemporalFilter(5, 7, TemporalFilterMode::EMA, 8, 1.5f),
+               std::invalid_argument);
+
+  auto filter = TemporalFilter(5, 7, TemporalFilterMode::MEAN);
+  EXPECT_THROW(filter.snapshot(), std::runtime_error);
+  EXPECT_THROW(filter.push(Frame(7, 5)), std::invalid_argument);
+}
+
+/**
+ * Should match recomputing each window from scratch, for every window size.
+ */
+TEST(test_temporal_filter, SlidingWindow) {
+  auto frames = random_frames(40);
+  for (auto window : std::vector<std::size_t>{1, 2, 3, 8, 50}) {
+    auto max_hold = TemporalFilter(5, 7, TemporalFilterMode::MAX_HOLD, window);
+    auto min_hold = TemporalFilter(5, 7, TemporalFilterMode::MIN_HOLD, window);
+    auto mean = TemporalFilter(5, 7, TemporalFilterMode::MEAN, window);
+
+    for (std::size_t i = 0; i < frames.size(); i++) {
+      max_hold.push(frames[i]);
+      min_hold.push(frames[i]);
+      mean.push(frames[i]);
+
+      auto first = i + 1 > window ? i + 1 - window : 0;
+      auto expected_max = Frame(frames[first]);
+      auto expected_min = Frame(frames[first]);
+      auto sum = Eigen::ArrayXXd(frames[first].cast<double>().array());
+      for (auto j = first + 1; j <= i; j++) {
+        expected_max = expected_max.cwiseMax(frames[j]);
+        expected_min = expected_min.cwiseMin(frames[j]);
+        sum += frames[j].cast<double>().array();
+      }
+      ASSERT_EQ(max_hold.snapshot(), expected_max) << "window " << window;
+      ASSERT_EQ(min_hold.snapshot(), expected_min) << "window " << window;
+
+      auto expected_mean = sum / static_cast<double>(i + 1 - first);
+      auto error = (mean.snapshot().cast<double>().array() - expected_mean)
+                       .abs()
+                       .maxCoeff();
+      ASSERT_LE(error, 0.5) << "window " << window;
+    }
+    EXPECT_EQ(mean.count(), frames.size());
+  }
+}
+
+TEST(test_temporal_filter, Ema) {
+  auto filter = TemporalFilter(5, 7, TemporalFilterMode::EMA, 8, 0.25f);
+  auto frames = random_frames(20);
+
+  // the first frame is returned as-is
+  auto expected = Eigen::ArrayXXf(frames[0].cast<float>().array());
+  for (const auto &frame : frames) {
+    filter.push(frame);
+    if (filter.count() > 1) {
+      expected = 0.75f * expected + 0.25f * frame.cast<float>().array();
+    }
+    auto error =
+        (filter.snapshot().cast<float>().array() - expected).abs().maxCoeff();
+    ASSERT_LE(error, 0.5f + 1e-3f);
+  }
+}
+
+/**
+ * Should filter frames in-place, and forget frames after reset().
+ */
+TEST(test_temporal_filter, ApplyAndReset) {
+  auto filter = TemporalFilter(2, 2, TemporalFilterMode::MAX_HOLD, 2);
+  auto frame = Frame(2, 2);
+  frame << 1, 2, 3, 4;
+  filter.apply(frame);
+  EXPECT_EQ(frame, filter.snapshot());
+
+  auto next = Frame(2, 2);
+  next << 4, 3, 2, 1;
+  filter.apply(next);
+  auto expected = Frame(2, 2);
+  expected << 4, 3, 3, 4;
+  EXPECT_EQ(next, expected);
+
+  // strided frames, e.g. a crop of a larger frame, are also supported
+  auto big = Frame(4, 4);
+  big.setConstant(9);
+  filter.push(big.block(1, 1, 2, 2));
+  EXPECT_EQ(filter.snapshot(), Frame::Constant(2, 2, 9));
+
+  filter.reset();
+  EXPECT_EQ(filter.count(), 0);
+  EXPECT_THROW(filter.snapshot(), std::runtime_error);
+  filter.push(frame);
+  EXPECT_EQ(filter.snapshot(), frame);
+}
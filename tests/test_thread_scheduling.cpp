@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+#include "../src/nqm/irimager/thread_scheduling.hpp"
+
+TEST(test_thread_scheduling, Validate) {
+  EXPECT_NO_THROW(ThreadScheduling{}.validate());
+  EXPECT_NO_THROW((ThreadScheduling{{0}, 1, -20}.validate()));
+  EXPECT_NO_THROW((ThreadScheduling{{}, 99, 19}.validate()));
+
+  EXPECT_THROW((ThreadScheduling{{1000000}, {}, {}}.validate()),
+               std::invalid_argument);
+  EXPECT_THROW((ThreadScheduling{{}, 0, {}}.validate()),
+               std::invalid_argument);
+  EXPECT_THROW((ThreadScheduling{{}, 100, {}}.validate()),
+               std::invalid_argument);
+  EXPECT_THROW((ThreadScheduling{{}, {}, -21}.validate()),
+               std::invalid_argument);
+  EXPECT_THROW((ThreadScheduling{{}, {}, 20}.validate()),
+               std::invalid_argument);
+  EXPECT_THROW(apply_thread_scheduling(ThreadScheduling{{}, {}, 20}),
+               std::invalid_argument);
+}
+
+/**
+ * Should apply what it's allowed to, and report what it wasn't allowed to.
+ */
+TEST(test_thread_scheduling, Apply) {
+  // run in a new thread, so that we don't change the scheduling of the
+  // other tests
+  auto thread = std::thread([]() {
+    auto unchanged = apply_thread_scheduling(ThreadScheduling{});
+    EXPECT_TRUE(unchanged.errors.empty());
+    ASSERT_FALSE(unchanged.cpus.empty());
+    EXPECT_EQ(unchanged.fifo_priority, std::nullopt);
+
+    // raising the niceness is always allowed
+    auto cpu = unchanged.cpus.back();
+    auto applied = apply_thread_scheduling(
+        ThreadScheduling{{cpu}, {}, std::max(unchanged.nice, 10)});
+    EXPECT_TRUE(applied.errors.empty());
+    EXPECT_EQ(applied.cpus, std::vector<std::size_t>{cpu});
+    EXPECT_EQ(applied.nice, std::max(unchanged.nice, 10));
+
+    // SCHED_FIFO may be refused, but the error must then be reported
+    applied = apply_thread_scheduling(ThreadScheduling{{}, 1, {}});
+    if (applied.fifo_priority) {
+      EXPECT_EQ(applied.fifo_priority, 1);
+      EXPECT_TRUE(applied.errors.empty());
+    } else {
+      EXPECT_EQ(applied.errors.size(), 1);
+    }
+    EXPECT_EQ(applied.cpus, std::vector<std::size_t>{cpu});
+  });
+  thread.join();
+}